@@ -80,6 +80,59 @@ static const wxChar RealtimeConnectivity[] = wxT( "RealtimeConnectivity" );
  */
 static const wxChar CoroutineStackSize[] = wxT( "CoroutineStackSize" );
 
+/**
+ * Save the zone fills and their triangulations to a cache file next to the board when it is
+ * saved, and restore them when the board is loaded, so that unchanged zones are neither
+ * refilled nor retriangulated.
+ */
+static const wxChar ZoneFillCacheFile[] = wxT( "ZoneFillCacheFile" );
+
+/**
+ * Limit the number of worker threads used by all parallel algorithms (zone filling, DRC,
+ * connectivity, etc.).  Zero uses one thread per hardware thread, which may be too many on
+ * large shared machines.
+ */
+static const wxChar MaxWorkerThreads[] = wxT( "MaxWorkerThreads" );
+
+/**
+ * Update the schematic connection graph incrementally after an edit, rebuilding only the
+ * subgraphs of the modified items and of the nets and buses they are linked to.  Turning this
+ * off rebuilds the whole graph every time, as before.
+ */
+static const wxChar IncrementalConnectivity[] = wxT( "IncrementalConnectivity" );
+
+/**
+ * When many items have to be redrawn into the OpenGL cache (board load, display option or
+ * color changes), let the painter compute their polygons and triangulations on the worker
+ * threads first.  The vertices are still written to the GPU buffers by the GUI thread.
+ */
+static const wxChar ParallelRecache[] = wxT( "ParallelRecache" );
+
+/**
+ * Walk around obstacles in both winding directions, and try the alternative walkarounds
+ * of a shove, on worker threads.  The router picks the same path as when it runs serially.
+ */
+static const wxChar ParallelRouting[] = wxT( "ParallelRouting" );
+
+/**
+ * Undo/redo commands older than this many commands keep the copies of the items they
+ * changed in a compressed, serialized form instead of as full item copies.
+ */
+static const wxChar UndoPackDepth[] = wxT( "UndoPackDepth" );
+
+/**
+ * When the packed undo/redo commands use more memory than this (in MiB), the oldest ones
+ * are written to a temporary journal file and read back when they are undone.
+ */
+static const wxChar UndoMemoryLimit[] = wxT( "UndoMemoryLimit" );
+
+/**
+ * Record the calls made to the interactive router (start items, mouse trajectory, sizes and
+ * settings) to a JSON file next to the board, which the router_replay tool of
+ * qa_pcbnew_tools can replay to measure the router performance.
+ */
+static const wxChar RecordRouterInput[] = wxT( "RecordRouterInput" );
+
 } // namespace KEYS
 
 
@@ -160,6 +213,14 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_EnableUsePadProperty = false;
     m_realTimeConnectivity = true;
     m_coroutineStackSize = AC_STACK::default_stack;
+    m_ZoneFillCacheFile = false;
+    m_MaxWorkerThreads = 0;
+    m_IncrementalConnectivity = true;
+    m_ParallelRecache = true;
+    m_ParallelRouting = true;
+    m_UndoPackDepth = 10;
+    m_UndoMemoryLimit = 0;
+    m_RecordRouterInput = false;
 
     loadFromConfigFile();
 }
@@ -203,6 +264,30 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
                                                &m_coroutineStackSize, AC_STACK::default_stack,
                                                AC_STACK::min_stack, AC_STACK::max_stack ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ZoneFillCacheFile,
+                                                &m_ZoneFillCacheFile, false ) );
+
+    configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::MaxWorkerThreads,
+                                               &m_MaxWorkerThreads, 0, 0, 1024 ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IncrementalConnectivity,
+                                                &m_IncrementalConnectivity, true ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ParallelRecache,
+                                                &m_ParallelRecache, true ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ParallelRouting,
+                                                &m_ParallelRouting, true ) );
+
+    configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::UndoPackDepth,
+                                               &m_UndoPackDepth, 10, 0, 1000 ) );
+
+    configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::UndoMemoryLimit,
+                                               &m_UndoMemoryLimit, 0, 0, 1 << 20 ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::RecordRouterInput,
+                                                &m_RecordRouterInput, false ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     for( auto param : configParams )
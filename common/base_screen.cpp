@@ -30,6 +30,7 @@
  */
 
 
+#include <advanced_config.h>
 #include <base_screen.h>
 #include <base_struct.h>
 #include <base_units.h>
@@ -297,6 +298,8 @@ void BASE_SCREEN::PushCommandToUndoList( PICKED_ITEMS_LIST* aNewitem )
         if( extraitems > 0 )
             ClearUndoORRedoList( m_UndoList, extraitems );
     }
+
+    compactUndoRedoLists();
 }
 
 
@@ -312,18 +315,104 @@ void BASE_SCREEN::PushCommandToRedoList( PICKED_ITEMS_LIST* aNewitem )
         if( extraitems > 0 )
             ClearUndoORRedoList( m_RedoList, extraitems );
     }
+
+    compactUndoRedoLists();
 }
 
 
 PICKED_ITEMS_LIST* BASE_SCREEN::PopCommandFromUndoList( )
 {
-    return m_UndoList.PopCommand();
+    PICKED_ITEMS_LIST* command = m_UndoList.PopCommand();
+
+    if( command && m_undoPacker )
+        command->Unpack( *m_undoPacker );
+
+    return command;
 }
 
 
 PICKED_ITEMS_LIST* BASE_SCREEN::PopCommandFromRedoList( )
 {
-    return m_RedoList.PopCommand();
+    PICKED_ITEMS_LIST* command = m_RedoList.PopCommand();
+
+    if( command && m_undoPacker )
+        command->Unpack( *m_undoPacker );
+
+    return command;
+}
+
+
+void BASE_SCREEN::SetUndoItemPacker( UNDO_ITEM_PACKER* aPacker )
+{
+    // Commands packed by the previous packer can only be read back by it
+    if( m_undoPacker )
+    {
+        for( UNDO_REDO_CONTAINER* list : { &m_UndoList, &m_RedoList } )
+        {
+            for( PICKED_ITEMS_LIST* command : list->m_CommandsList )
+                command->Unpack( *m_undoPacker );
+        }
+    }
+
+    m_undoPacker.reset( aPacker );
+    compactUndoRedoLists();
+}
+
+
+void BASE_SCREEN::compactUndoRedoLists()
+{
+    const ADVANCED_CFG& cfg = ADVANCED_CFG::GetCfg();
+
+    if( !m_undoPacker || cfg.m_UndoPackDepth <= 0 )
+        return;
+
+    // The most recent commands are at the back of the lists.  Commands are packed from the
+    // back, so the first packed command found means all the older ones are packed too.
+    for( UNDO_REDO_CONTAINER* list : { &m_UndoList, &m_RedoList } )
+    {
+        std::vector<PICKED_ITEMS_LIST*>& commands = list->m_CommandsList;
+
+        for( int ii = (int) commands.size() - 1 - cfg.m_UndoPackDepth; ii >= 0; ii-- )
+        {
+            if( commands[ii]->IsPacked() )
+                break;
+
+            commands[ii]->Pack( *m_undoPacker );
+        }
+    }
+
+    if( cfg.m_UndoMemoryLimit <= 0 )
+        return;
+
+    size_t limit = (size_t) cfg.m_UndoMemoryLimit * 1024 * 1024;
+    size_t used = 0;
+
+    for( UNDO_REDO_CONTAINER* list : { &m_UndoList, &m_RedoList } )
+    {
+        for( PICKED_ITEMS_LIST* command : list->m_CommandsList )
+            used += command->GetPackedMemory();
+    }
+
+    // Move the oldest commands out of memory first
+    for( UNDO_REDO_CONTAINER* list : { &m_UndoList, &m_RedoList } )
+    {
+        for( PICKED_ITEMS_LIST* command : list->m_CommandsList )
+        {
+            if( used <= limit )
+                return;
+
+            size_t size = command->GetPackedMemory();
+
+            if( size == 0 )
+                continue;
+
+            if( !m_undoJournal )
+                m_undoJournal.reset( new UNDO_JOURNAL() );
+
+            command->MoveToJournal( *m_undoJournal );
+            used -= size - command->GetPackedMemory();
+        }
+    }
 }
 
 
@@ -36,6 +36,7 @@
 
 #include <base_units.h>
 #include <common.h>
+#include <kicad_string.h>
 #include <math/util.h>      // for KiROUND
 #include <macros.h>
 #include <title_block.h>
@@ -54,38 +55,11 @@
 
 
 // Helper function to print a float number without using scientific notation
-// and no trailing 0
-// So we cannot always just use the %g or the %f format to print a fp number
-// this helper function uses the %f format when needed, or %g when %f is
-// not well working and then removes trailing 0
+// and no trailing 0, independently of the current locale
 
 std::string Double2Str( double aValue )
 {
-    char    buf[50];
-    int     len;
-
-    if( aValue != 0.0 && fabs( aValue ) <= 0.0001 )
-    {
-        // For these small values, %f works fine,
-        // and %g gives an exponent
-        len = sprintf( buf,  "%.16f", aValue );
-
-        while( --len > 0 && buf[len] == '0' )
-            buf[len] = '\0';
-
-        if( buf[len] == '.' )
-            buf[len] = '\0';
-        else
-            ++len;
-    }
-    else
-    {
-        // For these values, %g works fine, and sometimes %f
-        // gives a bad value (try aValue = 1.222222222222, with %.16f format!)
-        len = sprintf( buf, "%.16g", aValue );
-    }
-
-    return std::string( buf, len );
+    return FormatDouble( aValue );
 }
 
 
@@ -530,41 +504,17 @@ wxString GetAbbreviatedUnitsLabel( EDA_UNITS aUnit, bool aUseMils, EDA_DATA_TYPE
 
 std::string FormatInternalUnits( int aValue )
 {
-    char    buf[50];
-    double  engUnits = aValue;
-    int     len;
+    double engUnits = aValue;
 
     engUnits /= IU_PER_MM;
 
-    if( engUnits != 0.0 && fabs( engUnits ) <= 0.0001 )
-    {
-        len = snprintf( buf, sizeof(buf), "%.10f", engUnits );
-
-        while( --len > 0 && buf[len] == '0' )
-            buf[len] = '\0';
-
-        if( buf[len] == '.' )
-            buf[len] = '\0';
-        else
-            ++len;
-    }
-    else
-    {
-        len = snprintf( buf, sizeof(buf), "%.10g", engUnits );
-    }
-
-    return std::string( buf, len );
+    return FormatDouble( engUnits, 10 );
 }
 
 
 std::string FormatAngle( double aAngle )
 {
-    char temp[50];
-    int len;
-
-    len = snprintf( temp, sizeof(temp), "%.10g", aAngle / 10.0 );
-
-    return std::string( temp, len );
+    return FormatDouble( aAngle / 10.0, 10 );
 }
 
 
@@ -42,8 +42,9 @@
 using KIGFX::COLOR4D;
 
 
-// Create only once, as seeding is *very* expensive
-static boost::uuids::random_generator randomGenerator;
+// Create only once per thread, as seeding is *very* expensive and the generator is not
+// thread safe (items are created by parallel loaders)
+static thread_local boost::uuids::random_generator randomGenerator;
 
 // These don't have the same performance penalty, but might as well be consistent
 static boost::uuids::string_generator stringGenerator;
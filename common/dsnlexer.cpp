@@ -476,6 +476,95 @@ inline bool isSep( char cc )
 }
 
 
+void DSNLEXER::ReadBlockText( std::string& aText )
+{
+    wxASSERT( !specctraMode );
+
+    const char* cur = next;
+    const char* run = cur;          // start of the text not yet appended to aText
+    int         depth = 1;
+    bool        inString = false;
+    bool        tokenStart = true;  // a delimiter here would start a quoted string
+
+    while( true )
+    {
+        if( cur >= limit )
+        {
+            if( inString )
+            {
+                wxString errtxt( _( "Un-terminated delimited string" ) );
+                THROW_PARSE_ERROR( errtxt, CurSource(), CurLine(), CurLineNumber(),
+                                   run - start );
+            }
+
+            aText.append( run, cur );
+
+            if( readLine() == 0 )
+            {
+                next = start;
+                curOffset = 0;
+                Expecting( DSN_RIGHT );
+            }
+
+            cur = start;
+            run = start;
+            tokenStart = true;
+
+            const char* first = start;
+
+            while( first < limit && isSpace( *first ) )
+                ++first;
+
+            // comment lines are dropped, as they would be by NextTok(), but their line is kept
+            // so that the line numbers of the block still match the ones of the file
+            if( first < limit && *first == '#' )
+            {
+                aText += '\n';
+                cur = run = limit;
+            }
+
+            continue;
+        }
+
+        char cc = *cur++;
+
+        if( inString )
+        {
+            if( cc == '\\' && cur < limit )
+            {
+                ++cur;
+            }
+            else if( cc == stringDelimiter )
+            {
+                inString = false;
+                tokenStart = true;
+            }
+        }
+        else if( cc == stringDelimiter && tokenStart )
+        {
+            inString = true;
+        }
+        else
+        {
+            tokenStart = isSep( cc );
+
+            if( cc == '(' )
+                ++depth;
+            else if( cc == ')' && --depth == 0 )
+                break;
+        }
+    }
+
+    aText.append( run, cur );
+
+    prevTok   = curTok;
+    curTok    = DSN_RIGHT;
+    curText   = ")";
+    curOffset = cur - 1 - start;
+    next      = cur;
+}
+
+
 /**
  * Function isNumber
  * returns true if the next sequence of text is a number:
@@ -655,7 +744,7 @@ L_read:
                     case 'v':   c = '\x0b';     break;
 
                     case 'x':   // 1 or 2 byte hex escape sequence
-                        for( i=0; i<2; ++i )
+                        for( i=0; i<2 && head+i<limit; ++i )
                         {
                             if( !isxdigit( head[i] ) )
                                 break;
@@ -671,7 +760,7 @@ L_read:
 
                     default:    // 1-3 byte octal escape sequence
                         --head;
-                        for( i=0; i<3; ++i )
+                        for( i=0; i<3 && head+i<limit; ++i )
                         {
                             if( head[i] < '0' || head[i] > '7' )
                                 break;
@@ -697,7 +786,15 @@ L_read:
                 }
 
                 else
-                    curText += *head++;
+                {
+                    // copy the run of plain characters in one go
+                    const char* run = head;
+
+                    while( head<limit && *head != '\\' && *head != '"' )
+                        ++head;
+
+                    curText.append( run, head );
+                }
 
             }   // while
 
@@ -777,11 +874,11 @@ L_read:
     }           // specctraMode
 
     // non-quoted token, read it into curText.
-    curText.clear();
-
     head = cur;
     while( head<limit && !isSep( *head ) )
-        curText += *head++;
+        ++head;
+
+    curText.assign( cur, head );
 
     if( isNumber( curText.c_str(), curText.c_str() + curText.size() ) )
     {
@@ -338,7 +338,8 @@ const std::map<wxString, double> EDA_PATTERN_MATCH_RELATIONAL::m_units = {
 
 
 EDA_COMBINED_MATCHER::EDA_COMBINED_MATCHER( const wxString& aPattern )
-    : m_pattern( aPattern )
+    : m_pattern( aPattern ),
+      m_literal( IsLiteralPattern( aPattern ) )
 {
     // Whatever syntax users prefer, it shall be matched.
     AddMatcher( aPattern, std::make_unique<EDA_PATTERN_MATCH_REGEX>() );
@@ -355,6 +356,19 @@ bool EDA_COMBINED_MATCHER::Find( const wxString& aTerm, int& aMatchersTriggered,
     aPosition = EDA_PATTERN_NOT_FOUND;
     aMatchersTriggered = 0;
 
+    if( m_literal )
+    {
+        int loc = aTerm.Find( m_pattern );
+
+        if( loc != wxNOT_FOUND )
+        {
+            aMatchersTriggered = (int) m_matchers.size();
+            aPosition = loc;
+        }
+
+        return aPosition != EDA_PATTERN_NOT_FOUND;
+    }
+
     for( auto const& matcher : m_matchers )
     {
         int local_find = matcher->Find( aTerm );
@@ -374,6 +388,23 @@ bool EDA_COMBINED_MATCHER::Find( const wxString& aTerm, int& aMatchersTriggered,
 }
 
 
+bool EDA_COMBINED_MATCHER::IsLiteralPattern( const wxString& aPattern )
+{
+    if( aPattern.IsEmpty() )
+        return false;
+
+    // Letters, digits, '_' and '-' mean nothing special to the regex and wildcard matchers,
+    // and the relational matcher needs a relation.
+    for( wxUniChar c : aPattern )
+    {
+        if( !wxIsalnum( c ) && c != '_' && c != '-' )
+            return false;
+    }
+
+    return true;
+}
+
+
 wxString const& EDA_COMBINED_MATCHER::GetPattern() const
 {
     return m_pattern;
@@ -42,12 +42,14 @@
 #include <math/util.h>      // for KiROUND
 
 #include <macros.h>
+#include <thread_pool.h>
 
 #ifdef __WXDEBUG__
 #include <profile.h>
 #include <wx/log.h>
 #endif /* __WXDEBUG__ */
 
+#include <algorithm>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -978,26 +980,81 @@ void OPENGL_GAL::drawTriangulatedPolyset( const SHAPE_POLY_SET& aPolySet )
 
     if( isFillEnabled )
     {
+        // Large fills (zones) are split in runs of triangles written by the worker threads
+        const size_t trianglesPerTask = 4096;
+
+        struct TRIANGLE_RUN
+        {
+            const SHAPE_POLY_SET::TRIANGULATED_POLYGON* poly;
+            size_t                                      first;
+            size_t                                      last;
+            unsigned int                                offset;   ///< of the first vertex
+        };
+
+        std::vector<TRIANGLE_RUN> runs;
+        unsigned int              vertexCount = 0;
+
         for( unsigned int j = 0; j < aPolySet.TriangulatedPolyCount(); ++j )
         {
             auto triPoly = aPolySet.TriangulatedPolygon( j );
 
-            for( size_t i = 0; i < triPoly->GetTriangleCount(); i++ )
+            for( size_t i = 0; i < triPoly->GetTriangleCount(); i += trianglesPerTask )
             {
-                VECTOR2I a, b, c;
-                triPoly->GetTriangle( i, a, b, c );
-                currentManager->Vertex( a.x, a.y, layerDepth );
-                currentManager->Vertex( b.x, b.y, layerDepth );
-                currentManager->Vertex( c.x, c.y, layerDepth );
+                size_t last = std::min( i + trianglesPerTask, triPoly->GetTriangleCount() );
+                runs.push_back( { triPoly, i, last, vertexCount } );
+                vertexCount += 3 * ( last - i );
             }
         }
+
+        GLfloat depth = layerDepth;
+
+        auto fillRun = [depth]( const TRIANGLE_RUN& aRun, VERTEX* aVertices )
+        {
+            VERTEX* vertex = aVertices + aRun.offset;
+
+            for( size_t i = aRun.first; i < aRun.last; i++ )
+            {
+                VECTOR2I tri[3];
+                aRun.poly->GetTriangle( i, tri[0], tri[1], tri[2] );
+
+                for( const VECTOR2I& pt : tri )
+                {
+                    vertex->x = pt.x;
+                    vertex->y = pt.y;
+                    vertex->z = depth;
+                    ++vertex;
+                }
+            }
+        };
+
+        if( vertexCount > 0 )
+        {
+            currentManager->Vertices( vertexCount,
+                    [&]( VERTEX* aVertices )
+                    {
+                        if( vertexCount <= 3 * trianglesPerTask )
+                        {
+                            for( const TRIANGLE_RUN& run : runs )
+                                fillRun( run, aVertices );
+
+                            return;
+                        }
+
+                        TASK_GROUP tasks;
+
+                        for( const TRIANGLE_RUN& run : runs )
+                            tasks.Run( [&fillRun, &run, aVertices]() { fillRun( run, aVertices ); } );
+
+                        tasks.Wait();
+                    } );
+        }
     }
 
     if( isStrokeEnabled )
     {
         for( int j = 0; j < aPolySet.OutlineCount(); ++j )
         {
-            const auto& poly = aPolySet.Polygon( j );
+            const auto& poly = aPolySet.CPolygon( j );
 
             for( const auto& lc : poly )
             {
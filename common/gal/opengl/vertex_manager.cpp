@@ -34,6 +34,9 @@
 #include <gal/opengl/gpu_manager.h>
 #include <gal/opengl/vertex_item.h>
 #include <confirm.h>
+#include <thread_pool.h>
+
+#include <algorithm>
 
 using namespace KIGFX;
 
@@ -154,6 +157,60 @@ bool VERTEX_MANAGER::Vertices( const VERTEX aVertices[], unsigned int aSize )
 }
 
 
+bool VERTEX_MANAGER::Vertices( unsigned int aSize, const std::function<void( VERTEX* )>& aFiller )
+{
+    // Below this, the vertices are not worth the threads
+    const unsigned int verticesPerTask = 16384;
+
+    // flag to avoid hanging by calling DisplayError too many times:
+    static bool show_err = true;
+
+    assert( m_reservedSpace == 0 && m_reserved == NULL );
+
+    // Obtain pointer to the vertex in currently used container
+    VERTEX* newVertex = m_container->Allocate( aSize );
+
+    if( newVertex == NULL )
+    {
+        if( show_err )
+        {
+            DisplayError( NULL, wxT( "VERTEX_MANAGER::Vertices: Vertex allocation error" ) );
+            show_err = false;
+        }
+
+        return false;
+    }
+
+    aFiller( newVertex );
+
+    auto applyState = [this, newVertex]( unsigned int aFirst, unsigned int aLast )
+    {
+        for( unsigned int i = aFirst; i < aLast; ++i )
+            putVertex( newVertex[i], newVertex[i].x, newVertex[i].y, newVertex[i].z );
+    };
+
+    if( aSize <= verticesPerTask )
+    {
+        applyState( 0, aSize );
+        return true;
+    }
+
+    // The container memory is already allocated (and mapped), so it can be written from the
+    // worker threads
+    TASK_GROUP tasks;
+
+    for( unsigned int first = 0; first < aSize; first += verticesPerTask )
+    {
+        unsigned int last = std::min( first + verticesPerTask, aSize );
+        tasks.Run( [&applyState, first, last]() { applyState( first, last ); } );
+    }
+
+    tasks.Wait();
+
+    return true;
+}
+
+
 void VERTEX_MANAGER::SetItem( VERTEX_ITEM& aItem ) const
 {
     m_container->SetItem( &aItem );
@@ -28,10 +28,15 @@
 #include <class_text_mod.h>
 #include <class_edge_mod.h>
 #include <class_pad.h>
+#include <class_track.h>
+#include <class_pcb_text.h>
+#include <class_zone.h>
 
 #include <functional>
+#include <boost/functional/hash.hpp>
 
 using namespace std;
+using boost::hash_combine;
 
 // Common calculation part for all BOARD_ITEMs
 static inline size_t hash_board_item( const BOARD_ITEM* aItem, int aFlags )
@@ -45,6 +50,24 @@ static inline size_t hash_board_item( const BOARD_ITEM* aItem, int aFlags )
 }
 
 
+static inline void hash_poly_set( size_t& aSeed, const SHAPE_POLY_SET& aPolySet )
+{
+    for( int ii = 0; ii < aPolySet.OutlineCount(); ++ii )
+    {
+        for( const SHAPE_LINE_CHAIN& chain : aPolySet.CPolygon( ii ) )
+        {
+            hash_combine( aSeed, chain.PointCount() );
+
+            for( int jj = 0; jj < chain.PointCount(); ++jj )
+            {
+                hash_combine( aSeed, chain.CPoint( jj ).x );
+                hash_combine( aSeed, chain.CPoint( jj ).y );
+            }
+        }
+    }
+}
+
+
 size_t hash_eda( const EDA_ITEM* aItem, int aFlags )
 {
     size_t ret = 0xa82de1c0;
@@ -59,13 +82,14 @@ size_t hash_eda( const EDA_ITEM* aItem, int aFlags )
 
             if( aFlags & POSITION )
             {
-                ret += hash<int>{}( module->GetPosition().x );
-                ret += hash<int>{}( module->GetPosition().y );
+                hash_combine( ret, module->GetPosition().x );
+                hash_combine( ret, module->GetPosition().y );
             }
 
             if( aFlags & ROTATION )
-                ret += hash<double>{}( module->GetOrientation() );
+                hash_combine( ret, module->GetOrientation() );
 
+            // Children are summed so that their order doesn't matter
             for( auto i : module->GraphicalItems() )
                 ret += hash_eda( i, aFlags );
 
@@ -78,34 +102,45 @@ size_t hash_eda( const EDA_ITEM* aItem, int aFlags )
         {
             const D_PAD* pad = static_cast<const D_PAD*>( aItem );
             ret += hash_board_item( pad, aFlags );
-            ret += hash<int>{}( pad->GetShape() << 16 );
-            ret += hash<int>{}( pad->GetDrillShape() << 18 );
-            ret += hash<int>{}( pad->GetSize().x << 8 );
-            ret += hash<int>{}( pad->GetSize().y << 9 );
-            ret += hash<int>{}( pad->GetOffset().x << 6 );
-            ret += hash<int>{}( pad->GetOffset().y << 7 );
-            ret += hash<int>{}( pad->GetDelta().x << 4 );
-            ret += hash<int>{}( pad->GetDelta().y << 5 );
+            hash_combine( ret, static_cast<int>( pad->GetShape() ) );
+            hash_combine( ret, static_cast<int>( pad->GetDrillShape() ) );
+            hash_combine( ret, pad->GetSize().x );
+            hash_combine( ret, pad->GetSize().y );
+            hash_combine( ret, pad->GetDrillSize().x );
+            hash_combine( ret, pad->GetDrillSize().y );
+            hash_combine( ret, pad->GetOffset().x );
+            hash_combine( ret, pad->GetOffset().y );
+            hash_combine( ret, pad->GetDelta().x );
+            hash_combine( ret, pad->GetDelta().y );
+            hash_combine( ret, pad->GetRoundRectRadiusRatio() );
+            hash_combine( ret, pad->GetChamferRectRatio() );
+            hash_combine( ret, pad->GetChamferPositions() );
+
+            if( pad->GetShape() == PAD_SHAPE_CUSTOM )
+            {
+                hash_combine( ret, static_cast<int>( pad->GetCustomShapeInZoneOpt() ) );
+                hash_poly_set( ret, pad->GetCustomShapeAsPolygon() );
+            }
 
             if( aFlags & POSITION )
             {
                 if( aFlags & REL_COORD )
                 {
-                    ret += hash<int>{}( pad->GetPos0().x );
-                    ret += hash<int>{}( pad->GetPos0().y );
+                    hash_combine( ret, pad->GetPos0().x );
+                    hash_combine( ret, pad->GetPos0().y );
                 }
                 else
                 {
-                    ret += hash<int>{}( pad->GetPosition().x );
-                    ret += hash<int>{}( pad->GetPosition().y );
+                    hash_combine( ret, pad->GetPosition().x );
+                    hash_combine( ret, pad->GetPosition().y );
                 }
             }
 
             if( aFlags & ROTATION )
-                ret += hash<double>{}( pad->GetOrientation() );
+                hash_combine( ret, pad->GetOrientation() );
 
             if( aFlags & NET )
-                ret += hash<int>{}( pad->GetNetCode() << 6 );
+                hash_combine( ret, pad->GetNetCode() );
         }
         break;
 
@@ -120,31 +155,31 @@ size_t hash_eda( const EDA_ITEM* aItem, int aFlags )
                 break;
 
             ret += hash_board_item( text, aFlags );
-            ret += hash<string>{}( text->GetText().ToStdString() );
-            ret += hash<bool>{}( text->IsItalic() );
-            ret += hash<bool>{}( text->IsBold() );
-            ret += hash<bool>{}( text->IsMirrored() );
-            ret += hash<int>{}( text->GetTextWidth() );
-            ret += hash<int>{}( text->GetTextHeight() );
-            ret += hash<int>{}( text->GetHorizJustify() );
-            ret += hash<int>{}( text->GetVertJustify() );
+            hash_combine( ret, text->GetText().ToStdString() );
+            hash_combine( ret, text->IsItalic() );
+            hash_combine( ret, text->IsBold() );
+            hash_combine( ret, text->IsMirrored() );
+            hash_combine( ret, text->GetTextWidth() );
+            hash_combine( ret, text->GetTextHeight() );
+            hash_combine( ret, static_cast<int>( text->GetHorizJustify() ) );
+            hash_combine( ret, static_cast<int>( text->GetVertJustify() ) );
 
             if( aFlags & POSITION )
             {
                 if( aFlags & REL_COORD )
                 {
-                    ret += hash<int>{}( text->GetPos0().x );
-                    ret += hash<int>{}( text->GetPos0().y );
+                    hash_combine( ret, text->GetPos0().x );
+                    hash_combine( ret, text->GetPos0().y );
                 }
                 else
                 {
-                    ret += hash<int>{}( text->GetPosition().x );
-                    ret += hash<int>{}( text->GetPosition().y );
+                    hash_combine( ret, text->GetPosition().x );
+                    hash_combine( ret, text->GetPosition().y );
                 }
             }
 
             if( aFlags & ROTATION )
-                ret += hash<double>{}( text->GetTextAngle() );
+                hash_combine( ret, text->GetTextAngle() );
         }
         break;
 
@@ -152,36 +187,140 @@ size_t hash_eda( const EDA_ITEM* aItem, int aFlags )
         {
             const EDGE_MODULE* segment = static_cast<const EDGE_MODULE*>( aItem );
             ret += hash_board_item( segment, aFlags );
-            ret += hash<int>{}( segment->GetType() );
-            ret += hash<int>{}( segment->GetShape() );
-            ret += hash<int>{}( segment->GetWidth() );
-            ret += hash<int>{}( segment->GetRadius() );
+            hash_combine( ret, static_cast<int>( segment->GetType() ) );
+            hash_combine( ret, static_cast<int>( segment->GetShape() ) );
+            hash_combine( ret, segment->GetWidth() );
+            hash_combine( ret, segment->GetRadius() );
 
             if( aFlags & POSITION )
             {
                 if( aFlags & REL_COORD )
                 {
-                    ret += hash<int>{}( segment->GetStart0().x );
-                    ret += hash<int>{}( segment->GetStart0().y );
-                    ret += hash<int>{}( segment->GetEnd0().x );
-                    ret += hash<int>{}( segment->GetEnd0().y );
+                    hash_combine( ret, segment->GetStart0().x );
+                    hash_combine( ret, segment->GetStart0().y );
+                    hash_combine( ret, segment->GetEnd0().x );
+                    hash_combine( ret, segment->GetEnd0().y );
                 }
                 else
                 {
-                    ret += hash<int>{}( segment->GetStart().x );
-                    ret += hash<int>{}( segment->GetStart().y );
-                    ret += hash<int>{}( segment->GetEnd().x );
-                    ret += hash<int>{}( segment->GetEnd().y );
+                    hash_combine( ret, segment->GetStart().x );
+                    hash_combine( ret, segment->GetStart().y );
+                    hash_combine( ret, segment->GetEnd().x );
+                    hash_combine( ret, segment->GetEnd().y );
                 }
+
+                if( segment->GetShape() == S_POLYGON )
+                    hash_poly_set( ret, segment->GetPolyShape() );
             }
 
             if( aFlags & ROTATION )
-                ret += hash<double>{}( segment->GetAngle() );
+                hash_combine( ret, segment->GetAngle() );
+        }
+        break;
+
+    case PCB_LINE_T:
+        {
+            const DRAWSEGMENT* segment = static_cast<const DRAWSEGMENT*>( aItem );
+            ret += hash_board_item( segment, aFlags );
+            hash_combine( ret, static_cast<int>( segment->GetShape() ) );
+            hash_combine( ret, segment->GetWidth() );
+            hash_combine( ret, segment->GetAngle() );
+
+            if( aFlags & POSITION )
+            {
+                hash_combine( ret, segment->GetStart().x );
+                hash_combine( ret, segment->GetStart().y );
+                hash_combine( ret, segment->GetEnd().x );
+                hash_combine( ret, segment->GetEnd().y );
+                hash_combine( ret, segment->GetBezControl1().x );
+                hash_combine( ret, segment->GetBezControl1().y );
+                hash_combine( ret, segment->GetBezControl2().x );
+                hash_combine( ret, segment->GetBezControl2().y );
+
+                if( segment->GetShape() == S_POLYGON )
+                    hash_poly_set( ret, segment->GetPolyShape() );
+            }
+        }
+        break;
+
+    case PCB_TEXT_T:
+        {
+            const TEXTE_PCB* text = static_cast<const TEXTE_PCB*>( aItem );
+            ret += hash_board_item( text, aFlags );
+            hash_combine( ret, text->GetText().ToStdString() );
+            hash_combine( ret, text->IsItalic() );
+            hash_combine( ret, text->IsBold() );
+            hash_combine( ret, text->IsMirrored() );
+            hash_combine( ret, text->GetTextWidth() );
+            hash_combine( ret, text->GetTextHeight() );
+            hash_combine( ret, text->GetTextThickness() );
+            hash_combine( ret, static_cast<int>( text->GetHorizJustify() ) );
+            hash_combine( ret, static_cast<int>( text->GetVertJustify() ) );
+
+            if( aFlags & POSITION )
+            {
+                hash_combine( ret, text->GetTextPos().x );
+                hash_combine( ret, text->GetTextPos().y );
+            }
+
+            if( aFlags & ROTATION )
+                hash_combine( ret, text->GetTextAngle() );
+        }
+        break;
+
+    case PCB_TRACE_T:
+    case PCB_ARC_T:
+    case PCB_VIA_T:
+        {
+            const TRACK* track = static_cast<const TRACK*>( aItem );
+            ret += hash_board_item( track, aFlags );
+            hash_combine( ret, static_cast<int>( track->Type() ) );
+            hash_combine( ret, track->GetWidth() );
+
+            if( aFlags & POSITION )
+            {
+                hash_combine( ret, track->GetStart().x );
+                hash_combine( ret, track->GetStart().y );
+                hash_combine( ret, track->GetEnd().x );
+                hash_combine( ret, track->GetEnd().y );
+
+                if( track->Type() == PCB_ARC_T )
+                {
+                    hash_combine( ret, static_cast<const ARC*>( track )->GetMid().x );
+                    hash_combine( ret, static_cast<const ARC*>( track )->GetMid().y );
+                }
+            }
+
+            if( track->Type() == PCB_VIA_T )
+            {
+                const VIA* via = static_cast<const VIA*>( track );
+                hash_combine( ret, static_cast<int>( via->GetViaType() ) );
+                hash_combine( ret, via->GetDrillValue() );
+            }
+
+            if( aFlags & NET )
+                hash_combine( ret, track->GetNetCode() );
+        }
+        break;
+
+    case PCB_ZONE_AREA_T:
+        {
+            const ZONE_CONTAINER* zone = static_cast<const ZONE_CONTAINER*>( aItem );
+            ret += hash_board_item( zone, aFlags );
+
+            hash_combine( ret, zone->GetCornerSmoothingType() );
+            hash_combine( ret, zone->GetCornerRadius() );
+
+            if( aFlags & POSITION )
+                hash_poly_set( ret, *zone->Outline() );
+
+            if( aFlags & NET )
+                hash_combine( ret, zone->GetNetCode() );
         }
         break;
 
     default:
-        wxASSERT_MSG( false, "Unhandled type in function hashModItem() (exporter_gencad.cpp)" );
+        wxASSERT_MSG( false, "Unhandled type in function hash_eda()" );
     }
 
     return ret;
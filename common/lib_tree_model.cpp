@@ -22,6 +22,8 @@
 #include <lib_tree_model.h>
 
 #include <algorithm>
+#include <iterator>
+#include <numeric>
 #include <eda_pattern_match.h>
 #include <lib_tree_item.h>
 #include <utility>
@@ -59,6 +61,17 @@ void LIB_TREE_NODE::ResetScore()
 }
 
 
+void LIB_TREE_NODE::Normalize()
+{
+    if( !m_Normalized )
+    {
+        m_MatchName = m_MatchName.Lower();
+        m_SearchText = m_SearchText.Lower();
+        m_Normalized = true;
+    }
+}
+
+
 void LIB_TREE_NODE::AssignIntrinsicRanks( bool presorted )
 {
     std::vector<LIB_TREE_NODE*> sort_buf;
@@ -211,12 +224,7 @@ void LIB_TREE_NODE_LIB_ID::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
     if( m_Score <= 0 )
         return; // Leaf nodes without scores are out of the game.
 
-    if( !m_Normalized )
-    {
-        m_MatchName = m_MatchName.Lower();
-        m_SearchText = m_SearchText.Lower();
-        m_Normalized = true;
-    }
+    Normalize();
 
     // Keywords and description we only count if the match string is at
     // least two characters long. That avoids spurious, low quality
@@ -317,7 +325,8 @@ void LIB_TREE_NODE_LIB::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 }
 
 
-LIB_TREE_NODE_ROOT::LIB_TREE_NODE_ROOT()
+LIB_TREE_NODE_ROOT::LIB_TREE_NODE_ROOT() :
+        m_trigramsIndexed( false )
 {
     m_Type = ROOT;
 }
@@ -331,9 +340,269 @@ LIB_TREE_NODE_LIB& LIB_TREE_NODE_ROOT::AddLib( wxString const& aName, wxString c
 }
 
 
+LIB_TREE_NODE_LIB& LIB_TREE_NODE_ROOT::AddLib( std::unique_ptr<LIB_TREE_NODE_LIB> aLib )
+{
+    wxASSERT( aLib->m_Parent == this );
+
+    LIB_TREE_NODE_LIB* lib = aLib.release();
+    m_Children.push_back( std::unique_ptr<LIB_TREE_NODE>( lib ) );
+    return *lib;
+}
+
+
 void LIB_TREE_NODE_ROOT::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 {
     for( auto& child: m_Children )
         child->UpdateScore( aMatcher );
 }
 
+
+
+// Append the trigrams of aText to aTrigrams, each packed with 21 bits per character.
+static void addTrigrams( const wxString& aText, std::vector<uint64_t>& aTrigrams )
+{
+    const uint64_t mask = ( uint64_t( 1 ) << 63 ) - 1;
+    uint64_t       trigram = 0;
+    int            count = 0;
+
+    for( wxUniChar c : aText )
+    {
+        trigram = ( ( trigram << 21 ) | ( c.GetValue() & 0x1FFFFF ) ) & mask;
+
+        if( ++count >= 3 )
+            aTrigrams.push_back( trigram );
+    }
+}
+
+
+void LIB_TREE_NODE_ROOT::UpdateScores( const std::vector<wxString>& aTerms )
+{
+    if( aTerms.empty() )
+        return;
+
+    if( !isIndexValid() )
+        indexItems();
+
+    // Indices of the items still in the game.
+    std::vector<uint32_t> candidates;
+
+    if( narrowsLastSearch( aTerms ) )
+    {
+        std::vector<bool> matched( m_items.size(), false );
+
+        for( uint32_t ii : m_lastMatches )
+            matched[ii] = true;
+
+        for( size_t ii = 0; ii < m_items.size(); ++ii )
+        {
+            if( !matched[ii] )
+                m_items[ii]->m_Score = 0;
+        }
+
+        candidates = m_lastMatches;
+    }
+    else
+    {
+        candidates.resize( m_items.size() );
+        std::iota( candidates.begin(), candidates.end(), 0 );
+    }
+
+    for( const wxString& term : aTerms )
+    {
+        EDA_COMBINED_MATCHER  matcher( term );
+        std::vector<uint32_t> matches;
+
+        if( matcher.IsLiteral() && term.length() >= 3 )
+        {
+            if( !m_trigramsIndexed )
+                indexTrigrams();
+
+            // Items which contain the term, or whose library name does, are scored.  The
+            // others are out of the game.
+            std::vector<uint32_t>               found = findTrigrams( term );
+            std::unordered_set<LIB_TREE_NODE*>  matchingLibs;
+            std::vector<uint32_t>::iterator     next = found.begin();
+
+            for( std::unique_ptr<LIB_TREE_NODE>& lib : m_Children )
+            {
+                if( lib->m_MatchName.Find( term ) != wxNOT_FOUND )
+                    matchingLibs.insert( lib.get() );
+            }
+
+            for( uint32_t ii : candidates )
+            {
+                LIB_TREE_NODE* item = m_items[ii];
+
+                while( next != found.end() && *next < ii )
+                    ++next;
+
+                if( ( next != found.end() && *next == ii ) || matchingLibs.count( item->m_Parent ) )
+                    item->UpdateScore( matcher );
+                else
+                    item->m_Score = 0;
+
+                if( item->m_Score > 0 )
+                    matches.push_back( ii );
+            }
+        }
+        else
+        {
+            for( uint32_t ii : candidates )
+            {
+                m_items[ii]->UpdateScore( matcher );
+
+                if( m_items[ii]->m_Score > 0 )
+                    matches.push_back( ii );
+            }
+        }
+
+        candidates = std::move( matches );
+
+        // Libraries without items are scored on their own name, see LIB_TREE_NODE_LIB.
+        for( std::unique_ptr<LIB_TREE_NODE>& lib : m_Children )
+        {
+            if( lib->m_Children.empty() )
+                lib->UpdateScore( matcher );
+        }
+    }
+
+    for( std::unique_ptr<LIB_TREE_NODE>& lib : m_Children )
+    {
+        if( lib->m_Children.empty() )
+            continue;
+
+        lib->m_Score = 0;
+
+        for( std::unique_ptr<LIB_TREE_NODE>& item : lib->m_Children )
+            lib->m_Score = std::max( lib->m_Score, item->m_Score );
+    }
+
+    m_lastTerms = aTerms;
+    m_lastMatches = std::move( candidates );
+}
+
+
+bool LIB_TREE_NODE_ROOT::isIndexValid() const
+{
+    // The items are reordered by each search, so only check that they are the same.  New
+    // and updated items are not normalized yet.
+    size_t count = 0;
+
+    for( const std::unique_ptr<LIB_TREE_NODE>& lib : m_Children )
+    {
+        for( const std::unique_ptr<LIB_TREE_NODE>& item : lib->m_Children )
+        {
+            if( !item->m_Normalized || !m_itemSet.count( item.get() ) )
+                return false;
+
+            ++count;
+        }
+    }
+
+    return count == m_items.size();
+}
+
+
+void LIB_TREE_NODE_ROOT::indexItems()
+{
+    m_items.clear();
+    m_itemSet.clear();
+    m_trigrams.clear();
+    m_trigramsIndexed = false;
+    m_lastTerms.clear();
+    m_lastMatches.clear();
+
+    for( std::unique_ptr<LIB_TREE_NODE>& lib : m_Children )
+    {
+        for( std::unique_ptr<LIB_TREE_NODE>& item : lib->m_Children )
+        {
+            item->Normalize();
+            m_items.push_back( item.get() );
+            m_itemSet.insert( item.get() );
+        }
+    }
+}
+
+
+void LIB_TREE_NODE_ROOT::indexTrigrams()
+{
+    std::vector<uint64_t> trigrams;
+
+    for( uint32_t ii = 0; ii < m_items.size(); ++ii )
+    {
+        trigrams.clear();
+        addTrigrams( m_items[ii]->m_MatchName, trigrams );
+        addTrigrams( m_items[ii]->m_SearchText, trigrams );
+
+        std::sort( trigrams.begin(), trigrams.end() );
+        trigrams.erase( std::unique( trigrams.begin(), trigrams.end() ), trigrams.end() );
+
+        for( uint64_t trigram : trigrams )
+            m_trigrams[trigram].push_back( ii );
+    }
+
+    m_trigramsIndexed = true;
+}
+
+
+std::vector<uint32_t> LIB_TREE_NODE_ROOT::findTrigrams( const wxString& aTerm ) const
+{
+    std::vector<uint64_t>                     trigrams;
+    std::vector<const std::vector<uint32_t>*> lists;
+
+    addTrigrams( aTerm, trigrams );
+
+    for( uint64_t trigram : trigrams )
+    {
+        auto it = m_trigrams.find( trigram );
+
+        if( it == m_trigrams.end() )
+            return {};
+
+        lists.push_back( &it->second );
+    }
+
+    if( lists.empty() )
+        return {};
+
+    // Intersect the shortest lists first.
+    std::sort( lists.begin(), lists.end(),
+               []( const std::vector<uint32_t>* a, const std::vector<uint32_t>* b )
+               {
+                   return a->size() < b->size();
+               } );
+
+    std::vector<uint32_t> result = *lists[0];
+    std::vector<uint32_t> common;
+
+    for( size_t ii = 1; ii < lists.size() && !result.empty(); ++ii )
+    {
+        common.clear();
+        std::set_intersection( result.begin(), result.end(), lists[ii]->begin(),
+                               lists[ii]->end(), std::back_inserter( common ) );
+        result.swap( common );
+    }
+
+    return result;
+}
+
+
+bool LIB_TREE_NODE_ROOT::narrowsLastSearch( const std::vector<wxString>& aTerms ) const
+{
+    if( m_lastTerms.empty() || aTerms.size() < m_lastTerms.size() )
+        return false;
+
+    // An item which did not match a literal term cannot match a longer one containing it,
+    // but anything goes with the other kinds of patterns.
+    for( size_t ii = 0; ii < m_lastTerms.size(); ++ii )
+    {
+        if( !EDA_COMBINED_MATCHER::IsLiteralPattern( m_lastTerms[ii] )
+                || !EDA_COMBINED_MATCHER::IsLiteralPattern( aTerms[ii] )
+                || aTerms[ii].Find( m_lastTerms[ii] ) == wxNOT_FOUND )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -22,6 +22,9 @@
 #ifndef LIB_TREE_MODEL_H
 #define LIB_TREE_MODEL_H
 
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <memory>
 #include <wx/string.h>
@@ -119,6 +122,11 @@ public:
      */
     void ResetScore();
 
+    /**
+     * Convert m_MatchName and m_SearchText to lower case for matching, unless done already.
+     */
+    void Normalize();
+
     /**
      * Store intrinsic ranks on all children of this node. See m_IntrinsicRank
      * member doc for more information.
@@ -281,7 +289,65 @@ public:
      */
     LIB_TREE_NODE_LIB& AddLib( wxString const& aName, wxString const& aDesc );
 
+    /**
+     * Add a library node built separately, e.g. by a worker thread, and return it.  The
+     * node must have been constructed with this root as its parent.
+     */
+    LIB_TREE_NODE_LIB& AddLib( std::unique_ptr<LIB_TREE_NODE_LIB> aLib );
+
     virtual void UpdateScore( EDA_COMBINED_MATCHER& aMatcher ) override;
+
+    /**
+     * Update the scores of the tree for all the terms of a search.  The scores are the same
+     * as calling UpdateScore() for each term, but:
+     *
+     * - literal terms (see EDA_COMBINED_MATCHER::IsLiteral()) of three characters or more
+     *   are looked up in a trigram index of the items, so only the items which can match
+     *   them are scored;
+     * - if each term extends the corresponding one of the previous search, as happens while
+     *   the user types, only the items which matched the previous search are scored.
+     *
+     * The index is built on the first search after the tree changed.
+     *
+     * @param aTerms are the search terms, in lower case.
+     */
+    void UpdateScores( const std::vector<wxString>& aTerms );
+
+private:
+    /**
+     * Check that m_items still holds the items of the tree and none of them changed.
+     */
+    bool isIndexValid() const;
+
+    /// Collect the items of the tree, and forget the trigrams and the previous search.
+    void indexItems();
+
+    /// Index the trigrams of the items.
+    void indexTrigrams();
+
+    /**
+     * Return the sorted indices in m_items of the items whose name or search text contain
+     * all the trigrams of \a aTerm.
+     */
+    std::vector<uint32_t> findTrigrams( const wxString& aTerm ) const;
+
+    /**
+     * Return true if \a aTerms can only match items which matched m_lastTerms.
+     */
+    bool narrowsLastSearch( const std::vector<wxString>& aTerms ) const;
+
+    /// The children of the libraries, which are the items scored by the search.
+    std::vector<LIB_TREE_NODE*>                         m_items;
+    std::unordered_set<const LIB_TREE_NODE*>            m_itemSet;
+
+    /// Indices in m_items of the items containing each trigram, in increasing order.
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_trigrams;
+    bool                                                m_trigramsIndexed;
+
+    std::vector<wxString>                               m_lastTerms;
+
+    /// Indices in m_items of the items matching m_lastTerms, in increasing order.
+    std::vector<uint32_t>                               m_lastMatches;
 };
 
 
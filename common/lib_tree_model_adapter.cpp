@@ -163,7 +163,14 @@ void LIB_TREE_MODEL_ADAPTER::SetPreselectNode( LIB_ID const& aLibId, int aUnit )
 LIB_TREE_NODE_LIB& LIB_TREE_MODEL_ADAPTER::DoAddLibraryNode( wxString const& aNodeName,
                                                              wxString const& aDesc )
 {
-    LIB_TREE_NODE_LIB& lib_node = m_tree.AddLib( aNodeName, aDesc );
+    return DoAddLibraryNode( std::make_unique<LIB_TREE_NODE_LIB>( &m_tree, aNodeName, aDesc ) );
+}
+
+
+LIB_TREE_NODE_LIB& LIB_TREE_MODEL_ADAPTER::DoAddLibraryNode(
+        std::unique_ptr<LIB_TREE_NODE_LIB> aLibNode )
+{
+    LIB_TREE_NODE_LIB& lib_node = m_tree.AddLib( std::move( aLibNode ) );
 
     lib_node.m_Pinned = m_pinnedLibs.Index( lib_node.m_LibId.GetLibNickname() ) != wxNOT_FOUND;
 
@@ -194,15 +201,13 @@ void LIB_TREE_MODEL_ADAPTER::UpdateSearchString( wxString const& aSearch )
             child->m_Score *= 2;
     }
 
-    wxStringTokenizer tokenizer( aSearch );
+    std::vector<wxString> terms;
+    wxStringTokenizer     tokenizer( aSearch );
 
     while( tokenizer.HasMoreTokens() )
-    {
-        const wxString term = tokenizer.GetNextToken().Lower();
-        EDA_COMBINED_MATCHER matcher( term );
+        terms.push_back( tokenizer.GetNextToken().Lower() );
 
-        m_tree.UpdateScore( matcher );
-    }
+    m_tree.UpdateScores( terms );
 
     m_tree.SortNodes();
 
@@ -286,6 +286,11 @@ protected:
 
     LIB_TREE_NODE_LIB& DoAddLibraryNode( wxString const& aNodeName, wxString const& aDesc );
 
+    /**
+     * Add a library node which was populated outside of the tree, e.g. by a worker thread.
+     */
+    LIB_TREE_NODE_LIB& DoAddLibraryNode( std::unique_ptr<LIB_TREE_NODE_LIB> aLibNode );
+
     /**
      * Check whether a container has columns too
      */
@@ -202,7 +202,7 @@ void WS_DRAW_ITEM_POLYPOLYGONS::PrintWsItem( RENDER_SETTINGS* aSettings, const w
     for( int idx = 0; idx < m_Polygons.OutlineCount(); ++idx )
     {
         points_moved.clear();
-        SHAPE_LINE_CHAIN& outline = m_Polygons.Outline( idx );
+        const SHAPE_LINE_CHAIN& outline = m_Polygons.COutline( idx );
 
         for( int ii = 0; ii < outline.PointCount(); ii++ )
         {
@@ -309,7 +309,7 @@ void KIGFX::WS_PAINTER::draw( const WS_DRAW_ITEM_POLYPOLYGONS* aItem, int aLayer
 
     for( int idx = 0; idx < item->GetPolygons().OutlineCount(); ++idx )
     {
-        SHAPE_LINE_CHAIN& outline = item->GetPolygons().Outline( idx );
+        const SHAPE_LINE_CHAIN& outline = item->GetPolygons().COutline( idx );
         m_gal->DrawPolygon( outline );
     }
 }
@@ -779,7 +779,7 @@ void DXF_PLOTTER::FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aSize
                                  aCornerRadius, 0.0, 0, GetPlotterArcHighDef() );
 
     // TransformRoundRectToPolygon creates only one convex polygon
-    SHAPE_LINE_CHAIN& poly = outline.Outline( 0 );
+    const SHAPE_LINE_CHAIN& poly = outline.COutline( 0 );
 
     MoveTo( wxPoint( poly.CPoint( 0 ).x, poly.CPoint( 0 ).y ) );
 
@@ -795,7 +795,7 @@ void DXF_PLOTTER::FlashPadCustom( const wxPoint& aPadPos, const wxSize& aSize,
 {
     for( int cnt = 0; cnt < aPolygons->OutlineCount(); ++cnt )
     {
-        SHAPE_LINE_CHAIN& poly = aPolygons->Outline( cnt );
+        const SHAPE_LINE_CHAIN& poly = aPolygons->COutline( cnt );
 
         MoveTo( wxPoint( poly.CPoint( 0 ).x, poly.CPoint( 0 ).y ) );
 
@@ -890,7 +890,7 @@ void GERBER_PLOTTER::FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aS
 
         std::vector< wxPoint > cornerList;
         // TransformRoundRectToPolygon creates only one convex polygon
-        SHAPE_LINE_CHAIN& poly = outline.Outline( 0 );
+        const SHAPE_LINE_CHAIN& poly = outline.COutline( 0 );
         cornerList.reserve( poly.PointCount() + 1 );
 
         for( int ii = 0; ii < poly.PointCount(); ++ii )
@@ -1069,7 +1069,7 @@ void GERBER_PLOTTER::FlashPadCustom( const wxPoint& aPadPos, const wxSize& aSize
 
     for( int cnt = 0; cnt < polyshape.OutlineCount(); ++cnt )
     {
-        SHAPE_LINE_CHAIN& poly = polyshape.Outline( cnt );
+        const SHAPE_LINE_CHAIN& poly = polyshape.COutline( cnt );
 
         cornerList.clear();
 
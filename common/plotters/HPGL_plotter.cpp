@@ -647,7 +647,7 @@ void HPGL_PLOTTER::FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aSiz
 
     // TransformRoundRectToPolygon creates only one convex polygon
     std::vector<wxPoint> cornerList;
-    SHAPE_LINE_CHAIN&    poly = outline.Outline( 0 );
+    const SHAPE_LINE_CHAIN& poly = outline.COutline( 0 );
     cornerList.reserve( poly.PointCount() );
 
     for( int ii = 0; ii < poly.PointCount(); ++ii )
@@ -667,7 +667,7 @@ void HPGL_PLOTTER::FlashPadCustom( const wxPoint& aPadPos, const wxSize& aSize,
 
     for( int cnt = 0; cnt < aPolygons->OutlineCount(); ++cnt )
     {
-        SHAPE_LINE_CHAIN& poly = aPolygons->Outline( cnt );
+        const SHAPE_LINE_CHAIN& poly = aPolygons->COutline( cnt );
 
         cornerList.clear();
         cornerList.reserve( poly.PointCount() );
@@ -131,7 +131,7 @@ void PlotWorkSheet( PLOTTER* plotter, const PROJECT* aProject, const TITLE_BLOCK
                 for( int idx = 0; idx < poly->GetPolygons().OutlineCount(); ++idx )
                 {
                     points.clear();
-                    SHAPE_LINE_CHAIN& outline = poly->GetPolygons().Outline( idx );
+                    const SHAPE_LINE_CHAIN& outline = poly->GetPolygons().COutline( idx );
 
                     for( int ii = 0; ii < outline.PointCount(); ii++ )
                         points.emplace_back( outline.CPoint( ii ).x, outline.CPoint( ii ).y );
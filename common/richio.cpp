@@ -28,6 +28,16 @@
 
 #include <richio.h>
 
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN 1
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 // Fall back to getc() when getc_unlocked() is not available on the target platform.
 #if !defined( HAVE_FGETC_NOLOCK )
@@ -225,6 +235,157 @@ char* FILE_LINE_READER::ReadLine()
 }
 
 
+MAPPED_FILE_LINE_READER::MAPPED_FILE_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber, unsigned aMaxLineLength ):
+    LINE_READER( aMaxLineLength ), m_data( "" ), m_size( 0 ), m_ndx( 0 ), m_mapped( false )
+{
+    m_source  = aFileName;
+    m_lineNum = aStartingLineNumber;
+
+    bool opened = false;
+
+#if defined( _WIN32 )
+    // Other programs may still write, rename or delete the file: Windows refuses to truncate
+    // a file while it is mapped, so the view stays valid
+    HANDLE file = CreateFileW( aFileName.wc_str(), GENERIC_READ,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                               OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+
+    if( file != INVALID_HANDLE_VALUE )
+    {
+        LARGE_INTEGER size;
+
+        opened = GetFileSizeEx( file, &size ) != 0;
+        m_size = opened ? (size_t) size.QuadPart : 0;
+
+        // Empty files cannot be mapped, and need not be
+        if( opened && m_size )
+        {
+            HANDLE mapping = CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+            void*  view = mapping ? MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) : NULL;
+
+            // The view keeps the mapping alive
+            if( mapping )
+                CloseHandle( mapping );
+
+            opened = view != NULL;
+
+            if( view )
+            {
+                m_data = (const char*) view;
+                m_mapped = true;
+            }
+        }
+
+        CloseHandle( file );
+    }
+#else
+    // Reading a mapping of a file which another program truncates raises SIGBUS, so the file
+    // is read in one go instead
+    int fd = open( aFileName.fn_str(), O_RDONLY );
+
+    if( fd >= 0 )
+    {
+        struct stat info;
+
+        opened = fstat( fd, &info ) == 0;
+        m_size = opened ? (size_t) info.st_size : 0;
+
+        if( opened && m_size )
+        {
+            m_contents.resize( m_size );
+
+            size_t done = 0;
+
+            while( done < m_size )
+            {
+                ssize_t count = read( fd, m_contents.data() + done, m_size - done );
+
+                if( count < 0 && errno == EINTR )
+                    continue;
+
+                if( count < 0 )
+                    opened = false;
+
+                // The file may have been truncated since fstat()
+                if( count <= 0 )
+                    break;
+
+                done += count;
+            }
+
+            m_size = done;
+            m_data = m_contents.data();
+        }
+
+        close( fd );
+    }
+#endif
+
+    if( !opened )
+    {
+        m_data = "";
+        m_size = 0;
+
+        wxString msg = wxString::Format(
+            _( "Unable to open filename \"%s\" for reading" ), aFileName.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+}
+
+
+MAPPED_FILE_LINE_READER::~MAPPED_FILE_LINE_READER()
+{
+#if defined( _WIN32 )
+    if( m_mapped )
+        UnmapViewOfFile( m_data );
+#endif
+}
+
+
+const char* MAPPED_FILE_LINE_READER::ReadLineInPlace( unsigned* aLength )
+{
+    const char* line = m_data + m_ndx;
+    const char* nl = (const char*) memchr( line, '\n', m_size - m_ndx );
+    size_t      length = nl ? nl - line + 1 : m_size - m_ndx;     // include the newline
+
+    if( length >= m_maxLineLength )
+        THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+    m_ndx += length;
+    *aLength = length;
+
+    // The line is not in the line buffer
+    m_length = 0;
+    m_line[0] = 0;
+
+    // m_lineNum is incremented even if there was no line read, because this
+    // leads to better error reporting when we hit an end of file.
+    ++m_lineNum;
+
+    return length ? line : NULL;
+}
+
+
+char* MAPPED_FILE_LINE_READER::ReadLine()
+{
+    unsigned    length;
+    const char* line = ReadLineInPlace( &length );
+
+    if( length+1 > m_capacity )   // +1 for terminating nul
+        expandCapacity( length+1 );
+
+    m_length = length;
+
+    if( line )
+        memcpy( m_line, line, length );
+
+    m_line[m_length] = 0;
+
+    return m_length ? m_line : NULL;
+}
+
+
 STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource ):
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     m_lines( aString ), m_ndx( 0 )
@@ -31,6 +31,11 @@
 #include <richio.h>                        // StrPrintf
 #include <kicad_string.h>
 
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+
 
 /**
  * Illegal file name characters used to insure file names will be valid on all supported
@@ -385,6 +390,239 @@ wxString DateAndTime()
 }
 
 
+/**
+ * Powers of ten which are exactly representable as doubles
+ */
+static const double s_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const int      s_maxPow10 = 22;
+static const uint64_t s_maxExactInt = uint64_t( 1 ) << 53;  // larger integers may be rounded
+
+
+/**
+ * Convert the number text [aStart, aEnd) with strtod(), replacing the decimal point by the
+ * one of the current locale.  Only used for numbers which cannot be converted exactly by
+ * StrToDouble() itself.
+ */
+static double localeStrToDouble( const char* aStart, const char* aEnd )
+{
+    std::string  text( aStart, aEnd );
+    const char*  point = localeconv()->decimal_point;
+
+    if( point && *point && *point != '.' )
+        std::replace( text.begin(), text.end(), '.', *point );
+
+    return strtod( text.c_str(), nullptr );
+}
+
+
+double StrToDouble( const char* aText, const char** aEnd )
+{
+    const char* cur = aText;
+
+    while( *cur == ' ' || *cur == '\t' || *cur == '\n' || *cur == '\r' || *cur == '\f'
+           || *cur == '\v' )
+        ++cur;
+
+    const char* start = cur;
+    bool        negative = false;
+
+    if( *cur == '+' || *cur == '-' )
+        negative = *cur++ == '-';
+
+    uint64_t mantissa = 0;
+    int      digits = 0;        // significant digits in mantissa
+    int      exponent = 0;      // power of ten to apply to mantissa
+    bool     isExact = true;    // false if digits had to be dropped from mantissa
+    bool     anyDigit = false;
+
+    auto addDigit = [&]( int aDigit, bool aFraction )
+                    {
+                        anyDigit = true;
+
+                        if( digits < 19 )
+                        {
+                            mantissa = mantissa * 10 + aDigit;
+
+                            if( mantissa )
+                                ++digits;
+
+                            if( aFraction )
+                                --exponent;
+                        }
+                        else
+                        {
+                            if( aDigit )
+                                isExact = false;
+
+                            if( !aFraction )
+                                ++exponent;
+                        }
+                    };
+
+    for( ; *cur >= '0' && *cur <= '9'; ++cur )
+        addDigit( *cur - '0', false );
+
+    if( *cur == '.' )
+    {
+        for( ++cur; *cur >= '0' && *cur <= '9'; ++cur )
+            addDigit( *cur - '0', true );
+    }
+
+    if( !anyDigit )
+    {
+        if( aEnd )
+            *aEnd = aText;
+
+        return 0.0;
+    }
+
+    if( *cur == 'e' || *cur == 'E' )
+    {
+        const char* exp = cur + 1;
+        bool        negativeExp = false;
+        int         expValue = 0;
+
+        if( *exp == '+' || *exp == '-' )
+            negativeExp = *exp++ == '-';
+
+        if( *exp >= '0' && *exp <= '9' )
+        {
+            for( ; *exp >= '0' && *exp <= '9'; ++exp )
+            {
+                if( expValue < 100000 )
+                    expValue = expValue * 10 + ( *exp - '0' );
+            }
+
+            exponent += negativeExp ? -expValue : expValue;
+            cur = exp;
+        }
+    }
+
+    if( aEnd )
+        *aEnd = cur;
+
+    double value;
+
+    // With both the mantissa and the power of ten exact, a single multiplication or
+    // division is correctly rounded, which is all strtod() guarantees as well.
+    if( mantissa == 0 )
+        value = 0.0;
+    else if( isExact && mantissa <= s_maxExactInt && exponent >= 0 && exponent <= s_maxPow10 )
+        value = (double) mantissa * s_pow10[exponent];
+    else if( isExact && mantissa <= s_maxExactInt && exponent < 0 && exponent >= -s_maxPow10 )
+        value = (double) mantissa / s_pow10[-exponent];
+    else
+        return localeStrToDouble( start, cur );
+
+    return negative ? -value : value;
+}
+
+
+/**
+ * Print the decimal digits aDigits, with the decimal point after the first aIntDigits of
+ * them, in plain notation and without trailing zeros.
+ */
+static std::string formatDigits( bool aNegative, const std::string& aDigits, int aIntDigits )
+{
+    std::string result;
+    int         count = (int) aDigits.size();
+
+    while( count > std::max( aIntDigits, 0 ) && aDigits[count - 1] == '0' )
+        --count;
+
+    if( aNegative )
+        result += '-';
+
+    if( aIntDigits <= 0 )
+    {
+        result += "0";
+
+        if( count > 0 )
+        {
+            result += '.';
+            result.append( -aIntDigits, '0' );
+            result.append( aDigits, 0, count );
+        }
+    }
+    else if( aIntDigits >= count )
+    {
+        result.append( aDigits, 0, count );
+        result.append( aIntDigits - count, '0' );
+    }
+    else
+    {
+        result.append( aDigits, 0, aIntDigits );
+        result += '.';
+        result.append( aDigits, aIntDigits, count - aIntDigits );
+    }
+
+    return result;
+}
+
+
+std::string FormatDouble( double aValue, int aMaxDigits )
+{
+    if( aValue == 0.0 )
+        return "0";
+
+    if( !std::isfinite( aValue ) )
+        return aValue != aValue ? "nan" : aValue < 0 ? "-inf" : "inf";
+
+    bool   negative = aValue < 0;
+    double value = std::fabs( aValue );
+
+    aMaxDigits = std::min( std::max( aMaxDigits, 1 ), 17 );
+
+    // Try the decimal places one by one while the scaled value is an exact integer: the
+    // division by an exact power of ten reads back the same as StrToDouble() would.
+    for( int places = 0; places <= s_maxPow10; ++places )
+    {
+        double scaled = value * s_pow10[places];
+
+        if( scaled >= (double) s_maxExactInt )
+            break;
+
+        uint64_t    mantissa = (uint64_t) std::llround( scaled );
+        std::string digits = mantissa ? std::to_string( mantissa ) : std::string();
+
+        if( mantissa && ( (double) mantissa / s_pow10[places] == value
+                          || (int) digits.size() >= aMaxDigits ) )
+        {
+            return formatDigits( negative, digits, (int) digits.size() - places );
+        }
+    }
+
+    // Very large, very small or very precise values: let printf() find the digits
+    std::string result;
+
+    for( int precision = 1; precision <= aMaxDigits; ++precision )
+    {
+        char        buf[64];
+        std::string digits;
+
+        snprintf( buf, sizeof( buf ), "%.*e", precision - 1, value );
+
+        const char* cur = buf;
+
+        for( ; *cur && *cur != 'e'; ++cur )
+        {
+            if( *cur >= '0' && *cur <= '9' )
+                digits += *cur;
+        }
+
+        result = formatDigits( negative, digits, atoi( cur + 1 ) + 1 );
+
+        if( std::fabs( StrToDouble( result.c_str() ) ) == value )
+            break;
+    }
+
+    return result;
+}
+
 int StrNumCmp( const wxString& aString1, const wxString& aString2, bool aIgnoreCase )
 {
     int nb1 = 0, nb2 = 0;
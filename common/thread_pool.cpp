@@ -0,0 +1,284 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <advanced_config.h>
+#include <thread_pool.h>
+
+
+// The pool (if any) the current thread is a worker of, and its index in that pool.
+static thread_local const THREAD_POOL* s_currentPool = nullptr;
+static thread_local size_t             s_workerIndex = 0;
+
+
+static size_t defaultThreadCount()
+{
+    size_t count = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
+    int    limit = ADVANCED_CFG::GetCfg().m_MaxWorkerThreads;
+
+    if( limit > 0 )
+        count = std::min<size_t>( count, limit );
+
+    return count;
+}
+
+
+THREAD_POOL& THREAD_POOL::GetInstance()
+{
+    // Deliberately never destroyed: joining the workers from static destructors (or while
+    // a kiface is being unloaded) is not safe on all platforms.
+    static THREAD_POOL* pool = new THREAD_POOL( defaultThreadCount() );
+
+    return *pool;
+}
+
+
+THREAD_POOL::THREAD_POOL( size_t aThreadCount ) :
+        m_pendingCount( 0 ),
+        m_shutdown( false )
+{
+    aThreadCount = std::max<size_t>( aThreadCount, 1 );
+
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        m_queues.push_back( std::make_unique<TASK_QUEUE>() );
+
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        m_workers.emplace_back( &THREAD_POOL::workerMain, this, ii );
+}
+
+
+THREAD_POOL::~THREAD_POOL()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_sleepMutex );
+        m_shutdown = true;
+    }
+
+    m_wakeUp.notify_all();
+
+    for( std::thread& worker : m_workers )
+        worker.join();
+}
+
+
+bool THREAD_POOL::IsWorkerThread() const
+{
+    return s_currentPool == this;
+}
+
+
+void THREAD_POOL::Submit( TASK aTask )
+{
+    TASK_QUEUE& queue = IsWorkerThread() ? *m_queues[s_workerIndex] : m_injectQueue;
+
+    {
+        // The count is raised before the task becomes visible so that popTask() can never
+        // take it below zero.
+        std::lock_guard<std::mutex> sleepLock( m_sleepMutex );
+        ++m_pendingCount;
+
+        std::lock_guard<std::mutex> queueLock( queue.m_mutex );
+        queue.m_tasks.push_back( std::move( aTask ) );
+    }
+
+    m_wakeUp.notify_one();
+}
+
+
+bool THREAD_POOL::RunPendingTask()
+{
+    TASK task;
+
+    if( !popTask( task ) )
+        return false;
+
+    task();
+    return true;
+}
+
+
+bool THREAD_POOL::popTask( TASK& aTask )
+{
+    size_t count = m_queues.size();
+    size_t first = 0;
+
+    // Newest task from our own deque first: it is the most likely to still be in cache.
+    if( IsWorkerThread() )
+    {
+        TASK_QUEUE&                 own = *m_queues[s_workerIndex];
+        std::lock_guard<std::mutex> lock( own.m_mutex );
+
+        if( !own.m_tasks.empty() )
+        {
+            aTask = std::move( own.m_tasks.back() );
+            own.m_tasks.pop_back();
+            --m_pendingCount;
+            return true;
+        }
+
+        first = s_workerIndex + 1;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( m_injectQueue.m_mutex );
+
+        if( !m_injectQueue.m_tasks.empty() )
+        {
+            aTask = std::move( m_injectQueue.m_tasks.front() );
+            m_injectQueue.m_tasks.pop_front();
+            --m_pendingCount;
+            return true;
+        }
+    }
+
+    // Steal the oldest task of another worker; these are usually the largest.
+    for( size_t ii = 0; ii < count; ++ii )
+    {
+        TASK_QUEUE&                 victim = *m_queues[( first + ii ) % count];
+        std::lock_guard<std::mutex> lock( victim.m_mutex );
+
+        if( !victim.m_tasks.empty() )
+        {
+            aTask = std::move( victim.m_tasks.front() );
+            victim.m_tasks.pop_front();
+            --m_pendingCount;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void THREAD_POOL::workerMain( size_t aIndex )
+{
+    s_currentPool = this;
+    s_workerIndex = aIndex;
+
+    while( true )
+    {
+        TASK task;
+
+        if( popTask( task ) )
+        {
+            // Tasks which need error reporting are run through a TASK_GROUP; never let an
+            // exception take down the worker.
+            try
+            {
+                task();
+            }
+            catch( ... )
+            {
+            }
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock( m_sleepMutex );
+        m_wakeUp.wait( lock, [&]() { return m_shutdown || m_pendingCount > 0; } );
+
+        if( m_shutdown && m_pendingCount == 0 )
+            return;
+    }
+}
+
+
+TASK_GROUP::TASK_GROUP( THREAD_POOL& aPool ) :
+        m_pool( aPool ),
+        m_outstanding( 0 )
+{
+}
+
+
+TASK_GROUP::~TASK_GROUP()
+{
+    waitAll();
+}
+
+
+void TASK_GROUP::Run( THREAD_POOL::TASK aTask )
+{
+    ++m_outstanding;
+
+    m_pool.Submit( [this, task = std::move( aTask )]()
+                   {
+                       try
+                       {
+                           task();
+                       }
+                       catch( ... )
+                       {
+                           std::lock_guard<std::mutex> lock( m_mutex );
+
+                           if( !m_exception )
+                               m_exception = std::current_exception();
+                       }
+
+                       taskDone();
+                   } );
+}
+
+
+void TASK_GROUP::taskDone()
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    if( --m_outstanding == 0 )
+        m_done.notify_all();
+}
+
+
+void TASK_GROUP::waitAll()
+{
+    while( !IsDone() )
+    {
+        if( !m_pool.RunPendingTask() )
+        {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            m_done.wait_for( lock, std::chrono::milliseconds( 1 ), [&]() { return IsDone(); } );
+        }
+    }
+
+    // Synchronize with the last taskDone() before our owner is allowed to destroy us.
+    std::lock_guard<std::mutex> lock( m_mutex );
+}
+
+
+void TASK_GROUP::Wait()
+{
+    waitAll();
+
+    std::exception_ptr exception;
+
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        std::swap( exception, m_exception );
+    }
+
+    if( exception )
+        std::rethrow_exception( exception );
+}
+
+
+bool TASK_GROUP::WaitFor( std::chrono::milliseconds aTimeout )
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    return m_done.wait_for( lock, aTimeout, [&]() { return IsDone(); } );
+}
@@ -25,8 +25,108 @@
 
 #include <fctsys.h>
 #include <base_struct.h>
+#include <ki_exception.h>
 #include <undo_redo_container.h>
 
+#include <algorithm>
+
+#include <wx/filename.h>
+#include <wx/mstream.h>
+#include <wx/zstream.h>
+
+
+static std::string compressUndoData( const std::string& aData )
+{
+    wxMemoryOutputStream memStream;
+
+    {
+        wxZlibOutputStream zStream( memStream, wxZ_BEST_SPEED, wxZLIB_NO_HEADER );
+        zStream.Write( aData.data(), aData.size() );
+    }
+
+    std::string compressed( memStream.GetLength(), '\0' );
+    memStream.CopyTo( &compressed[0], compressed.size() );
+
+    return compressed;
+}
+
+
+static std::string decompressUndoData( const std::string& aData )
+{
+    wxMemoryInputStream memStream( aData.data(), aData.size() );
+    wxZlibInputStream   zStream( memStream, wxZLIB_NO_HEADER );
+    std::string         data;
+    char                buffer[16384];
+
+    do
+    {
+        zStream.Read( buffer, sizeof( buffer ) );
+        data.append( buffer, zStream.LastRead() );
+    } while( zStream.LastRead() > 0 );
+
+    if( zStream.GetLastError() != wxSTREAM_EOF )
+        THROW_IO_ERROR( _( "Corrupted undo data" ) );
+
+    return data;
+}
+
+
+UNDO_JOURNAL::UNDO_JOURNAL() :
+        m_usedSize( 0 )
+{
+    m_fileName = wxFileName::CreateTempFileName( "kicad_undo" );
+
+    if( !m_fileName.IsEmpty() )
+        m_file.Open( m_fileName, "w+b" );
+}
+
+
+UNDO_JOURNAL::~UNDO_JOURNAL()
+{
+    m_file.Close();
+
+    if( !m_fileName.IsEmpty() )
+        wxRemoveFile( m_fileName );
+}
+
+
+wxFileOffset UNDO_JOURNAL::Write( const std::string& aData )
+{
+    if( !m_file.IsOpened() || !m_file.SeekEnd() )
+        return -1;
+
+    wxFileOffset offset = m_file.Tell();
+
+    if( offset < 0 || m_file.Write( aData.data(), aData.size() ) != aData.size() )
+        return -1;
+
+    m_usedSize += aData.size();
+    return offset;
+}
+
+
+bool UNDO_JOURNAL::Read( wxFileOffset aOffset, size_t aSize, std::string& aData )
+{
+    aData.resize( aSize );
+
+    return m_file.IsOpened() && m_file.Seek( aOffset )
+           && m_file.Read( &aData[0], aSize ) == aSize;
+}
+
+
+void UNDO_JOURNAL::Release( size_t aSize )
+{
+    wxASSERT( aSize <= m_usedSize );
+    m_usedSize -= std::min( aSize, m_usedSize );
+
+    // Start over with an empty file once nothing in it is needed anymore
+    if( m_usedSize == 0 && m_file.IsOpened() && m_file.Length() > 0 )
+    {
+        m_file.Close();
+        m_file.Open( m_fileName, "w+b" );
+    }
+}
+
 
 ITEM_PICKER::ITEM_PICKER( EDA_ITEM* aItem, UNDO_REDO_T aUndoRedoStatus )
 {
@@ -40,10 +140,17 @@ ITEM_PICKER::ITEM_PICKER( EDA_ITEM* aItem, UNDO_REDO_T aUndoRedoStatus )
 PICKED_ITEMS_LIST::PICKED_ITEMS_LIST()
 {
     m_Status = UR_UNSPECIFIED;
+    m_isPacked = false;
+    m_journal = nullptr;
 }
 
 PICKED_ITEMS_LIST::~PICKED_ITEMS_LIST()
 {
+    for( const PACKED_PICKER& packed : m_packedPickers )
+    {
+        if( packed.m_Offset >= 0 )
+            m_journal->Release( packed.m_Size );
+    }
 }
 
 
@@ -103,8 +210,10 @@ void PICKED_ITEMS_LIST::ClearListAndDeleteItems()
     while( GetCount() > 0 )
     {
         ITEM_PICKER wrapper = PopItem();
-        if( wrapper.GetItem() == NULL ) // No more item in list.
-            break;
+
+        // The item of a packed picker may have been released until the list is unpacked
+        if( wrapper.GetItem() == NULL )
+            continue;
 
         // The Link is an undo construct; it is always owned by the undo/redo container
         if( wrapper.GetLink() )
@@ -261,6 +370,104 @@ void PICKED_ITEMS_LIST::ReversePickersListOrder()
 }
 
 
+void PICKED_ITEMS_LIST::Pack( UNDO_ITEM_PACKER& aPacker )
+{
+    if( m_isPacked )
+        return;
+
+    std::string data;
+
+    for( unsigned ii = 0; ii < m_ItemsList.size(); ii++ )
+    {
+        data.clear();
+
+        if( !aPacker.Pack( m_ItemsList[ii], data ) )
+            continue;
+
+        PACKED_PICKER packed;
+        packed.m_Index = ii;
+        packed.m_Data = compressUndoData( data );
+        packed.m_Offset = -1;
+        packed.m_Size = packed.m_Data.size();
+
+        m_packedPickers.push_back( std::move( packed ) );
+    }
+
+    m_isPacked = true;
+}
+
+
+void PICKED_ITEMS_LIST::Unpack( UNDO_ITEM_PACKER& aPacker )
+{
+    if( !m_isPacked )
+        return;
+
+    std::vector<unsigned> failed;
+
+    for( PACKED_PICKER& packed : m_packedPickers )
+    {
+        try
+        {
+            if( packed.m_Offset >= 0 )
+            {
+                if( !m_journal->Read( packed.m_Offset, packed.m_Size, packed.m_Data ) )
+                    THROW_IO_ERROR( _( "Cannot read undo data from the journal file" ) );
+
+                m_journal->Release( packed.m_Size );
+                packed.m_Offset = -1;
+            }
+
+            aPacker.Unpack( m_ItemsList[packed.m_Index], decompressUndoData( packed.m_Data ) );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            wxLogError( ioe.What() );
+            failed.push_back( packed.m_Index );
+        }
+    }
+
+    m_packedPickers.clear();
+    m_isPacked = false;
+
+    // Remove the pickers which lost their copy, from the last one so the indices stay valid
+    for( auto it = failed.rbegin(); it != failed.rend(); ++it )
+        RemovePicker( *it );
+}
+
+
+size_t PICKED_ITEMS_LIST::GetPackedMemory() const
+{
+    size_t size = 0;
+
+    for( const PACKED_PICKER& packed : m_packedPickers )
+        size += packed.m_Data.size();
+
+    return size;
+}
+
+
+void PICKED_ITEMS_LIST::MoveToJournal( UNDO_JOURNAL& aJournal )
+{
+    wxASSERT( !m_journal || m_journal == &aJournal );
+
+    for( PACKED_PICKER& packed : m_packedPickers )
+    {
+        if( packed.m_Offset >= 0 )
+            continue;
+
+        wxFileOffset offset = aJournal.Write( packed.m_Data );
+
+        // Keep the data in memory if the journal cannot be written
+        if( offset < 0 )
+            return;
+
+        m_journal = &aJournal;
+        packed.m_Offset = offset;
+        std::string().swap( packed.m_Data );
+    }
+}
+
+
 /**********************************************/
 /********** UNDO_REDO_CONTAINER ***************/
 /**********************************************/
@@ -24,8 +24,12 @@
  */
 
 
+#include <advanced_config.h>
 #include <base_struct.h>
 #include <layers_id_colors_and_visibility.h>
+#include <thread_pool.h>
+
+#include <algorithm>
 
 #include <view/view.h>
 #include <view/view_group.h>
@@ -53,6 +57,9 @@ public:
         m_flags( KIGFX::VISIBLE ),
         m_requiredUpdate( KIGFX::NONE ),
         m_drawPriority( 0 ),
+        m_updateView( nullptr ),
+        m_prevUpdate( nullptr ),
+        m_nextUpdate( nullptr ),
         m_groups( nullptr ),
         m_groupsSize( 0 ) {}
 
@@ -91,6 +98,10 @@ private:
     int     m_requiredUpdate;   ///< Flag required for updating
     int     m_drawPriority;     ///< Order to draw this item in a layer, lowest first
 
+    VIEW*      m_updateView;    ///< View whose update queue holds the item, if any
+    VIEW_ITEM* m_prevUpdate;    ///< Previous item in the update queue
+    VIEW_ITEM* m_nextUpdate;    ///< Next item in the update queue
+
     ///> Helper for storing cached items group ids
     typedef std::pair<int, int> GroupPair;
 
@@ -278,6 +289,8 @@ void VIEW::OnDestroy( VIEW_ITEM* aItem )
     if( data->m_view )
         data->m_view->VIEW::Remove( aItem );
 
+    dequeueUpdate( aItem );
+
     delete data;
     aItem->ClearViewPrivData();
 }
@@ -293,7 +306,9 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_dynamic( aIsDynamic ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
-    m_reverseDrawOrder( false )
+    m_reverseDrawOrder( false ),
+    m_updateQueueHead( nullptr ),
+    m_updateQueueTail( nullptr )
 {
     // Set m_boundary to define the max area size. The default area size
     // is defined here as the max value of a int.
@@ -325,6 +340,8 @@ VIEW::VIEW( bool aIsDynamic ) :
 
 VIEW::~VIEW()
 {
+    while( m_updateQueueHead )
+        dequeueUpdate( m_updateQueueHead );
 }
 
 
@@ -392,6 +409,8 @@ void VIEW::Remove( VIEW_ITEM* aItem )
         viewData->clearUpdateFlags();
     }
 
+    dequeueUpdate( aItem );
+
     int layers[VIEW::VIEW_MAX_LAYERS], layers_count;
     viewData->getLayers( layers, layers_count );
 
@@ -742,7 +761,7 @@ void VIEW::ReorderLayerData( std::unordered_map<int, int> aReorderMap )
 
         viewData->reorderGroups( aReorderMap );
 
-        viewData->m_requiredUpdate |= COLOR;
+        queueUpdate( item, COLOR );
     }
 
     UpdateItems();
@@ -1114,6 +1133,12 @@ void VIEW::Clear()
     r.SetMaximum();
     m_allItems->clear();
 
+    while( VIEW_ITEM* item = m_updateQueueHead )
+    {
+        dequeueUpdate( item );
+        item->viewPrivData()->clearUpdateFlags();
+    }
+
     for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
         i->second.items->RemoveAll();
 
@@ -1213,7 +1238,8 @@ void VIEW::clearGroupCache()
 }
 
 
-void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
+void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags,
+                           std::vector<LAYER_UPDATE>& aLayerUpdates )
 {
     if( aUpdateFlags & INITIAL_ADD )
     {
@@ -1237,24 +1263,68 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
     int layers[VIEW_MAX_LAYERS], layers_count;
     aItem->ViewGetLayers( layers, layers_count );
 
-    // Iterate through layers used by the item and recache it immediately
+    // Iterate through layers used by the item and queue the recaching
     for( int i = 0; i < layers_count; ++i )
     {
         int layerId = layers[i];
 
-        if( IsCached( layerId ) )
-        {
-            if( aUpdateFlags & ( GEOMETRY | LAYERS | REPAINT ) )
-                updateItemGeometry( aItem, layerId );
-            else if( aUpdateFlags & COLOR )
-                updateItemColor( aItem, layerId );
-        }
+        if( IsCached( layerId ) && ( aUpdateFlags & ( GEOMETRY | LAYERS | REPAINT | COLOR ) ) )
+            aLayerUpdates.push_back( { layerId, aItem, aUpdateFlags } );
 
         // Mark those layers as dirty, so the VIEW will be refreshed
         MarkTargetDirty( m_layers[layerId].target );
     }
+}
+
+
+void VIEW::queueUpdate( VIEW_ITEM* aItem, int aUpdateFlags )
+{
+    auto viewData = aItem->viewPrivData();
+
+    // Updating an item removed from this view, or belonging to another one, would put it
+    // back into the layers of this view
+    if( !viewData || viewData->m_view != this || aUpdateFlags == NONE )
+        return;
+
+    viewData->m_requiredUpdate |= aUpdateFlags;
+
+    if( viewData->m_updateView )
+        return;
+
+    viewData->m_updateView = this;
+    viewData->m_prevUpdate = m_updateQueueTail;
+    viewData->m_nextUpdate = nullptr;
+
+    if( m_updateQueueTail )
+        m_updateQueueTail->viewPrivData()->m_nextUpdate = aItem;
+    else
+        m_updateQueueHead = aItem;
+
+    m_updateQueueTail = aItem;
+}
+
+
+void VIEW::dequeueUpdate( VIEW_ITEM* aItem )
+{
+    auto  viewData = aItem->viewPrivData();
+    VIEW* view = viewData->m_updateView;
+
+    if( !view )
+        return;
 
-    aItem->viewPrivData()->clearUpdateFlags();
+    if( viewData->m_prevUpdate )
+        viewData->m_prevUpdate->viewPrivData()->m_nextUpdate = viewData->m_nextUpdate;
+    else
+        view->m_updateQueueHead = viewData->m_nextUpdate;
+
+    if( viewData->m_nextUpdate )
+        viewData->m_nextUpdate->viewPrivData()->m_prevUpdate = viewData->m_prevUpdate;
+    else
+        view->m_updateQueueTail = viewData->m_prevUpdate;
+
+    viewData->m_updateView = nullptr;
+    viewData->m_prevUpdate = nullptr;
+    viewData->m_nextUpdate = nullptr;
 }
 
 
@@ -1420,55 +1490,123 @@ void VIEW::RecacheAllItems()
 
 void VIEW::UpdateItems()
 {
-    if( m_gal->IsVisible() )
+    if( !m_gal->IsVisible() || !m_updateQueueHead )
+        return;
+
+    GAL_UPDATE_CONTEXT ctx( m_gal );
+
+    // Take the whole queue first; items queued while recaching are left for the next update
+    std::vector<std::pair<VIEW_ITEM*, int>> items;
+    std::vector<LAYER_UPDATE>               layerUpdates;
+
+    while( VIEW_ITEM* item = m_updateQueueHead )
     {
-        GAL_UPDATE_CONTEXT ctx( m_gal );
+        auto viewData = item->viewPrivData();
 
-        for( VIEW_ITEM* item : *m_allItems )
-        {
-            auto viewData = item->viewPrivData();
+        items.emplace_back( item, viewData->m_requiredUpdate );
+        dequeueUpdate( item );
+        viewData->clearUpdateFlags();
+    }
 
-            if( !viewData )
-                continue;
+    for( const std::pair<VIEW_ITEM*, int>& item : items )
+        invalidateItem( item.first, item.second, layerUpdates );
 
-            if( viewData->m_requiredUpdate != NONE )
-            {
-                invalidateItem( item, viewData->m_requiredUpdate );
-                viewData->m_requiredUpdate = NONE;
-            }
-        }
+    // Recache one layer at a time, so the GAL switches target and depth as little as possible
+    std::stable_sort( layerUpdates.begin(), layerUpdates.end(),
+                      []( const LAYER_UPDATE& aFirst, const LAYER_UPDATE& aSecond )
+                      {
+                          return aFirst.layer < aSecond.layer;
+                      } );
+
+    bool prepared = prepareItems( layerUpdates );
+
+    for( const LAYER_UPDATE& update : layerUpdates )
+    {
+        if( update.flags & ( GEOMETRY | LAYERS | REPAINT ) )
+            updateItemGeometry( update.item, update.layer );
+        else if( update.flags & COLOR )
+            updateItemColor( update.item, update.layer );
     }
+
+    if( prepared )
+        m_painter->ClearPrepared();
 }
 
 
-void VIEW::UpdateAllItems( int aUpdateFlags )
+bool VIEW::prepareItems( const std::vector<LAYER_UPDATE>& aLayerUpdates )
 {
-    for( VIEW_ITEM* item : *m_allItems )
-    {
-        auto viewData = item->viewPrivData();
+    // Below this, the tasks cost more than they save
+    const size_t minItems = 256;
+    const size_t itemsPerTask = 64;
 
-        if( !viewData )
+    if( !ADVANCED_CFG::GetCfg().m_ParallelRecache || aLayerUpdates.size() < minItems )
+        return false;
+
+    // All the layers of an item are prepared by the same task
+    std::vector<std::pair<VIEW_ITEM*, std::vector<int>>> items;
+    std::unordered_map<VIEW_ITEM*, size_t>               itemIndex;
+
+    for( const LAYER_UPDATE& update : aLayerUpdates )
+    {
+        if( !( update.flags & ( GEOMETRY | LAYERS | REPAINT ) ) )
             continue;
 
-        viewData->m_requiredUpdate |= aUpdateFlags;
+        auto it = itemIndex.emplace( update.item, items.size() );
+
+        if( it.second )
+            items.emplace_back( update.item, std::vector<int>() );
+
+        items[it.first->second].second.push_back( update.layer );
+    }
+
+    if( items.size() < minItems )
+        return false;
+
+    TASK_GROUP tasks;
+
+    for( size_t first = 0; first < items.size(); first += itemsPerTask )
+    {
+        size_t last = std::min( first + itemsPerTask, items.size() );
+
+        tasks.Run( [this, &items, first, last]()
+                   {
+                       for( size_t ii = first; ii < last; ++ii )
+                           m_painter->PrepareDraw( items[ii].first, items[ii].second );
+                   } );
+    }
+
+    try
+    {
+        tasks.Wait();
+    }
+    catch( ... )
+    {
+        // Draw the items the usual way rather than from a partial preparation
+        m_painter->ClearPrepared();
+        return false;
     }
+
+    return true;
 }
 
 
-void VIEW::UpdateAllItemsConditionally( int aUpdateFlags,
-                                        std::function<bool( VIEW_ITEM* )> aCondition )
+void VIEW::UpdateAllItems( int aUpdateFlags )
 {
     for( VIEW_ITEM* item : *m_allItems )
     {
-        if( aCondition( item ) )
-        {
-            auto viewData = item->viewPrivData();
+        if( item->viewPrivData() )
+            queueUpdate( item, aUpdateFlags );
+    }
+}
 
-            if( !viewData )
-                continue;
 
-            viewData->m_requiredUpdate |= aUpdateFlags;
-        }
+void VIEW::UpdateAllItemsConditionally( int aUpdateFlags,
+                                        std::function<bool( VIEW_ITEM* )> aCondition )
+{
+    for( VIEW_ITEM* item : *m_allItems )
+    {
+        if( item->viewPrivData() && aCondition( item ) )
+            queueUpdate( item, aUpdateFlags );
     }
 }
 
@@ -1541,13 +1679,12 @@ void VIEW::Update( VIEW_ITEM* aItem, int aUpdateFlags )
 {
     auto viewData = aItem->viewPrivData();
 
-    if( !viewData )
+    if( !viewData || viewData->m_view != this )
         return;
 
     assert( aUpdateFlags != NONE );
 
-    viewData->m_requiredUpdate |= aUpdateFlags;
-
+    queueUpdate( aItem, aUpdateFlags );
 }
 
 
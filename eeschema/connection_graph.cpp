@@ -19,9 +19,7 @@
  */
 
 #include <list>
-#include <thread>
 #include <algorithm>
-#include <future>
 #include <vector>
 #include <unordered_map>
 #include <profile.h>
@@ -42,6 +40,7 @@
 
 #include <advanced_config.h>
 #include <connection_graph.h>
+#include <thread_pool.h>
 #include <widgets/ui_common.h>
 
 bool CONNECTION_SUBGRAPH::ResolveDrivers( bool aCreateMarkers )
@@ -372,54 +371,115 @@ void CONNECTION_GRAPH::Reset()
     m_item_to_subgraph_map.clear();
     m_local_label_cache.clear();
     m_global_label_cache.clear();
+    m_link_key_index.clear();
+    m_sheet_list.clear();
+    m_bus_alias_signature.Empty();
     m_last_net_code = 1;
     m_last_bus_code = 1;
     m_last_subgraph_code = 1;
 }
 
 
+/**
+ * Returns a string describing all bus aliases of the given sheets, to detect alias changes
+ */
+static wxString busAliasSignature( const SCH_SHEET_LIST& aSheetList )
+{
+    std::vector<wxString> aliases;
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    {
+        for( const std::shared_ptr<BUS_ALIAS>& alias : sheet.LastScreen()->GetBusAliases() )
+        {
+            wxString desc = alias->GetName() + wxT( "{" );
+
+            for( const wxString& member : alias->Members() )
+                desc += member + wxT( " " );
+
+            aliases.push_back( desc + wxT( "}" ) );
+        }
+    }
+
+    std::sort( aliases.begin(), aliases.end() );
+
+    wxString signature;
+
+    for( const wxString& alias : aliases )
+        signature += alias;
+
+    return signature;
+}
+
+
 void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnconditional )
 {
     PROF_COUNTER recalc_time;
-    PROF_COUNTER update_items;
+    bool         incremental = false;
 
-    if( aUnconditional )
-        Reset();
+    if( !aUnconditional && ADVANCED_CFG::GetCfg().m_IncrementalConnectivity )
+    {
+        PROF_COUNTER update_incremental;
 
-    for( const SCH_SHEET_PATH& sheet : aSheetList )
+        incremental = updateIncremental( aSheetList );
+
+        update_incremental.Stop();
+        wxLogTrace( "CONN_PROFILE", "updateIncremental() %0.4f ms (%s)",
+                    update_incremental.msecs(), incremental ? "done" : "full rebuild needed" );
+    }
+
+    if( !incremental )
     {
-        std::vector<SCH_ITEM*> items;
+        PROF_COUNTER update_items;
+
+        Reset();
 
-        for( auto item : sheet.LastScreen()->Items() )
+        for( const SCH_SHEET_PATH& sheet : aSheetList )
         {
-            if( item->IsConnectable() && ( aUnconditional || item->IsConnectivityDirty() ) )
-                items.push_back( item );
+            std::vector<SCH_ITEM*> items;
+
+            for( auto item : sheet.LastScreen()->Items() )
+            {
+                if( item->IsConnectable() )
+                    items.push_back( item );
+            }
+
+            updateItemConnectivity( sheet, items );
+
+            // UpdateDanglingState() also adds connected items for SCH_TEXT
+            sheet.LastScreen()->TestDanglingEnds( &sheet );
         }
 
-        updateItemConnectivity( sheet, items );
+        update_items.Stop();
+        wxLogTrace( "CONN_PROFILE", "UpdateItemConnectivity() %0.4f ms", update_items.msecs() );
 
-        // UpdateDanglingState() also adds connected items for SCH_TEXT
-        sheet.LastScreen()->TestDanglingEnds( &sheet );
-    }
+        PROF_COUNTER build_graph;
 
-    update_items.Stop();
-    wxLogTrace( "CONN_PROFILE", "UpdateItemConnectivity() %0.4f ms", update_items.msecs() );
+        buildConnectionGraph();
 
-    PROF_COUNTER build_graph;
+        build_graph.Stop();
+        wxLogTrace( "CONN_PROFILE", "BuildConnectionGraph() %0.4f ms", build_graph.msecs() );
 
-    buildConnectionGraph();
+        if( ADVANCED_CFG::GetCfg().m_IncrementalConnectivity )
+        {
+            for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
+                cacheLinkKeys( subgraph );
 
-    build_graph.Stop();
-    wxLogTrace( "CONN_PROFILE", "BuildConnectionGraph() %0.4f ms", build_graph.msecs() );
+            m_sheet_list = aSheetList;
+            m_bus_alias_signature = busAliasSignature( aSheetList );
+        }
+    }
+
+    m_last_update_incremental = incremental;
 
     recalc_time.Stop();
     wxLogTrace( "CONN_PROFILE", "Recalculate time %0.4f ms", recalc_time.msecs() );
 
 #ifndef DEBUG
-    // Pressure relief valve for release builds
+    // Pressure relief valve for release builds.  Full rebuilds (loading, global cleanup) are
+    // expected to be slow on big schematics; only updates after edits are checked.
     const double max_recalc_time_msecs = 250.;
 
-    if( m_allowRealTime && ADVANCED_CFG::GetCfg().m_realTimeConnectivity &&
+    if( m_allowRealTime && ADVANCED_CFG::GetCfg().m_realTimeConnectivity && !aUnconditional &&
         recalc_time.msecs() > max_recalc_time_msecs )
     {
         m_allowRealTime = false;
@@ -428,6 +488,524 @@ void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnco
 }
 
 
+bool CONNECTION_GRAPH::updateIncremental( const SCH_SHEET_LIST& aSheetList )
+{
+    // Give up after this many attempts to find a self-contained set of subgraphs
+    const int max_iterations = 4;
+
+    if( m_subgraphs.empty() || aSheetList.size() != m_sheet_list.size()
+            || !std::equal( aSheetList.begin(), aSheetList.end(), m_sheet_list.begin() )
+            || busAliasSignature( aSheetList ) != m_bus_alias_signature )
+    {
+        return false;
+    }
+
+    std::unordered_set<SCH_ITEM*>                        live_items;
+    std::vector<std::pair<SCH_SHEET_PATH, SCH_ITEM*>>    dirty_items;
+    std::vector<std::pair<SCH_SHEET_PATH, SCH_ITEM*>>    bus_entries;
+    std::unordered_set<CONNECTION_SUBGRAPH*>             live_subgraphs( m_subgraphs.begin(),
+                                                                         m_subgraphs.end() );
+    std::unordered_map<int, CONNECTION_SUBGRAPH*>        code_to_subgraph;
+    std::unordered_set<SCH_ITEM*>                        stale_items;
+    std::unordered_set<SCH_ITEM*>                        dirty_set;
+    std::vector<CONNECTION_SUBGRAPH*>                    seeds;
+
+    for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
+        code_to_subgraph[ subgraph->m_code ] = subgraph;
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    {
+        for( SCH_ITEM* item : sheet.LastScreen()->Items() )
+        {
+            if( !item->IsConnectable() )
+                continue;
+
+            live_items.insert( item );
+
+            switch( item->Type() )
+            {
+            case SCH_COMPONENT_T:
+                for( SCH_PIN* pin : static_cast<SCH_COMPONENT*>( item )->GetSchPins( &sheet ) )
+                    live_items.insert( pin );
+
+                break;
+
+            case SCH_SHEET_T:
+                // Sheet pins are linked to the contents of the sub-sheet
+                if( item->IsConnectivityDirty() )
+                    return false;
+
+                for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( item )->GetPins() )
+                    live_items.insert( pin );
+
+                break;
+
+            case SCH_BUS_WIRE_ENTRY_T:
+            case SCH_BUS_BUS_ENTRY_T:
+                bus_entries.emplace_back( sheet, item );
+                break;
+
+            default:
+                break;
+            }
+
+            if( item->IsConnectivityDirty() )
+            {
+                dirty_items.emplace_back( sheet, item );
+                dirty_set.insert( item );
+
+                if( item->Type() == SCH_COMPONENT_T )
+                {
+                    for( SCH_PIN* pin : static_cast<SCH_COMPONENT*>( item )->GetSchPins( &sheet ) )
+                        dirty_set.insert( pin );
+                }
+            }
+        }
+    }
+
+    auto seedItem =
+            [&]( SCH_ITEM* aItem, const SCH_SHEET_PATH& aSheet )
+            {
+                SCH_CONNECTION* connection = aItem->Connection( aSheet );
+
+                if( connection && code_to_subgraph.count( connection->SubgraphCode() ) )
+                    seeds.push_back( code_to_subgraph.at( connection->SubgraphCode() ) );
+            };
+
+    // Subgraphs of deleted items.  These items may have been freed, so they are only compared.
+    // A new item may also have been allocated at the address of a deleted one: it is dirty, and
+    // may have no connection yet, so the subgraphs of dirty items are found here too.
+    for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
+    {
+        for( SCH_ITEM* item : subgraph->m_items )
+        {
+            if( !live_items.count( item ) )
+            {
+                stale_items.insert( item );
+                seeds.push_back( subgraph );
+            }
+            else if( dirty_set.count( item ) )
+            {
+                seeds.push_back( subgraph );
+            }
+        }
+    }
+
+    // Bus entries pointing at a deleted bus
+    for( const auto& it : bus_entries )
+    {
+        SCH_ITEM* bus_a = nullptr;
+        SCH_ITEM* bus_b = nullptr;
+
+        if( it.second->Type() == SCH_BUS_WIRE_ENTRY_T )
+        {
+            bus_a = static_cast<SCH_BUS_WIRE_ENTRY*>( it.second )->m_connected_bus_item;
+        }
+        else
+        {
+            bus_a = static_cast<SCH_BUS_BUS_ENTRY*>( it.second )->m_connected_bus_items[0];
+            bus_b = static_cast<SCH_BUS_BUS_ENTRY*>( it.second )->m_connected_bus_items[1];
+        }
+
+        if( ( bus_a && !live_items.count( bus_a ) ) || ( bus_b && !live_items.count( bus_b ) ) )
+            seedItem( it.second, it.first );
+    }
+
+    // Subgraphs of modified items, and of the items they may now touch
+    for( const auto& it : dirty_items )
+    {
+        const SCH_SHEET_PATH& sheet = it.first;
+        SCH_ITEM*             item = it.second;
+        EDA_RECT              bbox = item->GetBoundingBox();
+
+        bbox.Inflate( 1 );
+
+        seedItem( item, sheet );
+
+        if( item->Type() == SCH_COMPONENT_T )
+        {
+            for( SCH_PIN* pin : static_cast<SCH_COMPONENT*>( item )->GetSchPins( &sheet ) )
+                seedItem( pin, sheet );
+        }
+
+        for( SCH_ITEM* neighbor : sheet.LastScreen()->Items().Overlapping( bbox ) )
+        {
+            if( neighbor == item || !neighbor->IsConnectable() )
+                continue;
+
+            if( neighbor->Type() == SCH_COMPONENT_T )
+            {
+                auto component = static_cast<SCH_COMPONENT*>( neighbor );
+
+                for( SCH_PIN* pin : component->GetSchPins( &sheet ) )
+                {
+                    if( bbox.Contains( pin->GetPosition() ) )
+                        seedItem( pin, sheet );
+                }
+            }
+            else if( neighbor->Type() == SCH_SHEET_T )
+            {
+                for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( neighbor )->GetPins() )
+                {
+                    if( bbox.Contains( pin->GetTextPos() ) )
+                        seedItem( pin, sheet );
+                }
+            }
+            else
+            {
+                seedItem( neighbor, sheet );
+            }
+        }
+    }
+
+    if( dirty_items.empty() && seeds.empty() )
+        return true;
+
+    std::unordered_set<CONNECTION_SUBGRAPH*> affected;
+
+    for( int iteration = 0; iteration < max_iterations; ++iteration )
+    {
+        // Close the affected set over everything that is linked by name, bus or hierarchy
+        while( !seeds.empty() )
+        {
+            CONNECTION_SUBGRAPH* subgraph = seeds.back();
+            seeds.pop_back();
+
+            if( !live_subgraphs.count( subgraph ) || !affected.insert( subgraph ).second )
+                continue;
+
+            for( const wxString& key : subgraph->m_link_keys )
+            {
+                auto index_it = m_link_key_index.find( key );
+
+                if( index_it != m_link_key_index.end() )
+                    seeds.insert( seeds.end(), index_it->second.begin(), index_it->second.end() );
+            }
+
+            for( const auto& kv : subgraph->m_bus_neighbors )
+                seeds.insert( seeds.end(), kv.second.begin(), kv.second.end() );
+
+            for( const auto& kv : subgraph->m_bus_parents )
+                seeds.insert( seeds.end(), kv.second.begin(), kv.second.end() );
+
+            if( subgraph->m_hier_parent )
+                seeds.push_back( subgraph->m_hier_parent );
+        }
+
+        // Gather the items to rebuild, per sheet
+        std::unordered_map<SCH_SHEET_PATH, std::unordered_set<SCH_ITEM*>> sheet_items;
+        size_t                                                           item_count = 0;
+
+        for( CONNECTION_SUBGRAPH* subgraph : affected )
+        {
+            std::unordered_set<SCH_ITEM*>& items = sheet_items[ subgraph->m_sheet ];
+
+            // Dirty items are added below, on the sheets they are now on
+            for( SCH_ITEM* item : subgraph->m_items )
+            {
+                if( !stale_items.count( item ) && !dirty_set.count( item )
+                        && items.insert( item ).second )
+                {
+                    item_count++;
+                }
+            }
+        }
+
+        for( const auto& it : dirty_items )
+        {
+            std::unordered_set<SCH_ITEM*>& items = sheet_items[ it.first ];
+
+            if( it.second->Type() == SCH_COMPONENT_T )
+            {
+                for( SCH_PIN* pin : static_cast<SCH_COMPONENT*>( it.second )->GetSchPins( &it.first ) )
+                    item_count += items.insert( pin ).second;
+            }
+            else
+            {
+                item_count += items.insert( it.second ).second;
+            }
+        }
+
+        // A full rebuild is cheaper when most of the schematic is affected
+        if( item_count > m_items.size() / 2 )
+            return false;
+
+        CONNECTION_GRAPH partial( m_schematic );
+
+        partial.m_net_name_to_code_map = m_net_name_to_code_map;
+        partial.m_bus_name_to_code_map = m_bus_name_to_code_map;
+        partial.m_last_net_code        = m_last_net_code;
+        partial.m_last_bus_code        = m_last_bus_code;
+        partial.m_last_subgraph_code   = m_last_subgraph_code;
+
+        for( const auto& it : sheet_items )
+        {
+            std::vector<SCH_ITEM*> items( it.second.begin(), it.second.end() );
+            partial.updateItemConnectivity( it.first, items );
+        }
+
+        for( const auto& it : sheet_items )
+        {
+            // UpdateDanglingState() also adds connected items for SCH_TEXT
+            it.first.LastScreen()->TestDanglingEnds( &it.first );
+        }
+
+        partial.buildConnectionGraph();
+
+        // The rebuilt subgraphs must not be linked to anything outside of the affected set
+        for( CONNECTION_SUBGRAPH* subgraph : partial.m_subgraphs )
+        {
+            partial.cacheLinkKeys( subgraph );
+
+            for( const wxString& key : subgraph->m_link_keys )
+            {
+                auto index_it = m_link_key_index.find( key );
+
+                if( index_it == m_link_key_index.end() )
+                    continue;
+
+                for( CONNECTION_SUBGRAPH* candidate : index_it->second )
+                {
+                    if( !affected.count( candidate ) )
+                        seeds.push_back( candidate );
+                }
+            }
+        }
+
+        if( !seeds.empty() )
+        {
+            wxLogTrace( "CONN", "Incremental update links to %lu more subgraphs, retrying",
+                        seeds.size() );
+            continue;
+        }
+
+        wxLogTrace( "CONN", "Incremental update rebuilt %lu of %lu subgraphs (%lu items)",
+                    affected.size(), m_subgraphs.size(), item_count );
+
+        mergeGraph( partial, affected, stale_items );
+
+        // Component pins were updated individually
+        for( const auto& it : dirty_items )
+            it.second->SetConnectivityDirty( false );
+
+        return true;
+    }
+
+    return false;
+}
+
+
+void CONNECTION_GRAPH::cacheLinkKeys( CONNECTION_SUBGRAPH* aSubgraph )
+{
+    std::vector<wxString>& keys = aSubgraph->m_link_keys;
+    wxString               sheet_path = aSubgraph->m_sheet.PathAsString();
+
+    keys.clear();
+
+    auto addName =
+            [&]( SCH_CONNECTION* aConnection )
+            {
+                wxString name = aConnection->Name();
+
+                keys.push_back( wxT( "N:" ) + name );
+                keys.push_back( wxT( "L:" ) + sheet_path + wxT( ":" ) + aConnection->Name( true ) );
+
+                // Weakly driven nets are made unique with a suffix
+                if( !aConnection->Suffix().IsEmpty() && name.EndsWith( aConnection->Suffix() ) )
+                {
+                    name.RemoveLast( aConnection->Suffix().length() );
+                    keys.push_back( wxT( "N:" ) + name );
+                }
+            };
+
+    if( aSubgraph->m_driver_connection )
+    {
+        std::vector<SCH_CONNECTION*> connections = { aSubgraph->m_driver_connection };
+
+        for( size_t ii = 0; ii < connections.size(); ++ii )
+        {
+            addName( connections[ii] );
+
+            for( const std::shared_ptr<SCH_CONNECTION>& member : connections[ii]->Members() )
+                connections.push_back( member.get() );
+        }
+    }
+
+    for( SCH_ITEM* driver : aSubgraph->m_drivers )
+    {
+        wxString name = aSubgraph->GetNameForDriver( driver );
+
+        if( CONNECTION_SUBGRAPH::GetDriverPriority( driver )
+                >= CONNECTION_SUBGRAPH::PRIORITY::POWER_PIN )
+        {
+            keys.push_back( wxT( "N:" ) + name );
+        }
+
+        keys.push_back( wxT( "L:" ) + sheet_path + wxT( ":" ) + name );
+    }
+
+    for( SCH_HIERLABEL* label : aSubgraph->m_hier_ports )
+        keys.push_back( wxT( "H:" ) + sheet_path + wxT( ":" ) + label->GetShownText() );
+
+    for( SCH_SHEET_PIN* pin : aSubgraph->m_hier_pins )
+    {
+        SCH_SHEET_PATH path = aSubgraph->m_sheet;
+        path.push_back( pin->GetParent() );
+
+        keys.push_back( wxT( "H:" ) + path.PathAsString() + wxT( ":" ) + pin->GetShownText() );
+    }
+
+    std::sort( keys.begin(), keys.end() );
+    keys.erase( std::unique( keys.begin(), keys.end() ), keys.end() );
+
+    for( const wxString& key : keys )
+        m_link_key_index[ key ].push_back( aSubgraph );
+}
+
+
+void CONNECTION_GRAPH::mergeGraph( CONNECTION_GRAPH& aOther,
+                                   const std::unordered_set<CONNECTION_SUBGRAPH*>& aReplaced,
+                                   const std::unordered_set<SCH_ITEM*>& aStaleItems )
+{
+    auto isReplaced =
+            [&]( const CONNECTION_SUBGRAPH* aSubgraph )
+            {
+                return aReplaced.count( const_cast<CONNECTION_SUBGRAPH*>( aSubgraph ) ) > 0;
+            };
+
+    auto removeReplaced =
+            [&]( auto& aVector )
+            {
+                aVector.erase( std::remove_if( aVector.begin(), aVector.end(), isReplaced ),
+                               aVector.end() );
+            };
+
+    auto removeReplacedFromMap =
+            [&]( auto& aMap )
+            {
+                for( auto it = aMap.begin(); it != aMap.end(); )
+                {
+                    removeReplaced( it->second );
+
+                    if( it->second.empty() )
+                        it = aMap.erase( it );
+                    else
+                        ++it;
+                }
+            };
+
+    // Take the replaced subgraphs out of every cache
+
+    for( CONNECTION_SUBGRAPH* subgraph : aReplaced )
+    {
+        for( const wxString& key : subgraph->m_link_keys )
+        {
+            auto it = m_link_key_index.find( key );
+
+            if( it == m_link_key_index.end() )
+                continue;
+
+            removeReplaced( it->second );
+
+            if( it->second.empty() )
+                m_link_key_index.erase( it );
+        }
+
+        for( SCH_ITEM* item : subgraph->m_items )
+        {
+            auto it = m_item_to_subgraph_map.find( item );
+
+            if( it != m_item_to_subgraph_map.end() && isReplaced( it->second ) )
+                m_item_to_subgraph_map.erase( it );
+        }
+    }
+
+    removeReplaced( m_subgraphs );
+    removeReplaced( m_driver_subgraphs );
+    removeReplacedFromMap( m_sheet_to_subgraphs_map );
+    removeReplacedFromMap( m_global_label_cache );
+    removeReplacedFromMap( m_local_label_cache );
+    removeReplacedFromMap( m_net_name_to_subgraphs_map );
+    removeReplacedFromMap( m_net_code_to_subgraphs_map );
+
+    for( SCH_ITEM* item : aStaleItems )
+        m_items.erase( item );
+
+    m_invisible_power_pins.erase(
+            std::remove_if( m_invisible_power_pins.begin(), m_invisible_power_pins.end(),
+                    [&]( const std::pair<SCH_SHEET_PATH, SCH_PIN*>& aPin )
+                    {
+                        return aStaleItems.count( aPin.second )
+                               || aOther.m_items.count( aPin.second );
+                    } ),
+            m_invisible_power_pins.end() );
+
+    for( CONNECTION_SUBGRAPH* subgraph : aReplaced )
+        delete subgraph;
+
+    // Move the rebuilt subgraphs over, and point their connections at this graph
+
+    for( SCH_ITEM* item : aOther.m_items )
+    {
+        for( const auto& it : item->m_connection_map )
+            it.second->SetGraph( this );
+    }
+
+    for( CONNECTION_SUBGRAPH* subgraph : aOther.m_subgraphs )
+    {
+        subgraph->m_graph = this;
+
+        for( const auto& kv : subgraph->m_bus_neighbors )
+            kv.first->SetGraph( this );
+
+        for( const auto& kv : subgraph->m_bus_parents )
+            kv.first->SetGraph( this );
+
+        for( const wxString& key : subgraph->m_link_keys )
+            m_link_key_index[ key ].push_back( subgraph );
+    }
+
+    auto appendMap =
+            [&]( auto& aMap, auto& aOtherMap )
+            {
+                for( auto& it : aOtherMap )
+                {
+                    auto& vec = aMap[ it.first ];
+                    vec.insert( vec.end(), it.second.begin(), it.second.end() );
+                }
+            };
+
+    m_items.insert( aOther.m_items.begin(), aOther.m_items.end() );
+    m_subgraphs.insert( m_subgraphs.end(), aOther.m_subgraphs.begin(), aOther.m_subgraphs.end() );
+    m_driver_subgraphs.insert( m_driver_subgraphs.end(), aOther.m_driver_subgraphs.begin(),
+                               aOther.m_driver_subgraphs.end() );
+    m_invisible_power_pins.insert( m_invisible_power_pins.end(),
+                                   aOther.m_invisible_power_pins.begin(),
+                                   aOther.m_invisible_power_pins.end() );
+
+    appendMap( m_sheet_to_subgraphs_map, aOther.m_sheet_to_subgraphs_map );
+    appendMap( m_global_label_cache, aOther.m_global_label_cache );
+    appendMap( m_local_label_cache, aOther.m_local_label_cache );
+    appendMap( m_net_name_to_subgraphs_map, aOther.m_net_name_to_subgraphs_map );
+    appendMap( m_net_code_to_subgraphs_map, aOther.m_net_code_to_subgraphs_map );
+
+    for( const auto& it : aOther.m_item_to_subgraph_map )
+        m_item_to_subgraph_map[ it.first ] = it.second;
+
+    // The other graph started from our codes, so its maps are a superset of ours
+    m_bus_alias_cache       = std::move( aOther.m_bus_alias_cache );
+    m_net_name_to_code_map  = std::move( aOther.m_net_name_to_code_map );
+    m_bus_name_to_code_map  = std::move( aOther.m_bus_name_to_code_map );
+    m_last_net_code         = aOther.m_last_net_code;
+    m_last_bus_code         = aOther.m_last_bus_code;
+    m_last_subgraph_code    = aOther.m_last_subgraph_code;
+
+    // The subgraphs are owned by this graph now
+    aOther.m_subgraphs.clear();
+    aOther.Reset();
+}
+
+
 void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
                                                const std::vector<SCH_ITEM*>& aItemList )
 {
@@ -439,23 +1017,38 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
         item->GetConnectionPoints( points );
         item->ConnectedItems( aSheet ).clear();
 
-        if( item->Type() == SCH_SHEET_T )
+        if( item->Type() == SCH_SHEET_T || item->Type() == SCH_SHEET_PIN_T )
         {
-            for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( item )->GetPins() )
+            // Sheet pins are passed on their own by incremental updates
+            std::vector<SCH_SHEET_PIN*> pins;
+
+            if( item->Type() == SCH_SHEET_T )
+                pins = static_cast<SCH_SHEET*>( item )->GetPins();
+            else
+                pins.push_back( static_cast<SCH_SHEET_PIN*>( item ) );
+
+            for( SCH_SHEET_PIN* pin : pins )
             {
                 if( !pin->Connection( aSheet ) )
-                    pin->InitializeConnection( aSheet )->SetGraph( this );
+                    pin->InitializeConnection( aSheet );
 
                 pin->ConnectedItems( aSheet ).clear();
                 pin->Connection( aSheet )->Reset();
+                pin->Connection( aSheet )->SetGraph( this );
 
                 connection_map[ pin->GetTextPos() ].push_back( pin );
                 m_items.insert( pin );
             }
         }
-        else if( item->Type() == SCH_COMPONENT_T )
+        else if( item->Type() == SCH_COMPONENT_T || item->Type() == SCH_PIN_T )
         {
-            SCH_COMPONENT* component = static_cast<SCH_COMPONENT*>( item );
+            // Component pins are passed on their own by incremental updates
+            SCH_PIN_PTRS pins;
+
+            if( item->Type() == SCH_COMPONENT_T )
+                pins = static_cast<SCH_COMPONENT*>( item )->GetSchPins( &aSheet );
+            else
+                pins.push_back( static_cast<SCH_PIN*>( item ) );
 
             // TODO(JE) right now this relies on GetSchPins() returning good SCH_PIN pointers
             // that contain good LIB_PIN pointers.  Since these get invalidated whenever the
@@ -464,7 +1057,7 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
             // connectivity calculations.  This is slow and should be improved before release.
             // See https://gitlab.com/kicad/code/kicad/issues/3784
 
-            for( SCH_PIN* pin : component->GetSchPins( &aSheet ) )
+            for( SCH_PIN* pin : pins )
             {
                 pin->InitializeConnection( aSheet )->SetGraph( this );
 
@@ -504,10 +1097,6 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
                 static_cast<SCH_BUS_BUS_ENTRY*>( item )->m_connected_bus_items[1] = nullptr;
                 break;
 
-            case SCH_PIN_T:
-                conn->SetType( CONNECTION_TYPE::NET );
-                break;
-
             case SCH_BUS_WIRE_ENTRY_T:
                 conn->SetType( CONNECTION_TYPE::NET );
                 // clean previous (old) link:
@@ -749,12 +1338,11 @@ void CONNECTION_GRAPH::buildConnectionGraph()
 
     // Resolve drivers for subgraphs and propagate connectivity info
 
-    // We don't want to spin up a new thread for fewer than 8 nets (overhead costs)
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+    // We don't want to queue a new task for fewer than 4 subgraphs (overhead costs)
+    size_t parallelThreadCount = std::min<size_t>( THREAD_POOL::GetInstance().GetThreadCount(),
             ( m_subgraphs.size() + 3 ) / 4 );
 
     std::atomic<size_t> nextSubgraph( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
     std::vector<CONNECTION_SUBGRAPH*> dirty_graphs;
 
     std::copy_if( m_subgraphs.begin(), m_subgraphs.end(), std::back_inserter( dirty_graphs ),
@@ -852,16 +1440,17 @@ void CONNECTION_GRAPH::buildConnectionGraph()
         return 1;
     };
 
-    if( parallelThreadCount == 1 )
+    if( parallelThreadCount <= 1 )
         update_lambda();
     else
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
+        TASK_GROUP tasks;
 
-        // Finalize the threads
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
+            tasks.Run( update_lambda );
+
+        // Finalize the tasks
+        tasks.Wait();
     }
 
     // Now discard any non-driven subgraphs from further consideration
@@ -1487,6 +2076,59 @@ void CONNECTION_GRAPH::buildConnectionGraph()
         m_net_name_to_subgraphs_map[subgraph->m_driver_connection->Name()].push_back( subgraph );
     }
 
+    // Point everything that still refers to an absorbed subgraph at its absorber, since the
+    // absorbed subgraphs are deleted below
+    for( auto& it : m_item_to_subgraph_map )
+    {
+        while( it.second->m_absorbed )
+            it.second = it.second->m_absorbed_by;
+    }
+
+    for( auto& it : m_global_label_cache )
+    {
+        for( const CONNECTION_SUBGRAPH*& sg : it.second )
+        {
+            while( sg->m_absorbed )
+                sg = sg->m_absorbed_by;
+        }
+    }
+
+    for( auto& it : m_local_label_cache )
+    {
+        for( const CONNECTION_SUBGRAPH*& sg : it.second )
+        {
+            while( sg->m_absorbed )
+                sg = sg->m_absorbed_by;
+        }
+    }
+
+    for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
+    {
+        if( subgraph->m_absorbed )
+            continue;
+
+        for( auto* links : { &subgraph->m_bus_neighbors, &subgraph->m_bus_parents } )
+        {
+            for( auto& kv : *links )
+            {
+                std::unordered_set<CONNECTION_SUBGRAPH*> linked;
+
+                for( CONNECTION_SUBGRAPH* sg : kv.second )
+                {
+                    while( sg->m_absorbed )
+                        sg = sg->m_absorbed_by;
+
+                    linked.insert( sg );
+                }
+
+                kv.second = std::move( linked );
+            }
+        }
+
+        while( subgraph->m_hier_parent && subgraph->m_hier_parent->m_absorbed )
+            subgraph->m_hier_parent = subgraph->m_hier_parent->m_absorbed_by;
+    }
+
     // Clean up and deallocate stale subgraphs
     m_subgraphs.erase( std::remove_if( m_subgraphs.begin(), m_subgraphs.end(),
             [&]( const CONNECTION_SUBGRAPH* sg )
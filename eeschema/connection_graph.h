@@ -206,6 +206,13 @@ public:
 
     // If not null, this indicates the subgraph on a higher level sheet that is linked to this one
     CONNECTION_SUBGRAPH* m_hier_parent;
+
+    /**
+     * Names through which this subgraph can be linked to other subgraphs (net and bus member
+     * names, label texts and hierarchical links).  Subgraphs sharing a key must be rebuilt
+     * together by an incremental update.  Only filled in when incremental updates are enabled.
+     */
+    std::vector<wxString> m_link_keys;
 };
 
 /// Associates a net code with the final name of a net
@@ -224,7 +231,8 @@ public:
               m_last_net_code( 1 ),
               m_last_bus_code( 1 ),
               m_last_subgraph_code( 1 ),
-              m_schematic( aSchematic )
+              m_schematic( aSchematic ),
+              m_last_update_incremental( false )
     {}
 
     ~CONNECTION_GRAPH()
@@ -242,11 +250,21 @@ public:
     /**
      * Updates the connection graph for the given list of sheets.
      *
+     * Unless aUnconditional is set, only the subgraphs containing items flagged with
+     * IsConnectivityDirty() (or deleted items), and the subgraphs they are linked to by name,
+     * bus membership or hierarchy, are rebuilt.  The whole graph is rebuilt when the sheet
+     * hierarchy or the bus aliases have changed, or when an edit touches most of the schematic.
+     *
      * @param aSheetList is the list of possibly modified sheets
      * @param aUnconditional is true if an unconditional full recalculation should be done
      */
     void Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnconditional = false );
 
+    /**
+     * @return true if the last call to Recalculate() only rebuilt part of the graph
+     */
+    bool WasLastUpdateIncremental() const { return m_last_update_incremental; }
+
     /**
      * Returns a bus alias pointer for the given name if it exists (from cache)
      *
@@ -331,6 +349,14 @@ private:
 
     NET_MAP m_net_code_to_subgraphs_map;
 
+    /// Lookup of subgraphs by CONNECTION_SUBGRAPH::m_link_keys, for incremental updates
+    std::unordered_map<wxString, std::vector<CONNECTION_SUBGRAPH*>> m_link_key_index;
+
+    /// The sheets and bus aliases the graph was last fully built from
+    SCH_SHEET_LIST m_sheet_list;
+
+    wxString m_bus_alias_signature;
+
     int m_last_net_code;
 
     int m_last_bus_code;
@@ -339,6 +365,8 @@ private:
 
     SCHEMATIC* m_schematic;     ///< The schematic this graph represents
 
+    bool m_last_update_incremental;
+
     /**
      * Updates the graphical connectivity between items (i.e. where they touch)
      * The items passed in must be on the same sheet.
@@ -369,6 +397,38 @@ private:
     void updateItemConnectivity( SCH_SHEET_PATH aSheet,
                                  const std::vector<SCH_ITEM*>& aItemList );
 
+    /**
+     * Rebuilds only the part of the graph affected by the dirty and deleted items.
+     *
+     * The affected subgraphs are collected and closed over their link keys and bus and
+     * hierarchy neighbors, then rebuilt in a separate graph which is merged into this one.
+     * If the rebuilt subgraphs link to subgraphs outside of the affected set (for example
+     * because a label was renamed to an existing net name), those are added and the
+     * rebuild is repeated.
+     *
+     * @param aSheetList is the list of sheets of the schematic
+     * @return false if a full rebuild is needed instead.  The items may have been partly
+     *         updated in that case.
+     */
+    bool updateIncremental( const SCH_SHEET_LIST& aSheetList );
+
+    /**
+     * Computes the link keys of a subgraph and adds it to m_link_key_index
+     */
+    void cacheLinkKeys( CONNECTION_SUBGRAPH* aSubgraph );
+
+    /**
+     * Replaces a set of subgraphs of this graph with the subgraphs of another graph, which
+     * has been built from the items of the replaced subgraphs.  aOther is left empty.
+     *
+     * @param aOther is the graph holding the rebuilt subgraphs
+     * @param aReplaced is the set of subgraphs to delete
+     * @param aStaleItems are items of the replaced subgraphs that no longer exist
+     */
+    void mergeGraph( CONNECTION_GRAPH& aOther,
+                     const std::unordered_set<CONNECTION_SUBGRAPH*>& aReplaced,
+                     const std::unordered_set<SCH_ITEM*>& aStaleItems );
+
     /**
      * Generates the connection graph (after all item connectivity has been updated)
      *
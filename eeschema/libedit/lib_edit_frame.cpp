@@ -35,6 +35,7 @@
 #include <lib_edit_frame.h>
 #include <lib_manager.h>
 #include <lib_text.h>
+#include <lib_undo_packer.h>
 #include <libedit_settings.h>
 #include <pgm_base.h>
 #include <sch_draw_panel.h>
@@ -770,6 +771,10 @@ void LIB_EDIT_FRAME::ShowChangedLanguage()
 void LIB_EDIT_FRAME::SetScreen( BASE_SCREEN* aScreen )
 {
     SCH_BASE_FRAME::SetScreen( aScreen );
+
+    // Each symbol buffered by the library manager has its own screen and undo history
+    if( aScreen && !aScreen->GetUndoItemPacker() )
+        aScreen->SetUndoItemPacker( new LIB_UNDO_PACKER() );
 }
 
 
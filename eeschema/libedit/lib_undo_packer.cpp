@@ -0,0 +1,74 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <memory>
+
+#include <class_libentry.h>
+#include <richio.h>
+#include <sch_sexpr_plugin.h>
+#include "lib_undo_packer.h"
+
+
+bool LIB_UNDO_PACKER::Pack( ITEM_PICKER& aPicker, std::string& aData )
+{
+    if( aPicker.GetStatus() != UR_LIBEDIT && aPicker.GetStatus() != UR_LIB_RENAME )
+        return false;
+
+    LIB_PART* part = dynamic_cast<LIB_PART*>( aPicker.GetItem() );
+
+    if( !part || part->IsAlias() )
+        return false;
+
+    STRING_FORMATTER formatter;
+
+    try
+    {
+        SCH_SEXPR_PLUGIN::FormatPart( part, formatter );
+    }
+    catch( const IO_ERROR& )
+    {
+        return false;
+    }
+
+    aData = formatter.GetString();
+
+    delete part;
+    aPicker.SetItem( nullptr );
+
+    return true;
+}
+
+
+void LIB_UNDO_PACKER::Unpack( ITEM_PICKER& aPicker, const std::string& aData )
+{
+    STRING_LINE_READER        reader( aData, wxT( "undo" ) );
+    std::unique_ptr<LIB_PART> part( SCH_SEXPR_PLUGIN::ParsePart( reader ) );
+
+    if( !part )
+        THROW_IO_ERROR( _( "Invalid symbol in the undo data" ) );
+
+    // As set by LIB_EDIT_FRAME::SaveCopyInUndoList()
+    part->SetFlags( UR_TRANSIENT );
+
+    aPicker.SetItem( part.release() );
+}
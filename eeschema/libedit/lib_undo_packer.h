@@ -0,0 +1,45 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef LIB_UNDO_PACKER_H
+#define LIB_UNDO_PACKER_H
+
+#include <undo_redo_container.h>
+
+
+/**
+ * LIB_UNDO_PACKER
+ * keeps the symbol copies of old symbol editor undo commands as s-expressions.  Every
+ * symbol editor command holds a copy of the whole symbol, with all its units and pins.
+ *
+ * Derived symbols are kept as they are, as they can only be read back with their parent.
+ */
+class LIB_UNDO_PACKER : public UNDO_ITEM_PACKER
+{
+public:
+    bool Pack( ITEM_PICKER& aPicker, std::string& aData ) override;
+
+    void Unpack( ITEM_PICKER& aPicker, const std::string& aData ) override;
+};
+
+#endif    // LIB_UNDO_PACKER_H
@@ -193,7 +193,7 @@ void SCH_BUS_ENTRY_BASE::Rotate( wxPoint aPosition )
 }
 
 
-bool SCH_BUS_WIRE_ENTRY::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList,
+bool SCH_BUS_WIRE_ENTRY::UpdateDanglingState( const DANGLING_END_INDEX& aEnds,
                                               const SCH_SHEET_PATH* aPath )
 {
     bool previousStateStart = m_isDanglingStart;
@@ -201,44 +201,54 @@ bool SCH_BUS_WIRE_ENTRY::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aI
 
     m_isDanglingStart = m_isDanglingEnd = true;
 
-    // Wires and buses are stored in the list as a pair, start and end. This
-    // variable holds the start position from one iteration so it can be used
-    // when the end position is found.
-    wxPoint seg_start;
-
     // Store the connection type and state for the start (0) and end (1)
     bool has_wire[2] = { false };
     bool has_bus[2] = { false };
 
-    for( DANGLING_END_ITEM& each_item : aItemList )
+    auto hasWireAt =
+            [&]( const wxPoint& aPos ) -> bool
+            {
+                for( size_t ii : aEnds.GetEndsAt( aPos ) )
+                {
+                    const DANGLING_END_ITEM& item = aEnds.GetItem( ii );
+
+                    if( item.GetItem() != this
+                            && ( item.GetType() == WIRE_START_END
+                                 || item.GetType() == WIRE_END_END ) )
+                    {
+                        return true;
+                    }
+                }
+
+                return false;
+            };
+
+    has_wire[0] = hasWireAt( m_pos );
+    has_wire[1] = hasWireAt( m_End() );
+
+    // Wires and buses are stored in the list as a pair, start and end.  A bus passing through
+    // both ends only connects the start.
+    for( size_t ii : aEnds.GetSegmentsNear( m_pos ) )
     {
-        if( each_item.GetItem() == this )
-            continue;
-
-        switch( each_item.GetType() )
+        if( aEnds.GetItem( ii ).GetType() == BUS_START_END
+                && IsPointOnSegment( aEnds.GetItem( ii ).GetPosition(),
+                                     aEnds.GetItem( ii + 1 ).GetPosition(), m_pos ) )
         {
-        case WIRE_START_END:
-        case WIRE_END_END:
-            if( m_pos == each_item.GetPosition() )
-                has_wire[0] = true;
-            else if( m_End() == each_item.GetPosition() )
-                has_wire[1] = true;
-
-            break;
-
-        case BUS_START_END:
-            seg_start = each_item.GetPosition();
+            has_bus[0] = true;
             break;
+        }
+    }
 
-        case BUS_END_END:
-            if( IsPointOnSegment( seg_start, each_item.GetPosition(), m_pos ) )
-                has_bus[0] = true;
-            else if( IsPointOnSegment( seg_start, each_item.GetPosition(), m_End() ) )
-                has_bus[1] = true;
-
-            break;
+    for( size_t ii : aEnds.GetSegmentsNear( m_End() ) )
+    {
+        const wxPoint& seg_start = aEnds.GetItem( ii ).GetPosition();
+        const wxPoint& seg_end = aEnds.GetItem( ii + 1 ).GetPosition();
 
-        default:
+        if( aEnds.GetItem( ii ).GetType() == BUS_START_END
+                && !IsPointOnSegment( seg_start, seg_end, m_pos )
+                && IsPointOnSegment( seg_start, seg_end, m_End() ) )
+        {
+            has_bus[1] = true;
             break;
         }
     }
@@ -256,7 +266,7 @@ bool SCH_BUS_WIRE_ENTRY::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aI
 }
 
 
-bool SCH_BUS_BUS_ENTRY::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList,
+bool SCH_BUS_BUS_ENTRY::UpdateDanglingState( const DANGLING_END_INDEX& aEnds,
                                              const SCH_SHEET_PATH* aPath )
 {
     bool previousStateStart = m_isDanglingStart;
@@ -264,31 +274,25 @@ bool SCH_BUS_BUS_ENTRY::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aIt
 
     m_isDanglingStart = m_isDanglingEnd = true;
 
-    // Wires and buses are stored in the list as a pair, start and end. This
-    // variable holds the start position from one iteration so it can be used
-    // when the end position is found.
-    wxPoint seg_start;
-
-    for( DANGLING_END_ITEM& each_item : aItemList )
-    {
-        if( each_item.GetItem() == this )
-            continue;
-
-        switch( each_item.GetType() )
-        {
-        case BUS_START_END:
-            seg_start = each_item.GetPosition();
-            break;
-        case BUS_END_END:
-            if( IsPointOnSegment( seg_start, each_item.GetPosition(), m_pos ) )
-                m_isDanglingStart = false;
-            if( IsPointOnSegment( seg_start, each_item.GetPosition(), m_End() ) )
-                m_isDanglingEnd = false;
-            break;
-        default:
-            break;
-        }
-    }
+    auto isOnBus =
+            [&]( const wxPoint& aPos ) -> bool
+            {
+                // Wires and buses are stored in the list as a pair, start and end.
+                for( size_t ii : aEnds.GetSegmentsNear( aPos ) )
+                {
+                    if( aEnds.GetItem( ii ).GetType() == BUS_START_END
+                            && IsPointOnSegment( aEnds.GetItem( ii ).GetPosition(),
+                                                 aEnds.GetItem( ii + 1 ).GetPosition(), aPos ) )
+                    {
+                        return true;
+                    }
+                }
+
+                return false;
+            };
+
+    m_isDanglingStart = !isOnBus( m_pos );
+    m_isDanglingEnd = !isOnBus( m_End() );
 
     return (previousStateStart != m_isDanglingStart) || (previousStateEnd != m_isDanglingEnd);
 }
@@ -159,7 +159,7 @@ public:
 
     BITMAP_DEF GetMenuImage() const override;
 
-    bool UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList,
+    bool UpdateDanglingState( const DANGLING_END_INDEX& aEnds,
                               const SCH_SHEET_PATH* aPath = nullptr ) override;
 
     /**
@@ -204,7 +204,7 @@ public:
 
     BITMAP_DEF GetMenuImage() const override;
 
-    bool UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList,
+    bool UpdateDanglingState( const DANGLING_END_INDEX& aEnds,
                               const SCH_SHEET_PATH* aPath = nullptr ) override;
 
     /**
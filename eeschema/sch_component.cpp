@@ -1345,7 +1345,7 @@ void SCH_COMPONENT::GetEndPoints( std::vector <DANGLING_END_ITEM>& aItemList )
 }
 
 
-bool SCH_COMPONENT::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList,
+bool SCH_COMPONENT::UpdateDanglingState( const DANGLING_END_INDEX& aEnds,
                                          const SCH_SHEET_PATH* aPath )
 {
     bool changed = false;
@@ -1357,8 +1357,10 @@ bool SCH_COMPONENT::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemLi
 
         wxPoint pos = m_transform.TransformCoordinate( pin->GetLocalPosition() ) + m_Pos;
 
-        for( DANGLING_END_ITEM& each_item : aItemList )
+        for( size_t ii : aEnds.GetEndsAt( pos ) )
         {
+            const DANGLING_END_ITEM& each_item = aEnds.GetItem( ii );
+
             // Some people like to stack pins on top of each other in a symbol to indicate
             // internal connection. While technically connected, it is not particularly useful
             // to display them that way, so skip any pins that are in the same symbol as this
@@ -1375,10 +1377,7 @@ bool SCH_COMPONENT::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemLi
             case WIRE_END_END:
             case NO_CONNECT_END:
             case JUNCTION_END:
-
-                if( pos == each_item.GetPosition() )
-                    pin->SetIsDangling( false );
-
+                pin->SetIsDangling( false );
                 break;
 
             default:
@@ -597,11 +597,11 @@ public:
      *
      * @note This does not test for  short circuits.
      *
-     * @param aItemList is list of all #DANGLING_END_ITEM items to be tested.
+     * @param aEnds is the index of all #DANGLING_END_ITEM items to be tested.
      *
      * @return true if any pin's state has changed.
      */
-    bool UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList,
+    bool UpdateDanglingState( const DANGLING_END_INDEX& aEnds,
                               const SCH_SHEET_PATH* aPath = nullptr ) override;
 
     wxPoint GetPinPhysicalPosition( const LIB_PIN* Pin ) const;
@@ -79,6 +79,9 @@ public:
     void SetGraph( CONNECTION_GRAPH* aGraph )
     {
         m_graph = aGraph;
+
+        for( const std::shared_ptr<SCH_CONNECTION>& member : m_members )
+            member->SetGraph( aGraph );
     }
 
     /**
@@ -1030,7 +1030,8 @@ void SCH_EDIT_FRAME::RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags )
     timer.Stop();
     wxLogTrace( "CONN_PROFILE", "SchematicCleanUp() %0.4f ms", timer.msecs() );
 
-    Schematic().ConnectionGraph()->Recalculate( list, true );
+    // A global cleanup may touch every sheet, so don't bother with an incremental update
+    Schematic().ConnectionGraph()->Recalculate( list, aCleanupFlags == GLOBAL_CLEANUP );
 }
 
 
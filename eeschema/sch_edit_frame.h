@@ -350,7 +350,9 @@ public:
     bool BreakSegmentsOnJunctions( SCH_SCREEN* aScreen = nullptr );
 
     /**
-     * Test all of the connectable objects in the schematic for unused connection points.
+     * Test the connectable objects in the schematic for unused connection points.
+     *
+     * Only the objects near the connection points changed since the last test are retested.
      * @return True if any connection state changes were made.
      */
     bool TestDanglingEnds();
@@ -35,6 +35,7 @@ class SCH_PLUGIN;
 class SCHEMATIC;
 class KIWAY;
 class LIB_PART;
+class LIB_SYMBOL_INFO;
 class PART_LIB;
 class PROPERTIES;
 
@@ -284,6 +285,29 @@ public:
                                      const wxString&   aLibraryPath,
                                      const PROPERTIES* aProperties = NULL );
 
+    /**
+     * Populate a list of #LIB_SYMBOL_INFO describing the symbols of the library
+     * \a aLibraryPath, as shown by the symbol chooser.
+     *
+     * Plugins which index their libraries do not need to load the symbols to do so.  The
+     * default implementation loads them with EnumerateSymbolLib().
+     *
+     * @param aSymbolList is an array to populate with the #LIB_SYMBOL_INFO of the library.
+     *
+     * @param aLibraryPath is a locator for the "library", usually a directory, file,
+     *                     or URL containing one or more #LIB_PART objects.
+     *
+     * @param aProperties is an associative array that can be used to tell the plugin anything
+     *                    needed about how to perform with respect to \a aLibraryPath.  The
+     *                    caller continues to own this object (plugin may not delete it), and
+     *                    plugins should expect it to be optionally NULL.
+     *
+     * @throw IO_ERROR if the library cannot be found, the part library cannot be loaded.
+     */
+    virtual void EnumerateSymbolInfo( std::vector<LIB_SYMBOL_INFO>& aSymbolList,
+                                      const wxString&   aLibraryPath,
+                                      const PROPERTIES* aProperties = NULL );
+
     /**
      * Load a #LIB_PART object having \a aPartName from the \a aLibraryPath containing
      * a library format that this #SCH_PLUGIN knows about.
@@ -37,6 +37,9 @@
 #include <sch_pin.h>
 #include <schematic.h>
 #include <general.h>
+#include <convert_to_biu.h>
+#include <eda_rect.h>
+#include <math/util.h>
 
 
 /* Constructor and destructor for SCH_ITEM */
@@ -207,3 +210,138 @@ void SCH_ITEM::Plot( PLOTTER* aPlotter )
 {
     wxFAIL_MSG( wxT( "Plot() method not implemented for class " ) + GetClass() );
 }
+
+
+/// Size of the grid cells used to index the connection points and the wire and bus segments.
+static constexpr int DANGLING_END_CELL_SIZE = Mils2iu( 1000 );
+
+
+static int danglingEndCell( int aCoord )
+{
+    // Round towards minus infinity so that the cells do not overlap around the origin
+    if( aCoord >= 0 )
+        return aCoord / DANGLING_END_CELL_SIZE;
+    else
+        return ( aCoord + 1 ) / DANGLING_END_CELL_SIZE - 1;
+}
+
+
+static const std::vector<size_t> s_noDanglingEnds;
+
+
+void DANGLING_END_INDEX::Build( std::vector<DANGLING_END_ITEM> aItemList )
+{
+    Clear();
+
+    m_items = std::move( aItemList );
+
+    for( size_t ii = 0; ii < m_items.size(); ++ii )
+    {
+        const wxPoint& pos = m_items[ii].GetPosition();
+
+        m_ends[pos].push_back( ii );
+        m_endCells[wxPoint( danglingEndCell( pos.x ), danglingEndCell( pos.y ) )].push_back( ii );
+
+        if( IsSegmentStart( ii ) )
+            addSegment( ii );
+    }
+}
+
+
+void DANGLING_END_INDEX::Clear()
+{
+    m_items.clear();
+    m_ends.clear();
+    m_endCells.clear();
+    m_segmentCells.clear();
+}
+
+
+const std::vector<size_t>& DANGLING_END_INDEX::GetEndsAt( const wxPoint& aPos ) const
+{
+    auto it = m_ends.find( aPos );
+
+    return it != m_ends.end() ? it->second : s_noDanglingEnds;
+}
+
+
+const std::vector<size_t>& DANGLING_END_INDEX::GetSegmentsNear( const wxPoint& aPos ) const
+{
+    auto it = m_segmentCells.find( wxPoint( danglingEndCell( aPos.x ),
+                                            danglingEndCell( aPos.y ) ) );
+
+    return it != m_segmentCells.end() ? it->second : s_noDanglingEnds;
+}
+
+
+void DANGLING_END_INDEX::GetEndsInside( const EDA_RECT& aRect, std::vector<size_t>& aList ) const
+{
+    EDA_RECT rect = aRect;
+    rect.Normalize();
+
+    for( int cx = danglingEndCell( rect.GetLeft() ); cx <= danglingEndCell( rect.GetRight() );
+         ++cx )
+    {
+        for( int cy = danglingEndCell( rect.GetTop() ); cy <= danglingEndCell( rect.GetBottom() );
+             ++cy )
+        {
+            auto it = m_endCells.find( wxPoint( cx, cy ) );
+
+            if( it == m_endCells.end() )
+                continue;
+
+            for( size_t ii : it->second )
+            {
+                if( rect.Contains( m_items[ii].GetPosition() ) )
+                    aList.push_back( ii );
+            }
+        }
+    }
+}
+
+
+bool DANGLING_END_INDEX::IsSegmentStart( size_t aIndex ) const
+{
+    if( aIndex + 1 >= m_items.size() || m_items[aIndex].GetItem() != m_items[aIndex + 1].GetItem() )
+        return false;
+
+    switch( m_items[aIndex].GetType() )
+    {
+    case WIRE_START_END: return m_items[aIndex + 1].GetType() == WIRE_END_END;
+    case BUS_START_END:  return m_items[aIndex + 1].GetType() == BUS_END_END;
+    default:             return false;
+    }
+}
+
+
+void DANGLING_END_INDEX::addSegment( size_t aIndex )
+{
+    wxPoint start = m_items[aIndex].GetPosition();
+    wxPoint end = m_items[aIndex + 1].GetPosition();
+
+    if( start.x > end.x )
+        std::swap( start, end );
+
+    // Walk the grid columns crossed by the segment and add the cells covered by its y extent
+    // in each column.  Both are widened by one unit, the accuracy labels are hit tested with.
+    for( int cx = danglingEndCell( start.x - 1 ); cx <= danglingEndCell( end.x + 1 ); ++cx )
+    {
+        int ymin = std::min( start.y, end.y );
+        int ymax = std::max( start.y, end.y );
+
+        if( start.x != end.x )
+        {
+            double slope = double( end.y - start.y ) / double( end.x - start.x );
+            double x0 = std::max<double>( start.x, double( cx ) * DANGLING_END_CELL_SIZE - 1 );
+            double x1 = std::min<double>( end.x, double( cx + 1 ) * DANGLING_END_CELL_SIZE );
+            double y0 = start.y + ( x0 - start.x ) * slope;
+            double y1 = start.y + ( x1 - start.x ) * slope;
+
+            ymin = KiROUND( std::floor( std::min( y0, y1 ) ) );
+            ymax = KiROUND( std::ceil( std::max( y0, y1 ) ) );
+        }
+
+        for( int cy = danglingEndCell( ymin - 1 ); cy <= danglingEndCell( ymax + 1 ); ++cy )
+            m_segmentCells[wxPoint( cx, cy )].push_back( aIndex );
+    }
+}
@@ -139,6 +139,61 @@ public:
 };
 
 
+/**
+ * DANGLING_END_INDEX
+ * holds the #DANGLING_END_ITEM list of a screen indexed by position, so the dangling state of
+ * an item can be updated without scanning every connection point of the screen.
+ *
+ * Wires and buses are also indexed by segment on a coarse grid, for the items (labels and bus
+ * entries) which connect anywhere along a wire or a bus.  Query results are indices into the
+ * list, in list order.
+ */
+class DANGLING_END_INDEX
+{
+public:
+    DANGLING_END_INDEX() {}
+
+    explicit DANGLING_END_INDEX( std::vector<DANGLING_END_ITEM> aItemList )
+    {
+        Build( std::move( aItemList ) );
+    }
+
+    /**
+     * Replace the indexed list by \a aItemList.  Wire and bus end points must follow their
+     * start points in the list, as SCH_LINE::GetEndPoints() adds them.
+     */
+    void Build( std::vector<DANGLING_END_ITEM> aItemList );
+
+    void Clear();
+
+    const std::vector<DANGLING_END_ITEM>& GetItems() const { return m_items; }
+    const DANGLING_END_ITEM& GetItem( size_t aIndex ) const { return m_items[aIndex]; }
+
+    /// @return the connection points located at \a aPos.
+    const std::vector<size_t>& GetEndsAt( const wxPoint& aPos ) const;
+
+    /**
+     * @return the wires and buses which may pass within one unit of \a aPos, as the index of
+     * their start point.  The end point of the segment is the next item of the list.
+     */
+    const std::vector<size_t>& GetSegmentsNear( const wxPoint& aPos ) const;
+
+    /// Add the connection points located inside \a aRect to \a aList.
+    void GetEndsInside( const EDA_RECT& aRect, std::vector<size_t>& aList ) const;
+
+    /// @return true if \a aIndex is the start point of a wire or bus segment.
+    bool IsSegmentStart( size_t aIndex ) const;
+
+private:
+    void addSegment( size_t aIndex );
+
+    std::vector<DANGLING_END_ITEM>                    m_items;
+    std::unordered_map<wxPoint, std::vector<size_t>> m_ends;
+    std::unordered_map<wxPoint, std::vector<size_t>> m_endCells;
+    std::unordered_map<wxPoint, std::vector<size_t>> m_segmentCells;
+};
+
+
 typedef std::unordered_set<SCH_ITEM*> ITEM_SET;
 
 /**
@@ -320,7 +375,7 @@ public:
 
     /**
      * Function IsDanglingStateChanged
-     * tests the schematic item to \a aItemList to check if it's dangling state has changed.
+     * tests the schematic item to \a aEnds to check if it's dangling state has changed.
      *
      * Note that the return value only true when the state of the test has changed.  Use
      * the IsDangling() method to get the current dangling state of the item.  Some of
@@ -331,11 +386,11 @@ public:
      * If aSheet is passed a non-null pointer to a SCH_SHEET_PATH, the overrided method can
      * optionally use it to update sheet-local connectivity information
      *
-     * @param aItemList - List of items to test item against.
+     * @param aEnds - Index of the connection points to test item against.
      * @param aSheet - Sheet path to update connections for
      * @return True if the dangling state has changed from it's current setting.
      */
-    virtual bool UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList,
+    virtual bool UpdateDanglingState( const DANGLING_END_INDEX& aEnds,
                                       const SCH_SHEET_PATH* aPath = nullptr )
     {
         return false;
@@ -21,6 +21,7 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <boost/algorithm/string/join.hpp>
 #include <cctype>
 #include <set>
@@ -65,6 +66,7 @@
 #include <lib_rectangle.h>
 #include <lib_text.h>
 #include <eeschema_id.h>       // for MAX_UNIT_COUNT_PER_PACKAGE definition
+#include <symbol_lib_index.h>
 #include <symbol_lib_table.h>  // for PropPowerSymsOnly definintion.
 #include <confirm.h>
 #include <tool/selection.h>
@@ -474,19 +476,20 @@ static void parseQuotedString( wxString& aString, LINE_READER& aReader,
  */
 class SCH_LEGACY_PLUGIN_CACHE
 {
-    static int      m_modHash;      // Keep track of the modification status of the library.
+    static std::atomic<int> m_modHash; // Keep track of the modification status of the library.
 
     wxString        m_fileName;     // Absolute path and file name.
     wxFileName      m_libFileName;  // Absolute path and file name is required here.
     wxDateTime      m_fileModTime;
     LIB_PART_MAP    m_symbols;      // Map of names of #LIB_PART pointers.
+    SYMBOL_LIB_INDEX m_index;       // The symbols of the library file not parsed yet.
     bool            m_isWritable;
     bool            m_isModified;
     int             m_versionMajor;
     int             m_versionMinor;
     int             m_libType;      // Is this cache a component or symbol library.
 
-    void                  loadHeader( FILE_LINE_READER& aReader );
+    void                  loadIndex();
     static void           loadAliases( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader,
                                        LIB_PART_MAP* aMap = nullptr );
     static void           loadField( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader );
@@ -508,6 +511,7 @@ class SCH_LEGACY_PLUGIN_CACHE
     static FILL_T   parseFillMode( LINE_READER& aReader, const char* aLine,
                                    const char** aOutput );
     LIB_PART*       removeSymbol( LIB_PART* aAlias );
+    void            loadAllSymbols();
 
     void            saveDocFile();
     static void     saveArc( LIB_ARC* aArc, OUTPUTFORMATTER& aFormatter );
@@ -534,8 +538,16 @@ public:
     /// Save the entire library to file m_libFileName;
     void Save( bool aSaveDocFile = true );
 
+    /// Index the library and document files, the symbols are parsed on demand by GetSymbol().
     void Load();
 
+    /**
+     * Return the symbol \a aName, parsing it if it was not used yet.
+     *
+     * @return the symbol or nullptr if the library has no such symbol.
+     */
+    LIB_PART* GetSymbol( const wxString& aName );
+
     void AddSymbol( const LIB_PART* aPart );
 
     void DeleteSymbol( const wxString& aName );
@@ -2395,7 +2407,7 @@ void SCH_LEGACY_PLUGIN::saveBusAlias( std::shared_ptr<BUS_ALIAS> aAlias )
 }
 
 
-int SCH_LEGACY_PLUGIN_CACHE::m_modHash = 1;     // starts at 1 and goes up
+std::atomic<int> SCH_LEGACY_PLUGIN_CACHE::m_modHash( 1 );     // starts at 1 and goes up
 
 
 SCH_LEGACY_PLUGIN_CACHE::SCH_LEGACY_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
@@ -2542,6 +2554,8 @@ LIB_PART* SCH_LEGACY_PLUGIN_CACHE::removeSymbol( LIB_PART* aPart )
 
 void SCH_LEGACY_PLUGIN_CACHE::AddSymbol( const LIB_PART* aPart )
 {
+    loadAllSymbols();
+
     // aPart is cloned in PART_LIB::AddPart().  The cache takes ownership of aPart.
     wxString name = aPart->GetName();
     LIB_PART_MAP::iterator it = m_symbols.find( name );
@@ -2572,12 +2586,49 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
     wxLogTrace( traceSchLegacyPlugin, "Loading legacy symbol file \"%s\"",
                 m_libFileName.GetFullPath() );
 
-    FILE_LINE_READER reader( m_libFileName.GetFullPath() );
+    wxFileName docFileName = m_libFileName;
+
+    docFileName.SetExt( DOC_EXT );
+
+    // Take the stamps first, so that files modified while they are indexed are indexed again.
+    wxString stamp = SYMBOL_LIB_INDEX::FileStamp( m_libFileName ) + wxT( ";" )
+                     + SYMBOL_LIB_INDEX::FileStamp( docFileName );
+
+    if( m_index.ReadCache( m_libFileName.GetFullPath(), stamp ) )
+    {
+        m_versionMajor = m_index.GetVersionMajor();
+        m_versionMinor = m_index.GetVersionMinor();
+    }
+    else
+    {
+        loadIndex();
+
+        if( USE_OLD_DOC_FILE_FORMAT( m_versionMajor, m_versionMinor ) )
+            loadDocs();
+
+        m_index.WriteCache( m_libFileName.GetFullPath(), stamp );
+    }
+
+    ++m_modHash;
+
+    // Remember the file modification time of library file when the
+    // cache snapshot was made, so that in a networked environment we will
+    // reload the cache as needed.
+    m_fileModTime = GetLibModificationTime();
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::loadIndex()
+{
+    // The file is mapped rather than read in text mode, so that the line lengths add up to
+    // the byte offsets of the symbols.
+    MAPPED_FILE_LINE_READER reader( m_libFileName.GetFullPath() );
 
     if( !reader.ReadLine() )
         THROW_IO_ERROR( _( "unexpected end of file" ) );
 
     const char* line = reader.Line();
+    size_t      offset = reader.Length();
 
     if( !strCompare( "EESchema-LIBRARY Version", line, &line ) )
     {
@@ -2613,35 +2664,164 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
         m_libType = LIBRARY_TYPE_EESCHEMA;
     }
 
+    m_index.Clear();
+    m_index.SetVersion( m_versionMajor, m_versionMinor );
+
+    // The symbol of the current DEF/ENDDEF block, followed by its aliases.  Everything but
+    // these blocks, including old library headers, is skipped.
+    std::vector<SYMBOL_LIB_INDEX_ENTRY> symbols;
+
     while( reader.ReadLine() )
     {
+        size_t lineOffset = offset;
+
         line = reader.Line();
+        offset += reader.Length();
 
-        if( *line == '#' || isspace( *line ) )  // Skip comments and blank lines.
-            continue;
+        if( symbols.empty() )
+        {
+            if( !strCompare( "DEF", line, &line ) )
+                continue;
+
+            // Same as LoadPart().
+            wxStringTokenizer tokens( wxString::FromUTF8( line ), " \r\n\t" );
+
+            if( tokens.CountTokens() < 8 )
+                SCH_PARSE_ERROR( "invalid symbol definition", reader, line );
+
+            SYMBOL_LIB_INDEX_ENTRY entry;
+            wxString               name = tokens.GetNextToken();
+            long                   unitCount;
+
+            if( name.IsEmpty() )
+                name = "~";
+            else if( name[0] == '~' )
+                name = name.Mid( 1 );
 
-        // Headers where only supported in older library file formats.
-        if( m_libType == LIBRARY_TYPE_EESCHEMA && strCompare( "$HEADER", line ) )
-            loadHeader( reader );
+            entry.m_Name = LIB_ID::FixIllegalChars( name, LIB_ID::ID_SCH );
+            entry.m_Offset = lineOffset;
 
-        if( strCompare( "DEF", line ) )
+            // Skip the prefix, the unused pin count, the pin name offset and the pin number
+            // and name visibility flags.
+            for( int ii = 0; ii < 5; ++ii )
+                tokens.GetNextToken();
+
+            if( tokens.GetNextToken().ToLong( &unitCount ) && unitCount > 1 )
+                entry.m_UnitCount = static_cast<int>( unitCount );
+
+            // Skip the unit locking flag.  The power flag is optional.
+            tokens.GetNextToken();
+
+            entry.m_IsPower = tokens.HasMoreTokens() && tokens.GetNextToken() == "P";
+
+            symbols.push_back( entry );
+        }
+        else if( strCompare( "ALIAS", line, &line ) )
+        {
+            wxStringTokenizer tokens( wxString::FromUTF8( line ), " \r\n\t" );
+
+            while( tokens.HasMoreTokens() )
+            {
+                SYMBOL_LIB_INDEX_ENTRY alias;
+
+                // Same as the LIB_PART constructor.
+                alias.m_Name = LIB_ID::FixIllegalChars( tokens.GetNextToken(), LIB_ID::ID_SCH );
+                alias.m_Parent = symbols.front().m_Name;
+                alias.m_UnitCount = symbols.front().m_UnitCount;
+
+                symbols.push_back( alias );
+            }
+        }
+        else if( strCompare( "F2", line, &line ) )
+        {
+            if( *line == '"' )
+                parseQuotedString( symbols.front().m_Footprint, reader, line, nullptr, true );
+        }
+        else if( strCompare( "ENDDEF", line ) )
         {
-            // Read one DEF/ENDDEF part entry from library:
-            LIB_PART* part = LoadPart( reader, m_versionMajor, m_versionMinor, &m_symbols );
+            // Aliases are parsed with their symbol, and share its footprint field.
+            for( SYMBOL_LIB_INDEX_ENTRY& entry : symbols )
+            {
+                entry.m_Footprint = symbols.front().m_Footprint;
+                entry.m_Offset = symbols.front().m_Offset;
+                entry.m_Length = offset - entry.m_Offset;
+
+                m_index.Add( entry );
+            }
 
-            m_symbols[ part->GetName() ] = part;
+            symbols.clear();
         }
     }
 
-    ++m_modHash;
+    if( !symbols.empty() )
+        SCH_PARSE_ERROR( "missing ENDDEF", reader, reader.Line() );
+}
 
-    // Remember the file modification time of library file when the
-    // cache snapshot was made, so that in a networked environment we will
-    // reload the cache as needed.
-    m_fileModTime = GetLibModificationTime();
 
-    if( USE_OLD_DOC_FILE_FORMAT( m_versionMajor, m_versionMinor ) )
-        loadDocs();
+LIB_PART* SCH_LEGACY_PLUGIN_CACHE::GetSymbol( const wxString& aName )
+{
+    LIB_PART_MAP::iterator it = m_symbols.find( aName );
+
+    if( it != m_symbols.end() )
+        return it->second;
+
+    const SYMBOL_LIB_INDEX_ENTRY* entry = m_index.Find( aName );
+
+    if( !entry )
+        return nullptr;
+
+    wxLogTrace( traceSchLegacyPlugin, "Loading symbol \"%s\" from legacy symbol file \"%s\"",
+                aName, m_fileName );
+
+    // The range of an alias is the definition of its symbol, which creates all of the
+    // aliases.  m_fileName is the file the index was built from, m_libFileName may be a
+    // new name the library is about to be saved to.
+    STRING_LINE_READER reader( SYMBOL_LIB_INDEX::ReadSymbolText( m_fileName, *entry ),
+                               m_fileName );
+    LIB_PART_MAP       parts;
+
+    reader.ReadLine();
+
+    LIB_PART* part = LoadPart( reader, m_versionMajor, m_versionMinor, &parts );
+
+    parts[ part->GetName() ] = part;
+
+    for( const std::pair<const wxString, LIB_PART*>& pair : parts )
+    {
+        // The document file is not read again, its contents are kept in the index.
+        const SYMBOL_LIB_INDEX_ENTRY* docs = m_index.Find( pair.first );
+
+        if( docs && USE_OLD_DOC_FILE_FORMAT( m_versionMajor, m_versionMinor ) )
+        {
+            if( !docs->m_Description.IsEmpty() )
+                pair.second->SetDescription( docs->m_Description );
+
+            if( !docs->m_Keywords.IsEmpty() )
+                pair.second->SetKeyWords( docs->m_Keywords );
+
+            if( !docs->m_Datasheet.IsEmpty() )
+                pair.second->GetField( DATASHEET )->SetText( docs->m_Datasheet );
+        }
+
+        m_symbols[ pair.first ] = pair.second;
+    }
+
+    it = m_symbols.find( aName );
+
+    return it != m_symbols.end() ? it->second : nullptr;
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::loadAllSymbols()
+{
+    if( m_index.IsEmpty() )
+        return;
+
+    for( const auto& pair : m_index.GetEntries() )
+        GetSymbol( pair.first );
+
+    // Every symbol is in m_symbols now, and may be modified or removed there.
+    m_index.Clear();
 }
 
 
@@ -2651,7 +2831,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
     wxString    text;
     wxString    aliasName;
     wxFileName  fn = m_libFileName;
-    LIB_PART*   symbol = NULL;;
+    SYMBOL_LIB_INDEX_ENTRY* symbol = NULL;
 
     fn.SetExt( DOC_EXT );
 
@@ -2688,14 +2868,13 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
         aliasName.Trim();
         aliasName = LIB_ID::FixIllegalChars( aliasName, LIB_ID::ID_SCH );
 
-        LIB_PART_MAP::iterator it = m_symbols.find( aliasName );
+        // The documentation is applied to the symbols when they are parsed.
+        symbol = m_index.Find( aliasName );
 
-        if( it == m_symbols.end() )
+        if( !symbol )
             wxLogWarning( "Symbol '%s' not found in library:\n\n"
                           "'%s'\n\nat line %d offset %d", aliasName, fn.GetFullPath(),
                           reader.LineNumber(), (int) (line - reader.Line() ) );
-        else
-            symbol = it->second;
 
         // Read the curent alias associated doc.
         // if the alias does not exist, just skip the description
@@ -2718,17 +2897,17 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
             {
             case 'D':
                 if( symbol )
-                    symbol->SetDescription( text );
+                    symbol->m_Description = text;
                 break;
 
             case 'K':
                 if( symbol )
-                    symbol->SetKeyWords( text );
+                    symbol->m_Keywords = text;
                 break;
 
             case 'F':
                 if( symbol )
-                    symbol->GetField( DATASHEET )->SetText( text );
+                    symbol->m_Datasheet = text;
                 break;
 
             case 0:
@@ -2746,28 +2925,6 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
 }
 
 
-void SCH_LEGACY_PLUGIN_CACHE::loadHeader( FILE_LINE_READER& aReader )
-{
-    const char* line = aReader.Line();
-
-    wxASSERT( strCompare( "$HEADER", line, &line ) );
-
-    while( aReader.ReadLine() )
-    {
-        line = (char*) aReader;
-
-        // The time stamp saved in old library files is not used or saved in the latest
-        // library file version.
-        if( strCompare( "TimeStamp", line, &line ) )
-            continue;
-        else if( strCompare( "$ENDHEADER", line, &line ) )
-            return;
-    }
-
-    SCH_PARSE_ERROR( "$ENDHEADER not found", aReader, line );
-}
-
-
 LIB_PART* SCH_LEGACY_PLUGIN_CACHE::LoadPart( LINE_READER& aReader, int aMajorVersion,
                                              int aMinorVersion, LIB_PART_MAP* aMap )
 {
@@ -3761,6 +3918,8 @@ void SCH_LEGACY_PLUGIN_CACHE::Save( bool aSaveDocFile )
     if( !m_isModified )
         return;
 
+    loadAllSymbols();
+
     // Write through symlinks, don't replace them
     wxFileName fn = GetRealFile();
 
@@ -4290,6 +4449,8 @@ void SCH_LEGACY_PLUGIN_CACHE::saveDocFile()
 
 void SCH_LEGACY_PLUGIN_CACHE::DeleteSymbol( const wxString& aSymbolName )
 {
+    loadAllSymbols();
+
     LIB_PART_MAP::iterator it = m_symbols.find( aSymbolName );
 
     if( it == m_symbols.end() )
@@ -4392,6 +4553,18 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( wxArrayString&    aSymbolNameList,
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
     cacheLib( aLibraryPath );
 
+    // Symbols not parsed yet are only in the index, until it is cleared by loading them all.
+    if( !m_cache->m_index.IsEmpty() )
+    {
+        for( const auto& pair : m_cache->m_index.GetEntries() )
+        {
+            if( !powerSymbolsOnly || pair.second.m_IsPower )
+                aSymbolNameList.Add( pair.first );
+        }
+
+        return;
+    }
+
     const LIB_PART_MAP& symbols = m_cache->m_symbols;
 
     for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
@@ -4414,6 +4587,8 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
     cacheLib( aLibraryPath );
 
+    m_cache->loadAllSymbols();
+
     const LIB_PART_MAP& symbols = m_cache->m_symbols;
 
     for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
@@ -4424,6 +4599,39 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
 }
 
 
+void SCH_LEGACY_PLUGIN::EnumerateSymbolInfo( std::vector<LIB_SYMBOL_INFO>& aSymbolList,
+                                             const wxString&   aLibraryPath,
+                                             const PROPERTIES* aProperties )
+{
+    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
+
+    m_props = aProperties;
+
+    bool powerSymbolsOnly = ( aProperties &&
+                              aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
+    cacheLib( aLibraryPath );
+
+    if( !m_cache->m_index.IsEmpty() )
+    {
+        for( const auto& pair : m_cache->m_index.GetEntries() )
+        {
+            if( !powerSymbolsOnly || pair.second.m_IsPower )
+                aSymbolList.emplace_back( pair.second );
+        }
+
+        return;
+    }
+
+    const LIB_PART_MAP& symbols = m_cache->m_symbols;
+
+    for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
+    {
+        if( !powerSymbolsOnly || it->second->IsPower() )
+            aSymbolList.emplace_back( it->second );
+    }
+}
+
+
 LIB_PART* SCH_LEGACY_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxString& aSymbolName,
                                          const PROPERTIES* aProperties )
 {
@@ -4433,12 +4641,7 @@ LIB_PART* SCH_LEGACY_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxS
 
     cacheLib( aLibraryPath );
 
-    LIB_PART_MAP::const_iterator it = m_cache->m_symbols.find( aSymbolName );
-
-    if( it == m_cache->m_symbols.end() )
-        return nullptr;
-
-    return it->second;
+    return m_cache->GetSymbol( aSymbolName );
 }
 
 
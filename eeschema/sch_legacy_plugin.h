@@ -117,6 +117,9 @@ public:
     void EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
                              const wxString&   aLibraryPath,
                              const PROPERTIES* aProperties = nullptr ) override;
+    void EnumerateSymbolInfo( std::vector<LIB_SYMBOL_INFO>& aSymbolList,
+                              const wxString&   aLibraryPath,
+                              const PROPERTIES* aProperties = nullptr ) override;
     LIB_PART* LoadSymbol( const wxString& aLibraryPath, const wxString& aAliasName,
                            const PROPERTIES* aProperties = nullptr ) override;
     void SaveSymbol( const wxString& aLibraryPath, const LIB_PART* aSymbol,
@@ -516,7 +516,7 @@ void SCH_LINE::GetEndPoints( std::vector <DANGLING_END_ITEM>& aItemList )
 }
 
 
-bool SCH_LINE::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList,
+bool SCH_LINE::UpdateDanglingState( const DANGLING_END_INDEX& aEnds,
                                     const SCH_SHEET_PATH* aPath )
 {
     bool previousStartState = m_startIsDangling;
@@ -526,25 +526,29 @@ bool SCH_LINE::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList,
 
     if( GetLayer() == LAYER_WIRE )
     {
-        for( DANGLING_END_ITEM item : aItemList )
-        {
-            if( item.GetItem() == this )
-                continue;
+        auto isConnectedAt =
+                [&]( const wxPoint& aPos ) -> bool
+                {
+                    for( size_t ii : aEnds.GetEndsAt( aPos ) )
+                    {
+                        const DANGLING_END_ITEM& item = aEnds.GetItem( ii );
 
-            if(     item.GetType() == BUS_START_END ||
-                    item.GetType() == BUS_END_END  ||
-                    item.GetType() == BUS_ENTRY_END )
-                continue;
+                        if( item.GetItem() == this )
+                            continue;
 
-            if( m_start == item.GetPosition() )
-                m_startIsDangling = false;
+                        if(     item.GetType() == BUS_START_END ||
+                                item.GetType() == BUS_END_END  ||
+                                item.GetType() == BUS_ENTRY_END )
+                            continue;
 
-            if( m_end == item.GetPosition() )
-                m_endIsDangling = false;
+                        return true;
+                    }
 
-            if( !m_startIsDangling && !m_endIsDangling )
-                break;
-        }
+                    return false;
+                };
+
+        m_startIsDangling = !isConnectedAt( m_start );
+        m_endIsDangling = !isConnectedAt( m_end );
     }
     else if( GetLayer() == LAYER_BUS || IsGraphicLine() )
     {
@@ -23,6 +23,7 @@
 #include <properties.h>
 
 #include <sch_io_mgr.h>
+#include <symbol_lib_index.h>
 
 #define FMT_UNIMPLEMENTED   _( "Plugin \"%s\" does not implement the \"%s\" function." )
 
@@ -81,6 +82,19 @@ void SCH_PLUGIN::EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
 }
 
 
+void SCH_PLUGIN::EnumerateSymbolInfo( std::vector<LIB_SYMBOL_INFO>& aSymbolList,
+                                      const wxString&   aLibraryPath,
+                                      const PROPERTIES* aProperties )
+{
+    std::vector<LIB_PART*> symbols;
+
+    EnumerateSymbolLib( symbols, aLibraryPath, aProperties );
+
+    for( LIB_PART* symbol : symbols )
+        aSymbolList.emplace_back( symbol );
+}
+
+
 LIB_PART* SCH_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxString& aSymbolName,
                                   const PROPERTIES* aProperties )
 {
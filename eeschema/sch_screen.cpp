@@ -57,11 +57,11 @@
 #include <sch_text.h>
 #include <schematic.h>
 #include <symbol_lib_table.h>
+#include <thread_pool.h>
 #include <tool/common_tools.h>
 
-#include <thread>
 #include <algorithm>
-#include <future>
+#include <numeric>
 
 // TODO(JE) Debugging only
 #include <profile.h>
@@ -243,6 +243,7 @@ void SCH_SCREEN::Append( SCH_ITEM* aItem )
         }
 
         m_rtree.insert( aItem );
+        m_danglingEndsAppended.insert( aItem );
         --m_modification_sync;
     }
 }
@@ -271,6 +272,8 @@ void SCH_SCREEN::Clear( bool aFree )
     else
     {
         m_rtree.clear();
+        m_danglingEnds.Clear();
+        m_danglingEndsAppended.clear();
     }
 
     // Clear the project settings
@@ -293,6 +296,8 @@ void SCH_SCREEN::FreeDrawList()
             } );
 
     m_rtree.clear();
+    m_danglingEnds.Clear();
+    m_danglingEndsAppended.clear();
 
     for( auto item : delete_list )
         delete item;
@@ -310,6 +315,8 @@ bool SCH_SCREEN::Remove( SCH_ITEM* aItem )
 {
     bool retv = m_rtree.remove( aItem );
 
+    m_danglingEndsAppended.erase( aItem );
+
     // Check if the library symbol for the removed schematic symbol is still required.
     if( retv && aItem->Type() == SCH_COMPONENT_T )
     {
@@ -1055,7 +1062,8 @@ void SCH_SCREEN::GetSheets( std::vector<SCH_ITEM*>* aItems )
 }
 
 
-bool SCH_SCREEN::TestDanglingEnds( const SCH_SHEET_PATH* aPath )
+bool SCH_SCREEN::TestDanglingEnds( const SCH_SHEET_PATH* aPath,
+                                   std::function<void( SCH_ITEM* )>* aChangedHandler )
 {
     std::vector< DANGLING_END_ITEM > endPoints;
     bool hasStateChanged = false;
@@ -1063,10 +1071,166 @@ bool SCH_SCREEN::TestDanglingEnds( const SCH_SHEET_PATH* aPath )
     for( SCH_ITEM* item : Items() )
         item->GetEndPoints( endPoints );
 
+    m_danglingEnds.Build( std::move( endPoints ) );
+    m_danglingEndsAppended.clear();
+
+    for( SCH_ITEM* item : Items() )
+    {
+        if( item->UpdateDanglingState( m_danglingEnds, aPath ) )
+        {
+            hasStateChanged = true;
+
+            if( aChangedHandler )
+                ( *aChangedHandler )( item );
+        }
+    }
+
+    return hasStateChanged;
+}
+
+
+/**
+ * Strict weak ordering of all the fields of a DANGLING_END_ITEM, to compare the connection
+ * points of two dangling end tests.
+ */
+static bool danglingEndLess( const DANGLING_END_ITEM& aA, const DANGLING_END_ITEM& aB )
+{
+    if( aA.GetPosition().x != aB.GetPosition().x )
+        return aA.GetPosition().x < aB.GetPosition().x;
+
+    if( aA.GetPosition().y != aB.GetPosition().y )
+        return aA.GetPosition().y < aB.GetPosition().y;
+
+    if( aA.GetItem() != aB.GetItem() )
+        return std::less<const EDA_ITEM*>()( aA.GetItem(), aB.GetItem() );
+
+    if( aA.GetType() != aB.GetType() )
+        return aA.GetType() < aB.GetType();
+
+    return std::less<const EDA_ITEM*>()( aA.GetParent(), aB.GetParent() );
+}
+
+
+bool SCH_SCREEN::UpdateDanglingEnds( std::function<void( SCH_ITEM* )>* aChangedHandler )
+{
+    if( m_danglingEnds.GetItems().empty() )
+        return TestDanglingEnds( nullptr, aChangedHandler );
+
+    std::vector< DANGLING_END_ITEM > endPoints;
+
     for( SCH_ITEM* item : Items() )
+        item->GetEndPoints( endPoints );
+
+    DANGLING_END_INDEX previous = std::move( m_danglingEnds );
+    m_danglingEnds.Build( std::move( endPoints ) );
+
+    auto sortedEnds =
+            []( const DANGLING_END_INDEX& aIndex ) -> std::vector<size_t>
+            {
+                std::vector<size_t> order( aIndex.GetItems().size() );
+
+                std::iota( order.begin(), order.end(), 0 );
+                std::sort( order.begin(), order.end(),
+                        [&]( size_t a, size_t b )
+                        {
+                            return danglingEndLess( aIndex.GetItem( a ), aIndex.GetItem( b ) );
+                        } );
+
+                return order;
+            };
+
+    // Moving, adding or removing a wire or bus end changes the whole segment, which labels
+    // and bus entries can connect to anywhere.
+    std::vector<EDA_RECT> dirtyAreas;
+
+    auto addDirtyArea =
+            [&]( const DANGLING_END_INDEX& aIndex, size_t aEnd )
+            {
+                EDA_RECT area( aIndex.GetItem( aEnd ).GetPosition(), wxSize( 0, 0 ) );
+
+                if( aIndex.IsSegmentStart( aEnd ) )
+                    area.Merge( aIndex.GetItem( aEnd + 1 ).GetPosition() );
+                else if( aEnd > 0 && aIndex.IsSegmentStart( aEnd - 1 ) )
+                    area.Merge( aIndex.GetItem( aEnd - 1 ).GetPosition() );
+
+                dirtyAreas.push_back( area.Inflate( 1 ) );
+            };
+
+    std::vector<size_t> previousOrder = sortedEnds( previous );
+    std::vector<size_t> currentOrder = sortedEnds( m_danglingEnds );
+    size_t              ii = 0;
+    size_t              jj = 0;
+
+    while( ii < previousOrder.size() || jj < currentOrder.size() )
+    {
+        if( jj == currentOrder.size()
+                || ( ii < previousOrder.size()
+                     && danglingEndLess( previous.GetItem( previousOrder[ii] ),
+                                         m_danglingEnds.GetItem( currentOrder[jj] ) ) ) )
+        {
+            addDirtyArea( previous, previousOrder[ii++] );
+        }
+        else if( ii == previousOrder.size()
+                || danglingEndLess( m_danglingEnds.GetItem( currentOrder[jj] ),
+                                    previous.GetItem( previousOrder[ii] ) ) )
+        {
+            addDirtyArea( m_danglingEnds, currentOrder[jj++] );
+        }
+        else
+        {
+            ++ii;
+            ++jj;
+        }
+    }
+
+    // The item a connection point of the current test belongs to.  Symbol pins and sheet pins
+    // are tested through their parent.
+    auto endOwner =
+            []( const DANGLING_END_ITEM& aEnd ) -> SCH_ITEM*
+            {
+                if( aEnd.GetType() == PIN_END )
+                    return static_cast<SCH_ITEM*>( const_cast<EDA_ITEM*>( aEnd.GetParent() ) );
+                else if( aEnd.GetType() == SHEET_LABEL_END )
+                    return static_cast<SCH_ITEM*>( aEnd.GetItem()->GetParent() );
+                else
+                    return static_cast<SCH_ITEM*>( aEnd.GetItem() );
+            };
+
+    // Appended items may reuse the address of a removed item at the same position, so their
+    // neighbours are always retested.
+    std::unordered_set<SCH_ITEM*> retest( m_danglingEndsAppended.begin(),
+                                          m_danglingEndsAppended.end() );
+
+    if( !m_danglingEndsAppended.empty() )
+    {
+        for( size_t end = 0; end < m_danglingEnds.GetItems().size(); ++end )
+        {
+            if( m_danglingEndsAppended.count( endOwner( m_danglingEnds.GetItem( end ) ) ) )
+                addDirtyArea( m_danglingEnds, end );
+        }
+    }
+
+    std::vector<size_t> dirtyEnds;
+
+    for( const EDA_RECT& area : dirtyAreas )
+        m_danglingEnds.GetEndsInside( area, dirtyEnds );
+
+    for( size_t end : dirtyEnds )
+        retest.insert( endOwner( m_danglingEnds.GetItem( end ) ) );
+
+    m_danglingEndsAppended.clear();
+
+    bool hasStateChanged = false;
+
+    for( SCH_ITEM* item : retest )
     {
-        if( item->UpdateDanglingState( endPoints, aPath ) )
+        if( item->UpdateDanglingState( m_danglingEnds ) )
+        {
             hasStateChanged = true;
+
+            if( aChangedHandler )
+                ( *aChangedHandler )( item );
+        }
     }
 
     return hasStateChanged;
@@ -1457,11 +1621,10 @@ void SCH_SCREENS::TestDanglingEnds()
     for( SCH_SCREEN* screen = GetFirst(); screen; screen = GetNext() )
         screens.push_back( screen );
 
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+    size_t parallelThreadCount = std::min<size_t>( THREAD_POOL::GetInstance().GetThreadCount(),
             screens.size() );
 
     std::atomic<size_t> nextScreen( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
 
     auto update_lambda = [&screens, &nextScreen]() -> size_t
     {
@@ -1471,16 +1634,17 @@ void SCH_SCREENS::TestDanglingEnds()
         return 1;
     };
 
-    if( parallelThreadCount == 1 )
+    if( parallelThreadCount <= 1 )
         update_lambda();
     else
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
+        TASK_GROUP tasks;
 
-        // Finalize the threads
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
+            tasks.Run( update_lambda );
+
+        // Finalize the tasks
+        tasks.Wait();
     }
 }
 
@@ -25,6 +25,7 @@
 #ifndef SCREEN_H
 #define SCREEN_H
 
+#include <functional>
 #include <memory>
 #include <stddef.h>
 #include <unordered_set>
@@ -123,6 +124,12 @@ private:
     /// List of bus aliases stored in this screen
     std::unordered_set< std::shared_ptr< BUS_ALIAS > > m_aliases;
 
+    /// Connection points found by the last dangling end test, to find what changed since.
+    DANGLING_END_INDEX m_danglingEnds;
+
+    /// Items appended since the last dangling end test.
+    std::unordered_set<SCH_ITEM*> m_danglingEndsAppended;
+
     /// Library symbols required for this schematic.
     std::map<wxString, LIB_PART*> m_libSymbols;
 
@@ -331,9 +338,23 @@ public:
     /**
      * Test all of the connectable objects in the schematic for unused connection points.
      * @param aPath is a sheet path to pass to UpdateDanglingState if desired
+     * @param aChangedHandler is called with each item whose state changed, if not null
+     * @return True if any connection state changes were made.
+     */
+    bool TestDanglingEnds( const SCH_SHEET_PATH* aPath = nullptr,
+                           std::function<void( SCH_ITEM* )>* aChangedHandler = nullptr );
+
+    /**
+     * Test the connectable objects for unused connection points, like TestDanglingEnds(),
+     * but only the items near the connection points which were added, moved or removed
+     * since the last test, and the items appended to the screen since then.
+     *
+     * Falls back to a full test when the screen has not been tested yet.
+     *
+     * @param aChangedHandler is called with each item whose state changed, if not null
      * @return True if any connection state changes were made.
      */
-    bool TestDanglingEnds( const SCH_SHEET_PATH* aPath = nullptr );
+    bool UpdateDanglingEnds( std::function<void( SCH_ITEM* )>* aChangedHandler = nullptr );
 
     /**
      * Return all wires and junctions connected to \a aSegment which are not connected any
@@ -32,6 +32,7 @@
 #include <wx/tokenzr.h>
 
 #include <common.h>
+#include <kicad_string.h>
 #include <lib_id.h>
 #include <plotter.h>
 
@@ -53,6 +54,7 @@
 #include <sch_no_connect.h>
 #include <sch_screen.h>
 #include <sch_sexpr_parser.h>
+#include <symbol_lib_index.h>
 #include <template_fieldnames.h>
 
 
@@ -105,6 +107,174 @@ void SCH_SEXPR_PARSER::ParseLib( LIB_PART_MAP& aSymbolLibMap )
 }
 
 
+void SCH_SEXPR_PARSER::ParseLibIndex( SYMBOL_LIB_INDEX& aIndex )
+{
+    const MAPPED_FILE_LINE_READER* file = dynamic_cast<const MAPPED_FILE_LINE_READER*>( reader );
+
+    wxCHECK_RET( file, "Symbol library indices can only be built from mapped files." );
+
+    // The lines read from a mapped file point into the mapping.
+    auto tokenOffset =
+            [&]() -> size_t
+            {
+                return static_cast<size_t>( start - file->Data() ) + curOffset;
+            };
+
+    T token;
+
+    NeedLEFT();
+    NextTok();
+    parseHeader( T_kicad_symbol_lib, SEXPR_SYMBOL_LIB_FILE_VERSION );
+
+    aIndex.Clear();
+    aIndex.SetVersion( m_requiredVersion );
+
+    for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
+    {
+        if( token != T_LEFT )
+            Expecting( T_LEFT );
+
+        SYMBOL_LIB_INDEX_ENTRY entry;
+
+        entry.m_Offset = tokenOffset();
+
+        token = NextTok();
+
+        if( token != T_symbol )
+            Expecting( "symbol" );
+
+        parseIndexEntry( entry );
+
+        entry.m_Length = tokenOffset() + 1 - entry.m_Offset;
+        aIndex.Add( entry );
+    }
+
+    aIndex.ResolveParents();
+}
+
+
+void SCH_SEXPR_PARSER::parseIndexEntry( SYMBOL_LIB_INDEX_ENTRY& aEntry )
+{
+    wxCHECK_RET( CurTok() == T_symbol,
+                 wxT( "Cannot parse " ) + GetTokenString( CurTok() ) + wxT( " as a symbol." ) );
+
+    T           token;
+    long        unit;
+    wxString    error;
+    std::string skipped;
+
+    token = NextTok();
+
+    if( !IsSymbol( token ) )
+    {
+        error.Printf( _( "Invalid symbol name in\nfile: \"%s\"\nline: %d\noffset: %d" ),
+                      CurSource().c_str(), CurLineNumber(), CurOffset() );
+        THROW_IO_ERROR( error );
+    }
+
+    LIB_ID id;
+
+    if( id.Parse( FromUTF8(), LIB_ID::ID_SCH ) >= 0 )
+    {
+        error.Printf( _( "Invalid library identifier in\nfile: \"%s\"\nline: %d\noffset: %d" ),
+                      CurSource().c_str(), CurLineNumber(), CurOffset() );
+        THROW_IO_ERROR( error );
+    }
+
+    // Same as LIB_PART::SetName()
+    aEntry.m_Name = LIB_ID::FixIllegalChars( id.GetLibItemName(), LIB_ID::ID_SCH );
+
+    for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
+    {
+        if( token != T_LEFT )
+            Expecting( T_LEFT );
+
+        token = NextTok();
+
+        switch( token )
+        {
+        case T_power:
+            aEntry.m_IsPower = true;
+            NeedRIGHT();
+            break;
+
+        case T_extends:
+            NeedSYMBOL();
+            aEntry.m_Parent = FromUTF8();
+            NeedRIGHT();
+            break;
+
+        case T_property:
+            parseIndexProperty( aEntry );
+            break;
+
+        case T_symbol:
+            // Units are named "<symbol>_<unit>_<convert>".  Bad names are reported when the
+            // symbol is parsed.
+            NeedSYMBOL();
+
+            if( FromUTF8().BeforeLast( '_' ).AfterLast( '_' ).ToLong( &unit )
+                    && unit > aEntry.m_UnitCount )
+            {
+                aEntry.m_UnitCount = static_cast<int>( unit );
+            }
+
+            ReadBlockText( skipped );
+            skipped.clear();
+            break;
+
+        default:
+            ReadBlockText( skipped );
+            skipped.clear();
+        }
+    }
+}
+
+
+void SCH_SEXPR_PARSER::parseIndexProperty( SYMBOL_LIB_INDEX_ENTRY& aEntry )
+{
+    wxCHECK_RET( CurTok() == T_property,
+                 wxT( "Cannot parse " ) + GetTokenString( CurTok() ) +
+                 wxT( " as a property token." ) );
+
+    wxString    name;
+    wxString    value;
+    std::string skipped;
+    int         id = MANDATORY_FIELDS;
+
+    NeedSYMBOL();
+    name = FromUTF8();
+    NeedSYMBOL();
+    value = FromUTF8();
+
+    for( T token = NextTok();  token != T_RIGHT;  token = NextTok() )
+    {
+        if( token != T_LEFT )
+            Expecting( T_LEFT );
+
+        if( NextTok() == T_id )
+        {
+            id = parseInt( "field ID" );
+            NeedRIGHT();
+        }
+        else
+        {
+            ReadBlockText( skipped );
+            skipped.clear();
+        }
+    }
+
+    if( id == FOOTPRINT )
+        aEntry.m_Footprint = value;
+    else if( id < MANDATORY_FIELDS )
+        return;
+    else if( name == "ki_keywords" )
+        aEntry.m_Keywords = value;
+    else if( name == "ki_description" )
+        aEntry.m_Description = value;
+}
+
+
 LIB_PART* SCH_SEXPR_PARSER::ParseSymbol( LIB_PART_MAP& aSymbolLibMap, int aFileVersion )
 {
     wxCHECK_MSG( CurTok() == T_symbol, nullptr,
@@ -371,11 +541,11 @@ LIB_ITEM* SCH_SEXPR_PARSER::ParseDrawItem()
 
 double SCH_SEXPR_PARSER::parseDouble()
 {
-    char* tmp;
+    const char* tmp;
 
     errno = 0;
 
-    double fval = strtod( CurText(), &tmp );
+    double fval = StrToDouble( CurText(), &tmp );
 
     if( errno )
     {
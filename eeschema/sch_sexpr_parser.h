@@ -59,6 +59,8 @@ class SCH_SCREEN;
 class SCH_SHEET;
 class SCH_SHEET_PIN;
 class SCH_TEXT;
+class SYMBOL_LIB_INDEX;
+struct SYMBOL_LIB_INDEX_ENTRY;
 class TITLE_BLOCK;
 
 
@@ -218,11 +220,24 @@ class SCH_SEXPR_PARSER : public SCHEMATIC_LEXER
     SCH_TEXT* parseSchText();
     void parseBusAlias( SCH_SCREEN* aScreen );
 
+    void parseIndexEntry( SYMBOL_LIB_INDEX_ENTRY& aEntry );
+    void parseIndexProperty( SYMBOL_LIB_INDEX_ENTRY& aEntry );
+
 public:
     SCH_SEXPR_PARSER( LINE_READER* aLineReader = nullptr );
 
     void ParseLib( LIB_PART_MAP& aSymbolLibMap );
 
+    /**
+     * Index the symbols of the library file mapped by the internal #MAPPED_FILE_LINE_READER
+     * into \a aIndex.
+     *
+     * Only the symbol names, the properties shown by the symbol chooser and the unit counts
+     * are parsed, everything else is skipped.  The symbols can then be parsed individually
+     * with #ParseSymbol() from the byte ranges stored in the index.
+     */
+    void ParseLibIndex( SYMBOL_LIB_INDEX& aIndex );
+
     LIB_PART* ParseSymbol( LIB_PART_MAP& aSymbolLibMap,
                            int aFileVersion = SEXPR_SYMBOL_LIB_FILE_VERSION );
 
@@ -20,6 +20,7 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <boost/algorithm/string/join.hpp>
 #include <cctype>
 
@@ -76,6 +77,7 @@
 #include <schematic_lexer.h>
 #include <sch_reference_list.h>
 #include <sch_sexpr_parser.h>
+#include <symbol_lib_index.h>
 #include <symbol_lib_table.h>  // for PropPowerSymsOnly definintion.
 #include <confirm.h>
 #include <ee_selection.h>
@@ -319,12 +321,13 @@ static void formatStroke( OUTPUTFORMATTER* aFormatter, int aNestLevel, int aWidt
  */
 class SCH_SEXPR_PLUGIN_CACHE
 {
-    static int      m_modHash;      // Keep track of the modification status of the library.
+    static std::atomic<int> m_modHash; // Keep track of the modification status of the library.
 
     wxString        m_fileName;     // Absolute path and file name.
     wxFileName      m_libFileName;  // Absolute path and file name is required here.
     wxDateTime      m_fileModTime;
     LIB_PART_MAP    m_symbols;      // Map of names of #LIB_PART pointers.
+    SYMBOL_LIB_INDEX m_index;       // The symbols of the library file not parsed yet.
     bool            m_isWritable;
     bool            m_isModified;
     int             m_versionMajor;
@@ -334,6 +337,7 @@ class SCH_SEXPR_PLUGIN_CACHE
     static FILL_T   parseFillMode( LINE_READER& aReader, const char* aLine,
                                    const char** aOutput );
     LIB_PART*       removeSymbol( LIB_PART* aAlias );
+    void            loadAllSymbols();
 
     static void     saveSymbolDrawItem( LIB_ITEM* aItem, OUTPUTFORMATTER& aFormatter,
                                         int aNestLevel );
@@ -368,8 +372,16 @@ public:
     /// Save the entire library to file m_libFileName;
     void Save();
 
+    /// Index the library file, the symbols are parsed on demand by GetSymbol().
     void Load();
 
+    /**
+     * Return the symbol \a aName, parsing it if it was not used yet.
+     *
+     * @return the symbol or nullptr if the library has no such symbol.
+     */
+    LIB_PART* GetSymbol( const wxString& aName );
+
     void AddSymbol( const LIB_PART* aPart );
 
     void DeleteSymbol( const wxString& aName );
@@ -561,7 +573,7 @@ void SCH_SEXPR_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
 
 void SCH_SEXPR_PLUGIN::loadFile( const wxString& aFileName, SCH_SHEET* aSheet )
 {
-    FILE_LINE_READER reader( aFileName );
+    MAPPED_FILE_LINE_READER reader( aFileName );
 
     SCH_SEXPR_PARSER parser( &reader );
 
@@ -1229,7 +1241,7 @@ void SCH_SEXPR_PLUGIN::saveBusAlias( std::shared_ptr<BUS_ALIAS> aAlias, int aNes
 }
 
 
-int SCH_SEXPR_PLUGIN_CACHE::m_modHash = 1;     // starts at 1 and goes up
+std::atomic<int> SCH_SEXPR_PLUGIN_CACHE::m_modHash( 1 );     // starts at 1 and goes up
 
 
 SCH_SEXPR_PLUGIN_CACHE::SCH_SEXPR_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
@@ -1374,6 +1386,8 @@ LIB_PART* SCH_SEXPR_PLUGIN_CACHE::removeSymbol( LIB_PART* aPart )
 
 void SCH_SEXPR_PLUGIN_CACHE::AddSymbol( const LIB_PART* aPart )
 {
+    loadAllSymbols();
+
     // aPart is cloned in PART_LIB::AddPart().  The cache takes ownership of aPart.
     wxString name = aPart->GetName();
     LIB_PART_MAP::iterator it = m_symbols.find( name );
@@ -1404,11 +1418,19 @@ void SCH_SEXPR_PLUGIN_CACHE::Load()
     wxLogTrace( traceSchLegacyPlugin, "Loading sexpr symbol library file \"%s\"",
                 m_libFileName.GetFullPath() );
 
-    FILE_LINE_READER reader( m_libFileName.GetFullPath() );
+    // Take the stamp first, so that a file modified while it is indexed is indexed again.
+    wxString stamp = SYMBOL_LIB_INDEX::FileStamp( m_libFileName );
 
-    SCH_SEXPR_PARSER parser( &reader );
+    if( !m_index.ReadCache( m_libFileName.GetFullPath(), stamp ) )
+    {
+        MAPPED_FILE_LINE_READER reader( m_libFileName.GetFullPath() );
+
+        SCH_SEXPR_PARSER parser( &reader );
+
+        parser.ParseLibIndex( m_index );
+        m_index.WriteCache( m_libFileName.GetFullPath(), stamp );
+    }
 
-    parser.ParseLib( m_symbols );
     ++m_modHash;
 
     // Remember the file modification time of library file when the
@@ -1418,11 +1440,70 @@ void SCH_SEXPR_PLUGIN_CACHE::Load()
 }
 
 
+LIB_PART* SCH_SEXPR_PLUGIN_CACHE::GetSymbol( const wxString& aName )
+{
+    LIB_PART_MAP::iterator it = m_symbols.find( aName );
+
+    if( it != m_symbols.end() )
+        return it->second;
+
+    const SYMBOL_LIB_INDEX_ENTRY* entry = m_index.Find( aName );
+
+    if( !entry )
+        return nullptr;
+
+    // Derived symbols are parsed after the symbol they extend, as they are in the file.
+    // Symbols cannot extend derived symbols, so this does not recurse any further.
+    if( !entry->m_Parent.IsEmpty() && entry->m_Parent != aName )
+    {
+        const SYMBOL_LIB_INDEX_ENTRY* parent = m_index.Find( entry->m_Parent );
+
+        if( parent && parent->m_Parent.IsEmpty() )
+            GetSymbol( entry->m_Parent );
+    }
+
+    wxLogTrace( traceSchLegacyPlugin, "Loading symbol \"%s\" from sexpr library file \"%s\"",
+                aName, m_fileName );
+
+    // m_fileName is the file the index was built from, m_libFileName may be a new name
+    // the library is about to be saved to.
+    STRING_LINE_READER reader( SYMBOL_LIB_INDEX::ReadSymbolText( m_fileName, *entry ),
+                               m_fileName );
+    SCH_SEXPR_PARSER   parser( &reader );
+
+    parser.NeedLEFT();
+    parser.NextTok();
+
+    LIB_PART* symbol = parser.ParseSymbol( m_symbols, m_index.GetVersionMajor() );
+
+    wxASSERT( symbol->GetName() == aName );
+
+    m_symbols[ symbol->GetName() ] = symbol;
+
+    return symbol;
+}
+
+
+void SCH_SEXPR_PLUGIN_CACHE::loadAllSymbols()
+{
+    if( m_index.IsEmpty() )
+        return;
+
+    for( const auto& pair : m_index.GetEntries() )
+        GetSymbol( pair.first );
+
+    // Every symbol is in m_symbols now, and may be modified or removed there.
+    m_index.Clear();
+}
+
+
 void SCH_SEXPR_PLUGIN_CACHE::Save()
 {
     if( !m_isModified )
         return;
 
+    loadAllSymbols();
+
     LOCALE_IO   toggle;     // toggles on, then off, the C locale.
 
     // Write through symlinks, don't replace them.
@@ -1918,6 +1999,8 @@ void SCH_SEXPR_PLUGIN_CACHE::saveText( LIB_TEXT* aText,
 
 void SCH_SEXPR_PLUGIN_CACHE::DeleteSymbol( const wxString& aSymbolName )
 {
+    loadAllSymbols();
+
     LIB_PART_MAP::iterator it = m_symbols.find( aSymbolName );
 
     if( it == m_symbols.end() )
@@ -2009,6 +2092,18 @@ void SCH_SEXPR_PLUGIN::EnumerateSymbolLib( wxArrayString&    aSymbolNameList,
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
     cacheLib( aLibraryPath );
 
+    // Symbols not parsed yet are only in the index, until it is cleared by loading them all.
+    if( !m_cache->m_index.IsEmpty() )
+    {
+        for( const auto& pair : m_cache->m_index.GetEntries() )
+        {
+            if( !powerSymbolsOnly || pair.second.m_IsPower )
+                aSymbolNameList.Add( pair.first );
+        }
+
+        return;
+    }
+
     const LIB_PART_MAP& symbols = m_cache->m_symbols;
 
     for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
@@ -2031,6 +2126,8 @@ void SCH_SEXPR_PLUGIN::EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
     cacheLib( aLibraryPath );
 
+    m_cache->loadAllSymbols();
+
     const LIB_PART_MAP& symbols = m_cache->m_symbols;
 
     for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
@@ -2041,6 +2138,39 @@ void SCH_SEXPR_PLUGIN::EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
 }
 
 
+void SCH_SEXPR_PLUGIN::EnumerateSymbolInfo( std::vector<LIB_SYMBOL_INFO>& aSymbolList,
+                                            const wxString&   aLibraryPath,
+                                            const PROPERTIES* aProperties )
+{
+    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
+
+    m_props = aProperties;
+
+    bool powerSymbolsOnly = ( aProperties &&
+                              aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
+    cacheLib( aLibraryPath );
+
+    if( !m_cache->m_index.IsEmpty() )
+    {
+        for( const auto& pair : m_cache->m_index.GetEntries() )
+        {
+            if( !powerSymbolsOnly || pair.second.m_IsPower )
+                aSymbolList.emplace_back( pair.second );
+        }
+
+        return;
+    }
+
+    const LIB_PART_MAP& symbols = m_cache->m_symbols;
+
+    for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
+    {
+        if( !powerSymbolsOnly || it->second->IsPower() )
+            aSymbolList.emplace_back( it->second );
+    }
+}
+
+
 LIB_PART* SCH_SEXPR_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxString& aSymbolName,
                                         const PROPERTIES* aProperties )
 {
@@ -2050,12 +2180,7 @@ LIB_PART* SCH_SEXPR_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxSt
 
     cacheLib( aLibraryPath );
 
-    LIB_PART_MAP::const_iterator it = m_cache->m_symbols.find( aSymbolName );
-
-    if( it == m_cache->m_symbols.end() )
-        return nullptr;
-
-    return it->second;
+    return m_cache->GetSymbol( aSymbolName );
 }
 
 
@@ -843,13 +843,13 @@ void SCH_SHEET::GetEndPoints( std::vector <DANGLING_END_ITEM>& aItemList )
 }
 
 
-bool SCH_SHEET::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList,
+bool SCH_SHEET::UpdateDanglingState( const DANGLING_END_INDEX& aEnds,
                                      const SCH_SHEET_PATH* aPath )
 {
     bool changed = false;
 
     for( SCH_SHEET_PIN* sheetPin : m_pins )
-        changed |= sheetPin->UpdateDanglingState( aItemList );
+        changed |= sheetPin->UpdateDanglingState( aEnds );
 
     return changed;
 }
@@ -28,6 +28,8 @@
  * @brief Code for handling schematic texts (texts, labels, hlabels and global labels).
  */
 
+#include <limits>
+
 #include <fctsys.h>
 #include <gr_basic.h>
 #include <macros.h>
@@ -343,7 +345,7 @@ void SCH_TEXT::GetEndPoints( std::vector <DANGLING_END_ITEM>& aItemList )
 }
 
 
-bool SCH_TEXT::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList,
+bool SCH_TEXT::UpdateDanglingState( const DANGLING_END_INDEX& aEnds,
                                     const SCH_SHEET_PATH* aPath )
 {
     // Normal text labels cannot be tested for dangling ends.
@@ -354,9 +356,15 @@ bool SCH_TEXT::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList,
     m_isDangling       = true;
     m_connectionType   = CONNECTION_TYPE::NONE;
 
-    for( unsigned ii = 0; ii < aItemList.size(); ii++ )
+    // The label connects to the first item of the list found at its position, either another
+    // connection point or a wire or bus passing through it.
+    const size_t none = std::numeric_limits<size_t>::max();
+    size_t       firstEnd = none;
+    size_t       firstSegment = none;
+
+    for( size_t ii : aEnds.GetEndsAt( GetTextPos() ) )
     {
-        DANGLING_END_ITEM& item = aItemList[ii];
+        const DANGLING_END_ITEM& item = aEnds.GetItem( ii );
 
         if( item.GetItem() == this )
             continue;
@@ -367,59 +375,61 @@ bool SCH_TEXT::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList,
         case LABEL_END:
         case SHEET_LABEL_END:
         case NO_CONNECT_END:
-            if( GetTextPos() == item.GetPosition() )
-            {
-                m_isDangling = false;
+            firstEnd = ii;
+            break;
 
-                if( aPath && item.GetType() != PIN_END )
-                    m_connected_items[ *aPath ].insert( static_cast<SCH_ITEM*>( item.GetItem() ) );
-            }
+        default:
+            break;
+        }
 
+        if( firstEnd != none )
             break;
+    }
 
+    int accuracy = 1;   // We have rounding issues with an accuracy of 0
 
-        case BUS_START_END:
-            m_connectionType = CONNECTION_TYPE::BUS;
-            KI_FALLTHROUGH;
+    // These schematic items have created 2 DANGLING_END_ITEM one per end.
+    for( size_t ii : aEnds.GetSegmentsNear( GetTextPos() ) )
+    {
+        if( ii > firstEnd )
+            break;
 
-        case WIRE_START_END:
+        if( TestSegmentHit( GetTextPos(), aEnds.GetItem( ii ).GetPosition(),
+                            aEnds.GetItem( ii + 1 ).GetPosition(), accuracy ) )
         {
-            // These schematic items have created 2 DANGLING_END_ITEM one per end.  But being
-            // a paranoid programmer, I'll check just in case.
-            ii++;
-
-            wxCHECK_MSG( ii < aItemList.size(), previousState != m_isDangling,
-                         wxT( "Dangling end type list overflow.  Bad programmer!" ) );
+            firstSegment = ii;
+            break;
+        }
+    }
 
-            int accuracy = 1;   // We have rounding issues with an accuracy of 0
+    if( firstSegment != none )
+    {
+        const DANGLING_END_ITEM& item = aEnds.GetItem( firstSegment );
 
-            DANGLING_END_ITEM & nextItem = aItemList[ii];
-            m_isDangling = !TestSegmentHit( GetTextPos(), item.GetPosition(),
-                                            nextItem.GetPosition(), accuracy );
+        m_isDangling = false;
 
-            if( !m_isDangling )
-            {
-                if( m_connectionType != CONNECTION_TYPE::BUS )
-                    m_connectionType = CONNECTION_TYPE::NET;
+        if( item.GetType() == BUS_START_END )
+            m_connectionType = CONNECTION_TYPE::BUS;
+        else
+            m_connectionType = CONNECTION_TYPE::NET;
 
-                // Add the line to the connected items, since it won't be picked
-                // up by a search of intersecting connection points
-                if( aPath )
-                {
-                    auto sch_item = static_cast<SCH_ITEM*>( item.GetItem() );
-                    AddConnectionTo( *aPath, sch_item );
-                    sch_item->AddConnectionTo( *aPath, this );
-                }
-            }
+        // Add the line to the connected items, since it won't be picked
+        // up by a search of intersecting connection points
+        if( aPath )
+        {
+            auto sch_item = static_cast<SCH_ITEM*>( item.GetItem() );
+            AddConnectionTo( *aPath, sch_item );
+            sch_item->AddConnectionTo( *aPath, this );
         }
-            break;
+    }
+    else if( firstEnd != none )
+    {
+        const DANGLING_END_ITEM& item = aEnds.GetItem( firstEnd );
 
-        default:
-            break;
-        }
+        m_isDangling = false;
 
-        if( !m_isDangling )
-            break;
+        if( aPath && item.GetType() != PIN_END )
+            m_connected_items[ *aPath ].insert( static_cast<SCH_ITEM*>( item.GetItem() ) );
     }
 
     if( m_isDangling )
@@ -272,6 +272,10 @@ void SCH_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
         eda_item->ClearEditFlags();
         eda_item->ClearTempFlags();
 
+        // Connectivity may change
+        if( SCH_ITEM* sch_item = dynamic_cast<SCH_ITEM*>( eda_item ) )
+            sch_item->SetConnectivityDirty();
+
         if( status == UR_NEW )
         {
             // new items are deleted on undo
@@ -335,6 +339,7 @@ void SCH_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
                 aList->SetPickedItem( alt_item, (unsigned) ii );
                 aList->SetPickedItemLink( item, (unsigned) ii );
                 item = alt_item;
+                item->SetConnectivityDirty();
                 break;
 
             default:
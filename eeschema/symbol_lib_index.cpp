@@ -0,0 +1,300 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <functional>
+
+#include <nlohmann/json.hpp>
+
+#include <wx/ffile.h>
+#include <wx/log.h>
+#include <wx/stdpaths.h>
+
+#include <class_libentry.h>
+#include <ki_exception.h>
+#include <symbol_lib_index.h>
+
+
+/// Bump this when the cached index format changes.
+static const int SYMBOL_LIB_INDEX_CACHE_FORMAT = 1;
+
+
+static const wxChar traceSymbolLibIndex[] = wxT( "KICAD_SYMBOL_LIB_INDEX" );
+
+
+/**
+ * Return the name of the file caching the index of \a aLibraryPath.
+ *
+ * The caches are kept with the other per-user caches, named after a hash of the library
+ * path.  The path itself is stored in the cache to catch hash collisions.
+ */
+static wxFileName indexCacheFile( const wxString& aLibraryPath )
+{
+    wxFileName fn;
+
+#if defined( __WXMAC__ )
+    fn.AssignDir( wxGetHomeDir() );
+    fn.AppendDir( "Library" );
+    fn.AppendDir( "Caches" );
+    fn.AppendDir( "kicad" );
+#elif defined( __UNIX__ )
+    wxString envstr;
+
+    if( wxGetEnv( "XDG_CACHE_HOME", &envstr ) && !envstr.IsEmpty() )
+    {
+        fn.AssignDir( envstr );
+    }
+    else
+    {
+        fn.AssignDir( wxGetHomeDir() );
+        fn.AppendDir( ".cache" );
+    }
+
+    fn.AppendDir( "kicad" );
+#else
+    fn.AssignDir( wxStandardPaths::Get().GetUserLocalDataDir() );
+#endif
+
+    fn.AppendDir( "symbol-index" );
+
+    size_t hash = std::hash<std::string>()( std::string( aLibraryPath.ToUTF8() ) );
+
+    fn.SetName( wxString::Format( "%016llx", (unsigned long long) hash ) );
+    fn.SetExt( "json" );
+
+    return fn;
+}
+
+
+const SYMBOL_LIB_INDEX_ENTRY* SYMBOL_LIB_INDEX::Find( const wxString& aName ) const
+{
+    auto it = m_entries.find( aName );
+
+    return it == m_entries.end() ? nullptr : &it->second;
+}
+
+
+SYMBOL_LIB_INDEX_ENTRY* SYMBOL_LIB_INDEX::Find( const wxString& aName )
+{
+    auto it = m_entries.find( aName );
+
+    return it == m_entries.end() ? nullptr : &it->second;
+}
+
+
+void SYMBOL_LIB_INDEX::ResolveParents()
+{
+    for( auto& pair : m_entries )
+    {
+        SYMBOL_LIB_INDEX_ENTRY& entry = pair.second;
+
+        if( entry.m_Parent.IsEmpty() )
+            continue;
+
+        const SYMBOL_LIB_INDEX_ENTRY* parent = Find( entry.m_Parent );
+
+        if( parent )
+            entry.m_UnitCount = parent->m_UnitCount;
+    }
+}
+
+
+std::string SYMBOL_LIB_INDEX::ReadSymbolText( const wxString& aLibraryPath,
+                                              const SYMBOL_LIB_INDEX_ENTRY& aEntry )
+{
+    wxFFile     file( aLibraryPath, "rb" );
+    std::string text( aEntry.m_Length, '\0' );
+
+    if( !file.IsOpened()
+            || !file.Seek( static_cast<wxFileOffset>( aEntry.m_Offset ) )
+            || file.Read( &text[0], aEntry.m_Length ) != aEntry.m_Length )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Cannot read symbol \"%s\" from library \"%s\"." ),
+                                          aEntry.m_Name, aLibraryPath ) );
+    }
+
+    return text;
+}
+
+
+wxString SYMBOL_LIB_INDEX::FileStamp( const wxFileName& aFile )
+{
+    if( !aFile.FileExists() )
+        return wxT( "-" );
+
+    return aFile.GetSize().ToString() + wxT( ":" )
+           + aFile.GetModificationTime().GetValue().ToString();
+}
+
+
+bool SYMBOL_LIB_INDEX::ReadCache( const wxString& aLibraryPath, const wxString& aStamp )
+{
+    wxFileName fn = indexCacheFile( aLibraryPath );
+
+    if( !fn.FileExists() )
+        return false;
+
+    std::ifstream file( fn.GetFullPath().ToStdString() );
+
+    if( !file.is_open() )
+        return false;
+
+    Clear();
+
+    try
+    {
+        nlohmann::json js;
+        file >> js;
+
+        if( js.at( "format" ).get<int>() != SYMBOL_LIB_INDEX_CACHE_FORMAT
+                || js.at( "library" ).get<std::string>() != std::string( aLibraryPath.ToUTF8() )
+                || js.at( "stamp" ).get<std::string>() != std::string( aStamp.ToUTF8() ) )
+        {
+            return false;
+        }
+
+        auto fromUTF8 =
+                []( const nlohmann::json& aValue )
+                {
+                    return wxString::FromUTF8( aValue.get<std::string>().c_str() );
+                };
+
+        SetVersion( js.at( "version" )[0].get<int>(), js.at( "version" )[1].get<int>() );
+
+        for( const nlohmann::json& jentry : js.at( "symbols" ) )
+        {
+            SYMBOL_LIB_INDEX_ENTRY entry;
+
+            entry.m_Name = fromUTF8( jentry.at( "name" ) );
+            entry.m_Parent = fromUTF8( jentry.at( "parent" ) );
+            entry.m_Description = fromUTF8( jentry.at( "description" ) );
+            entry.m_Keywords = fromUTF8( jentry.at( "keywords" ) );
+            entry.m_Footprint = fromUTF8( jentry.at( "footprint" ) );
+            entry.m_Datasheet = fromUTF8( jentry.at( "datasheet" ) );
+            entry.m_UnitCount = jentry.at( "units" ).get<int>();
+            entry.m_IsPower = jentry.at( "power" ).get<bool>();
+            entry.m_Offset = jentry.at( "offset" ).get<size_t>();
+            entry.m_Length = jentry.at( "length" ).get<size_t>();
+
+            Add( entry );
+        }
+    }
+    catch( const std::exception& e )
+    {
+        wxLogTrace( traceSymbolLibIndex, "Ignoring symbol library index cache %s: %s",
+                    fn.GetFullPath(), e.what() );
+        Clear();
+        return false;
+    }
+
+    wxLogTrace( traceSymbolLibIndex, "Read index of \"%s\" from %s", aLibraryPath,
+                fn.GetFullPath() );
+
+    return true;
+}
+
+
+void SYMBOL_LIB_INDEX::WriteCache( const wxString& aLibraryPath, const wxString& aStamp ) const
+{
+    wxFileName fn = indexCacheFile( aLibraryPath );
+
+    // The libraries may be indexed by several threads, which race to create the directory.
+    if( !fn.DirExists() && !fn.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) && !fn.DirExists() )
+        return;
+
+    nlohmann::json js;
+
+    js[ "format" ] = SYMBOL_LIB_INDEX_CACHE_FORMAT;
+    js[ "library" ] = std::string( aLibraryPath.ToUTF8() );
+    js[ "stamp" ] = std::string( aStamp.ToUTF8() );
+    js[ "version" ] = { m_versionMajor, m_versionMinor };
+    js[ "symbols" ] = nlohmann::json::array();
+
+    for( const auto& pair : m_entries )
+    {
+        const SYMBOL_LIB_INDEX_ENTRY& entry = pair.second;
+
+        js[ "symbols" ].push_back( {
+                { "name", std::string( entry.m_Name.ToUTF8() ) },
+                { "parent", std::string( entry.m_Parent.ToUTF8() ) },
+                { "description", std::string( entry.m_Description.ToUTF8() ) },
+                { "keywords", std::string( entry.m_Keywords.ToUTF8() ) },
+                { "footprint", std::string( entry.m_Footprint.ToUTF8() ) },
+                { "datasheet", std::string( entry.m_Datasheet.ToUTF8() ) },
+                { "units", entry.m_UnitCount },
+                { "power", entry.m_IsPower },
+                { "offset", entry.m_Offset },
+                { "length", entry.m_Length } } );
+    }
+
+    // Write to a temporary file first, so that other instances never read a partial cache.
+    wxString tmpName = wxFileName::CreateTempFileName( fn.GetPathWithSep() + fn.GetName() );
+
+    if( tmpName.IsEmpty() )
+        return;
+
+    {
+        std::ofstream file( tmpName.ToStdString() );
+
+        if( file.is_open() )
+            file << js;
+
+        if( !file.good() )
+        {
+            file.close();
+            wxRemoveFile( tmpName );
+            return;
+        }
+    }
+
+    if( !wxRenameFile( tmpName, fn.GetFullPath() ) )
+        wxRemoveFile( tmpName );
+}
+
+
+LIB_SYMBOL_INFO::LIB_SYMBOL_INFO( const SYMBOL_LIB_INDEX_ENTRY& aEntry ) :
+        m_libId( wxEmptyString, aEntry.m_Name ),
+        m_description( aEntry.m_Description ),
+        m_isRoot( aEntry.m_Parent.IsEmpty() ),
+        m_unitCount( aEntry.m_UnitCount )
+{
+    // Same as LIB_PART::GetSearchText()
+    static const wxString discount( wxT( "        " ) );
+
+    m_searchText = aEntry.m_Keywords + discount + aEntry.m_Description;
+
+    if( !aEntry.m_Footprint.IsEmpty() )
+        m_searchText += discount + aEntry.m_Footprint;
+}
+
+
+LIB_SYMBOL_INFO::LIB_SYMBOL_INFO( LIB_PART* aPart ) :
+        m_libId( aPart->GetLibId() ),
+        m_description( aPart->GetDescription() ),
+        m_searchText( aPart->GetSearchText() ),
+        m_isRoot( aPart->IsRoot() ),
+        m_unitCount( aPart->GetUnitCount() )
+{
+}
+
+
+wxString LIB_SYMBOL_INFO::GetUnitReference( int aUnit )
+{
+    return LIB_PART::SubReference( aUnit, false );
+}
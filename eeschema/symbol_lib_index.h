@@ -0,0 +1,178 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYMBOL_LIB_INDEX_H
+#define SYMBOL_LIB_INDEX_H
+
+#include <map>
+#include <string>
+
+#include <wx/filename.h>
+
+#include <lib_id.h>
+#include <lib_tree_item.h>
+
+class LIB_PART;
+
+
+/**
+ * What the symbol chooser needs to know about a library symbol, and where the symbol is
+ * defined in the library file.
+ */
+struct SYMBOL_LIB_INDEX_ENTRY
+{
+    SYMBOL_LIB_INDEX_ENTRY() :
+            m_UnitCount( 1 ),
+            m_IsPower( false ),
+            m_Offset( 0 ),
+            m_Length( 0 )
+    {
+    }
+
+    wxString m_Name;
+    wxString m_Parent;         ///< The symbol this one is derived from or an alias of.
+    wxString m_Description;
+    wxString m_Keywords;
+    wxString m_Footprint;
+    wxString m_Datasheet;      ///< Only used by libraries with a separate document file.
+    int      m_UnitCount;
+    bool     m_IsPower;
+    size_t   m_Offset;         ///< Byte offset of the symbol definition in the library file.
+    size_t   m_Length;         ///< Byte length of the symbol definition.
+};
+
+
+/**
+ * An index of the symbols of a library file.
+ *
+ * The library plugins build it in a single pass over the file without creating any
+ * #LIB_PART, which lets them enumerate a library and parse only the symbols which are
+ * actually loaded.  Indices are kept in a per-user cache so that libraries which did not
+ * change are not even read again.
+ */
+class SYMBOL_LIB_INDEX
+{
+public:
+    SYMBOL_LIB_INDEX() :
+            m_versionMajor( 0 ),
+            m_versionMinor( 0 )
+    {
+    }
+
+    void Clear() { m_entries.clear(); }
+
+    bool IsEmpty() const { return m_entries.empty(); }
+
+    /**
+     * Add \a aEntry to the index.  An entry with the same name is replaced, like a symbol
+     * defined twice in a library replaces the first definition.
+     */
+    void Add( const SYMBOL_LIB_INDEX_ENTRY& aEntry ) { m_entries[ aEntry.m_Name ] = aEntry; }
+
+    const SYMBOL_LIB_INDEX_ENTRY* Find( const wxString& aName ) const;
+    SYMBOL_LIB_INDEX_ENTRY* Find( const wxString& aName );
+
+    /// The entries sorted by name.
+    const std::map<wxString, SYMBOL_LIB_INDEX_ENTRY>& GetEntries() const { return m_entries; }
+
+    void SetVersion( int aMajor, int aMinor = 0 )
+    {
+        m_versionMajor = aMajor;
+        m_versionMinor = aMinor;
+    }
+
+    int GetVersionMajor() const { return m_versionMajor; }
+    int GetVersionMinor() const { return m_versionMinor; }
+
+    /**
+     * Copy the unit count of each derived symbol from the symbol it is derived from, as
+     * #LIB_PART::GetUnitCount() does.
+     */
+    void ResolveParents();
+
+    /**
+     * Read the text defining \a aEntry from the library file \a aLibraryPath.
+     *
+     * @throw IO_ERROR if the file cannot be read.
+     */
+    static std::string ReadSymbolText( const wxString& aLibraryPath,
+                                       const SYMBOL_LIB_INDEX_ENTRY& aEntry );
+
+    /**
+     * Return a string which changes whenever \a aFile is modified.
+     */
+    static wxString FileStamp( const wxFileName& aFile );
+
+    /**
+     * Load the cached index of \a aLibraryPath.
+     *
+     * @param aStamp identifies the state of the library files the index is built from, as
+     *               returned by #FileStamp().
+     * @return true if a cached index was found and was built from the same files.
+     */
+    bool ReadCache( const wxString& aLibraryPath, const wxString& aStamp );
+
+    /**
+     * Save the index of \a aLibraryPath to the per-user cache.  Failing to do so is not an
+     * error, the index will simply be built again.
+     */
+    void WriteCache( const wxString& aLibraryPath, const wxString& aStamp ) const;
+
+private:
+    std::map<wxString, SYMBOL_LIB_INDEX_ENTRY> m_entries;
+    int                                        m_versionMajor;
+    int                                        m_versionMinor;
+};
+
+
+/**
+ * A library symbol as shown by the symbol chooser.  Unlike #LIB_PART it can be created
+ * from a #SYMBOL_LIB_INDEX_ENTRY without parsing the symbol.
+ */
+class LIB_SYMBOL_INFO : public LIB_TREE_ITEM
+{
+public:
+    LIB_SYMBOL_INFO( const SYMBOL_LIB_INDEX_ENTRY& aEntry );
+    LIB_SYMBOL_INFO( LIB_PART* aPart );
+
+    LIB_ID GetLibId() const override { return m_libId; }
+    void SetLibNickname( const wxString& aNickname ) { m_libId.SetLibNickname( aNickname ); }
+
+    wxString GetName() const override { return m_libId.GetLibItemName(); }
+    wxString GetLibNickname() const override { return m_libId.GetLibNickname(); }
+
+    wxString GetDescription() override { return m_description; }
+
+    wxString GetSearchText() override { return m_searchText; }
+
+    bool IsRoot() const override { return m_isRoot; }
+
+    int GetUnitCount() const override { return m_unitCount; }
+
+    wxString GetUnitReference( int aUnit ) override;
+
+private:
+    LIB_ID   m_libId;
+    wxString m_description;
+    wxString m_searchText;
+    bool     m_isRoot;
+    int      m_unitCount;
+};
+
+#endif // SYMBOL_LIB_INDEX_H
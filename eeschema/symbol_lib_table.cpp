@@ -32,6 +32,7 @@
 #include <search_stack.h>
 #include <settings/settings_manager.h>
 #include <systemdirsappend.h>
+#include <symbol_lib_index.h>
 #include <symbol_lib_table.h>
 #include <class_libentry.h>
 
@@ -331,6 +332,30 @@ void SYMBOL_LIB_TABLE::LoadSymbolLib( std::vector<LIB_PART*>& aSymbolList,
 }
 
 
+void SYMBOL_LIB_TABLE::LoadSymbolInfo( std::vector<LIB_SYMBOL_INFO>& aSymbolList,
+                                       const wxString& aNickname, bool aPowerSymbolsOnly )
+{
+    SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
+    wxCHECK( row && row->plugin, /* void */  );
+
+    wxString options = row->GetOptions();
+    size_t   first = aSymbolList.size();
+
+    if( aPowerSymbolsOnly )
+        row->SetOptions( row->GetOptions() + " " + PropPowerSymsOnly );
+
+    row->plugin->EnumerateSymbolInfo( aSymbolList, row->GetFullURI( true ),
+                                      row->GetProperties() );
+
+    if( aPowerSymbolsOnly )
+        row->SetOptions( options );
+
+    // See LoadSymbolLib().
+    for( size_t ii = first; ii < aSymbolList.size(); ++ii )
+        aSymbolList[ii].SetLibNickname( row->GetNickName() );
+}
+
+
 LIB_PART* SYMBOL_LIB_TABLE::LoadSymbol( const wxString& aNickname, const wxString& aSymbolName )
 {
     SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
@@ -161,6 +161,16 @@ public:
     void LoadSymbolLib( std::vector<LIB_PART*>& aAliasList, const wxString& aNickname,
                         bool aPowerSymbolsOnly = false );
 
+    /**
+     * Return the #LIB_SYMBOL_INFO of the symbols of the library given by @a aNickname.
+     *
+     * Unlike LoadSymbolLib(), this does not need to parse the symbols of indexed libraries.
+     *
+     * @throw IO_ERROR if the library cannot be found or loaded.
+     */
+    void LoadSymbolInfo( std::vector<LIB_SYMBOL_INFO>& aSymbolList, const wxString& aNickname,
+                         bool aPowerSymbolsOnly = false );
+
     /**
      * Load a #LIB_PART having @a aName from the library given by @a aNickname.
      *
@@ -19,15 +19,21 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
+
 #include <wx/tokenzr.h>
 #include <wx/progdlg.h>
 
+#include <common.h>
+
 #include <eda_pattern_match.h>
+#include <symbol_lib_index.h>
 #include <symbol_lib_table.h>
 #include <class_libentry.h>
 #include <generate_alias_info.h>
 
 #include <symbol_tree_model_adapter.h>
+#include <thread_pool.h>
 
 
 bool SYMBOL_TREE_MODEL_ADAPTER::m_show_progress = true;
@@ -55,6 +61,7 @@ SYMBOL_TREE_MODEL_ADAPTER::~SYMBOL_TREE_MODEL_ADAPTER()
 void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNicknames,
                                               wxWindow* aParent )
 {
+    bool              onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
     wxProgressDialog* prg = nullptr;
     wxLongLong        nextUpdate = wxGetUTCTimeMillis() + (PROGRESS_INTERVAL_MILLIS / 2);
 
@@ -64,18 +71,67 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNick
                                     aNicknames.size(), aParent );
     }
 
-    unsigned int ii = 0;
-
-    for( const auto& nickname : aNicknames )
+    // The library table indexes its rows and creates their plugins lazily, so do it before
+    // starting the workers.  After that each worker only touches the rows, and thus the
+    // plugins, of the libraries it loads.
+    for( const wxString& nickname : aNicknames )
+        m_libs->FindRow( nickname );
+
+    std::vector<std::unique_ptr<LIB_TREE_NODE_LIB>> libNodes( aNicknames.size() );
+    std::vector<wxString>                           errors( aNicknames.size() );
+    std::atomic_size_t                              nextLib( 0 );
+    std::atomic_size_t                              libsFinished( 0 );
+
+    // The plugins toggle the global locale while loading.  Holding it here keeps them from
+    // switching it back and forth under each other, see FOOTPRINT_LIST_IMPL::JoinWorkers().
+    LOCALE_IO toggle;
+
+    size_t taskCount = std::min<size_t>( THREAD_POOL::GetInstance().GetThreadCount(),
+                                         aNicknames.size() );
+
+    auto loader = [&]()
+            {
+                for( size_t lib = nextLib++; lib < aNicknames.size(); lib = nextLib++ )
+                {
+                    libNodes[lib] = loadLibraryNode( aNicknames[lib], onlyPowerSymbols,
+                                                     errors[lib] );
+                    libsFinished++;
+                }
+            };
+
+    TASK_GROUP tasks;
+
+    for( size_t ii = 0; ii < taskCount; ++ii )
+        tasks.Run( loader );
+
+    // Here we balance returns with a timeout to allow UI updating
+    while( !tasks.WaitFor( std::chrono::milliseconds( PROGRESS_INTERVAL_MILLIS ) ) )
     {
         if( prg && wxGetUTCTimeMillis() > nextUpdate )
         {
-            prg->Update( ii, wxString::Format( _( "Loading library \"%s\"" ), nickname ) );
+            // All the libraries may have finished since the wait timed out
+            size_t finished = std::min( libsFinished.load(), aNicknames.size() - 1 );
+
+            prg->Update( finished, wxString::Format( _( "Loading library \"%s\"" ),
+                                                     aNicknames[finished] ) );
             nextUpdate = wxGetUTCTimeMillis() + PROGRESS_INTERVAL_MILLIS;
         }
+    }
+
+    tasks.Wait();
 
-        AddLibrary( nickname );
-        ii++;
+    // Keep the libraries in the order they were given, whichever worker finished first.
+    for( size_t lib = 0; lib < aNicknames.size(); ++lib )
+    {
+        if( !errors[lib].IsEmpty() )
+        {
+            wxLogError( wxString::Format( _( "Error loading symbol library %s.\n\n%s" ),
+                                          aNicknames[lib],
+                                          errors[lib] ) );
+        }
+
+        if( libNodes[lib] )
+            DoAddLibraryNode( std::move( libNodes[lib] ) );
     }
 
     m_tree.AssignIntrinsicRanks();
@@ -90,27 +146,59 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNick
 
 void SYMBOL_TREE_MODEL_ADAPTER::AddLibrary( wxString const& aLibNickname )
 {
-    bool                        onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
-    std::vector<LIB_PART*>      symbols;
-    std::vector<LIB_TREE_ITEM*> comp_list;
+    bool     onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
+    wxString error;
 
+    std::unique_ptr<LIB_TREE_NODE_LIB> libNode = loadLibraryNode( aLibNickname, onlyPowerSymbols,
+                                                                  error );
+
+    if( !error.IsEmpty() )
+    {
+        wxLogError( wxString::Format( _( "Error loading symbol library %s.\n\n%s" ),
+                                      aLibNickname,
+                                      error ) );
+    }
+
+    if( libNode )
+        DoAddLibraryNode( std::move( libNode ) );
+}
+
+
+std::unique_ptr<LIB_TREE_NODE_LIB> SYMBOL_TREE_MODEL_ADAPTER::loadLibraryNode(
+        const wxString& aLibNickname, bool aOnlyPowerSymbols, wxString& aError )
+{
+    std::vector<LIB_SYMBOL_INFO> symbols;
+
+    // The tree only needs the names and descriptions, which indexed libraries provide
+    // without parsing their symbols.
     try
     {
-        m_libs->LoadSymbolLib( symbols, aLibNickname, onlyPowerSymbols );
+        m_libs->LoadSymbolInfo( symbols, aLibNickname, aOnlyPowerSymbols );
     }
     catch( const IO_ERROR& ioe )
     {
-        wxLogError( wxString::Format( _( "Error loading symbol library %s.\n\n%s" ),
-                                      aLibNickname,
-                                      ioe.What() ) );
-        return;
+        aError = ioe.What();
+        return nullptr;
     }
-
-    if( symbols.size() > 0 )
+    catch( const std::exception& e )
     {
-        comp_list.assign( symbols.begin(), symbols.end() );
-        DoAddLibrary( aLibNickname, m_libs->GetDescription( aLibNickname ), comp_list, false );
+        // Nothing may escape a worker thread.
+        aError = e.what();
+        return nullptr;
     }
+
+    if( symbols.empty() )
+        return nullptr;
+
+    std::unique_ptr<LIB_TREE_NODE_LIB> libNode = std::make_unique<LIB_TREE_NODE_LIB>(
+            &m_tree, aLibNickname, m_libs->GetDescription( aLibNickname ) );
+
+    for( LIB_SYMBOL_INFO& symbol : symbols )
+        libNode->AddItem( &symbol );
+
+    libNode->AssignIntrinsicRanks( false );
+
+    return libNode;
 }
 
 
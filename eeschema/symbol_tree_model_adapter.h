@@ -44,6 +44,7 @@ public:
 
     /**
      * Add all the libraries in a SYMBOL_LIB_TABLE to the model.
+     * The libraries are loaded in parallel, one worker thread per processor.
      * Displays a progress dialog attached to the parent frame the first time it is run.
      *
      * @param aNicknames is the list of library nicknames
@@ -62,6 +63,17 @@ protected:
     SYMBOL_TREE_MODEL_ADAPTER( EDA_BASE_FRAME* aParent, LIB_TABLE* aLibs );
 
 private:
+    /**
+     * Load the symbols of a library into a new library node which is not yet in the tree.
+     * Safe to call from worker threads once the library's row has been looked up.
+     *
+     * @param aError is set to the error message if the library cannot be loaded.
+     * @return the library node, or nullptr if the library has no symbols to show.
+     */
+    std::unique_ptr<LIB_TREE_NODE_LIB> loadLibraryNode( const wxString& aLibNickname,
+                                                        bool aOnlyPowerSymbols,
+                                                        wxString& aError );
+
     /**
      * Flag to only show the symbol library table load progress dialog the first time.
      */
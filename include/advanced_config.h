@@ -83,6 +83,48 @@ public:
      */
     int m_coroutineStackSize;
 
+    /**
+     * Keep the zone fills and their triangulations in a cache file next to the board
+     */
+    bool m_ZoneFillCacheFile;
+
+    /**
+     * Maximum number of threads of the shared worker pool (0 for one per hardware thread)
+     */
+    int m_MaxWorkerThreads;
+
+    /**
+     * Only rebuild the parts of the schematic connection graph affected by an edit
+     */
+    bool m_IncrementalConnectivity;
+
+    /**
+     * Prepare the geometry of the items to recache on worker threads
+     */
+    bool m_ParallelRecache;
+
+    /**
+     * Let the interactive router explore independent walkaround candidates on worker threads
+     */
+    bool m_ParallelRouting;
+
+    /**
+     * Number of most recent undo/redo commands kept as they are; older ones are packed
+     * (0 to never pack commands)
+     */
+    int m_UndoPackDepth;
+
+    /**
+     * Memory in MiB the packed undo/redo commands may use before the oldest ones are moved
+     * to a journal file (0 for no limit)
+     */
+    int m_UndoMemoryLimit;
+
+    /**
+     * Record the inputs of the interactive router next to the board file, for offline replay
+     */
+    bool m_RecordRouterInput;
+
 
 private:
     ADVANCED_CFG();
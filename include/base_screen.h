@@ -78,6 +78,9 @@ private:
     bool        m_FlagSave;         ///< Indicates automatic file save.
     int         m_UndoRedoCountMax; ///< undo/Redo command Max depth
 
+    std::unique_ptr<UNDO_ITEM_PACKER> m_undoPacker;   ///< packs old commands, if supported
+    std::unique_ptr<UNDO_JOURNAL>     m_undoJournal;  ///< packed commands moved out of memory
+
     /**
      * The cross hair position in logical (drawing) units.  The cross hair is not the cursor
      * position.  It is an addition indicator typically drawn on grid to indicate to the
@@ -102,6 +105,14 @@ private:
      */
     wxPoint getNearestGridPosition( const wxPoint& aPosition, const wxPoint& aGridOrigin ) const;
 
+    /**
+     * Function compactUndoRedoLists
+     * packs the commands older than ADVANCED_CFG::m_UndoPackDepth and moves the oldest
+     * packed commands to the journal file when they use more than
+     * ADVANCED_CFG::m_UndoMemoryLimit.
+     */
+    void compactUndoRedoLists();
+
     //----</Old public API now is private, and migratory>------------------------
 
 
@@ -203,6 +214,15 @@ public:
      */
     virtual PICKED_ITEMS_LIST* PopCommandFromRedoList();
 
+    /**
+     * Function SetUndoItemPacker
+     * sets the packer used to keep old undo/redo commands in a compact form.  The screen
+     * takes ownership of \a aPacker.  Without a packer, commands are kept as they are.
+     */
+    void SetUndoItemPacker( UNDO_ITEM_PACKER* aPacker );
+
+    UNDO_ITEM_PACKER* GetUndoItemPacker() const { return m_undoPacker.get(); }
+
     int GetUndoCommandCount() const
     {
         return m_UndoList.m_CommandsList.size();
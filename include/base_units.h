@@ -68,9 +68,8 @@ inline int Mils2mm( double x ) { return KiROUND( x * 25.4 / 1000. ); }
  * using scientific notation and no trailing 0
  * We want to avoid scientific notation in S-expr files (not easy to read)
  * for floating numbers.
- * So we cannot always just use the %g or the %f format to print a fp number
- * this helper function uses the %f format when needed, or %g when %f is
- * not well working and then removes trailing 0
+ * The shortest string which reads back as the same value is used, and the
+ * result does not depend on the current locale (see FormatDouble()).
  */
 std::string Double2Str( double aValue );
 
@@ -214,6 +214,9 @@ public:
     std::vector<DRC_SELECTOR*>       m_DRCRuleSelectors;
     std::vector<DRC_RULE*>           m_DRCRules;
 
+    // Compiled form of m_DRCRuleSelectors (rebuilt whenever the rules are loaded)
+    std::shared_ptr<DRC_RULE_RESOLVER> m_DRCRuleResolver;
+
     // Temporary storage for rule matching.
     std::vector<DRC_SELECTOR*>       m_matched;
 
@@ -107,6 +107,7 @@ protected:
 
     int                 curTok;                 ///< the current token obtained on last NextTok()
     std::string         curText;                ///< the text of the current token
+    std::string         curLine;                ///< nul terminated copy of a line read in place
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
@@ -118,13 +119,12 @@ protected:
     {
         if( reader )
         {
-            reader->ReadLine();
-
-            unsigned len = reader->Length();
+            unsigned    len;
+            const char* line = reader->ReadLineInPlace( &len );
 
             // start may have changed in ReadLine(), which can resize and
-            // relocate reader's line buffer.
-            start = reader->Line();
+            // relocate reader's line buffer, or may not be in that buffer at all.
+            start = line ? line : reader->Line();
 
             next  = start;
             limit = next + len;
@@ -458,6 +458,17 @@ public:
      */
     void NeedRIGHT();
 
+    /**
+     * Function ReadBlockText
+     * appends the raw text up to and including the DSN_RIGHT which closes the current
+     * nesting level to @a aText, without tokenizing it.  Quoted strings are honoured and
+     * comment lines are dropped.  Afterwards the lexer is positioned as if that DSN_RIGHT
+     * had just been read by NextTok().  Not available in specctra mode.
+     * @param aText is where to append the text of the block.
+     * @throw IO_ERROR, if the end of the input is reached first.
+     */
+    void ReadBlockText( std::string& aText );
+
     /**
      * Function GetTokenText
      * returns the C string representation of a DSN_T value.
@@ -516,6 +527,14 @@ public:
      */
     const char* CurLine()
     {
+        // Lines read in place are not nul terminated, so they are only copied when
+        // needed, which is usually for an error message.
+        if( start != reader->Line() )
+        {
+            curLine.assign( start, limit );
+            return curLine.c_str();
+        }
+
         return (const char*)(*reader);
     }
 
@@ -170,12 +170,26 @@ public:
 
     wxString const& GetPattern() const;
 
+    /**
+     * Return true if the pattern has no regular expression, wildcard or relational syntax.
+     *
+     * All the matchers then find the pattern exactly where a plain substring search does,
+     * so Find() only runs that, and callers may look the pattern up in a text index instead.
+     */
+    bool IsLiteral() const { return m_literal; }
+
+    /**
+     * Return true if \a aPattern would make a literal matcher, see IsLiteral().
+     */
+    static bool IsLiteralPattern( const wxString& aPattern );
+
 private:
     // Add matcher if it can compile the pattern.
     void AddMatcher( const wxString &aPattern, std::unique_ptr<EDA_PATTERN_MATCH> aMatcher );
 
     std::vector<std::unique_ptr<EDA_PATTERN_MATCH>> m_matchers;
     wxString m_pattern;
+    bool     m_literal;
 };
 
 #endif  // EDA_PATTERN_MATCH_H
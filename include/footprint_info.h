@@ -207,8 +207,17 @@ public:
     {
     }
 
-    virtual void WriteCacheToFile( wxTextFile* aFile ) { };
-    virtual void ReadCacheFromFile( wxTextFile* aFile ) { };
+    /**
+     * Save the list, along with the timestamps of the libraries it was read from, to the
+     * cache file \a aFilePath.
+     */
+    virtual void WriteCacheToFile( const wxString& aFilePath ) { };
+
+    /**
+     * Replace the list by the one saved in the cache file \a aFilePath.  The next call to
+     * ReadFootprintFiles() only reads the libraries which changed since the cache was saved.
+     */
+    virtual void ReadCacheFromFile( const wxString& aFilePath ) { };
 
     /**
      * @return the number of items stored in list
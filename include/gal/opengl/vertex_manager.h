@@ -38,6 +38,7 @@
 #include <gal/color4d.h>
 #include <stack>
 #include <memory>
+#include <functional>
 #include <wx/log.h>
 
 namespace KIGFX
@@ -134,6 +135,19 @@ public:
      */
     bool Vertices( const VERTEX aVertices[], unsigned int aSize );
 
+    /**
+     * Function Vertices()
+     * adds aSize vertices to the currently set item.  aFiller receives the pointer to the new
+     * vertices and only has to store their coordinates; as it does not call any other method,
+     * it may split the work between threads.  The current color, shader and transformation
+     * are applied afterwards, as with the other Vertex() functions.
+     *
+     * @param aSize is the number of vertices to be added.
+     * @param aFiller stores the coordinates of the new vertices.
+     * @return True if successful, false otherwise.
+     */
+    bool Vertices( unsigned int aSize, const std::function<void( VERTEX* )>& aFiller );
+
     /**
      * Function Color()
      * changes currently used color that will be applied to newly added vertices.
@@ -29,6 +29,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 #include <gal/color4d.h>
 #include <render_settings.h>
@@ -104,6 +105,23 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function PrepareDraw
+     * Computes in advance the geometry (polygons, triangulations) that the next Draw() calls
+     * for an item will need, so that they only have to pass it to the GAL.  It is called from
+     * worker threads for many items at once (but never twice at the same time for the same
+     * item) and so must not use the GAL.
+     * @param aItem is the item that is going to be drawn.
+     * @param aLayers are the layers it is going to be drawn on.
+     */
+    virtual void PrepareDraw( const VIEW_ITEM* aItem, const std::vector<int>& aLayers ) {}
+
+    /**
+     * Function ClearPrepared
+     * Frees the data computed by PrepareDraw() that has not been used by Draw().
+     */
+    virtual void ClearPrepared() {}
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
@@ -120,6 +120,23 @@ public:
      */
     virtual char* ReadLine() = 0;
 
+    /**
+     * Function ReadLineInPlace
+     * reads a line of text like ReadLine(), but readers which hold their whole input
+     * in memory may return the line where it lies instead of copying it into the line
+     * buffer.  Such a line is not nul terminated and is not returned by Line().
+     * @param aLength is set to the number of bytes in the line.
+     * @return const char* - The beginning of the read line, or NULL if EOF.
+     * @throw IO_ERROR when a line is too long.
+     */
+    virtual const char* ReadLineInPlace( unsigned* aLength )
+    {
+        const char* line = ReadLine();
+
+        *aLength = m_length;
+        return line;
+    }
+
     /**
      * Function GetSource
      * returns the name of the source of the lines in an abstract sense.
@@ -247,6 +264,68 @@ public:
 };
 
 
+/**
+ * MAPPED_FILE_LINE_READER
+ * is a LINE_READER that holds a whole file in memory.  ReadLineInPlace() returns the
+ * lines straight from it, which spares DSNLEXER a copy of every byte of large files.
+ * ReadLine() copies them into the line buffer as usual.
+ *
+ * The file is mapped on Windows, which does not let other programs truncate it meanwhile.
+ * Elsewhere a truncation would make reading the mapping raise SIGBUS, so the file is read
+ * into memory instead.
+ */
+class MAPPED_FILE_LINE_READER : public LINE_READER
+{
+protected:
+    const char* m_data;     ///< the file contents
+    size_t      m_size;
+    size_t      m_ndx;      ///< offset of the next line in m_data
+    bool        m_mapped;   ///< m_data is a mapping to release, not an empty file
+
+    std::vector<char> m_contents;   ///< the file contents, when they are not mapped
+
+public:
+
+    /**
+     * Constructor MAPPED_FILE_LINE_READER
+     * loads @a aFileName into memory for reading.
+     *
+     * @param aFileName is the name of the file to map and to use for error reporting purposes.
+     * @param aStartingLineNumber is the initial line number to report on error.
+     * @param aMaxLineLength is the maximum allowed line length.
+     *
+     * @throw IO_ERROR if @a aFileName cannot be opened or mapped.
+     */
+    MAPPED_FILE_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber = 0,
+            unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX );
+
+    ~MAPPED_FILE_LINE_READER();
+
+    char* ReadLine() override;
+
+    const char* ReadLineInPlace( unsigned* aLength ) override;
+
+    /**
+     * Function Data
+     * returns the file contents.  Lines returned by ReadLineInPlace() point into
+     * it, so their byte offset in the file is their distance from Data().
+     */
+    const char* Data() const { return m_data; }
+
+    /**
+     * Function Rewind
+     * rewinds the file and resets the line number back to zero.  Line number
+     * will go to 1 on first ReadLine().
+     */
+    void Rewind()
+    {
+        m_ndx = 0;
+        m_lineNum = 0;
+    }
+};
+
+
 /**
  * STRING_LINE_READER
  * is a LINE_READER that reads from a multiline 8 bit wide std::string
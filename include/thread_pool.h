@@ -0,0 +1,145 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * THREAD_POOL
+ * A fixed set of worker threads executing submitted tasks.
+ *
+ * Each worker owns a task deque.  Tasks submitted from a worker go onto its own deque and
+ * are executed newest-first by that worker; idle workers steal the oldest tasks from the
+ * other deques.  Tasks submitted from any other thread go onto a shared injection queue.
+ *
+ * Tasks may themselves submit (and wait for) further tasks through a TASK_GROUP; a waiting
+ * worker keeps executing pending tasks so nested parallelism cannot deadlock the pool.
+ */
+class THREAD_POOL
+{
+public:
+    typedef std::function<void()> TASK;
+
+    /**
+     * Return the process-wide pool shared by all parallel algorithms.
+     */
+    static THREAD_POOL& GetInstance();
+
+    explicit THREAD_POOL( size_t aThreadCount );
+    ~THREAD_POOL();
+
+    size_t GetThreadCount() const { return m_workers.size(); }
+
+    /**
+     * Queue a task for execution.  Prefer TASK_GROUP::Run() when the result has to be
+     * waited for.
+     */
+    void Submit( TASK aTask );
+
+    /**
+     * Execute one pending task on the calling thread, if there is one.
+     * @return true if a task was executed.
+     */
+    bool RunPendingTask();
+
+    /**
+     * @return true if the calling thread is one of this pool's workers.
+     */
+    bool IsWorkerThread() const;
+
+private:
+    struct TASK_QUEUE
+    {
+        std::mutex       m_mutex;
+        std::deque<TASK> m_tasks;
+    };
+
+    void workerMain( size_t aIndex );
+
+    bool popTask( TASK& aTask );
+
+    std::vector<std::thread>                 m_workers;
+    std::vector<std::unique_ptr<TASK_QUEUE>> m_queues;        // One per worker
+    TASK_QUEUE                               m_injectQueue;   // Tasks from non-workers
+
+    std::mutex                               m_sleepMutex;
+    std::condition_variable                  m_wakeUp;
+    std::atomic<size_t>                      m_pendingCount;
+    bool                                     m_shutdown;
+};
+
+
+/**
+ * TASK_GROUP
+ * A set of tasks run on a THREAD_POOL which can be waited for as a whole.
+ *
+ * The first exception thrown by a task is captured and rethrown from Wait().  The
+ * destructor waits for any outstanding tasks, as they usually reference the caller's stack.
+ */
+class TASK_GROUP
+{
+public:
+    TASK_GROUP( THREAD_POOL& aPool = THREAD_POOL::GetInstance() );
+    ~TASK_GROUP();
+
+    TASK_GROUP( const TASK_GROUP& ) = delete;
+    TASK_GROUP& operator=( const TASK_GROUP& ) = delete;
+
+    void Run( THREAD_POOL::TASK aTask );
+
+    bool IsDone() const { return m_outstanding == 0; }
+
+    /**
+     * Block until all tasks have finished, executing pending pool tasks on the calling
+     * thread in the meantime.  Rethrows the first exception thrown by a task.
+     */
+    void Wait();
+
+    /**
+     * Block until all tasks have finished or until aTimeout expires, without executing
+     * tasks on the calling thread.  Intended for the GUI thread, which must keep refreshing
+     * its progress reporter between calls.
+     * @return true if all tasks have finished.
+     */
+    bool WaitFor( std::chrono::milliseconds aTimeout );
+
+private:
+    void taskDone();
+
+    void waitAll();
+
+    THREAD_POOL&            m_pool;
+    std::atomic<size_t>     m_outstanding;
+    std::mutex              m_mutex;
+    std::condition_variable m_done;
+    std::exception_ptr      m_exception;
+};
+
+#endif // THREAD_POOL_H
@@ -25,8 +25,12 @@
 
 #ifndef _CLASS_UNDOREDO_CONTAINER_H
 #define _CLASS_UNDOREDO_CONTAINER_H
+#include <memory>
+#include <string>
 #include <vector>
 
+#include <wx/ffile.h>
+
 #include <base_struct.h>
 
 
@@ -117,6 +121,72 @@ public:
 };
 
 
+/**
+ * UNDO_ITEM_PACKER
+ * is implemented by the editors able to serialize the copies of items kept by undo/redo
+ * commands.  Once a command is old enough to be unlikely to be undone soon, its copies are
+ * replaced by their (compressed) serialized form, which is usually much smaller.
+ */
+class UNDO_ITEM_PACKER
+{
+public:
+    virtual ~UNDO_ITEM_PACKER() {}
+
+    /**
+     * Function Pack
+     * serializes the copy of an item owned by \a aPicker into \a aData, then deletes the
+     * copy and clears its pointer in the picker.
+     * @return false if the picker holds nothing that can be packed.  It is then unchanged.
+     */
+    virtual bool Pack( ITEM_PICKER& aPicker, std::string& aData ) = 0;
+
+    /**
+     * Function Unpack
+     * restores in \a aPicker the copy serialized by Pack().
+     * @throw IO_ERROR if \a aData cannot be read back.
+     */
+    virtual void Unpack( ITEM_PICKER& aPicker, const std::string& aData ) = 0;
+};
+
+
+/**
+ * UNDO_JOURNAL
+ * is a temporary file holding packed undo/redo commands that were moved out of memory.
+ * The file is removed when the journal is deleted.
+ */
+class UNDO_JOURNAL
+{
+public:
+    UNDO_JOURNAL();
+    ~UNDO_JOURNAL();
+
+    /**
+     * Function Write
+     * appends \a aData to the journal.
+     * @return the offset of the data in the journal, or -1 if it could not be written.
+     */
+    wxFileOffset Write( const std::string& aData );
+
+    /**
+     * Function Read
+     * reads back \a aSize bytes written at \a aOffset.
+     */
+    bool Read( wxFileOffset aOffset, size_t aSize, std::string& aData );
+
+    /**
+     * Function Release
+     * tells the journal \a aSize bytes are not needed anymore.  The file is emptied once
+     * nothing it holds is needed.
+     */
+    void Release( size_t aSize );
+
+private:
+    wxString m_fileName;
+    wxFFile  m_file;
+    size_t   m_usedSize;     ///< bytes of the file still needed
+};
+
+
 /**
  * PICKED_ITEMS_LIST
  * is a holder to handle information on schematic or board items.
@@ -133,6 +203,22 @@ public:
 private:
     std::vector <ITEM_PICKER> m_ItemsList;
 
+    /**
+     * PACKED_PICKER
+     * the compressed copy of the item of a picker packed by Pack()
+     */
+    struct PACKED_PICKER
+    {
+        unsigned     m_Index;     ///< index of the picker in m_ItemsList
+        std::string  m_Data;      ///< compressed data, empty when stored in the journal
+        wxFileOffset m_Offset;    ///< position of the data in the journal, or -1
+        size_t       m_Size;      ///< size of the compressed data
+    };
+
+    std::vector<PACKED_PICKER> m_packedPickers;
+    bool                       m_isPacked;
+    UNDO_JOURNAL*              m_journal;        ///< holds the data moved out of memory
+
 public:
     PICKED_ITEMS_LIST();
     ~PICKED_ITEMS_LIST();
@@ -293,6 +379,35 @@ public:
      * @param aSource The list of items to copy to the list.
      */
     void CopyList( const PICKED_ITEMS_LIST& aSource );
+
+    /**
+     * Function Pack
+     * replaces the item copies owned by this command with their compressed serialized
+     * form, for the pickers \a aPacker knows how to serialize.
+     * The pickers must not be modified until the list is unpacked.
+     */
+    void Pack( UNDO_ITEM_PACKER& aPacker );
+
+    /**
+     * Function Unpack
+     * restores the item copies packed by Pack().  Pickers whose copy cannot be restored
+     * are removed from the list.
+     */
+    void Unpack( UNDO_ITEM_PACKER& aPacker );
+
+    bool IsPacked() const { return m_isPacked; }
+
+    /**
+     * Function GetPackedMemory
+     * @return The size of the packed data still held in memory.
+     */
+    size_t GetPackedMemory() const;
+
+    /**
+     * Function MoveToJournal
+     * writes the packed data held in memory to \a aJournal, which must outlive the list.
+     */
+    void MoveToJournal( UNDO_JOURNAL& aJournal );
 };
 
 
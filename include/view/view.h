@@ -622,7 +622,8 @@ public:
 
     /**
      * Function UpdateItems()
-     * Iterates through the list of items that asked for updating and updates them.
+     * Updates the items that asked for updating.  Only the queued items are visited, and
+     * their cached layers are recached layer by layer.
      */
     void UpdateItems();
 
@@ -776,13 +777,39 @@ protected:
     ///* used by GAL)
     void clearGroupCache();
 
+    ///* An item to be recached on one of its cached layers
+    struct LAYER_UPDATE
+    {
+        int        layer;
+        VIEW_ITEM* item;
+        int        flags;       ///< KIGFX::VIEW_UPDATE_FLAGS of the item
+    };
+
     /**
      * Function invalidateItem()
-     * Manages dirty flags & redraw queueing when updating an item.
+     * Manages dirty flags & redraw queueing when updating an item.  Layers and bounding box
+     * are updated immediately, the recaching of the item is added to aLayerUpdates.
      * @param aItem is the item to be updated.
      * @param aUpdateFlags determines the way an item is refreshed.
+     * @param aLayerUpdates collects the cached layers to be redrawn.
+     */
+    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags,
+                         std::vector<LAYER_UPDATE>& aLayerUpdates );
+
+    /**
+     * Adds update flags to an item and appends it to the update queue, unless it is already
+     * queued.  Items which are not in this view are ignored.
      */
-    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags );
+    void queueUpdate( VIEW_ITEM* aItem, int aUpdateFlags );
+
+    /// Removes an item from the update queue it is in, if any
+    static void dequeueUpdate( VIEW_ITEM* aItem );
+
+    /**
+     * Lets the painter compute the geometry of the items to be redrawn on the worker threads.
+     * @return true if the painter has been asked to prepare the items.
+     */
+    bool prepareItems( const std::vector<LAYER_UPDATE>& aLayerUpdates );
 
     /// Updates colors that are used for an item to be drawn
     void updateItemColor( VIEW_ITEM* aItem, int aLayer );
@@ -867,6 +894,11 @@ protected:
     /// Flag to reverse the draw order when using draw priority
     bool m_reverseDrawOrder;
 
+    /// Ends of the queue of items waiting for UpdateItems(), linked through their
+    /// VIEW_ITEM_DATA
+    VIEW_ITEM* m_updateQueueHead;
+    VIEW_ITEM* m_updateQueueTail;
+
     /// A control for printing: m_printMode <= 0 means no printing mode (normal draw mode
     /// m_printMode > 0 is a printing mode (currently means "we are in printing mode")
     int m_printMode;
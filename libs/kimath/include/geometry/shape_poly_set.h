@@ -26,6 +26,7 @@
 #ifndef __SHAPE_POLY_SET_H
 #define __SHAPE_POLY_SET_H
 
+#include <atomic>
 #include <cstdio>
 #include <deque>                        // for deque
 #include <iosfwd>                       // for string, stringstream
@@ -119,6 +120,16 @@ class SHAPE_POLY_SET : public SHAPE
                 return m_vertices.size();
             }
 
+            const TRI& GetTriangleIndices( int index ) const
+            {
+                return m_triangles[ index ];
+            }
+
+            const VECTOR2I& GetVertex( int index ) const
+            {
+                return m_vertices[ index ];
+            }
+
         private:
 
             std::deque<TRI> m_triangles;
@@ -240,7 +251,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             const T& Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].CPoint(
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CPoint(
                         m_currentVertex );
             }
 
@@ -363,7 +374,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             T Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].Segment( m_currentSegment );
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CSegment( m_currentSegment );
             }
 
             T operator*()
@@ -446,9 +457,11 @@ class SHAPE_POLY_SET : public SHAPE
 
         /**
          * Copy constructor SHAPE_POLY_SET
-         * Performs a deep copy of \p aOther into \p this.
+         * Copies \p aOther into \p this.  The polygons and the triangulation are shared with
+         * \p aOther until one of the sets is modified, so copying is cheap.
          * @param aOther is the SHAPE_POLY_SET object that will be copied.
-         * @param aDeepCopy if true, make new copies of the triangulated unique_ptr vector
+         * @param aDeepCopy if true, make new copies of the polygons and of the triangulation
+         * right away (for instance to hand them to another thread which will modify them)
          */
         SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther, bool aDeepCopy = false );
 
@@ -565,10 +578,13 @@ class SHAPE_POLY_SET : public SHAPE
         bool IsSelfIntersecting() const;
 
         ///> Returns the number of triangulated polygons
-        unsigned int TriangulatedPolyCount() const { return m_triangulatedPolys.size(); }
+        unsigned int TriangulatedPolyCount() const
+        {
+            return m_triangulatedPolys ? m_triangulatedPolys->size() : 0;
+        }
 
         ///> Returns the number of outlines in the set
-        int OutlineCount() const { return m_polys.size(); }
+        int OutlineCount() const { return polys().size(); }
 
         ///> Returns the number of vertices in a given outline/hole
         int VertexCount( int aOutline = -1, int aHole = -1 ) const;
@@ -576,18 +592,19 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the number of holes in a given outline
         int HoleCount( int aOutline ) const
         {
-            if( ( aOutline < 0 ) || (aOutline >= (int)m_polys.size()) || (m_polys[aOutline].size() < 2) )
+            if( ( aOutline < 0 ) || (aOutline >= (int)polys().size()) || (polys()[aOutline].size() < 2) )
                 return 0;
 
-            // the first polygon in m_polys[aOutline] is the main contour,
+            // the first polygon in polys()[aOutline] is the main contour,
             // only others are holes:
-            return m_polys[aOutline].size() - 1;
+            return polys()[aOutline].size() - 1;
         }
 
         ///> Returns the reference to aIndex-th outline in the set
+        ///> (use COutline() if the outline is not modified, it is cheaper)
         SHAPE_LINE_CHAIN& Outline( int aIndex )
         {
-            return m_polys[aIndex][0];
+            return leakPolys()[aIndex][0];
         }
 
         /**
@@ -609,38 +626,38 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aHole-th hole in the aIndex-th outline
         SHAPE_LINE_CHAIN& Hole( int aOutline, int aHole )
         {
-            return m_polys[aOutline][aHole + 1];
+            return leakPolys()[aOutline][aHole + 1];
         }
 
         ///> Returns the aIndex-th subpolygon in the set
         POLYGON& Polygon( int aIndex )
         {
-            return m_polys[aIndex];
+            return leakPolys()[aIndex];
         }
 
         const POLYGON& Polygon( int aIndex ) const
         {
-            return m_polys[aIndex];
+            return polys()[aIndex];
         }
 
         const TRIANGULATED_POLYGON* TriangulatedPolygon( int aIndex ) const
         {
-            return m_triangulatedPolys[aIndex].get();
+            return (*m_triangulatedPolys)[aIndex].get();
         }
 
         const SHAPE_LINE_CHAIN& COutline( int aIndex ) const
         {
-            return m_polys[aIndex][0];
+            return polys()[aIndex][0];
         }
 
         const SHAPE_LINE_CHAIN& CHole( int aOutline, int aHole ) const
         {
-            return m_polys[aOutline][aHole + 1];
+            return polys()[aOutline][aHole + 1];
         }
 
         const POLYGON& CPolygon( int aIndex ) const
         {
-            return m_polys[aIndex];
+            return polys()[aIndex];
         }
 
         /**
@@ -1060,7 +1077,7 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns true if the set is empty (no polygons at all)
         bool IsEmpty() const
         {
-            return m_polys.size() == 0;
+            return polys().size() == 0;
         }
 
         /**
@@ -1290,8 +1307,66 @@ class SHAPE_POLY_SET : public SHAPE
         bool hasTouchingHoles( const POLYGON& aPoly ) const;
 
         typedef std::vector<POLYGON> POLYSET;
+        typedef std::vector<std::unique_ptr<TRIANGULATED_POLYGON>> TRIANGULATION;
+
+        ///> Returns the polygons, for reading
+        const POLYSET& polys() const
+        {
+            return m_polys ? *m_polys : s_emptyPolys;
+        }
 
-        POLYSET m_polys;
+        /**
+         * Returns the polygons for modification.  If they are shared with other sets, this set
+         * gets its own copy of them first.
+         */
+        POLYSET& mutablePolys()
+        {
+            // No reference to new polygons has been handed out yet
+            if( !m_polys )
+            {
+                m_polys = std::make_shared<POLYSET>();
+                m_polysLeaked = false;
+            }
+            else if( m_polys.use_count() > 1 )
+            {
+                m_polys = std::make_shared<POLYSET>( *m_polys );
+                m_polysLeaked = false;
+            }
+
+            return *m_polys;
+        }
+
+        /**
+         * Same as mutablePolys(), for the references given to the callers: they may modify the
+         * polygons through them as long as this set keeps these polygons, so the polygons cannot
+         * be shared with the copies of this set until they are replaced.
+         */
+        POLYSET& leakPolys()
+        {
+            POLYSET& polys = mutablePolys();
+            m_polysLeaked = true;
+            return polys;
+        }
+
+        ///> Replaces the polygons with an empty set (which can be shared again, as no
+        ///> reference to the removed polygons is valid anymore)
+        void clearPolys()
+        {
+            m_polys.reset();
+            m_polysLeaked = false;
+        }
+
+        ///> Copies the polygons and the triangulation of aOther
+        void copyFrom( const SHAPE_POLY_SET& aOther, bool aDeepCopy );
+
+        ///> The polygons, shared by the copies of this set until they are modified
+        std::shared_ptr<POLYSET> m_polys;
+
+        ///> True when the callers may hold references into m_polys.  Reset whenever m_polys is
+        ///> replaced, as no reference to the new polygons has been handed out yet.
+        std::atomic<bool> m_polysLeaked{ false };
+
+        static const POLYSET s_emptyPolys;
 
     public:
 
@@ -1300,13 +1375,20 @@ class SHAPE_POLY_SET : public SHAPE
         void CacheTriangulation();
         bool IsTriangulationUpToDate() const;
 
+        /**
+         * Replaces the triangulation with aTriangulation, which must have been built from
+         * the current polygons (for instance by CacheTriangulation() in an earlier session).
+         */
+        void SetTriangulation( std::vector<std::unique_ptr<TRIANGULATED_POLYGON>> aTriangulation );
+
         MD5_HASH GetHash() const;
 
     private:
 
         MD5_HASH checksum() const;
 
-        std::vector<std::unique_ptr<TRIANGULATED_POLYGON>> m_triangulatedPolys;
+        ///> Never modified once built, so it is shared by the copies of this set
+        std::shared_ptr<const TRIANGULATION> m_triangulatedPolys;
         bool m_triangulationValid = false;
         MD5_HASH m_hash;
 
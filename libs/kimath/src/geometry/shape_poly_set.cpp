@@ -54,6 +54,9 @@
 
 using namespace ClipperLib;
 
+const SHAPE_POLY_SET::POLYSET SHAPE_POLY_SET::s_emptyPolys;
+
+
 SHAPE_POLY_SET::SHAPE_POLY_SET() :
     SHAPE( SH_POLY_SET )
 {
@@ -68,17 +71,40 @@ SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_LINE_CHAIN& aOutline ) :
 
 
 SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther, bool aDeepCopy ) :
-    SHAPE( SH_POLY_SET ), m_polys( aOther.m_polys )
+    SHAPE( SH_POLY_SET )
+{
+    copyFrom( aOther, aDeepCopy );
+}
+
+
+void SHAPE_POLY_SET::copyFrom( const SHAPE_POLY_SET& aOther, bool aDeepCopy )
 {
-    if( aOther.IsTriangulationUpToDate() )
+    // Polygons which the owner of aOther may still modify through a reference cannot be shared
+    if( !aOther.m_polys || ( !aDeepCopy && !aOther.m_polysLeaked ) )
+        m_polys = aOther.m_polys;
+    else
+        m_polys = std::make_shared<POLYSET>( *aOther.m_polys );
+
+    m_polysLeaked = false;
+
+    // The triangulation is valid for the copy exactly when it is valid for aOther, as they have
+    // the same polygons and hash; IsTriangulationUpToDate() checks it when it is needed.
+    if( aDeepCopy && aOther.m_triangulatedPolys )
     {
-        for( unsigned i = 0; i < aOther.TriangulatedPolyCount(); i++ )
-            m_triangulatedPolys.push_back(
-                    std::make_unique<TRIANGULATED_POLYGON>( *aOther.TriangulatedPolygon( i ) ) );
+        auto triangulation = std::make_shared<TRIANGULATION>();
 
-        m_hash = aOther.GetHash();
-        m_triangulationValid = true;
+        for( const std::unique_ptr<TRIANGULATED_POLYGON>& tri : *aOther.m_triangulatedPolys )
+            triangulation->push_back( std::make_unique<TRIANGULATED_POLYGON>( *tri ) );
+
+        m_triangulatedPolys = std::move( triangulation );
+    }
+    else
+    {
+        m_triangulatedPolys = aOther.m_triangulatedPolys;
     }
+
+    m_triangulationValid = aOther.m_triangulationValid;
+    m_hash = aOther.m_hash;
 }
 
 
@@ -141,8 +167,8 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
     unsigned int    selectedPolygon = aRelativeIndices.m_polygon;
 
     // Check whether the vertex indices make sense in this poly set
-    if( selectedPolygon < m_polys.size() && selectedContour < m_polys[selectedPolygon].size()
-        && selectedVertex < m_polys[selectedPolygon][selectedContour].PointCount() )
+    if( selectedPolygon < polys().size() && selectedContour < polys()[selectedPolygon].size()
+        && selectedVertex < polys()[selectedPolygon][selectedContour].PointCount() )
     {
         POLYGON currentPolygon;
 
@@ -150,7 +176,7 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
 
         for( unsigned int polygonIdx = 0; polygonIdx < selectedPolygon; polygonIdx++ )
         {
-            currentPolygon = Polygon( polygonIdx );
+            currentPolygon = CPolygon( polygonIdx );
 
             for( unsigned int contourIdx = 0; contourIdx < currentPolygon.size(); contourIdx++ )
             {
@@ -158,7 +184,7 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
             }
         }
 
-        currentPolygon = Polygon( selectedPolygon );
+        currentPolygon = CPolygon( selectedPolygon );
 
         for( unsigned int contourIdx = 0; contourIdx < selectedContour; contourIdx++ )
         {
@@ -183,8 +209,8 @@ int SHAPE_POLY_SET::NewOutline()
 
     empty_path.SetClosed( true );
     poly.push_back( empty_path );
-    m_polys.push_back( poly );
-    return m_polys.size() - 1;
+    mutablePolys().push_back( poly );
+    return mutablePolys().size() - 1;
 }
 
 
@@ -196,21 +222,21 @@ int SHAPE_POLY_SET::NewHole( int aOutline )
 
     // Default outline is the last one
     if( aOutline < 0 )
-        aOutline += m_polys.size();
+        aOutline += mutablePolys().size();
 
     // Add hole to the selected outline
-    m_polys[aOutline].push_back( empty_path );
+    mutablePolys()[aOutline].push_back( empty_path );
 
-    return m_polys.back().size() - 2;
+    return mutablePolys().back().size() - 2;
 }
 
 
 int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDuplication )
 {
-    assert( m_polys.size() );
+    assert( mutablePolys().size() );
 
     if( aOutline < 0 )
-        aOutline += m_polys.size();
+        aOutline += mutablePolys().size();
 
     int idx;
 
@@ -219,12 +245,12 @@ int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDu
     else
         idx = aHole + 1;
 
-    assert( aOutline < (int) m_polys.size() );
-    assert( idx < (int) m_polys[aOutline].size() );
+    assert( aOutline < (int) mutablePolys().size() );
+    assert( idx < (int) mutablePolys()[aOutline].size() );
 
-    m_polys[aOutline][idx].Append( x, y, aAllowDuplication );
+    mutablePolys()[aOutline][idx].Append( x, y, aAllowDuplication );
 
-    return m_polys[aOutline][idx].PointCount();
+    return mutablePolys()[aOutline][idx].PointCount();
 }
 
 
@@ -243,7 +269,7 @@ void SHAPE_POLY_SET::InsertVertex( int aGlobalIndex, VECTOR2I aNewVertex )
     {
         // Assure the position to be inserted exists; throw an exception otherwise
         if( GetRelativeIndices( aGlobalIndex, &index ) )
-            m_polys[index.m_polygon][index.m_contour].Insert( index.m_vertex, aNewVertex );
+            mutablePolys()[index.m_polygon][index.m_contour].Insert( index.m_vertex, aNewVertex );
         else
             throw( std::out_of_range( "aGlobalIndex-th vertex does not exist" ) );
     }
@@ -252,11 +278,11 @@ void SHAPE_POLY_SET::InsertVertex( int aGlobalIndex, VECTOR2I aNewVertex )
 
 int SHAPE_POLY_SET::VertexCount( int aOutline, int aHole  ) const
 {
-    if( m_polys.size() == 0 ) // Empty poly set
+    if( polys().size() == 0 ) // Empty poly set
         return 0;
 
     if( aOutline < 0 ) // Use last outline
-        aOutline += m_polys.size();
+        aOutline += polys().size();
 
     int idx;
 
@@ -265,13 +291,13 @@ int SHAPE_POLY_SET::VertexCount( int aOutline, int aHole  ) const
     else
         idx = aHole + 1;
 
-    if( aOutline >= (int) m_polys.size() ) // not existing outline
+    if( aOutline >= (int) polys().size() ) // not existing outline
         return 0;
 
-    if( idx >= (int) m_polys[aOutline].size() ) // not existing hole
+    if( idx >= (int) polys()[aOutline].size() ) // not existing hole
         return 0;
 
-    return m_polys[aOutline][idx].PointCount();
+    return polys()[aOutline][idx].PointCount();
 }
 
 
@@ -283,7 +309,7 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon )
 
     for( int index = aFirstPolygon; index < aLastPolygon; index++ )
     {
-        newPolySet.m_polys.push_back( Polygon( index ) );
+        newPolySet.mutablePolys().push_back( CPolygon( index ) );
     }
 
     return newPolySet;
@@ -293,7 +319,7 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon )
 const VECTOR2I& SHAPE_POLY_SET::CVertex( int aIndex, int aOutline, int aHole ) const
 {
     if( aOutline < 0 )
-        aOutline += m_polys.size();
+        aOutline += polys().size();
 
     int idx;
 
@@ -302,10 +328,10 @@ const VECTOR2I& SHAPE_POLY_SET::CVertex( int aIndex, int aOutline, int aHole ) c
     else
         idx = aHole + 1;
 
-    assert( aOutline < (int) m_polys.size() );
-    assert( idx < (int) m_polys[aOutline].size() );
+    assert( aOutline < (int) polys().size() );
+    assert( idx < (int) polys()[aOutline].size() );
 
-    return m_polys[aOutline][idx].CPoint( aIndex );
+    return polys()[aOutline][idx].CPoint( aIndex );
 }
 
 
@@ -317,7 +343,7 @@ const VECTOR2I& SHAPE_POLY_SET::CVertex( int aGlobalIndex ) const
     if( !GetRelativeIndices( aGlobalIndex, &index ) )
         throw( std::out_of_range( "aGlobalIndex-th vertex does not exist" ) );
 
-    return m_polys[index.m_polygon][index.m_contour].CPoint( index.m_vertex );
+    return polys()[index.m_polygon][index.m_contour].CPoint( index.m_vertex );
 }
 
 
@@ -338,7 +364,7 @@ bool SHAPE_POLY_SET::GetNeighbourIndexes( int aGlobalIndex, int* aPrevious, int*
     // Calculate the previous and next index of aGlobalIndex, corresponding to
     // the same contour;
     VERTEX_INDEX inext = index;
-    int lastpoint = m_polys[index.m_polygon][index.m_contour].SegmentCount();
+    int lastpoint = polys()[index.m_polygon][index.m_contour].SegmentCount();
 
     if( index.m_vertex == 0 )
     {
@@ -403,7 +429,7 @@ bool SHAPE_POLY_SET::IsPolygonSelfIntersecting( int aPolygonIndex ) const
 
 bool SHAPE_POLY_SET::IsSelfIntersecting() const
 {
-    for( unsigned int polygon = 0; polygon < m_polys.size(); polygon++ )
+    for( unsigned int polygon = 0; polygon < polys().size(); polygon++ )
     {
         if( IsPolygonSelfIntersecting( polygon ) )
             return true;
@@ -421,22 +447,22 @@ int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 
     poly.push_back( aOutline );
 
-    m_polys.push_back( poly );
+    mutablePolys().push_back( poly );
 
-    return m_polys.size() - 1;
+    return mutablePolys().size() - 1;
 }
 
 
 int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
 {
-    assert( m_polys.size() );
+    assert( mutablePolys().size() );
 
     if( aOutline < 0 )
-        aOutline += m_polys.size();
+        aOutline += mutablePolys().size();
 
-    assert( aOutline < (int)m_polys.size() );
+    assert( aOutline < (int)mutablePolys().size() );
 
-    POLYGON& poly = m_polys[aOutline];
+    POLYGON& poly = mutablePolys()[aOutline];
 
     assert( poly.size() );
 
@@ -462,13 +488,13 @@ void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType,
 
     c.StrictlySimple( aFastMode == PM_STRICTLY_SIMPLE );
 
-    for( auto poly : aShape.m_polys )
+    for( auto poly : aShape.polys() )
     {
         for( size_t i = 0 ; i < poly.size(); i++ )
             c.AddPath( poly[i].convertToClipper( i == 0 ), ptSubject, true );
     }
 
-    for( auto poly : aOtherShape.m_polys )
+    for( auto poly : aOtherShape.polys() )
     {
         for( size_t i = 0; i < poly.size(); i++ )
             c.AddPath( poly[i].convertToClipper( i == 0 ), ptClip, true );
@@ -580,7 +606,7 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
         break;
     }
 
-    for( const POLYGON& poly : m_polys )
+    for( const POLYGON& poly : polys() )
     {
         for( size_t i = 0; i < poly.size(); i++ )
             c.AddPath( poly[i].convertToClipper( i == 0 ), joinType, etClosedPolygon );
@@ -618,7 +644,7 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
 
 void SHAPE_POLY_SET::importTree( PolyTree* tree )
 {
-    m_polys.clear();
+    clearPolys();
 
     for( PolyNode* n = tree->GetFirst(); n; n = n->GetNext() )
     {
@@ -631,7 +657,7 @@ void SHAPE_POLY_SET::importTree( PolyTree* tree )
             for( unsigned int i = 0; i < n->Childs.size(); i++ )
                 paths.push_back( n->Childs[i]->Contour );
 
-            m_polys.push_back( paths );
+            mutablePolys().push_back( paths );
         }
     }
 }
@@ -849,7 +875,7 @@ void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode )
 {
     Simplify( aFastMode );    // remove overlapping holes/degeneracy
 
-    for( POLYGON& paths : m_polys )
+    for( POLYGON& paths : mutablePolys() )
     {
         fractureSingle( paths );
     }
@@ -1020,7 +1046,7 @@ void SHAPE_POLY_SET::unfractureSingle( SHAPE_POLY_SET::POLYGON& aPoly )
 bool SHAPE_POLY_SET::HasHoles() const
 {
     // Iterate through all the polygons on the set
-    for( const POLYGON& paths : m_polys )
+    for( const POLYGON& paths : polys() )
     {
         // If any of them has more than one contour, it is a hole.
         if( paths.size() > 1 )
@@ -1034,7 +1060,7 @@ bool SHAPE_POLY_SET::HasHoles() const
 
 void SHAPE_POLY_SET::Unfracture( POLYGON_MODE aFastMode )
 {
-    for( POLYGON& path : m_polys )
+    for( POLYGON& path : mutablePolys() )
     {
         unfractureSingle( path );
     }
@@ -1058,7 +1084,7 @@ int SHAPE_POLY_SET::NormalizeAreaOutlines()
     // Note also we are using SHAPE_POLY_SET::PM_STRICTLY_SIMPLE in polygon
     // calculations, but it is not mandatory. It is used mainly
     // because there is usually only very few vertices in area outlines
-    SHAPE_POLY_SET::POLYGON& outline = Polygon( 0 );
+    SHAPE_POLY_SET::POLYGON& outline = mutablePolys()[0];
     SHAPE_POLY_SET holesBuffer;
 
     // Move holes stored in outline to holesBuffer:
@@ -1088,18 +1114,18 @@ const std::string SHAPE_POLY_SET::Format() const
 {
     std::stringstream ss;
 
-    ss << "polyset " << m_polys.size() << "\n";
+    ss << "polyset " << polys().size() << "\n";
 
-    for( unsigned i = 0; i < m_polys.size(); i++ )
+    for( unsigned i = 0; i < polys().size(); i++ )
     {
-        ss << "poly " << m_polys[i].size() << "\n";
+        ss << "poly " << polys()[i].size() << "\n";
 
-        for( unsigned j = 0; j < m_polys[i].size(); j++ )
+        for( unsigned j = 0; j < polys()[i].size(); j++ )
         {
-            ss << m_polys[i][j].PointCount() << "\n";
+            ss << polys()[i][j].PointCount() << "\n";
 
-            for( int v = 0; v < m_polys[i][j].PointCount(); v++ )
-                ss << m_polys[i][j].CPoint( v ).x << " " << m_polys[i][j].CPoint( v ).y << "\n";
+            for( int v = 0; v < polys()[i][j].PointCount(); v++ )
+                ss << polys()[i][j].CPoint( v ).x << " " << polys()[i][j].CPoint( v ).y << "\n";
         }
 
         ss << "\n";
@@ -1161,7 +1187,7 @@ bool SHAPE_POLY_SET::Parse( std::stringstream& aStream )
             paths.push_back( outline );
         }
 
-        m_polys.push_back( paths );
+        mutablePolys().push_back( paths );
     }
 
     return true;
@@ -1172,12 +1198,12 @@ const BOX2I SHAPE_POLY_SET::BBox( int aClearance ) const
 {
     BOX2I bb;
 
-    for( unsigned i = 0; i < m_polys.size(); i++ )
+    for( unsigned i = 0; i < polys().size(); i++ )
     {
         if( i == 0 )
-            bb = m_polys[i][0].BBox();
+            bb = polys()[i][0].BBox();
         else
-            bb.Merge( m_polys[i][0].BBox() );
+            bb.Merge( polys()[i][0].BBox() );
     }
 
     bb.Inflate( aClearance );
@@ -1189,12 +1215,12 @@ const BOX2I SHAPE_POLY_SET::BBoxFromCaches() const
 {
     BOX2I bb;
 
-    for( unsigned i = 0; i < m_polys.size(); i++ )
+    for( unsigned i = 0; i < polys().size(); i++ )
     {
         if( i == 0 )
-            bb = m_polys[i][0].BBoxFromCache();
+            bb = polys()[i][0].BBoxFromCache();
         else
-            bb.Merge( m_polys[i][0].BBoxFromCache() );
+            bb.Merge( polys()[i][0].BBoxFromCache() );
     }
 
     return bb;
@@ -1204,7 +1230,7 @@ const BOX2I SHAPE_POLY_SET::BBoxFromCaches() const
 bool SHAPE_POLY_SET::PointOnEdge( const VECTOR2I& aP ) const
 {
     // Iterate through all the polygons in the set
-    for( const POLYGON& polygon : m_polys )
+    for( const POLYGON& polygon : polys() )
     {
         // Iterate through all the line chains in the polygon
         for( const SHAPE_LINE_CHAIN& lineChain : polygon )
@@ -1267,7 +1293,7 @@ bool SHAPE_POLY_SET::Collide( const VECTOR2I& aP, int aClearance ) const
 
 void SHAPE_POLY_SET::RemoveAllContours()
 {
-    m_polys.clear();
+    clearPolys();
 }
 
 
@@ -1275,9 +1301,9 @@ void SHAPE_POLY_SET::RemoveContour( int aContourIdx, int aPolygonIdx )
 {
     // Default polygon is the last one
     if( aPolygonIdx < 0 )
-        aPolygonIdx += m_polys.size();
+        aPolygonIdx += mutablePolys().size();
 
-    m_polys[aPolygonIdx].erase( m_polys[aPolygonIdx].begin() + aContourIdx );
+    mutablePolys()[aPolygonIdx].erase( mutablePolys()[aPolygonIdx].begin() + aContourIdx );
 }
 
 
@@ -1336,13 +1362,21 @@ int SHAPE_POLY_SET::RemoveNullSegments()
 
 void SHAPE_POLY_SET::DeletePolygon( int aIdx )
 {
-    m_polys.erase( m_polys.begin() + aIdx );
+    mutablePolys().erase( mutablePolys().begin() + aIdx );
 }
 
 
 void SHAPE_POLY_SET::Append( const SHAPE_POLY_SET& aSet )
 {
-    m_polys.insert( m_polys.end(), aSet.m_polys.begin(), aSet.m_polys.end() );
+    // Share the polygons of aSet instead of copying them when there is nothing to append to
+    if( IsEmpty() && !aSet.m_polysLeaked )
+    {
+        m_polys = aSet.m_polys;
+        m_polysLeaked = false;
+        return;
+    }
+
+    mutablePolys().insert( mutablePolys().end(), aSet.polys().begin(), aSet.polys().end() );
 }
 
 
@@ -1424,10 +1458,10 @@ void SHAPE_POLY_SET::BuildBBoxCaches()
 {
     for( int polygonIdx = 0; polygonIdx < OutlineCount(); polygonIdx++ )
     {
-        Outline( polygonIdx ).GenerateBBoxCache();
+        POLYGON& polygon = mutablePolys()[polygonIdx];
 
-        for( int holeIdx = 0; holeIdx < HoleCount( polygonIdx ); holeIdx++ )
-            Hole( polygonIdx, holeIdx ).GenerateBBoxCache();
+        for( SHAPE_LINE_CHAIN& contour : polygon )
+            contour.GenerateBBoxCache();
     }
 }
 
@@ -1435,7 +1469,7 @@ void SHAPE_POLY_SET::BuildBBoxCaches()
 bool SHAPE_POLY_SET::Contains( const VECTOR2I& aP, int aSubpolyIndex, int aAccuracy,
                                bool aUseBBoxCaches ) const
 {
-    if( m_polys.empty() )
+    if( polys().empty() )
         return false;
 
     // If there is a polygon specified, check the condition against that polygon
@@ -1467,7 +1501,7 @@ void SHAPE_POLY_SET::RemoveVertex( int aGlobalIndex )
 
 void SHAPE_POLY_SET::RemoveVertex( VERTEX_INDEX aIndex )
 {
-    m_polys[aIndex.m_polygon][aIndex.m_contour].Remove( aIndex.m_vertex );
+    mutablePolys()[aIndex.m_polygon][aIndex.m_contour].Remove( aIndex.m_vertex );
 }
 
 
@@ -1484,7 +1518,7 @@ void SHAPE_POLY_SET::SetVertex( int aGlobalIndex, const VECTOR2I& aPos )
 
 void SHAPE_POLY_SET::SetVertex( const VERTEX_INDEX& aIndex, const VECTOR2I& aPos )
 {
-    m_polys[aIndex.m_polygon][aIndex.m_contour].SetPoint( aIndex.m_vertex, aPos );
+    mutablePolys()[aIndex.m_polygon][aIndex.m_contour].SetPoint( aIndex.m_vertex, aPos );
 }
 
 
@@ -1492,7 +1526,7 @@ bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int
                                      bool aUseBBoxCaches ) const
 {
     // Check that the point is inside the outline
-    if( m_polys[aSubpolyIndex][0].PointInside( aP, aAccuracy ) )
+    if( polys()[aSubpolyIndex][0].PointInside( aP, aAccuracy ) )
     {
         // Check that the point is not in any of the holes
         for( int holeIdx = 0; holeIdx < HoleCount( aSubpolyIndex ); holeIdx++ )
@@ -1514,7 +1548,7 @@ bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int
 
 void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 {
-    for( POLYGON& poly : m_polys )
+    for( POLYGON& poly : mutablePolys() )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
             path.Move( aVector );
@@ -1524,7 +1558,7 @@ void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 
 void SHAPE_POLY_SET::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 {
-    for( POLYGON& poly : m_polys )
+    for( POLYGON& poly : mutablePolys() )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
         {
@@ -1536,7 +1570,7 @@ void SHAPE_POLY_SET::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 
 void SHAPE_POLY_SET::Rotate( double aAngle, const VECTOR2I& aCenter )
 {
-    for( POLYGON& poly : m_polys )
+    for( POLYGON& poly : mutablePolys() )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
             path.Rotate( aAngle, aCenter );
@@ -1548,7 +1582,7 @@ int SHAPE_POLY_SET::TotalVertices() const
 {
     int c = 0;
 
-    for( const POLYGON& poly : m_polys )
+    for( const POLYGON& poly : polys() )
     {
         for( const SHAPE_LINE_CHAIN& path : poly )
             c += path.PointCount();
@@ -1635,7 +1669,7 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistance( VECTOR2I aPoint )
     SEG::ecoord minDistance = SquaredDistanceToPolygon( aPoint, 0 );
 
     // Iterate through all the polygons and get the minimum distance.
-    for( unsigned int polygonIdx = 1; polygonIdx < m_polys.size(); polygonIdx++ )
+    for( unsigned int polygonIdx = 1; polygonIdx < polys().size(); polygonIdx++ )
     {
         currentDistance = SquaredDistanceToPolygon( aPoint, polygonIdx );
 
@@ -1653,7 +1687,7 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistance( const SEG& aSegment )
     SEG::ecoord minDistance = SquaredDistanceToPolygon( aSegment, 0 );
 
     // Iterate through all the polygons and get the minimum distance.
-    for( unsigned int polygonIdx = 1; polygonIdx < m_polys.size(); polygonIdx++ )
+    for( unsigned int polygonIdx = 1; polygonIdx < polys().size(); polygonIdx++ )
     {
         currentDistance = SquaredDistanceToPolygon( aSegment, polygonIdx );
 
@@ -1682,8 +1716,8 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Chamfer( int aDistance, std::set<VECTOR2I>* aPres
 {
     SHAPE_POLY_SET chamfered;
 
-    for( unsigned int idx = 0; idx < m_polys.size(); idx++ )
-        chamfered.m_polys.push_back( ChamferPolygon( aDistance, idx, aPreserveCorners ) );
+    for( unsigned int idx = 0; idx < polys().size(); idx++ )
+        chamfered.mutablePolys().push_back( ChamferPolygon( aDistance, idx, aPreserveCorners ) );
 
     return chamfered;
 }
@@ -1694,8 +1728,8 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Fillet( int aRadius, int aErrorMax,
 {
     SHAPE_POLY_SET filleted;
 
-    for( size_t idx = 0; idx < m_polys.size(); idx++ )
-        filleted.m_polys.push_back( FilletPolygon( aRadius, aErrorMax, idx, aPreserveCorners ) );
+    for( size_t idx = 0; idx < polys().size(); idx++ )
+        filleted.mutablePolys().push_back( FilletPolygon( aRadius, aErrorMax, idx, aPreserveCorners ) );
 
     return filleted;
 }
@@ -1708,7 +1742,7 @@ SHAPE_POLY_SET::POLYGON SHAPE_POLY_SET::chamferFilletPolygon( CORNER_MODE aMode,
     // Null segments create serious issues in calculations. Remove them:
     RemoveNullSegments();
 
-    SHAPE_POLY_SET::POLYGON currentPoly = Polygon( aIndex );
+    SHAPE_POLY_SET::POLYGON currentPoly = CPolygon( aIndex );
     SHAPE_POLY_SET::POLYGON newPoly;
 
     // If the chamfering distance is zero, then the polygon remain intact.
@@ -1872,12 +1906,8 @@ SHAPE_POLY_SET::POLYGON SHAPE_POLY_SET::chamferFilletPolygon( CORNER_MODE aMode,
 SHAPE_POLY_SET &SHAPE_POLY_SET::operator=( const SHAPE_POLY_SET& aOther )
 {
     static_cast<SHAPE&>(*this) = aOther;
-    m_polys = aOther.m_polys;
+    copyFrom( aOther, false );
 
-    // reset poly cache:
-    m_hash = MD5_HASH{};
-    m_triangulationValid = false;
-    m_triangulatedPolys.clear();
     return *this;
 }
 
@@ -1931,18 +1961,18 @@ void SHAPE_POLY_SET::CacheTriangulation()
     if( tmpSet.HasHoles() )
         tmpSet.Fracture( PM_FAST );
 
-    m_triangulatedPolys.clear();
+    auto triangulation = std::make_shared<TRIANGULATION>();
     m_triangulationValid = true;
 
     while( tmpSet.OutlineCount() > 0 )
     {
-        m_triangulatedPolys.push_back( std::make_unique<TRIANGULATED_POLYGON>() );
-        PolygonTriangulation tess( *m_triangulatedPolys.back() );
+        triangulation->push_back( std::make_unique<TRIANGULATED_POLYGON>() );
+        PolygonTriangulation tess( *triangulation->back() );
 
         // If the tesselation fails, we re-fracture the polygon, which will
         // first simplify the system before fracturing and removing the holes
         // This may result in multiple, disjoint polygons.
-        if( !tess.TesselatePolygon( tmpSet.Polygon( 0 ).front() ) )
+        if( !tess.TesselatePolygon( tmpSet.CPolygon( 0 ).front() ) )
         {
             tmpSet.Fracture( PM_FAST );
             m_triangulationValid = false;
@@ -1953,18 +1983,29 @@ void SHAPE_POLY_SET::CacheTriangulation()
         m_triangulationValid = true;
     }
 
+    m_triangulatedPolys = std::move( triangulation );
+
     if( m_triangulationValid )
         m_hash = checksum();
 }
 
 
+void SHAPE_POLY_SET::SetTriangulation(
+        std::vector<std::unique_ptr<TRIANGULATED_POLYGON>> aTriangulation )
+{
+    m_triangulatedPolys = std::make_shared<TRIANGULATION>( std::move( aTriangulation ) );
+    m_triangulationValid = true;
+    m_hash = checksum();
+}
+
+
 MD5_HASH SHAPE_POLY_SET::checksum() const
 {
     MD5_HASH hash;
 
-    hash.Hash( m_polys.size() );
+    hash.Hash( polys().size() );
 
-    for( const auto& outline : m_polys )
+    for( const auto& outline : polys() )
     {
         hash.Hash( outline.size() );
 
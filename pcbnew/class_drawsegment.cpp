@@ -381,7 +381,7 @@ void DRAWSEGMENT::GetMsgPanelInfo( EDA_DRAW_FRAME* aFrame, std::vector<MSG_PANEL
     case S_POLYGON:
         aList.emplace_back( shape, _( "Polygon" ), RED );
 
-        msg.Printf( "%d", GetPolyShape().Outline(0).PointCount() );
+        msg.Printf( "%d", GetPolyShape().COutline(0).PointCount() );
         aList.emplace_back( _( "Points" ), msg, DARKGREEN );
         break;
 
@@ -402,7 +402,7 @@ void DRAWSEGMENT::GetMsgPanelInfo( EDA_DRAW_FRAME* aFrame, std::vector<MSG_PANEL
 
     if( m_Shape == S_POLYGON )
     {
-        VECTOR2I point0 = GetPolyShape().Outline(0).CPoint(0);
+        VECTOR2I point0 = GetPolyShape().COutline(0).CPoint(0);
         wxString origin = wxString::Format( "@(%s, %s)",
                                            MessageTextFromValue( units, point0.x ),
                                            MessageTextFromValue( units, point0.y ) );
@@ -881,7 +881,7 @@ bool DRAWSEGMENT::IsPolyShapeValid() const
     if( GetPolyShape().OutlineCount() == 0 )
         return false;
 
-    const SHAPE_LINE_CHAIN& outline = ((SHAPE_POLY_SET&)GetPolyShape()).Outline( 0 );
+    const SHAPE_LINE_CHAIN& outline = GetPolyShape().COutline( 0 );
 
     return outline.PointCount() > 2;
 }
@@ -107,8 +107,7 @@ ZONE_CONTAINER& ZONE_CONTAINER::operator=( const ZONE_CONTAINER& aOther )
     SetHatchStyle( aOther.GetHatchStyle() );
     SetHatchPitch( aOther.GetHatchPitch() );
     m_HatchLines = aOther.m_HatchLines;     // copy vector <SEG>
-    m_FilledPolysList.RemoveAllContours();
-    m_FilledPolysList.Append( aOther.m_FilledPolysList );
+    m_FilledPolysList = aOther.m_FilledPolysList;     // shared until modified
     m_FillSegmList.clear();
     m_FillSegmList = aOther.m_FillSegmList;
 
@@ -158,7 +157,7 @@ void ZONE_CONTAINER::initDataFromSrcInCopyCtor( const ZONE_CONTAINER& aZone )
     m_PadConnection = aZone.m_PadConnection;
     m_ThermalReliefGap = aZone.m_ThermalReliefGap;
     m_ThermalReliefCopperBridge = aZone.m_ThermalReliefCopperBridge;
-    m_FilledPolysList.Append( aZone.m_FilledPolysList );
+    m_FilledPolysList = aZone.m_FilledPolysList;      // shared until modified
     m_FillSegmList = aZone.m_FillSegmList;      // vector <> copy
 
     m_doNotAllowCopperPour = aZone.m_doNotAllowCopperPour;
@@ -560,7 +559,7 @@ bool ZONE_CONTAINER::HitTestCutout( const VECTOR2I& aRefPos, int* aOutlineIdx, i
     {
         for( int j = 0; j < m_Poly->HoleCount( i ); j++ )
         {
-            if( m_Poly->Hole( i, j ).PointInside( aRefPos ) )
+            if( m_Poly->CHole( i, j ).PointInside( aRefPos ) )
             {
                 if( aOutlineIdx )
                     *aOutlineIdx = i;
@@ -783,7 +782,7 @@ void ZONE_CONTAINER::RemoveCutout( int aOutlineIdx, int aHoleIdx )
     if( m_Poly->OutlineCount() < aOutlineIdx || m_Poly->HoleCount( aOutlineIdx ) < aHoleIdx )
         return;
 
-    SHAPE_POLY_SET cutPoly( m_Poly->Hole( aOutlineIdx, aHoleIdx ) );
+    SHAPE_POLY_SET cutPoly( m_Poly->CHole( aOutlineIdx, aHoleIdx ) );
 
     // Add the cutout back to the zone
     m_Poly->BooleanAdd( cutPoly, SHAPE_POLY_SET::PM_FAST );
@@ -1179,11 +1178,11 @@ double ZONE_CONTAINER::CalculateFilledArea()
     // each hole it has to compute the total area.
     for( int i = 0; i < m_FilledPolysList.OutlineCount(); i++ )
     {
-        m_area += m_FilledPolysList.Outline( i ).Area();
+        m_area += m_FilledPolysList.COutline( i ).Area();
 
         for( int j = 0; j < m_FilledPolysList.HoleCount( i ); j++ )
         {
-            m_area -= m_FilledPolysList.Hole( i, j ).Area();
+            m_area -= m_FilledPolysList.CHole( i, j ).Area();
         }
     }
 
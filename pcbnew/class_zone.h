@@ -30,6 +30,7 @@
 #define CLASS_ZONE_H_
 
 
+#include <memory>
 #include <vector>
 #include <gr_basic.h>
 #include <class_board_item.h>
@@ -45,6 +46,7 @@ class PCB_EDIT_FRAME;
 class BOARD;
 class ZONE_CONTAINER;
 class MSG_PANEL_ITEM;
+struct ZONE_FILL_CACHE;
 
 typedef std::vector<SEG> ZONE_SEGMENT_FILL;
 
@@ -649,6 +651,11 @@ public:
         return m_RawPolysList;
     }
 
+    SHAPE_POLY_SET& FilledPolysList()
+    {
+        return m_FilledPolysList;
+    }
+
     wxString GetSelectMenuText( EDA_UNITS aUnits ) const override;
 
     BITMAP_DEF GetMenuImage() const override;
@@ -744,6 +751,13 @@ public:
      */
     void BuildHashValue() { m_filledPolysHash = m_FilledPolysList.GetHash(); }
 
+    /**
+     * The intermediate results of the last fill, used by ZONE_FILLER to only redo the parts
+     * of a refill whose inputs have changed.  Not copied with the zone.
+     */
+    std::shared_ptr<ZONE_FILL_CACHE> GetFillCache() const { return m_fillCache; }
+    void SetFillCache( std::shared_ptr<ZONE_FILL_CACHE> aCache ) { m_fillCache = aCache; }
+
 
 
 #if defined(DEBUG)
@@ -852,6 +866,7 @@ protected:
     SHAPE_POLY_SET        m_RawPolysList;
     MD5_HASH              m_filledPolysHash;    // A hash value used in zone filling calculations
                                                 // to see if the filled areas are up to date
+    std::shared_ptr<ZONE_FILL_CACHE> m_fillCache;
 
     ZONE_HATCH_STYLE      m_hatchStyle;     // hatch style, see enum above
     int                   m_hatchPitch;     // for DIAGONAL_EDGE, distance between 2 hatch lines
@@ -26,11 +26,10 @@
 #include <widgets/progress_reporter.h>
 #include <geometry/geometry_utils.h>
 #include <board_commit.h>
+#include <thread_pool.h>
 
-#include <thread>
 #include <mutex>
 #include <algorithm>
-#include <future>
 
 #ifdef PROFILE
 #include <profile.h>
@@ -229,11 +228,10 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     if( m_itemList.IsDirty() )
     {
-        size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-                ( dirtyItems.size() + 7 ) / 8 );
+        size_t parallelThreadCount = std::min<size_t>(
+                THREAD_POOL::GetInstance().GetThreadCount(), ( dirtyItems.size() + 7 ) / 8 );
 
         std::atomic<size_t> nextItem( 0 );
-        std::vector<std::future<size_t>> returns( parallelThreadCount );
 
         auto conn_lambda = [&nextItem, &dirtyItems]
                             ( CN_LIST* aItemList, PROGRESS_REPORTER* aReporter) -> size_t
@@ -254,22 +252,26 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
             conn_lambda( &m_itemList, m_progressReporter );
         else
         {
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-                returns[ii] = std::async( std::launch::async, conn_lambda,
-                        &m_itemList, m_progressReporter );
+            TASK_GROUP tasks;
 
             for( size_t ii = 0; ii < parallelThreadCount; ++ii )
             {
-                // Here we balance returns with a 100ms timeout to allow UI updating
-                std::future_status status;
-                do
-                {
-                    if( m_progressReporter )
-                        m_progressReporter->KeepRefreshing();
+                tasks.Run( [&]()
+                           {
+                               conn_lambda( &m_itemList, m_progressReporter );
+                           } );
+            }
 
-                    status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-                } while( status != std::future_status::ready );
+            // Only the GUI thread may refresh the progress reporter; pool workers waiting
+            // for us (nested parallelism) help out with the tasks instead.
+            if( m_progressReporter && !THREAD_POOL::GetInstance().IsWorkerThread() )
+            {
+                // Here we balance returns with a 100ms timeout to allow UI updating
+                while( !tasks.WaitFor( std::chrono::milliseconds( 100 ) ) )
+                    m_progressReporter->KeepRefreshing();
             }
+
+            tasks.Wait();
         }
 
         if( m_progressReporter )
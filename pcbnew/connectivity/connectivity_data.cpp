@@ -27,13 +27,12 @@
 #include <profile.h>
 #endif
 
-#include <thread>
 #include <algorithm>
-#include <future>
 
 #include <connectivity/connectivity_data.h>
 #include <connectivity/connectivity_algo.h>
 #include <ratsnest_data.h>
+#include <thread_pool.h>
 
 CONNECTIVITY_DATA::CONNECTIVITY_DATA()
 {
@@ -106,12 +105,11 @@ void CONNECTIVITY_DATA::updateRatsnest()
     std::copy_if( m_nets.begin() + 1, m_nets.end(), std::back_inserter( dirty_nets ),
             [] ( RN_NET* aNet ) { return aNet->IsDirty() && aNet->GetNodeCount() > 0; } );
 
-    // We don't want to spin up a new thread for fewer than 8 nets (overhead costs)
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+    // We don't want to queue a new task for fewer than 8 nets (overhead costs)
+    size_t parallelThreadCount = std::min<size_t>( THREAD_POOL::GetInstance().GetThreadCount(),
             ( dirty_nets.size() + 7 ) / 8 );
 
     std::atomic<size_t> nextNet( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
 
     auto update_lambda = [&nextNet, &dirty_nets]() -> size_t
     {
@@ -121,16 +119,17 @@ void CONNECTIVITY_DATA::updateRatsnest()
         return 1;
     };
 
-    if( parallelThreadCount == 1 )
+    if( parallelThreadCount <= 1 )
         update_lambda();
     else
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
+        TASK_GROUP tasks;
 
-        // Finalize the ratsnest threads
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
+            tasks.Run( update_lambda );
+
+        // Finalize the ratsnest tasks
+        tasks.Wait();
     }
 
     #ifdef PROFILE
@@ -254,7 +253,37 @@ void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>&
         return ;
     }
 
-    CONNECTIVITY_DATA connData( aItems );
+    // While the same items are being dragged around, update them in the connectivity data of
+    // the previous call instead of building it again, so that their nets keep their
+    // triangulations
+    if( m_dynamicConnectivity && m_dynamicItems == aItems )
+    {
+        for( BOARD_ITEM* item : aItems )
+        {
+            switch( item->Type() )
+            {
+            case PCB_TRACE_T:
+            case PCB_ARC_T:
+            case PCB_VIA_T:
+            case PCB_PAD_T:
+            case PCB_MODULE_T:
+                m_dynamicConnectivity->Update( item );
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        m_dynamicConnectivity->RecalculateRatsnest();
+    }
+    else
+    {
+        m_dynamicConnectivity = std::make_unique<CONNECTIVITY_DATA>( aItems );
+        m_dynamicItems = aItems;
+    }
+
+    CONNECTIVITY_DATA& connData = *m_dynamicConnectivity;
     BlockRatsnestItems( aItems );
 
     for( unsigned int nc = 1; nc < connData.m_nets.size(); nc++ )
@@ -307,6 +336,9 @@ void CONNECTIVITY_DATA::ClearDynamicRatsnest()
 {
     m_connAlgo->ForEachAnchor( [] ( CN_ANCHOR& anchor ) { anchor.SetNoLine( false ); } );
     HideDynamicRatsnest();
+
+    m_dynamicConnectivity.reset();
+    m_dynamicItems.clear();
 }
 
 
@@ -260,6 +260,10 @@ private:
     std::vector<RN_DYNAMIC_LINE> m_dynamicRatsnest;
     std::vector<RN_NET*> m_nets;
 
+    ///> Connectivity of the items of the last ComputeDynamicRatsnest() call
+    std::unique_ptr<CONNECTIVITY_DATA> m_dynamicConnectivity;
+    std::vector<BOARD_ITEM*>           m_dynamicItems;
+
     PROGRESS_REPORTER* m_progressReporter;
 
     std::mutex m_lock;
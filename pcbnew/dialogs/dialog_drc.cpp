@@ -94,6 +94,7 @@ DIALOG_DRC::~DIALOG_DRC()
     settings->m_DrcDialog.refill_zones       = m_cbRefillZones->GetValue();
     settings->m_DrcDialog.test_track_to_zone = m_cbReportAllTrackErrors->GetValue();
     settings->m_DrcDialog.test_footprints    = m_cbTestFootprints->GetValue();
+    settings->m_DrcDialog.online_drc         = m_cbOnlineDRC->GetValue();
     settings->m_DrcDialog.severities         = m_severities;
 
     m_markerTreeModel->DecRef();
@@ -146,6 +147,7 @@ void DIALOG_DRC::initValues()
     m_cbRefillZones->SetValue( cfg->m_DrcDialog.refill_zones );
     m_cbReportAllTrackErrors->SetValue( cfg->m_DrcDialog.test_track_to_zone );
     m_cbTestFootprints->SetValue( cfg->m_DrcDialog.test_footprints );
+    m_cbOnlineDRC->SetValue( cfg->m_DrcDialog.online_drc );
 
     m_severities = cfg->m_DrcDialog.severities;
     m_markerTreeModel->SetSeverities( m_severities );
@@ -186,6 +188,7 @@ void DIALOG_DRC::OnRunDRCClick( wxCommandEvent& aEvent )
     m_tester->m_refillZones            = m_cbRefillZones->GetValue();
     m_tester->m_reportAllTrackErrors   = m_cbReportAllTrackErrors->GetValue();
     m_tester->m_testFootprints         = m_cbTestFootprints->GetValue();
+    m_tester->m_onlineDRC              = m_cbOnlineDRC->GetValue();
 
     m_brdEditor->RecordDRCExclusions();
     deleteAllMarkers();
@@ -97,6 +97,11 @@ DIALOG_DRC_BASE::DIALOG_DRC_BASE( wxWindow* parent, wxWindowID id, const wxStrin
 	m_cbTestFootprints = new wxCheckBox( this, wxID_ANY, _("Test footprints against schematic"), wxDefaultPosition, wxDefaultSize, 0 );
 	bSizerOptSettings->Add( m_cbTestFootprints, 0, wxBOTTOM|wxRIGHT|wxLEFT, 5 );
 
+	m_cbOnlineDRC = new wxCheckBox( this, wxID_ANY, _("Test changes as they are made (online DRC)"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_cbOnlineDRC->SetToolTip( _("If selected, once DRC has been run, edited items and their neighbours will be re-tested each time the board is changed.") );
+
+	bSizerOptSettings->Add( m_cbOnlineDRC, 0, wxBOTTOM|wxRIGHT|wxLEFT, 5 );
+
 
 	bSizerOptions->Add( bSizerOptSettings, 1, wxEXPAND, 5 );
 
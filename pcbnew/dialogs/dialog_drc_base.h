@@ -55,6 +55,7 @@ class DIALOG_DRC_BASE : public DIALOG_SHIM
 		wxCheckBox* m_cbReportAllTrackErrors;
 		wxCheckBox* m_cbReportTracksToZonesErrors;
 		wxCheckBox* m_cbTestFootprints;
+		wxCheckBox* m_cbOnlineDRC;
 		wxTextCtrl* m_Messages;
 		wxNotebook* m_Notebook;
 		wxPanel* m_panelViolations;
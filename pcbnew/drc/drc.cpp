@@ -41,6 +41,7 @@
 #include <tool/tool_manager.h>
 #include <tools/pcb_actions.h>
 #include <tools/pcb_tool_base.h>
+#include <tools/selection_tool.h>
 #include <tools/zone_filler_tool.h>
 #include <kiface_i.h>
 #include <pcbnew.h>
@@ -52,6 +53,7 @@
 #include <geometry/shape_arc.h>
 #include <drc/drc.h>
 #include <drc/drc_rule_parser.h>
+#include <drc/drc_rtree.h>
 #include <drc/drc_item.h>
 #include <drc/drc_courtyard_tester.h>
 #include <drc/drc_drilled_hole_tester.h>
@@ -60,6 +62,9 @@
 #include <drc/drc_textvar_tester.h>
 #include <drc/footprint_tester.h>
 #include <dialogs/panel_setup_rules.h>
+#include <thread_pool.h>
+
+#include <atomic>
 
 DRC::DRC() :
         PCB_TOOL_BASE( "pcbnew.DRCTool" ),
@@ -67,6 +72,7 @@ DRC::DRC() :
         m_pcb( nullptr ),
         m_board_outline_valid( false ),
         m_drcDialog( nullptr ),
+        m_onlineIndexed( false ),
         m_largestClearance( 0 )
 {
     // establish initial values for everything:
@@ -76,14 +82,19 @@ DRC::DRC() :
     m_refillZones = false;              // Only fill zones if requested by user.
     m_reportAllTrackErrors = false;
     m_testFootprints = false;
+    m_onlineDRC = false;
 
     m_drcRun = false;
     m_footprintsTested = false;
+
+    m_dummyEdge.SetLayer( Edge_Cuts );
 }
 
 
 DRC::~DRC()
 {
+    DetachBoard();
+
     for( DRC_ITEM* unconnectedItem : m_unconnected )
         delete unconnectedItem;
 
@@ -101,8 +112,189 @@ void DRC::Reset( RESET_REASON aReason )
         if( m_drcDialog )
             DestroyDRCDialog( wxID_OK );
 
+        // Note: the previous board has already been deleted, so there is no need (and no
+        // way) to unregister from it.
         m_pcb = m_editFrame->GetBoard();
+        m_pcb->AddListener( this );
+
+        // Online DRC needs a full run on the new board before it can work incrementally
+        m_onlineDRC = false;
+        clearDirtyItems();
+        clearOnlineIndex();
+    }
+}
+
+
+void DRC::DetachBoard()
+{
+    if( m_pcb )
+        m_pcb->RemoveListener( this );
+
+    m_pcb = nullptr;
+    clearDirtyItems();
+    clearOnlineIndex();
+}
+
+
+void DRC::StartOnlineDRC( BOARD* aBoard )
+{
+    if( m_pcb != aBoard )
+    {
+        DetachBoard();
+        m_pcb = aBoard;
+        m_pcb->AddListener( this );
+    }
+
+    m_onlineDRC = true;
+    clearDirtyItems();
+    indexOnlineItems();
+}
+
+
+void DRC::OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    OnBoardItemChanged( aBoard, aBoardItem );
+}
+
+
+void DRC::OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    if( !m_onlineDRC || !m_onlineIndexed || aBoardItem->Type() == PCB_MARKER_T )
+        return;
+
+    m_dirtyItems.erase( aBoardItem );
+    m_removedItems.insert( aBoardItem->m_Uuid );
+    m_removedAreas.push_back( aBoardItem->GetBoundingBox() );
+
+    if( aBoardItem->Type() == PCB_MODULE_T )
+    {
+        MODULE* module = static_cast<MODULE*>( aBoardItem );
+
+        for( D_PAD* pad : module->Pads() )
+        {
+            m_dirtyItems.erase( pad );
+            m_removedItems.insert( pad->m_Uuid );
+        }
+
+        unindexOnlinePads( module, m_removedAreas, m_removedItems );
+    }
+    else
+    {
+        unindexOnlineItem( aBoardItem, m_removedAreas, m_removedItems );
+    }
+}
+
+
+void DRC::OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    if( !m_onlineDRC || !m_onlineIndexed || aBoardItem->Type() == PCB_MARKER_T )
+        return;
+
+    m_dirtyItems.insert( aBoardItem );
+}
+
+
+void DRC::clearDirtyItems()
+{
+    m_dirtyItems.clear();
+    m_removedItems.clear();
+    m_removedAreas.clear();
+}
+
+
+void DRC::clearOnlineIndex()
+{
+    m_onlineIndexed = false;
+    m_onlineTree.RemoveAll();
+    m_onlineItems.clear();
+    m_onlinePads.clear();
+}
+
+
+void DRC::indexOnlineItems()
+{
+    clearOnlineIndex();
+
+    for( TRACK* track : m_pcb->Tracks() )
+        indexOnlineItem( track );
+
+    for( MODULE* module : m_pcb->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+            indexOnlineItem( pad );
+
+        m_onlinePads[ module ].assign( module->Pads().begin(), module->Pads().end() );
+    }
+
+    m_onlineIndexed = true;
+}
+
+
+void DRC::indexOnlineItem( BOARD_ITEM* aItem )
+{
+    ONLINE_ITEM entry;
+
+    entry.m_Uuid = aItem->m_Uuid;
+    entry.m_Layers = aItem->GetLayerSet();
+
+    if( aItem->Type() == PCB_PAD_T )
+    {
+        D_PAD* pad = static_cast<D_PAD*>( aItem );
+
+        entry.m_BBox = EDA_RECT( pad->GetPosition(), wxSize( 0, 0 ) );
+        entry.m_BBox.Inflate( pad->GetBoundingRadius() );
+    }
+    else
+    {
+        entry.m_BBox = aItem->GetBoundingBox();
     }
+
+    auto it = m_onlineItems.find( aItem );
+
+    if( it != m_onlineItems.end() )
+        m_onlineTree.Remove( aItem, it->second.m_BBox, it->second.m_Layers );
+
+    m_onlineTree.Insert( aItem, entry.m_BBox, entry.m_Layers );
+    m_onlineItems[ aItem ] = entry;
+}
+
+
+void DRC::unindexOnlineItem( BOARD_ITEM* aItem, std::vector<EDA_RECT>& aOldAreas,
+                             std::set<KIID>& aOldIDs )
+{
+    // The item itself may have changed already, so only use what was indexed
+    auto it = m_onlineItems.find( aItem );
+
+    if( it == m_onlineItems.end() )
+        return;
+
+    m_onlineTree.Remove( aItem, it->second.m_BBox, it->second.m_Layers );
+    aOldAreas.push_back( it->second.m_BBox );
+    aOldIDs.insert( it->second.m_Uuid );
+    m_onlineItems.erase( it );
+}
+
+
+void DRC::unindexOnlinePads( MODULE* aModule, std::vector<EDA_RECT>& aOldAreas,
+                             std::set<KIID>& aOldIDs )
+{
+    // An undo swaps the pads of the module, which may not be the indexed ones anymore
+    auto it = m_onlinePads.find( aModule );
+
+    if( it == m_onlinePads.end() )
+        return;
+
+    for( D_PAD* pad : it->second )
+        unindexOnlineItem( pad, aOldAreas, aOldIDs );
+
+    m_onlinePads.erase( it );
+}
+
+
+int DRC::onBoardChanged( const TOOL_EVENT& aEvent )
+{
+    testChangedItems();
+    return 0;
 }
 
 
@@ -218,6 +410,7 @@ bool DRC::LoadRules()
     BOARD_DESIGN_SETTINGS& bds = m_pcb->GetDesignSettings();
     bds.m_DRCRuleSelectors = m_ruleSelectors;
     bds.m_DRCRules = m_rules;
+    bds.m_DRCRuleResolver = std::make_shared<DRC_RULE_RESOLVER>( m_ruleSelectors );
 
     return true;
 }
@@ -468,6 +661,14 @@ void DRC::RunTests( wxTextCtrl* aMessages )
     commit.Push( wxEmptyString, false, false );
     m_drcRun = true;
 
+    // This run is the new baseline for the online DRC
+    clearDirtyItems();
+
+    if( m_onlineDRC )
+        indexOnlineItems();
+    else
+        clearOnlineIndex();
+
     // update the m_drcDialog listboxes
     updatePointers();
 
@@ -535,10 +736,7 @@ void DRC::testPadClearances( BOARD_COMMIT& aCommit )
             int minClearance = bds.m_CopperEdgeClearance;
             m_clearanceSource = _( "board edge" );
 
-            static DRAWSEGMENT dummyEdge;
-            dummyEdge.SetLayer( Edge_Cuts );
-
-            if( pad->GetRuleClearance( &dummyEdge, &minClearance, &m_clearanceSource ) )
+            if( pad->GetRuleClearance( &m_dummyEdge, &minClearance, &m_clearanceSource ) )
                 /* minClearance and m_clearanceSource set in GetRuleClearance() */;
 
             for( auto it = m_board_outlines.IterateSegmentsWithHoles(); it; it++ )
@@ -578,11 +776,11 @@ void DRC::testPadClearances( BOARD_COMMIT& aCommit )
 
 void DRC::testTracks( BOARD_COMMIT& aCommit, wxWindow *aActiveWindow, bool aShowProgressBar )
 {
-    wxProgressDialog* progressDialog = NULL;
-    const int         delta = 500;  // This is the number of tests between 2 calls to the
-                                    // progress bar
-    int               count = m_pcb->Tracks().size();
-    int               deltamax = count/delta;
+    wxProgressDialog*   progressDialog = NULL;
+    const int           delta = 500;  // This is the number of tests between 2 calls to the
+                                      // progress bar
+    std::vector<TRACK*> tracks( m_pcb->Tracks().begin(), m_pcb->Tracks().end() );
+    int                 deltamax = tracks.size() / delta;
 
     if( aShowProgressBar && deltamax > 3 )
     {
@@ -605,20 +803,114 @@ void DRC::testTracks( BOARD_COMMIT& aCommit, wxWindow *aActiveWindow, bool aShow
         connectivity->Build( m_pcb ); // just in case. This really needs to be reliable.
     }
 
-    int ii = 0;
-    count = 0;
+    // Broad phase: index pads and tracks by layer.  The trees hold positions in board
+    // order so that the narrow phase visits candidates in the same order a linear scan
+    // would, and each pair of tracks is only tested once.
+    std::vector<D_PAD*> pads;
+
+    for( MODULE* mod : m_pcb->Modules() )
+    {
+        for( D_PAD* pad : mod->Pads() )
+            pads.push_back( pad );
+    }
+
+    DRC_RTREE<size_t> padTree;
+    DRC_RTREE<size_t> trackTree;
+
+    for( size_t ii = 0; ii < pads.size(); ++ii )
+    {
+        EDA_RECT padBB( pads[ii]->GetPosition(), wxSize( 0, 0 ) );
+        padBB.Inflate( pads[ii]->GetBoundingRadius() );
+
+        padTree.Insert( ii, padBB, pads[ii]->GetLayerSet() );
+    }
+
+    for( size_t ii = 0; ii < tracks.size(); ++ii )
+        trackTree.Insert( ii, tracks[ii]->GetBoundingBox(), tracks[ii]->GetLayerSet() );
 
-    for( auto seg_it = m_pcb->Tracks().begin(); seg_it != m_pcb->Tracks().end(); seg_it++ )
+    // Narrow phase: doTrackDrc() only reads the board, so the tracks can be shared out
+    // between worker threads.  Each track gets its own marker list, which keeps the
+    // final order independent of the thread scheduling.
+    std::vector<std::vector<MARKER_PCB*>> markers( tracks.size() );
+    std::atomic<size_t>                   nextItem( 0 );
+    std::atomic<size_t>                   doneCount( 0 );
+    std::atomic<bool>                     cancelled( false );
+    size_t                                parallelThreadCount =
+            std::min<size_t>( THREAD_POOL::GetInstance().GetThreadCount(), tracks.size() );
+
+    auto drc_lambda = [&]() -> size_t
     {
-        if( ii++ > delta )
+        std::vector<size_t> candidates;
+        std::vector<D_PAD*> candidatePads;
+        std::vector<TRACK*> candidateTracks;
+        size_t              num = 0;
+
+        auto collector = [&]( const size_t& aIndex ) -> bool
+                         {
+                             candidates.push_back( aIndex );
+                             return true;
+                         };
+
+        for( size_t i = nextItem++; i < tracks.size() && !cancelled; i = nextItem++ )
         {
-            ii = 0;
-            count++;
+            TRACK*   refSeg = tracks[i];
+            LSET     refLayers = refSeg->GetLayerSet();
+            EDA_RECT searchBB = refSeg->GetBoundingBox();
+
+            searchBB.Inflate( m_largestClearance + 1 );
+
+            candidates.clear();
+            candidatePads.clear();
+            padTree.Query( searchBB, refLayers, collector );
+            std::sort( candidates.begin(), candidates.end() );
+            candidates.erase( std::unique( candidates.begin(), candidates.end() ),
+                              candidates.end() );
+
+            for( size_t idx : candidates )
+                candidatePads.push_back( pads[idx] );
+
+            candidates.clear();
+            candidateTracks.clear();
+            trackTree.Query( searchBB, refLayers, collector );
+            std::sort( candidates.begin(), candidates.end() );
+            candidates.erase( std::unique( candidates.begin(), candidates.end() ),
+                              candidates.end() );
+
+            for( size_t idx : candidates )
+            {
+                if( idx > i )
+                    candidateTracks.push_back( tracks[idx] );
+            }
+
+            // Test new segment against tracks and pads, optionally against copper zones
+            doTrackDrc( refSeg, candidatePads, candidateTracks, m_testTracksAgainstZones, false,
+                        markers[i] );
+
+            doneCount++;
+            num++;
+        }
 
-            if( progressDialog )
+        return num;
+    };
+
+    if( parallelThreadCount <= 1 )
+        drc_lambda();
+    else
+    {
+        TASK_GROUP tasks;
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            tasks.Run( drc_lambda );
+
+        // Here we balance returns with a 100ms timeout to allow UI updating
+        while( !tasks.WaitFor( std::chrono::milliseconds( 100 ) ) )
+        {
+            if( progressDialog && !cancelled )
             {
+                int count = std::min<int>( doneCount / delta, deltamax );
+
                 if( !progressDialog->Update( count, wxEmptyString ) )
-                    break;  // Aborted by user
+                    cancelled = true;   // Aborted by user
 #ifdef __WXMAC__
                 // Work around a dialog z-order issue on OS X
                 if( count == deltamax )
@@ -627,17 +919,26 @@ void DRC::testTracks( BOARD_COMMIT& aCommit, wxWindow *aActiveWindow, bool aShow
             }
         }
 
-        // Test new segment against tracks and pads, optionally against copper zones
-        doTrackDrc( aCommit, *seg_it, seg_it + 1, m_pcb->Tracks().end(), m_testTracksAgainstZones );
+        tasks.Wait();
+    }
+
+    // Merge the results in board order
+    for( size_t ii = 0; ii < tracks.size(); ++ii )
+    {
+        for( MARKER_PCB* marker : markers[ii] )
+            addMarkerToPcb( aCommit, marker );
+
+        if( cancelled )
+            continue;
 
         // Test for dangling items
-        int code = (*seg_it)->Type() == PCB_VIA_T ? DRCE_DANGLING_VIA : DRCE_DANGLING_TRACK;
+        int code = tracks[ii]->Type() == PCB_VIA_T ? DRCE_DANGLING_VIA : DRCE_DANGLING_TRACK;
         wxPoint pos;
 
-        if( !settings.Ignore( code ) && connectivity->TestTrackEndpointDangling( *seg_it, &pos ) )
+        if( !settings.Ignore( code ) && connectivity->TestTrackEndpointDangling( tracks[ii], &pos ) )
         {
             DRC_ITEM* drcItem = new DRC_ITEM( code );
-            drcItem->SetItems( *seg_it );
+            drcItem->SetItems( tracks[ii] );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, pos );
             addMarkerToPcb( aCommit, marker );
@@ -649,6 +950,271 @@ void DRC::testTracks( BOARD_COMMIT& aCommit, wxWindow *aActiveWindow, bool aShow
 }
 
 
+static bool isTrackTestCode( int aErrorCode )
+{
+    // The error codes which DRC::doTrackDrc() can report
+    switch( aErrorCode )
+    {
+    case DRCE_TOO_SMALL_VIA_ANNULUS:
+    case DRCE_TOO_SMALL_MICROVIA:
+    case DRCE_TOO_SMALL_VIA:
+    case DRCE_VIA_HOLE_BIGGER:
+    case DRCE_MICROVIA_NOT_ALLOWED:
+    case DRCE_BURIED_VIA_NOT_ALLOWED:
+    case DRCE_MICROVIA_TOO_MANY_LAYERS:
+    case DRCE_TOO_SMALL_TRACK_WIDTH:
+    case DRCE_TOO_LARGE_TRACK_WIDTH:
+    case DRCE_TRACK_NEAR_HOLE:
+    case DRCE_TRACK_NEAR_PAD:
+    case DRCE_TRACKS_CROSSING:
+    case DRCE_TRACK_ENDS:
+    case DRCE_VIA_NEAR_VIA:
+    case DRCE_VIA_NEAR_TRACK:
+    case DRCE_TRACK_SEGMENTS_TOO_CLOSE:
+    case DRCE_TRACK_NEAR_ZONE:
+    case DRCE_TRACK_NEAR_EDGE:
+    case DRCE_VIA_NEAR_EDGE:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
+void DRC::testChangedItems()
+{
+    std::vector<MARKER_PCB*> removed;
+    std::vector<MARKER_PCB*> added;
+
+    RetestChangedItems( removed, added );
+
+    if( removed.empty() && added.empty() )
+        return;
+
+    SELECTION_TOOL* selTool = m_toolMgr->GetTool<SELECTION_TOOL>();
+
+    for( MARKER_PCB* marker : removed )
+    {
+        if( marker->IsSelected() )
+            selTool->RemoveItemFromSel( marker, true /* quiet mode */ );
+
+        view()->Remove( marker );
+        delete marker;
+    }
+
+    for( MARKER_PCB* marker : added )
+        view()->Add( marker );
+
+    if( m_drcDialog )
+        m_drcDialog->SetMarkersProvider( new BOARD_DRC_ITEMS_PROVIDER( m_pcb ) );
+
+    m_editFrame->GetCanvas()->Refresh();
+}
+
+
+void DRC::RetestChangedItems( std::vector<MARKER_PCB*>& aRemoved,
+                              std::vector<MARKER_PCB*>& aAdded )
+{
+    if( !m_onlineDRC || !m_onlineIndexed || !m_pcb )
+        return;
+
+    if( m_dirtyItems.empty() && m_removedItems.empty() )
+        return;
+
+    BOARD_DESIGN_SETTINGS& bds = m_pcb->GetDesignSettings();
+    std::set<KIID>         dirtyIDs = m_removedItems;
+    std::set<TRACK*>       dirtyTracks;
+    std::vector<EDA_RECT>  dirtyAreas = m_removedAreas;
+
+    // The changed items are re-indexed, and both their old and new areas are re-tested so
+    // that the neighbours they moved away from are updated too.
+    for( BOARD_ITEM* item : m_dirtyItems )
+    {
+        dirtyIDs.insert( item->m_Uuid );
+        dirtyAreas.push_back( item->GetBoundingBox() );
+
+        switch( item->Type() )
+        {
+        case PCB_TRACE_T:
+        case PCB_ARC_T:
+        case PCB_VIA_T:
+            unindexOnlineItem( item, dirtyAreas, dirtyIDs );
+            indexOnlineItem( item );
+            dirtyTracks.insert( static_cast<TRACK*>( item ) );
+            break;
+
+        case PCB_PAD_T:
+            unindexOnlineItem( item, dirtyAreas, dirtyIDs );
+            indexOnlineItem( item );
+            break;
+
+        case PCB_MODULE_T:
+        {
+            MODULE* module = static_cast<MODULE*>( item );
+
+            unindexOnlinePads( module, dirtyAreas, dirtyIDs );
+
+            for( D_PAD* pad : module->Pads() )
+            {
+                indexOnlineItem( pad );
+                dirtyIDs.insert( pad->m_Uuid );
+            }
+
+            m_onlinePads[ module ].assign( module->Pads().begin(), module->Pads().end() );
+            break;
+        }
+
+        default:
+            // Other items are only checked by a full DRC run
+            break;
+        }
+    }
+
+    clearDirtyItems();
+
+    m_largestClearance = bds.GetBiggestClearanceValue();
+
+    // Gather everything within clearance range of the changes.  The results are sorted by
+    // ID to keep them independent of the memory layout.
+    std::set<TRACK*> nearTrackSet = dirtyTracks;
+    std::set<D_PAD*> nearPadSet;
+
+    auto collector = [&]( BOARD_ITEM* aItem ) -> bool
+                     {
+                         if( aItem->Type() == PCB_PAD_T )
+                             nearPadSet.insert( static_cast<D_PAD*>( aItem ) );
+                         else
+                             nearTrackSet.insert( static_cast<TRACK*>( aItem ) );
+
+                         return true;
+                     };
+
+    for( EDA_RECT& area : dirtyAreas )
+    {
+        area.Inflate( m_largestClearance + 1 );
+        m_onlineTree.Query( area, LSET::AllLayersMask(), collector );
+    }
+
+    auto byID = []( const BOARD_ITEM* a, const BOARD_ITEM* b )
+                {
+                    return a->m_Uuid < b->m_Uuid;
+                };
+
+    std::vector<TRACK*> nearTracks( nearTrackSet.begin(), nearTrackSet.end() );
+    std::vector<D_PAD*> nearPads( nearPadSet.begin(), nearPadSet.end() );
+
+    std::sort( nearTracks.begin(), nearTracks.end(), byID );
+    std::sort( nearPads.begin(), nearPads.end(), byID );
+
+    std::set<KIID> nearTrackIDs;
+    std::set<KIID> nearPadIDs;
+
+    for( TRACK* track : nearTracks )
+        nearTrackIDs.insert( track->m_Uuid );
+
+    for( D_PAD* pad : nearPads )
+        nearPadIDs.insert( pad->m_Uuid );
+
+    // Drop the markers which are about to be recomputed: track markers involving a changed
+    // item or two items near the changes, and dangling markers of the tracks whose
+    // connections may have changed.
+    std::set<wxString> exclusions;
+
+    for( MARKER_PCB* marker : m_pcb->Markers() )
+    {
+        int  code = marker->GetRCItem()->GetErrorCode();
+        KIID mainID = marker->GetRCItem()->GetMainItemID();
+        KIID auxID = marker->GetRCItem()->GetAuxItemID();
+        bool stale = false;
+
+        if( isTrackTestCode( code ) )
+        {
+            stale = dirtyIDs.count( mainID ) || dirtyIDs.count( auxID )
+                    || ( nearTrackIDs.count( mainID )
+                         && ( nearTrackIDs.count( auxID ) || nearPadIDs.count( auxID ) ) );
+        }
+        else if( code == DRCE_DANGLING_TRACK || code == DRCE_DANGLING_VIA )
+        {
+            stale = dirtyIDs.count( mainID ) || nearTrackIDs.count( mainID );
+        }
+
+        if( stale )
+        {
+            if( marker->IsExcluded() )
+                exclusions.insert( marker->Serialize() );
+
+            aRemoved.push_back( marker );
+        }
+    }
+
+    for( MARKER_PCB* marker : aRemoved )
+        m_pcb->Remove( marker );
+
+    // Re-test every pair of nearby items once, as a change may also uncover a problem
+    // between two unchanged items.  Only the changed tracks are tested on their own and
+    // against the zones.
+    // A full run may stop at the first error of each track, which here would lose the
+    // errors the dropped markers were hiding, so all the errors are reported.
+    std::vector<MARKER_PCB*> markers;
+    std::vector<TRACK*>      candidateTracks;
+    std::set<TRACK*>         testedTracks;
+    bool                     reportAllTrackErrors = m_reportAllTrackErrors;
+
+    m_reportAllTrackErrors = true;
+
+    for( TRACK* track : nearTracks )
+    {
+        bool dirty = dirtyTracks.count( track ) > 0;
+
+        candidateTracks.clear();
+
+        for( TRACK* other : nearTracks )
+        {
+            if( other != track && !testedTracks.count( other ) )
+                candidateTracks.push_back( other );
+        }
+
+        doTrackDrc( track, nearPads, candidateTracks, dirty && m_testTracksAgainstZones, !dirty,
+                    markers );
+        testedTracks.insert( track );
+    }
+
+    m_reportAllTrackErrors = reportAllTrackErrors;
+
+    std::shared_ptr<CONNECTIVITY_DATA> connectivity = m_pcb->GetConnectivity();
+
+    for( TRACK* track : nearTracks )
+    {
+        int code = track->Type() == PCB_VIA_T ? DRCE_DANGLING_VIA : DRCE_DANGLING_TRACK;
+        wxPoint pos;
+
+        if( !bds.Ignore( code ) && connectivity->TestTrackEndpointDangling( track, &pos ) )
+        {
+            DRC_ITEM* drcItem = new DRC_ITEM( code );
+            drcItem->SetItems( track );
+
+            markers.push_back( new MARKER_PCB( drcItem, pos ) );
+        }
+    }
+
+    for( MARKER_PCB* marker : markers )
+    {
+        if( bds.Ignore( marker->GetRCItem()->GetErrorCode() ) )
+        {
+            delete marker;
+            continue;
+        }
+
+        if( exclusions.count( marker->Serialize() ) )
+            marker->SetExcluded( true );
+
+        m_pcb->Add( marker );
+        aAdded.push_back( marker );
+    }
+}
+
+
 void DRC::testUnconnected()
 {
     for( DRC_ITEM* unconnectedItem : m_unconnected )
@@ -972,7 +1538,7 @@ void DRC::testCopperDrawItem( BOARD_COMMIT& aCommit, BOARD_ITEM* aItem )
 
         case S_POLYGON:
         {
-            SHAPE_LINE_CHAIN l = drawItem->GetPolyShape().Outline( 0 );
+            SHAPE_LINE_CHAIN l = drawItem->GetPolyShape().COutline( 0 );
 
             for( int i = 0; i < l.SegmentCount(); i++ )
                 itemShape.push_back( l.Segment( i ) );
@@ -1380,6 +1946,9 @@ bool DRC::doPadToPadsDrc( BOARD_COMMIT& aCommit, D_PAD* aRefPad, D_PAD** aStart,
 void DRC::setTransitions()
 {
     Go( &DRC::ShowDRCDialog,              PCB_ACTIONS::runDRC.MakeEvent() );
+
+    Go( &DRC::onBoardChanged,             TOOL_EVENT( TC_MESSAGE, TA_MODEL_CHANGE, AS_GLOBAL ) );
+    Go( &DRC::onBoardChanged,             TOOL_EVENT( TC_MESSAGE, TA_UNDO_REDO_POST, AS_GLOBAL ) );
 }
 
 
@@ -29,9 +29,13 @@
 #include <class_board.h>
 #include <class_track.h>
 #include <class_marker_pcb.h>
+#include <class_drawsegment.h>
+#include <drc/drc_rtree.h>
 #include <geometry/seg.h>
 #include <geometry/shape_poly_set.h>
 #include <memory>
+#include <set>
+#include <unordered_map>
 #include <vector>
 #include <tools/pcb_tool_base.h>
 
@@ -125,6 +129,7 @@ class DIALOG_DRC;
 class BOARD_ITEM;
 class BOARD;
 class D_PAD;
+class MODULE;
 class ZONE_CONTAINER;
 class TRACK;
 class MARKER_PCB;
@@ -145,8 +150,11 @@ class wxTextCtrl;
  * be sent to a text file on disk.
  * This class is given access to the windows and the BOARD
  * that it needs via its constructor or public access functions.
+ *
+ * When online DRC is enabled the tool also listens to the board, and after each commit
+ * re-tests only the tracks and pads near the changed items, updating the markers in place.
  */
-class DRC : public PCB_TOOL_BASE
+class DRC : public PCB_TOOL_BASE, public BOARD_LISTENER
 {
     friend class DIALOG_DRC;
 
@@ -157,6 +165,37 @@ public:
     /// @copydoc TOOL_INTERACTIVE::Reset()
     void Reset( RESET_REASON aReason ) override;
 
+    ///> BOARD_LISTENER overrides, used to track the changes for the online DRC.
+    void OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+
+    /**
+     * Stop listening to the board, which is about to be deleted.
+     */
+    void DetachBoard();
+
+    /**
+     * Start the online DRC on \a aBoard, taking its current markers as the result of a full
+     * run.  RunTests() does this for the edited board when the online DRC is enabled.
+     */
+    void StartOnlineDRC( BOARD* aBoard );
+
+    /**
+     * Re-test the tracks and pads near the items changed since the last pass (or the last
+     * full run) and update the track markers of the board.  Only the track tests are
+     * repeated; zone, courtyard, keepout, etc. tests still require a full DRC run.  All the
+     * errors of the re-tested tracks are reported, whatever m_reportAllTrackErrors is.
+     *
+     * This only updates the board, the caller updates the view and the selection.
+     *
+     * @param aRemoved [out] receives the markers removed from the board, which the caller
+     *                 must delete
+     * @param aAdded [out] receives the markers added to the board
+     */
+    void RetestChangedItems( std::vector<MARKER_PCB*>& aRemoved,
+                             std::vector<MARKER_PCB*>& aAdded );
+
 private:
     bool     m_doUnconnectedTest;       // enable unconnected tests
     bool     m_testTracksAgainstZones;  // enable zone to items clearance tests
@@ -164,6 +203,7 @@ private:
     bool     m_refillZones;             // refill zones if requested (by user).
     bool     m_reportAllTrackErrors;    // Report all tracks errors (or only 4 first errors)
     bool     m_testFootprints;          // Test footprints against schematic
+    bool     m_onlineDRC;               // Re-test changed items after each commit
 
     PCB_EDIT_FRAME*            m_editFrame;        // The pcb frame editor which owns the board
     BOARD*                     m_pcb;
@@ -179,6 +219,25 @@ private:
     std::vector<DRC_SELECTOR*> m_ruleSelectors;
     std::vector<DRC_RULE*>     m_rules;
 
+    // Online DRC: changes accumulated since the last incremental pass
+    std::set<BOARD_ITEM*>      m_dirtyItems;       // items added or modified
+    std::set<KIID>             m_removedItems;     // items removed
+    std::vector<EDA_RECT>      m_removedAreas;     // old bounding boxes of the changed items
+
+    // Online DRC: the tracks and pads as last tested, to find the neighbours of the changes
+    // and to re-test around the old position of the items which moved
+    struct ONLINE_ITEM
+    {
+        KIID     m_Uuid;
+        EDA_RECT m_BBox;
+        LSET     m_Layers;
+    };
+
+    bool                       m_onlineIndexed;    // m_onlineTree holds the board
+    DRC_RTREE<BOARD_ITEM*>     m_onlineTree;
+    std::unordered_map<BOARD_ITEM*, ONLINE_ITEM>          m_onlineItems;
+    std::unordered_map<MODULE*, std::vector<D_PAD*>>      m_onlinePads;   // pads by module
+
     // Temp variables for performance during a single DRC run
     //
     // wxString's c'tor is surprisingly expensive, and in the world of DRC everything matters
@@ -186,6 +245,7 @@ private:
     wxString                   m_msg;
     wxString                   m_clearanceSource;
     int                        m_largestClearance;
+    DRAWSEGMENT                m_dummyEdge;        // Edge_Cuts stand-in for rule lookups
 
 private:
     ///> Sets up handlers for various events.
@@ -196,18 +256,58 @@ private:
      */
     void updatePointers();
 
-    EDA_UNITS userUnits() const { return m_editFrame->GetUserUnits(); }
+    EDA_UNITS userUnits() const
+    {
+        return m_editFrame ? m_editFrame->GetUserUnits() : EDA_UNITS::MILLIMETRES;
+    }
 
     /**
      * Adds a DRC marker to the PCB through the COMMIT mechanism.
      */
     void addMarkerToPcb( BOARD_COMMIT& aCommit, MARKER_PCB* aMarker );
 
+    ///> Runs the online DRC after a commit or an undo/redo.
+    int onBoardChanged( const TOOL_EVENT& aEvent );
+
+    ///> Forgets the changes accumulated for the online DRC.
+    void clearDirtyItems();
+
+    ///> Forgets the online DRC index.
+    void clearOnlineIndex();
+
+    /**
+     * Run RetestChangedItems() and update the view and the selection.
+     */
+    void testChangedItems();
+
+    ///> Indexes the tracks and pads of the board for the online DRC.
+    void indexOnlineItems();
+
+    ///> Adds a track or pad to the online DRC index.
+    void indexOnlineItem( BOARD_ITEM* aItem );
+
+    /**
+     * Remove a track or pad from the online DRC index.
+     *
+     * @param aOldAreas [out] receives the bounding box of the item when it was indexed
+     * @param aOldIDs [out] receives the ID of the item when it was indexed
+     */
+    void unindexOnlineItem( BOARD_ITEM* aItem, std::vector<EDA_RECT>& aOldAreas,
+                            std::set<KIID>& aOldIDs );
+
+    ///> Removes the pads of a module, as they were indexed, from the online DRC index.
+    void unindexOnlinePads( MODULE* aModule, std::vector<EDA_RECT>& aOldAreas,
+                            std::set<KIID>& aOldIDs );
+
     //-----<categorical group tests>-----------------------------------------
 
     /**
      * Perform the DRC on all tracks.
      *
+     * Candidate pads and tracks are found through a layer-bucketed R-tree and the
+     * per-track tests are spread over worker threads.  The resulting markers are added
+     * to the commit in track order so the results do not depend on thread scheduling.
+     *
      * This test can take a while, a progress bar can be displayed
      * @param aActiveWindow = the active window ued as parent for the progress bar
      * @param aShowProgressBar = true to show a progress bar
@@ -253,15 +353,20 @@ private:
     /**
      * Test the current segment.
      *
+     * Does not modify the DRC object or the board and so may be called from several
+     * threads at once.
+     *
      * @param aRefSeg The segment to test
-     * @param aStartIt the iterator to the first track to test
-     * @param aEndIt the marker for the iterator end
+     * @param aPads the candidate pads to test against, in board order
+     * @param aTracks the candidate tracks to test against (those after aRefSeg in board order)
      * @param aTestZones true if should do copper zones test. This can be very time consumming
-     * @return bool - true if no problems, else false and m_currentMarker is
-     *          filled in with the problem information.
+     * @param aPairsOnly true to skip the tests concerning only aRefSeg (via and track sizes,
+     *                   board edge clearance)
+     * @param aMarkers [out] receives the markers for the problems found
      */
-    void doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aStartIt,
-                     TRACKS::iterator aEndIt, bool aTestZones );
+    void doTrackDrc( TRACK* aRefSeg, const std::vector<D_PAD*>& aPads,
+                     const std::vector<TRACK*>& aTracks, bool aTestZones, bool aPairsOnly,
+                     std::vector<MARKER_PCB*>& aMarkers );
 
     //-----<single tests>----------------------------------------------
 
@@ -136,11 +136,17 @@ bool poly2segmentDRC( wxPoint* aTref, int aTrefCount, wxPoint aSegStart, wxPoint
 }
 
 
-void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aStartIt,
-                      TRACKS::iterator aEndIt, bool aTestZones )
+void DRC::doTrackDrc( TRACK* aRefSeg, const std::vector<D_PAD*>& aPads,
+                      const std::vector<TRACK*>& aTracks, bool aTestZones, bool aPairsOnly,
+                      std::vector<MARKER_PCB*>& aMarkers )
 {
     BOARD_DESIGN_SETTINGS&     bds = m_pcb->GetDesignSettings();
 
+    // Note: this can run on several worker threads at once, so the message buffers must
+    // be local rather than the m_msg / m_clearanceSource members.
+    wxString     msg;
+    wxString     clearanceSource;
+
     SEG          refSeg( aRefSeg->GetStart(), aRefSeg->GetEnd() );
     PCB_LAYER_ID refLayer = aRefSeg->GetLayer();
     LSET         refLayerSet = aRefSeg->GetLayerSet();
@@ -154,11 +160,13 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
     /* Phase 0 : via DRC tests :              */
     /******************************************/
 
-    if( aRefSeg->Type() == PCB_VIA_T )
+    // Phases 0 and 4 only concern aRefSeg itself, and are skipped when only the clearances
+    // to aPads and aTracks are wanted.
+    if( !aPairsOnly && aRefSeg->Type() == PCB_VIA_T )
     {
         VIA *refvia = static_cast<VIA*>( aRefSeg );
         int viaAnnulus = ( refvia->GetWidth() - refvia->GetDrill() ) / 2;
-        int minAnnulus = refvia->GetMinAnnulus( &m_clearanceSource );
+        int minAnnulus = refvia->GetMinAnnulus( &clearanceSource );
 
         // test if the via size is smaller than minimum
         if( refvia->GetViaType() == VIATYPE::MICROVIA )
@@ -167,31 +175,31 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
             {
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TOO_SMALL_VIA_ANNULUS );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s %s; actual %s)" ),
-                              m_clearanceSource,
-                              MessageTextFromValue( userUnits(), minAnnulus, true ),
-                              MessageTextFromValue( userUnits(), viaAnnulus, true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s %s; actual %s)" ),
+                            clearanceSource,
+                            MessageTextFromValue( userUnits(), minAnnulus, true ),
+                            MessageTextFromValue( userUnits(), viaAnnulus, true ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( refvia );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-                addMarkerToPcb( aCommit, marker );
+                aMarkers.push_back( marker );
             }
 
             if( refvia->GetWidth() < bds.m_MicroViasMinSize )
             {
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TOO_SMALL_MICROVIA );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (board minimum %s; actual %s)" ),
-                              MessageTextFromValue( userUnits(), bds.m_MicroViasMinSize, true ),
-                              MessageTextFromValue( userUnits(), refvia->GetWidth(), true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (board minimum %s; actual %s)" ),
+                            MessageTextFromValue( userUnits(), bds.m_MicroViasMinSize, true ),
+                            MessageTextFromValue( userUnits(), refvia->GetWidth(), true ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( refvia );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-                addMarkerToPcb( aCommit, marker );
+                aMarkers.push_back( marker );
             }
         }
         else
@@ -199,38 +207,38 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
             if( bds.m_ViasMinAnnulus > minAnnulus )
             {
                 minAnnulus = bds.m_ViasMinAnnulus;
-                m_clearanceSource = _( "board minimum" );
+                clearanceSource = _( "board minimum" );
             }
 
             if( viaAnnulus < minAnnulus )
             {
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TOO_SMALL_VIA_ANNULUS );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s %s; actual %s)" ),
-                              m_clearanceSource,
-                              MessageTextFromValue( userUnits(), minAnnulus, true ),
-                              MessageTextFromValue( userUnits(), viaAnnulus, true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s %s; actual %s)" ),
+                            clearanceSource,
+                            MessageTextFromValue( userUnits(), minAnnulus, true ),
+                            MessageTextFromValue( userUnits(), viaAnnulus, true ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( refvia );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-                addMarkerToPcb( aCommit, marker );
+                aMarkers.push_back( marker );
             }
 
             if( refvia->GetWidth() < bds.m_ViasMinSize )
             {
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TOO_SMALL_VIA );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (board minimum %s; actual %s)" ),
-                              MessageTextFromValue( userUnits(), bds.m_ViasMinSize, true ),
-                              MessageTextFromValue( userUnits(), refvia->GetWidth(), true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (board minimum %s; actual %s)" ),
+                            MessageTextFromValue( userUnits(), bds.m_ViasMinSize, true ),
+                            MessageTextFromValue( userUnits(), refvia->GetWidth(), true ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( refvia );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-                addMarkerToPcb( aCommit, marker );
+                aMarkers.push_back( marker );
             }
         }
 
@@ -241,15 +249,15 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
         {
             DRC_ITEM* drcItem = new DRC_ITEM( DRCE_VIA_HOLE_BIGGER );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( " (diameter %s; drill %s)" ),
-                          MessageTextFromValue( userUnits(), refvia->GetWidth(), true ),
-                          MessageTextFromValue( userUnits(), refvia->GetDrillValue(), true ) );
+            msg.Printf( drcItem->GetErrorText() + _( " (diameter %s; drill %s)" ),
+                        MessageTextFromValue( userUnits(), refvia->GetWidth(), true ),
+                        MessageTextFromValue( userUnits(), refvia->GetDrillValue(), true ) );
 
-            drcItem->SetErrorMessage( m_msg );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( refvia );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-            addMarkerToPcb( aCommit, marker );
+            aMarkers.push_back( marker );
         }
 
         // test if the type of via is allowed due to design rules
@@ -257,12 +265,12 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
         {
             DRC_ITEM* drcItem = new DRC_ITEM( DRCE_MICROVIA_NOT_ALLOWED );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( " (board design rule constraints)" ) );
-            drcItem->SetErrorMessage( m_msg );
+            msg.Printf( drcItem->GetErrorText() + _( " (board design rule constraints)" ) );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( refvia );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-            addMarkerToPcb( aCommit, marker );
+            aMarkers.push_back( marker );
         }
 
         // test if the type of via is allowed due to design rules
@@ -270,12 +278,12 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
         {
             DRC_ITEM* drcItem = new DRC_ITEM( DRCE_BURIED_VIA_NOT_ALLOWED );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( " (board design rule constraints)" ) );
-            drcItem->SetErrorMessage( m_msg );
+            msg.Printf( drcItem->GetErrorText() + _( " (board design rule constraints)" ) );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( refvia );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-            addMarkerToPcb( aCommit, marker );
+            aMarkers.push_back( marker );
         }
 
         // For microvias: test if they are blind vias and only between 2 layers
@@ -300,23 +308,23 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
             {
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_MICROVIA_TOO_MANY_LAYERS );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s and %s not adjacent)" ),
-                              m_pcb->GetLayerName( layer1 ),
-                              m_pcb->GetLayerName( layer2 ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s and %s not adjacent)" ),
+                            m_pcb->GetLayerName( layer1 ),
+                            m_pcb->GetLayerName( layer2 ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( refvia );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, refvia->GetPosition() );
-                addMarkerToPcb( aCommit, marker );
+                aMarkers.push_back( marker );
             }
         }
 
     }
-    else    // This is a track segment
+    else if( !aPairsOnly )    // This is a track segment
     {
         int minWidth, maxWidth;
-        aRefSeg->GetWidthConstraints( &minWidth, &maxWidth, &m_clearanceSource );
+        aRefSeg->GetWidthConstraints( &minWidth, &maxWidth, &clearanceSource );
 
         int errorCode = 0;
         int constraintWidth;
@@ -338,16 +346,16 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
 
             DRC_ITEM* drcItem = new DRC_ITEM( errorCode );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( " (%s %s; actual %s)" ),
-                          m_clearanceSource,
-                          MessageTextFromValue( userUnits(), constraintWidth, true ),
-                          MessageTextFromValue( userUnits(), refSegWidth, true ) );
+            msg.Printf( drcItem->GetErrorText() + _( " (%s %s; actual %s)" ),
+                        clearanceSource,
+                        MessageTextFromValue( userUnits(), constraintWidth, true ),
+                        MessageTextFromValue( userUnits(), refSegWidth, true ) );
 
-            drcItem->SetErrorMessage( m_msg );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( aRefSeg );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, refsegMiddle );
-            addMarkerToPcb( aCommit, marker );
+            aMarkers.push_back( marker );
         }
     }
 
@@ -356,95 +364,88 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
     /* Phase 1 : test DRC track to pads :     */
     /******************************************/
 
-    // Compute the min distance to pads
-    for( MODULE* mod : m_pcb->Modules() )
+    // Compute the min distance to pads.  aPads holds the broad-phase candidates in board order.
+    for( D_PAD* pad : aPads )
     {
-        // Don't preflight at the module level.  Getting a module's bounding box goes
-        // through all its pads anyway (so it's no faster), and also all its drawings
-        // (so it's in fact slower).
-
-        for( D_PAD* pad : mod->Pads() )
-        {
-            // Preflight based on bounding boxes.
-            EDA_RECT inflatedBB = refSegBB;
-            inflatedBB.Inflate( pad->GetBoundingRadius() + m_largestClearance );
+        // Preflight based on bounding boxes.
+        EDA_RECT inflatedBB = refSegBB;
+        inflatedBB.Inflate( pad->GetBoundingRadius() + m_largestClearance );
 
-            if( !inflatedBB.Contains( pad->GetPosition() ) )
-                continue;
+        if( !inflatedBB.Contains( pad->GetPosition() ) )
+            continue;
 
-            if( !( pad->GetLayerSet() & refLayerSet ).any() )
-                continue;
+        if( !( pad->GetLayerSet() & refLayerSet ).any() )
+            continue;
 
-            // No need to check pads with the same net as the refSeg.
-            if( pad->GetNetCode() && aRefSeg->GetNetCode() == pad->GetNetCode() )
-                continue;
+        // No need to check pads with the same net as the refSeg.
+        if( pad->GetNetCode() && aRefSeg->GetNetCode() == pad->GetNetCode() )
+            continue;
 
-            if( pad->GetDrillSize().x > 0 )
-            {
-                int minClearance = aRefSeg->GetClearance( nullptr, &m_clearanceSource );
+        if( pad->GetDrillSize().x > 0 )
+        {
+            int minClearance = aRefSeg->GetClearance( nullptr, &clearanceSource );
 
-                /* Treat an oval hole as a line segment along the hole's major axis,
-                 * shortened by half its minor axis.
-                 * A circular hole is just a degenerate case of an oval hole.
-                 */
-                wxPoint slotStart, slotEnd;
-                int     slotWidth;
+            /* Treat an oval hole as a line segment along the hole's major axis,
+             * shortened by half its minor axis.
+             * A circular hole is just a degenerate case of an oval hole.
+             */
+            wxPoint slotStart, slotEnd;
+            int     slotWidth;
 
-                pad->GetOblongGeometry( pad->GetDrillSize(), &slotStart, &slotEnd, &slotWidth );
-                slotStart += pad->GetPosition();
-                slotEnd += pad->GetPosition();
+            pad->GetOblongGeometry( pad->GetDrillSize(), &slotStart, &slotEnd, &slotWidth );
+            slotStart += pad->GetPosition();
+            slotEnd += pad->GetPosition();
 
-                SEG     slotSeg( slotStart, slotEnd );
-                int     widths = ( slotWidth + refSegWidth ) / 2;
-                int     center2centerAllowed = minClearance + widths;
+            SEG     slotSeg( slotStart, slotEnd );
+            int     widths = ( slotWidth + refSegWidth ) / 2;
+            int     center2centerAllowed = minClearance + widths;
 
-                // Avoid square-roots if possible (for performance)
-                SEG::ecoord center2center_squared = refSeg.SquaredDistance( slotSeg );
+            // Avoid square-roots if possible (for performance)
+            SEG::ecoord center2center_squared = refSeg.SquaredDistance( slotSeg );
 
-                if( center2center_squared < SEG::Square( center2centerAllowed ) )
-                {
-                    int       actual = std::max( 0.0, sqrt( center2center_squared ) - widths );
-                    DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TRACK_NEAR_HOLE );
+            if( center2center_squared < SEG::Square( center2centerAllowed ) )
+            {
+                int       actual = std::max( 0.0, sqrt( center2center_squared ) - widths );
+                DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TRACK_NEAR_HOLE );
 
-                    m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                                  m_clearanceSource,
-                                  MessageTextFromValue( userUnits(), minClearance, true ),
-                                  MessageTextFromValue( userUnits(), actual, true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                            clearanceSource,
+                            MessageTextFromValue( userUnits(), minClearance, true ),
+                            MessageTextFromValue( userUnits(), actual, true ) );
 
-                    drcItem->SetErrorMessage( m_msg );
-                    drcItem->SetItems( aRefSeg, pad );
+                drcItem->SetErrorMessage( msg );
+                drcItem->SetItems( aRefSeg, pad );
 
-                    MARKER_PCB* marker = new MARKER_PCB( drcItem, GetLocation( aRefSeg, slotSeg ) );
-                    addMarkerToPcb( aCommit, marker );
+                MARKER_PCB* marker = new MARKER_PCB( drcItem, GetLocation( aRefSeg, slotSeg ) );
+                aMarkers.push_back( marker );
 
-                    if( !m_reportAllTrackErrors )
-                        return;
-                }
+                if( !m_reportAllTrackErrors )
+                    return;
             }
+        }
 
-            int minClearance = aRefSeg->GetClearance( pad, &m_clearanceSource );
-            int actual;
+        int minClearance = aRefSeg->GetClearance( pad, &clearanceSource );
+        int actual;
 
-            if( !checkClearanceSegmToPad( refSeg, refSegWidth, pad, minClearance, &actual ) )
-            {
-                actual = std::max( 0, actual );
-                SEG       padSeg( pad->GetPosition(), pad->GetPosition() );
-                DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TRACK_NEAR_PAD );
+        if( !checkClearanceSegmToPad( refSeg, refSegWidth, pad, minClearance, &actual ) )
+        {
+            actual = std::max( 0, actual );
+            SEG       padSeg( pad->GetPosition(), pad->GetPosition() );
+            DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TRACK_NEAR_PAD );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                              m_clearanceSource,
-                              MessageTextFromValue( userUnits(), minClearance, true ),
-                              MessageTextFromValue( userUnits(), actual, true ) );
+            msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                        clearanceSource,
+                        MessageTextFromValue( userUnits(), minClearance, true ),
+                        MessageTextFromValue( userUnits(), actual, true ) );
 
-                drcItem->SetErrorMessage( m_msg );
-                drcItem->SetItems( aRefSeg, pad );
+            drcItem->SetErrorMessage( msg );
+            drcItem->SetItems( aRefSeg, pad );
 
-                MARKER_PCB* marker = new MARKER_PCB( drcItem, GetLocation( aRefSeg, padSeg ) );
-                addMarkerToPcb( aCommit, marker );
+            MARKER_PCB* marker = new MARKER_PCB( drcItem, GetLocation( aRefSeg, padSeg ) );
+            aMarkers.push_back( marker );
 
-                if( !m_reportAllTrackErrors )
-                    return;
-            }
+            if( !m_reportAllTrackErrors )
+                return;
         }
     }
 
@@ -452,11 +453,10 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
     /* Phase 2: test DRC with other track segments */
     /***********************************************/
 
-    // Test the reference segment with other track segments
-    for( auto it = aStartIt; it != aEndIt; it++ )
+    // Test the reference segment with other track segments.  aTracks holds the broad-phase
+    // candidates which follow aRefSeg in board order.
+    for( TRACK* track : aTracks )
     {
-        TRACK* track = *it;
-
         // No problem if segments have the same net code:
         if( aRefSeg->GetNetCode() == track->GetNetCode() )
             continue;
@@ -491,7 +491,7 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
         if( !trackBB.Intersects( refSegBB ) )
             continue;
 
-        int minClearance = aRefSeg->GetClearance( track, &m_clearanceSource );
+        int minClearance = aRefSeg->GetClearance( track, &clearanceSource );
         SEG trackSeg( track->GetStart(), track->GetEnd() );
         int widths = ( refSegWidth + track->GetWidth() ) / 2;
         int center2centerAllowed = minClearance + widths;
@@ -504,11 +504,10 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
         if( intersection )
         {
             DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TRACKS_CROSSING );
-            drcItem->SetErrorMessage( m_msg );
             drcItem->SetItems( aRefSeg, track );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, (wxPoint) intersection.get() );
-            addMarkerToPcb( aCommit, marker );
+            aMarkers.push_back( marker );
 
             if( !m_reportAllTrackErrors )
                 return;
@@ -527,16 +526,16 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
             int       actual = std::max( 0.0, sqrt( center2center_squared ) - widths );
             DRC_ITEM* drcItem = new DRC_ITEM( errorCode );
 
-            m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                          m_clearanceSource,
-                          MessageTextFromValue( userUnits(), minClearance, true ),
-                          MessageTextFromValue( userUnits(), actual, true ) );
+            msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                        clearanceSource,
+                        MessageTextFromValue( userUnits(), minClearance, true ),
+                        MessageTextFromValue( userUnits(), actual, true ) );
 
-            drcItem->SetErrorMessage( m_msg );
+            drcItem->SetErrorMessage( msg );
             drcItem->SetItems( aRefSeg, track );
 
             MARKER_PCB* marker = new MARKER_PCB( drcItem, GetLocation( aRefSeg, trackSeg ) );
-            addMarkerToPcb( aCommit, marker );
+            aMarkers.push_back( marker );
 
             if( !m_reportAllTrackErrors )
                 return;
@@ -562,7 +561,7 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
             if( zone->GetNetCode() && zone->GetNetCode() == aRefSeg->GetNetCode() )
                 continue;
 
-            int             minClearance = aRefSeg->GetClearance( zone, &m_clearanceSource );
+            int             minClearance = aRefSeg->GetClearance( zone, &clearanceSource );
             int             widths = refSegWidth / 2;
             int             center2centerAllowed = minClearance + widths;
             SHAPE_POLY_SET* outline = const_cast<SHAPE_POLY_SET*>( &zone->GetFilledPolysList() );
@@ -579,16 +578,16 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
                 int       actual = std::max( 0.0, sqrt( center2center_squared ) - widths );
                 DRC_ITEM* drcItem = new DRC_ITEM( DRCE_TRACK_NEAR_ZONE );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                              m_clearanceSource,
-                              MessageTextFromValue( userUnits(), minClearance, true ),
-                              MessageTextFromValue( userUnits(), actual, true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                            clearanceSource,
+                            MessageTextFromValue( userUnits(), minClearance, true ),
+                            MessageTextFromValue( userUnits(), actual, true ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( aRefSeg, zone );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, GetLocation( aRefSeg, zone ) );
-                addMarkerToPcb( aCommit, marker );
+                aMarkers.push_back( marker );
             }
         }
     }
@@ -596,16 +595,13 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
     /***********************************************/
     /* Phase 4: test DRC with to board edge        */
     /***********************************************/
-    if( m_board_outline_valid )
+    if( !aPairsOnly && m_board_outline_valid )
     {
         int minClearance = bds.m_CopperEdgeClearance;
-        m_clearanceSource = _( "board edge" );
-
-        static DRAWSEGMENT dummyEdge;
-        dummyEdge.SetLayer( Edge_Cuts );
+        clearanceSource = _( "board edge" );
 
-        if( aRefSeg->GetRuleClearance( &dummyEdge, &minClearance, &m_clearanceSource ) )
-            /* minClearance and m_clearanceSource set in GetRuleClearance() */;
+        if( aRefSeg->GetRuleClearance( &m_dummyEdge, &minClearance, &clearanceSource ) )
+            /* minClearance and clearanceSource set in GetRuleClearance() */;
 
         SEG testSeg( aRefSeg->GetStart(), aRefSeg->GetEnd() );
         int halfWidth = refSegWidth / 2;
@@ -646,16 +642,16 @@ void DRC::doTrackDrc( BOARD_COMMIT& aCommit, TRACK* aRefSeg, TRACKS::iterator aS
                                                                        : DRCE_TRACK_NEAR_EDGE;
                 DRC_ITEM* drcItem = new DRC_ITEM( errorCode );
 
-                m_msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
-                              m_clearanceSource,
-                              MessageTextFromValue( userUnits(), minClearance, true ),
-                              MessageTextFromValue( userUnits(), actual, true ) );
+                msg.Printf( drcItem->GetErrorText() + _( " (%s clearance %s; actual %s)" ),
+                            clearanceSource,
+                            MessageTextFromValue( userUnits(), minClearance, true ),
+                            MessageTextFromValue( userUnits(), actual, true ) );
 
-                drcItem->SetErrorMessage( m_msg );
+                drcItem->SetErrorMessage( msg );
                 drcItem->SetItems( aRefSeg, edge );
 
                 MARKER_PCB* marker = new MARKER_PCB( drcItem, (wxPoint) pt );
-                addMarkerToPcb( aCommit, marker );
+                aMarkers.push_back( marker );
             }
         }
     }
@@ -0,0 +1,150 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_RTREE_H_
+#define DRC_RTREE_H_
+
+#include <eda_rect.h>
+#include <layers_id_colors_and_visibility.h>
+
+#include <geometry/rtree.h>
+
+
+/**
+ * DRC_RTREE -
+ * Implements a layer-bucketed R-tree used as the broad phase of the DRC clearance tests.
+ * Each item is inserted into the tree of every layer it lives on, so a query on a single
+ * layer only visits items which can actually collide on that layer.
+ * Non-owning.  The tree may be queried from several threads as long as it is not modified.
+ */
+template< class T >
+class DRC_RTREE
+{
+public:
+    typedef RTree<T, int, 2, double> DRC_LAYER_TREE;
+
+    DRC_RTREE()
+    {
+        for( int layer = 0; layer < PCB_LAYER_ID_COUNT; ++layer )
+            m_tree[layer] = nullptr;
+    }
+
+    ~DRC_RTREE()
+    {
+        for( int layer = 0; layer < PCB_LAYER_ID_COUNT; ++layer )
+            delete m_tree[layer];
+    }
+
+    /**
+     * Function Insert()
+     * Inserts an item into the trees of all of the layers in aLayers.
+     * @param aBBox is the (possibly pre-inflated) bounding box used for the broad phase.
+     */
+    void Insert( T aItem, const EDA_RECT& aBBox, LSET aLayers )
+    {
+        EDA_RECT  bbox = aBBox;
+        bbox.Normalize();
+
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        for( PCB_LAYER_ID layer : aLayers.Seq() )
+        {
+            if( !m_tree[layer] )
+                m_tree[layer] = new DRC_LAYER_TREE();
+
+            m_tree[layer]->Insert( mmin, mmax, aItem );
+        }
+    }
+
+    /**
+     * Function Remove()
+     * Removes an item from the trees of all of the layers in aLayers.
+     * @param aBBox must be the bounding box the item was inserted with.
+     */
+    void Remove( T aItem, const EDA_RECT& aBBox, LSET aLayers )
+    {
+        EDA_RECT  bbox = aBBox;
+        bbox.Normalize();
+
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        for( PCB_LAYER_ID layer : aLayers.Seq() )
+        {
+            if( m_tree[layer] )
+                m_tree[layer]->Remove( mmin, mmax, aItem );
+        }
+    }
+
+    /**
+     * Function RemoveAll()
+     * Removes all items from all layers.
+     */
+    void RemoveAll()
+    {
+        for( int layer = 0; layer < PCB_LAYER_ID_COUNT; ++layer )
+        {
+            if( m_tree[layer] )
+                m_tree[layer]->RemoveAll();
+        }
+    }
+
+    /**
+     * Function Query()
+     * Executes aVisitor for each item on aLayer whose bounding box intersects aBounds.
+     * The visitor returns false to stop the search.
+     */
+    template <class Visitor>
+    void Query( const EDA_RECT& aBounds, PCB_LAYER_ID aLayer, Visitor& aVisitor ) const
+    {
+        if( !m_tree[aLayer] )
+            return;
+
+        EDA_RECT  bbox = aBounds;
+        bbox.Normalize();
+
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        m_tree[aLayer]->Search( mmin, mmax, aVisitor );
+    }
+
+    /**
+     * Function Query()
+     * Executes aVisitor for each item on any of aLayers whose bounding box intersects
+     * aBounds.  Items living on several of the layers are visited once per layer.
+     */
+    template <class Visitor>
+    void Query( const EDA_RECT& aBounds, LSET aLayers, Visitor& aVisitor ) const
+    {
+        for( PCB_LAYER_ID layer : aLayers.Seq() )
+            Query( aBounds, layer, aVisitor );
+    }
+
+private:
+    DRC_LAYER_TREE* m_tree[PCB_LAYER_ID_COUNT];
+};
+
+
+#endif /* DRC_RTREE_H_ */
@@ -28,6 +28,9 @@
 #include <class_board.h>
 #include <class_board_item.h>
 
+#include <atomic>
+#include <unordered_map>
+
 /*
  * Rule tokens:
  *     disallow
@@ -64,15 +67,202 @@
  *     (rule "disallowMicrovias" (disallow micro_via))
  */
 
-DRC_RULE* GetRule( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem, int aConstraint )
+DRC_RULE_RESOLVER::DRC_RULE_RESOLVER( const std::vector<DRC_SELECTOR*>& aSelectors )
 {
-    // JEY TODO: the bulk of this will be replaced by Tom's expression evaluator
+    static std::atomic<unsigned> s_nextGeneration( 1 );
 
-    BOARD* board = aItem->GetBoard();
+    m_generation = s_nextGeneration++;
 
-    if( !board )
-        return nullptr;
+    bool tooManyValues = false;
+
+    auto bitFor =
+            [&]( auto& aList, auto aValue ) -> uint64_t
+            {
+                auto it = std::find( aList.begin(), aList.end(), aValue );
+
+                if( it == aList.end() )
+                    it = aList.insert( aList.end(), aValue );
+
+                size_t index = it - aList.begin();
+
+                // The signatures have a single 64 bit word
+                if( index >= 64 )
+                {
+                    tooManyValues = true;
+                    return 0;
+                }
+
+                return (uint64_t) 1 << index;
+            };
+
+    for( DRC_SELECTOR* selector : aSelectors )
+    {
+        COMPILED_SELECTOR compiled = { { nullptr, nullptr }, 0, { 0, 0 }, 0, 0, selector->m_Rule };
+
+        compiled.m_NetclassCount = std::min<int>( selector->m_MatchNetclasses.size(), 2 );
+
+        for( int ii = 0; ii < compiled.m_NetclassCount; ++ii )
+            compiled.m_Netclasses[ii] = selector->m_MatchNetclasses[ii].get();
+
+        compiled.m_TypeCount = std::min<int>( selector->m_MatchTypes.size(), 2 );
+
+        for( int ii = 0; ii < compiled.m_TypeCount; ++ii )
+            compiled.m_TypeBits[ii] = bitFor( m_types, selector->m_MatchTypes[ii] );
+
+        if( selector->m_MatchLayers.size() )
+            compiled.m_LayerBit = bitFor( m_layers, selector->m_MatchLayers[0] );
+
+        // TODO: area/room matches; only "$board" (which matches everything) is supported.
+
+        m_selectors.push_back( compiled );
+    }
+
+    // The selectors cannot be compiled; they are scanned for each query instead
+    if( tooManyValues )
+    {
+        m_selectors.clear();
+        m_types.clear();
+        m_layers.clear();
+        m_uncompiled = aSelectors;
+    }
+}
+
+
+bool DRC_RULE_RESOLVER::MATCH_KEY::operator==( const MATCH_KEY& aOther ) const
+{
+    return m_ANetclass == aOther.m_ANetclass && m_BNetclass == aOther.m_BNetclass
+            && m_ATypes == aOther.m_ATypes && m_BTypes == aOther.m_BTypes
+            && m_ALayers == aOther.m_ALayers && m_Constraint == aOther.m_Constraint
+            && m_HasB == aOther.m_HasB;
+}
+
+
+size_t DRC_RULE_RESOLVER::MATCH_KEY_HASH::operator()( const MATCH_KEY& aKey ) const
+{
+    size_t seed = std::hash<void*>()( aKey.m_ANetclass );
+
+    auto combine =
+            [&]( size_t aValue )
+            {
+                seed ^= aValue + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+            };
+
+    combine( std::hash<void*>()( aKey.m_BNetclass ) );
+    combine( std::hash<uint64_t>()( aKey.m_ATypes ) );
+    combine( std::hash<uint64_t>()( aKey.m_BTypes ) );
+    combine( std::hash<uint64_t>()( aKey.m_ALayers ) );
+    combine( std::hash<int>()( aKey.m_Constraint ) );
+    combine( aKey.m_HasB );
+
+    return seed;
+}
+
+
+uint64_t DRC_RULE_RESOLVER::typeSignature( const BOARD_ITEM* aItem ) const
+{
+    // IsType() depends on more than Type() (via types, pad holes, board edges, etc.), so
+    // the signature records the answer for each type the selectors ask about.
+    uint64_t signature = 0;
+    KICAD_T  scanTypes[2] = { EOT, EOT };
+
+    for( size_t ii = 0; ii < m_types.size(); ++ii )
+    {
+        scanTypes[0] = m_types[ii];
+
+        if( aItem->IsType( scanTypes ) )
+            signature |= (uint64_t) 1 << ii;
+    }
+
+    return signature;
+}
+
+
+uint64_t DRC_RULE_RESOLVER::layerSignature( const BOARD_ITEM* aItem ) const
+{
+    uint64_t signature = 0;
+
+    if( m_layers.empty() )
+        return signature;
+
+    LSET layers = aItem->GetLayerSet();
+
+    for( size_t ii = 0; ii < m_layers.size(); ++ii )
+    {
+        if( layers.test( m_layers[ii] ) )
+            signature |= (uint64_t) 1 << ii;
+    }
+
+    return signature;
+}
+
+
+DRC_RULE* DRC_RULE_RESOLVER::match( const MATCH_KEY& aKey ) const
+{
+    for( const COMPILED_SELECTOR& candidate : m_selectors )
+    {
+        if( candidate.m_NetclassCount == 2 )
+        {
+            if( !aKey.m_HasB )
+                continue;
+
+            NETCLASS* firstNetclass = candidate.m_Netclasses[0];
+            NETCLASS* secondNetclass = candidate.m_Netclasses[1];
+
+            if( !( aKey.m_ANetclass == firstNetclass && aKey.m_BNetclass == secondNetclass )
+                    && !( aKey.m_ANetclass == secondNetclass && aKey.m_BNetclass == firstNetclass ) )
+            {
+                continue;
+            }
+        }
+        else if( candidate.m_NetclassCount == 1 )
+        {
+            NETCLASS* matchNetclass = candidate.m_Netclasses[0];
 
+            if( matchNetclass != aKey.m_ANetclass
+                    && !( aKey.m_HasB && matchNetclass == aKey.m_BNetclass ) )
+            {
+                continue;
+            }
+        }
+
+        if( candidate.m_TypeCount == 2 )
+        {
+            if( !aKey.m_HasB )
+                continue;
+
+            uint64_t firstType = candidate.m_TypeBits[0];
+            uint64_t secondType = candidate.m_TypeBits[1];
+
+            if( !( ( aKey.m_ATypes & firstType ) && ( aKey.m_BTypes & secondType ) )
+                    && !( ( aKey.m_ATypes & secondType ) && ( aKey.m_BTypes & firstType ) ) )
+            {
+                continue;
+            }
+        }
+        else if( candidate.m_TypeCount == 1 )
+        {
+            uint64_t matchType = candidate.m_TypeBits[0];
+
+            if( !( aKey.m_ATypes & matchType ) && !( aKey.m_BTypes & matchType ) )
+                continue;
+        }
+
+        if( candidate.m_LayerBit && !( aKey.m_ALayers & candidate.m_LayerBit ) )
+            continue;
+
+        // All tests done; if we're still here then it matches
+
+        if( ( candidate.m_Rule->m_ConstraintFlags & aKey.m_Constraint ) > 0 )
+            return candidate.m_Rule;
+    }
+
+    return nullptr;
+}
+
+
+DRC_RULE* DRC_RULE_RESOLVER::matchUncompiled( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem,
+                                              int aConstraint ) const
+{
     NETCLASS* aNetclass = nullptr;
     NETCLASS* bNetclass = nullptr;
 
@@ -82,7 +272,7 @@ DRC_RULE* GetRule( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem, int aConstr
     if( bItem && bItem->IsConnected() )
         bNetclass = static_cast<const BOARD_CONNECTED_ITEM*>( bItem )->GetEffectiveNetclass();
 
-    for( DRC_SELECTOR* candidate : board->GetDesignSettings().m_DRCRuleSelectors )
+    for( DRC_SELECTOR* candidate : m_uncompiled )
     {
         if( candidate->m_MatchNetclasses.size() == 2 )
         {
@@ -136,17 +326,7 @@ DRC_RULE* GetRule( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem, int aConstr
                 continue;
         }
 
-        if( candidate->m_MatchAreas.size() )
-        {
-            if( candidate->m_MatchAreas[0] == "$board" )
-            {
-                // matches everything
-            }
-            else
-            {
-                // TODO: area/room matches...
-            }
-        }
+        // TODO: area/room matches; only "$board" (which matches everything) is supported.
 
         // All tests done; if we're still here then it matches
 
@@ -158,3 +338,74 @@ DRC_RULE* GetRule( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem, int aConstr
 }
 
 
+DRC_RULE* DRC_RULE_RESOLVER::Resolve( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem,
+                                      int aConstraint ) const
+{
+    struct MEMO
+    {
+        unsigned                                                m_Generation = 0;
+        std::unordered_map<MATCH_KEY, DRC_RULE*, MATCH_KEY_HASH> m_Rules;
+    };
+
+    // One memo per thread keeps the DRC worker threads from contending for a lock.  It is
+    // flushed whenever a different resolver (ie: a new set of rules) is used.
+    static thread_local MEMO memo;
+
+    if( !m_uncompiled.empty() )
+        return matchUncompiled( aItem, bItem, aConstraint );
+
+    if( m_selectors.empty() )
+        return nullptr;
+
+    MATCH_KEY key;
+
+    key.m_ANetclass = nullptr;
+    key.m_BNetclass = nullptr;
+    key.m_HasB = bItem != nullptr;
+    key.m_Constraint = aConstraint;
+
+    if( aItem->IsConnected() )
+        key.m_ANetclass = static_cast<const BOARD_CONNECTED_ITEM*>( aItem )->GetEffectiveNetclass();
+
+    if( bItem && bItem->IsConnected() )
+        key.m_BNetclass = static_cast<const BOARD_CONNECTED_ITEM*>( bItem )->GetEffectiveNetclass();
+
+    key.m_ATypes = typeSignature( aItem );
+    key.m_BTypes = bItem ? typeSignature( bItem ) : 0;
+    key.m_ALayers = layerSignature( aItem );
+
+    if( memo.m_Generation != m_generation )
+    {
+        memo.m_Rules.clear();
+        memo.m_Generation = m_generation;
+    }
+
+    auto it = memo.m_Rules.find( key );
+
+    if( it != memo.m_Rules.end() )
+        return it->second;
+
+    DRC_RULE* rule = match( key );
+    memo.m_Rules.emplace( key, rule );
+
+    return rule;
+}
+
+
+DRC_RULE* GetRule( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem, int aConstraint )
+{
+    // JEY TODO: the bulk of this will be replaced by Tom's expression evaluator
+
+    BOARD* board = aItem->GetBoard();
+
+    if( !board )
+        return nullptr;
+
+    const std::shared_ptr<DRC_RULE_RESOLVER>& resolver =
+            board->GetDesignSettings().m_DRCRuleResolver;
+
+    if( !resolver )
+        return nullptr;
+
+    return resolver->Resolve( aItem, bItem, aConstraint );
+}
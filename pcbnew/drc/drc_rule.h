@@ -28,6 +28,9 @@
 #include <netclass.h>
 #include <layers_id_colors_and_visibility.h>
 
+#include <cstdint>
+#include <vector>
+
 
 class BOARD_ITEM;
 
@@ -104,6 +107,80 @@ public:
 };
 
 
+/**
+ * DRC_RULE_RESOLVER
+ * is a compiled form of a list of DRC_SELECTORs, built once when the rules are loaded.
+ *
+ * Netclass, item type and layer tests are reduced to pointer compares and bit tests, and
+ * the rule chosen for a given (netclass pair, item types, layers, constraint) combination
+ * is memoized so that repeated lookups from the DRC inner loops are O(1).
+ *
+ * The resolver itself is immutable.  The memo is kept per thread so it may be used from
+ * the DRC worker threads without locking.
+ */
+class DRC_RULE_RESOLVER
+{
+public:
+    DRC_RULE_RESOLVER( const std::vector<DRC_SELECTOR*>& aSelectors );
+
+    /**
+     * Returns the first rule (in selector priority order) matching the given items and
+     * having aConstraint, or nullptr.  Gives the same result as a linear scan of the
+     * selectors.
+     */
+    DRC_RULE* Resolve( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem, int aConstraint ) const;
+
+    bool IsEmpty() const { return m_selectors.empty() && m_uncompiled.empty(); }
+
+private:
+    struct COMPILED_SELECTOR
+    {
+        NETCLASS* m_Netclasses[2];
+        int       m_NetclassCount;
+        uint64_t  m_TypeBits[2];      // bits in the type signature of the matched types
+        int       m_TypeCount;
+        uint64_t  m_LayerBit;         // bit in the layer signature, or 0 for any layer
+        DRC_RULE* m_Rule;
+    };
+
+    struct MATCH_KEY
+    {
+        NETCLASS* m_ANetclass;
+        NETCLASS* m_BNetclass;
+        uint64_t  m_ATypes;
+        uint64_t  m_BTypes;
+        uint64_t  m_ALayers;
+        int       m_Constraint;
+        bool      m_HasB;
+
+        bool operator==( const MATCH_KEY& aOther ) const;
+    };
+
+    struct MATCH_KEY_HASH
+    {
+        size_t operator()( const MATCH_KEY& aKey ) const;
+    };
+
+    uint64_t typeSignature( const BOARD_ITEM* aItem ) const;
+    uint64_t layerSignature( const BOARD_ITEM* aItem ) const;
+
+    DRC_RULE* match( const MATCH_KEY& aKey ) const;
+
+    /**
+     * Linear scan of the selectors, for when they ask about more distinct types or layers
+     * than the signatures can hold
+     */
+    DRC_RULE* matchUncompiled( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem,
+                               int aConstraint ) const;
+
+    std::vector<COMPILED_SELECTOR> m_selectors;
+    std::vector<KICAD_T>           m_types;        // distinct types referenced by the selectors
+    std::vector<PCB_LAYER_ID>      m_layers;       // distinct layers referenced by the selectors
+    unsigned                       m_generation;   // identifies this resolver's memo entries
+    std::vector<DRC_SELECTOR*>     m_uncompiled;   // selectors to scan when not compiled
+};
+
+
 DRC_RULE* GetRule( const BOARD_ITEM* aItem, const BOARD_ITEM* bItem, int aConstraint );
 
 
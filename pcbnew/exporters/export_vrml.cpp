@@ -869,7 +869,7 @@ static void export_vrml_board( MODEL_VRML& aModel, BOARD* aPcb )
         // Generate holes:
         for( int ii = 0; ii < pcbOutlines.HoleCount( cnt ); ii++ )
         {
-            const SHAPE_LINE_CHAIN& hole = pcbOutlines.Hole( cnt, ii );
+            const SHAPE_LINE_CHAIN& hole = pcbOutlines.CHole( cnt, ii );
 
             seg = aModel.m_holes.NewContour();
 
@@ -1146,7 +1146,7 @@ static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_P
                 0.0, corner_radius, 0.0, 0, ARC_HIGH_DEF );
         std::vector< wxRealPoint > cornerList;
         // TransformRoundChamferedRectToPolygon creates only one convex polygon
-        SHAPE_LINE_CHAIN poly( polySet.Outline( 0 ) );
+        SHAPE_LINE_CHAIN poly( polySet.COutline( 0 ) );
 
         cornerList.reserve( poly.PointCount() );
         for( int ii = 0; ii < poly.PointCount(); ++ii )
@@ -1169,7 +1169,7 @@ static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_P
 
         for( int cnt = 0; cnt < polySet.OutlineCount(); ++cnt )
         {
-            SHAPE_LINE_CHAIN& poly = polySet.Outline( cnt );
+            const SHAPE_LINE_CHAIN& poly = polySet.COutline( cnt );
             cornerList.clear();
 
             for( int ii = 0; ii < poly.PointCount(); ++ii )
@@ -195,7 +195,7 @@ int PLACEFILE_GERBER_WRITER::CreatePlaceFile( wxString& aFullFilename,
 
             for( int ii = 0; ii < courtyard.OutlineCount(); ii++ )
             {
-                SHAPE_LINE_CHAIN poly = courtyard.Outline( ii );
+                SHAPE_LINE_CHAIN poly = courtyard.COutline( ii );
 
                 if( !poly.PointCount() )
                     continue;
@@ -50,6 +50,8 @@
 #include <wx/stdpaths.h>
 #include <pcb_layer_widget.h>
 #include <wx/wupdlock.h>
+#include <advanced_config.h>
+#include <zone_fill_cache.h>
 
 
 //#define     USE_INSTRUMENTATION     1
@@ -591,6 +593,10 @@ bool PCB_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
         BOARD_DESIGN_SETTINGS& configBds = GetBoard()->GetDesignSettings();
         bds.m_DRCSeverities              = configBds.m_DRCSeverities;
 
+        // Must be restored before SetBoard(), which triangulates the zone fills
+        if( ADVANCED_CFG::GetCfg().m_ZoneFillCacheFile )
+            LoadZoneFillCache( loadedBoard, ZoneFillCacheFileName( fullFileName ) );
+
         SetBoard( loadedBoard );
 
         // we should not ask PLUGINs to do these items:
@@ -773,6 +779,10 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
     if( aCreateBackupFile )
         UpdateFileHistory( GetBoard()->GetFileName() );
 
+    // The cache is optional: failing to write it is not worth bothering the user about.
+    if( aCreateBackupFile && ADVANCED_CFG::GetCfg().m_ZoneFillCacheFile )
+        SaveZoneFillCache( GetBoard(), ZoneFillCacheFileName( pcbFileName.GetFullPath() ) );
+
     // Delete auto save file on successful save.
     wxFileName autoSaveFileName = pcbFileName;
 
@@ -53,6 +53,7 @@
 #include <pcb_draw_panel_gal.h>
 #include <pcb_edit_frame.h>
 #include <pcb_layer_widget.h>
+#include <pcb_undo_packer.h>
 #include <pcbnew.h>
 #include <pcbnew_id.h>
 #include <pgm_base.h>
@@ -173,6 +174,7 @@ FOOTPRINT_EDIT_FRAME::FOOTPRINT_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent,
 
     SetScreen( new PCB_SCREEN( GetPageSettings().GetSizeIU() ) );
     GetScreen()->SetMaxUndoItems( m_UndoRedoCountMax );
+    GetScreen()->SetUndoItemPacker( new PCB_UNDO_PACKER() );
 
     GetScreen()->AddGrid( m_UserGridSize, EDA_UNITS::UNSCALED, ID_POPUP_GRID_USER );
     GetScreen()->SetGrid( ID_POPUP_GRID_LEVEL_1000 + m_LastGridSizeId );
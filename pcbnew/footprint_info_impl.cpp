@@ -37,6 +37,12 @@
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
 
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
 #include <thread>
 #include <mutex>
 
@@ -118,9 +124,8 @@ void FOOTPRINT_LIST_IMPL::loader_job()
 bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname,
                                               PROGRESS_REPORTER* aProgressReporter )
 {
-    long long int generatedTimestamp = aTable->GenerateTimestamp( aNickname );
-
-    if( generatedTimestamp == m_list_timestamp )
+    // Nothing to do if the same libraries are requested and none of them changed.
+    if( libraryTimestamps( aTable, aNickname ) == m_lib_timestamps )
         return true;
 
     m_progress_reporter = aProgressReporter;
@@ -164,15 +169,34 @@ bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxStri
             m_progress_reporter->AdvancePhase();
     }
 
-    if( m_cancelled )
-        m_list_timestamp = 0;       // God knows what we got before we were cancelled
-    else
-        m_list_timestamp = generatedTimestamp;
+    // If cancelled, m_lib_timestamps only holds the libraries which did not need to be
+    // read.  God knows what we got of the others, they will be read again next time.
+    if( !m_cancelled )
+        m_lib_timestamps = m_load_timestamps;
 
     return m_errors.empty();
 }
 
 
+std::map<wxString, long long> FOOTPRINT_LIST_IMPL::libraryTimestamps( FP_LIB_TABLE* aTable,
+                                                                      const wxString* aNickname )
+{
+    std::map<wxString, long long> timestamps;
+
+    if( aNickname )
+    {
+        timestamps[ *aNickname ] = aTable->GenerateTimestamp( aNickname );
+    }
+    else
+    {
+        for( const wxString& nickname : aTable->GetLogicalLibs() )
+            timestamps[ nickname ] = aTable->GenerateTimestamp( &nickname );
+    }
+
+    return timestamps;
+}
+
+
 void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aNickname,
         FOOTPRINT_ASYNC_LOADER* aLoader, unsigned aNThreads )
 {
@@ -182,19 +206,43 @@ void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aN
     // Clear data before reading files
     m_count_finished.store( 0 );
     m_errors.clear();
-    m_list.clear();
     m_threads.clear();
     m_queue_in.clear();
     m_queue_out.clear();
 
-    if( aNickname )
-        m_queue_in.push( *aNickname );
-    else
+    m_load_timestamps = libraryTimestamps( aTable, aNickname );
+
+    // Keep the footprints of the requested libraries which did not change since they were
+    // read, and only read the others.
+    auto isCurrent =
+            [this]( const wxString& aLibNickname )
+            {
+                auto loaded = m_lib_timestamps.find( aLibNickname );
+                auto requested = m_load_timestamps.find( aLibNickname );
+
+                return loaded != m_lib_timestamps.end() && requested != m_load_timestamps.end()
+                       && loaded->second == requested->second;
+            };
+
+    m_list.erase( std::remove_if( m_list.begin(), m_list.end(),
+                                  [&]( const std::unique_ptr<FOOTPRINT_INFO>& aFootprint )
+                                  {
+                                      return !isCurrent( aFootprint->GetLibNickname() );
+                                  } ),
+                  m_list.end() );
+
+    std::map<wxString, long long> current;
+
+    for( const auto& pair : m_load_timestamps )
     {
-        for( auto const& nickname : aTable->GetLogicalLibs() )
-            m_queue_in.push( nickname );
+        if( isCurrent( pair.first ) )
+            current.insert( pair );
+        else
+            m_queue_in.push( pair.first );
     }
 
+    m_lib_timestamps = std::move( current );
+
     m_loader->m_total_libs = m_queue_in.size();
 
     for( unsigned i = 0; i < aNThreads; ++i )
@@ -218,9 +266,8 @@ void FOOTPRINT_LIST_IMPL::StopWorkers()
     m_queue_in.clear();
     m_count_finished.store( 0 );
 
-    // If we have cancelled in the middle of a load, clear our timestamp to re-load next time
-    if( m_cancelled )
-        m_list_timestamp = 0;
+    // If we have cancelled in the middle of a load, m_lib_timestamps does not include the
+    // libraries being read, so they are read again next time.
 }
 
 bool FOOTPRINT_LIST_IMPL::JoinWorkers()
@@ -325,7 +372,6 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
 FOOTPRINT_LIST_IMPL::FOOTPRINT_LIST_IMPL() :
     m_loader( nullptr ),
     m_count_finished( 0 ),
-    m_list_timestamp( 0 ),
     m_progress_reporter( nullptr ),
     m_cancelled( false )
 {
@@ -338,76 +384,252 @@ FOOTPRINT_LIST_IMPL::~FOOTPRINT_LIST_IMPL()
 }
 
 
-void FOOTPRINT_LIST_IMPL::WriteCacheToFile( wxTextFile* aCacheFile )
+/*
+ * The footprint info cache is a binary file, read with a single sequential read:
+ *
+ *   magic, version
+ *   library count, then for each library:  nickname, timestamp
+ *   footprint count, then for each footprint:  library index, name, description, keywords,
+ *                                              order number, pad count, unique pad count
+ *
+ * Integers are little endian and strings are UTF-8, preceded by their byte length.
+ */
+
+static const char FP_INFO_CACHE_MAGIC[] = "KIFPINFO";
+
+/// Bump this when the cache format changes.
+static const int32_t FP_INFO_CACHE_VERSION = 1;
+
+
+static void writeInt32( std::string& aData, int32_t aValue )
+{
+    uint32_t value = (uint32_t) aValue;
+
+    for( int ii = 0; ii < 4; ++ii )
+        aData.push_back( (char) ( ( value >> ( 8 * ii ) ) & 0xFF ) );
+}
+
+
+static void writeInt64( std::string& aData, int64_t aValue )
+{
+    uint64_t value = (uint64_t) aValue;
+
+    for( int ii = 0; ii < 8; ++ii )
+        aData.push_back( (char) ( ( value >> ( 8 * ii ) ) & 0xFF ) );
+}
+
+
+static void writeString( std::string& aData, const wxString& aValue )
+{
+    wxScopedCharBuffer utf8 = aValue.utf8_str();
+
+    writeInt32( aData, (int32_t) utf8.length() );
+    aData.append( utf8.data(), utf8.length() );
+}
+
+
+/**
+ * Read the values written by the functions above from a footprint info cache in memory.
+ * Reading past the end of the data throws std::out_of_range, so that a truncated cache
+ * is simply discarded.
+ */
+class FP_INFO_CACHE_READER
 {
-    if( aCacheFile->Exists() )
+public:
+    FP_INFO_CACHE_READER( const std::string& aData ) :
+            m_data( aData ),
+            m_pos( 0 )
     {
-        if( !aCacheFile->Open() )
-            return;
+    }
 
-        aCacheFile->Clear();
+    std::string ReadBytes( size_t aCount )
+    {
+        return std::string( take( aCount ), aCount );
     }
-    else
+
+    int32_t ReadInt32()
     {
-        if( !aCacheFile->Create() )
-            return;
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>( take( 4 ) );
+        uint32_t             value = 0;
+
+        for( int ii = 0; ii < 4; ++ii )
+            value |= (uint32_t) bytes[ii] << ( 8 * ii );
+
+        return (int32_t) value;
+    }
+
+    int64_t ReadInt64()
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>( take( 8 ) );
+        uint64_t             value = 0;
+
+        for( int ii = 0; ii < 8; ++ii )
+            value |= (uint64_t) bytes[ii] << ( 8 * ii );
+
+        return (int64_t) value;
+    }
+
+    /**
+     * Read an item count, which cannot exceed the number of remaining bytes.
+     */
+    size_t ReadCount()
+    {
+        size_t count = (uint32_t) ReadInt32();
+
+        if( count > m_data.size() - m_pos )
+            throw std::out_of_range( "invalid footprint info cache count" );
+
+        return count;
+    }
+
+    wxString ReadString()
+    {
+        size_t length = ReadCount();
+
+        return wxString::FromUTF8( take( length ), length );
+    }
+
+private:
+    const char* take( size_t aCount )
+    {
+        if( aCount > m_data.size() - m_pos )
+            throw std::out_of_range( "truncated footprint info cache" );
+
+        const char* bytes = m_data.data() + m_pos;
+        m_pos += aCount;
+        return bytes;
     }
 
-    aCacheFile->AddLine( wxString::Format( "%lld", m_list_timestamp ) );
+    const std::string& m_data;
+    size_t             m_pos;
+};
 
-    for( auto& fpinfo : m_list )
+
+void FOOTPRINT_LIST_IMPL::WriteCacheToFile( const wxString& aFilePath )
+{
+    std::string                 data( FP_INFO_CACHE_MAGIC, sizeof( FP_INFO_CACHE_MAGIC ) - 1 );
+    std::map<wxString, int32_t> libIndices;
+
+    writeInt32( data, FP_INFO_CACHE_VERSION );
+    writeInt32( data, (int32_t) m_lib_timestamps.size() );
+
+    for( const auto& pair : m_lib_timestamps )
     {
-        aCacheFile->AddLine( fpinfo->GetLibNickname() );
-        aCacheFile->AddLine( fpinfo->GetName() );
-        aCacheFile->AddLine( EscapeString( fpinfo->GetDescription(), CTX_DELIMITED_STR ) );
-        aCacheFile->AddLine( EscapeString( fpinfo->GetKeywords(), CTX_DELIMITED_STR ) );
-        aCacheFile->AddLine( wxString::Format( "%d", fpinfo->GetOrderNum() ) );
-        aCacheFile->AddLine( wxString::Format( "%u", fpinfo->GetPadCount() ) );
-        aCacheFile->AddLine( wxString::Format( "%u", fpinfo->GetUniquePadCount() ) );
+        libIndices.emplace( pair.first, (int32_t) libIndices.size() );
+        writeString( data, pair.first );
+        writeInt64( data, pair.second );
     }
 
-    aCacheFile->Write();
-    aCacheFile->Close();
+    // Footprints of libraries whose load was cancelled are not worth keeping.
+    size_t countPos = data.size();
+    int    count = 0;
+
+    writeInt32( data, 0 );
+
+    for( const std::unique_ptr<FOOTPRINT_INFO>& fpinfo : m_list )
+    {
+        auto lib = libIndices.find( fpinfo->GetLibNickname() );
+
+        if( lib == libIndices.end() )
+            continue;
+
+        writeInt32( data, lib->second );
+        writeString( data, fpinfo->GetName() );
+        writeString( data, fpinfo->GetDescription() );
+        writeString( data, fpinfo->GetKeywords() );
+        writeInt32( data, fpinfo->GetOrderNum() );
+        writeInt32( data, (int32_t) fpinfo->GetPadCount() );
+        writeInt32( data, (int32_t) fpinfo->GetUniquePadCount() );
+        count++;
+    }
+
+    std::string countData;
+    writeInt32( countData, count );
+    data.replace( countPos, countData.size(), countData );
+
+    wxFFile file( aFilePath, "wb" );
+
+    if( file.IsOpened() )
+        file.Write( data.data(), data.size() );
 }
 
 
-void FOOTPRINT_LIST_IMPL::ReadCacheFromFile( wxTextFile* aCacheFile )
+void FOOTPRINT_LIST_IMPL::ReadCacheFromFile( const wxString& aFilePath )
 {
-    m_list_timestamp = 0;
+    m_lib_timestamps.clear();
     m_list.clear();
 
+    if( !wxFileName::FileExists( aFilePath ) )
+        return;
+
     try
     {
-        if( aCacheFile->Exists() && aCacheFile->Open() )
+        // Read the whole file at once and parse it from memory.
+        wxFFile     file( aFilePath, "rb" );
+        std::string data;
+
+        if( !file.IsOpened() )
+            return;
+
+        wxFileOffset length = file.Length();
+
+        if( length <= 0 )
+            return;
+
+        data.resize( (size_t) length );
+
+        if( file.Read( &data[0], data.size() ) != data.size() )
+            return;
+
+        FP_INFO_CACHE_READER reader( data );
+
+        // Caches of other versions, including the older text format, are simply rebuilt.
+        if( reader.ReadBytes( sizeof( FP_INFO_CACHE_MAGIC ) - 1 ) != FP_INFO_CACHE_MAGIC
+                || reader.ReadInt32() != FP_INFO_CACHE_VERSION )
         {
-            aCacheFile->GetFirstLine().ToLongLong( &m_list_timestamp );
+            return;
+        }
 
-            while( aCacheFile->GetCurrentLine() + 6 < aCacheFile->GetLineCount() )
-            {
-                wxString libNickname = aCacheFile->GetNextLine();
-                wxString name = aCacheFile->GetNextLine();
-                wxString description = UnescapeString( aCacheFile->GetNextLine() );
-                wxString keywords = UnescapeString( aCacheFile->GetNextLine() );
-                int orderNum = wxAtoi( aCacheFile->GetNextLine() );
-                unsigned int padCount = (unsigned) wxAtoi( aCacheFile->GetNextLine() );
-                unsigned int uniquePadCount = (unsigned) wxAtoi( aCacheFile->GetNextLine() );
-
-                auto* fpinfo = new FOOTPRINT_INFO_IMPL( libNickname, name, description, keywords,
-                                                        orderNum, padCount, uniquePadCount );
-                m_list.emplace_back( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
-            }
+        std::vector<wxString> libNicknames( reader.ReadCount() );
+
+        for( wxString& libNickname : libNicknames )
+        {
+            libNickname = reader.ReadString();
+            m_lib_timestamps[ libNickname ] = reader.ReadInt64();
+        }
+
+        size_t count = reader.ReadCount();
+
+        m_list.reserve( count );
+
+        for( size_t ii = 0; ii < count; ++ii )
+        {
+            size_t lib = (size_t) reader.ReadInt32();
+
+            if( lib >= libNicknames.size() )
+                throw std::out_of_range( "invalid library index" );
+
+            wxString     name = reader.ReadString();
+            wxString     description = reader.ReadString();
+            wxString     keywords = reader.ReadString();
+            int          orderNum = reader.ReadInt32();
+            unsigned int padCount = (unsigned) reader.ReadInt32();
+            unsigned int uniquePadCount = (unsigned) reader.ReadInt32();
+
+            auto* fpinfo = new FOOTPRINT_INFO_IMPL( libNicknames[lib], name, description,
+                                                    keywords, orderNum, padCount,
+                                                    uniquePadCount );
+            m_list.emplace_back( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
         }
     }
     catch( ... )
     {
         // whatever went wrong, invalidate the cache
-        m_list_timestamp = 0;
+        m_lib_timestamps.clear();
+        m_list.clear();
     }
 
     // Sanity check: an empty list is very unlikely to be correct.
     if( m_list.size() == 0 )
-        m_list_timestamp = 0;
-
-    if( aCacheFile->IsOpened() )
-        aCacheFile->Close();
+        m_lib_timestamps.clear();
 }
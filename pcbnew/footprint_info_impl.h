@@ -22,6 +22,7 @@
 
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
 #include <thread>
 #include <vector>
@@ -88,11 +89,16 @@ class FOOTPRINT_LIST_IMPL : public FOOTPRINT_LIST
     SYNC_QUEUE<wxString>     m_queue_in;
     SYNC_QUEUE<wxString>     m_queue_out;
     std::atomic_size_t       m_count_finished;
-    long long                m_list_timestamp;
     PROGRESS_REPORTER*       m_progress_reporter;
     std::atomic_bool         m_cancelled;
     std::mutex               m_join;
 
+    /// Timestamps of the libraries whose footprints are in m_list, by nickname.
+    std::map<wxString, long long> m_lib_timestamps;
+
+    /// Timestamps of the libraries requested by the current load.
+    std::map<wxString, long long> m_load_timestamps;
+
     /**
      * Call aFunc, pushing any IO_ERRORs and std::exceptions it throws onto m_errors.
      *
@@ -107,6 +113,13 @@ protected:
 
     void StopWorkers() override;
 
+    /**
+     * Return the timestamps of \a aNickname, or of all the libraries of \a aTable if it is
+     * null.  A library needs to be read again when its timestamp changes.
+     */
+    static std::map<wxString, long long> libraryTimestamps( FP_LIB_TABLE* aTable,
+                                                            const wxString* aNickname );
+
     /**
      * Function loader_job
      * loads footprints from m_queue_in.
@@ -117,8 +130,8 @@ public:
     FOOTPRINT_LIST_IMPL();
     virtual ~FOOTPRINT_LIST_IMPL();
 
-    void WriteCacheToFile( wxTextFile* aFile ) override;
-    void ReadCacheFromFile( wxTextFile* aFile ) override;
+    void WriteCacheToFile( const wxString& aFilePath ) override;
+    void ReadCacheFromFile( const wxString& aFilePath ) override;
 
     bool ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname = nullptr,
                              PROGRESS_REPORTER* aProgressReporter = nullptr ) override;
@@ -285,7 +285,7 @@ void FP_CACHE::Load()
             // Queue I/O errors so only files that fail to parse don't get loaded.
             try
             {
-                FILE_LINE_READER    reader( fn.GetFullPath() );
+                MAPPED_FILE_LINE_READER reader( fn.GetFullPath() );
 
                 m_owner->m_parser->SetLineReader( &reader );
 
@@ -905,7 +905,7 @@ void PCB_IO::format( DRAWSEGMENT* aSegment, int aNestLevel ) const
         if( aSegment->IsPolyShapeValid() )
         {
             SHAPE_POLY_SET& poly = aSegment->GetPolyShape();
-            SHAPE_LINE_CHAIN& outline = poly.Outline( 0 );
+            const SHAPE_LINE_CHAIN& outline = poly.COutline( 0 );
             int pointsCount = outline.PointCount();
 
             m_out->Print( aNestLevel, "(gr_poly (pts" );
@@ -978,7 +978,7 @@ void PCB_IO::format( EDGE_MODULE* aModuleDrawing, int aNestLevel ) const
         if( aModuleDrawing->IsPolyShapeValid() )
         {
             SHAPE_POLY_SET& poly = aModuleDrawing->GetPolyShape();
-            SHAPE_LINE_CHAIN& outline = poly.Outline( 0 );
+            const SHAPE_LINE_CHAIN& outline = poly.COutline( 0 );
             int pointsCount = outline.PointCount();
 
             m_out->Print( aNestLevel, "(fp_poly (pts" );
@@ -2062,7 +2062,7 @@ PCB_IO::~PCB_IO()
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
-    FILE_LINE_READER    reader( aFileName );
+    MAPPED_FILE_LINE_READER reader( aFileName );
 
     init( aProperties );
 
@@ -47,8 +47,7 @@ PCB_BASE_EDIT_FRAME::PCB_BASE_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent,
 {
     if( !GFootprintList.GetCount() )
     {
-        wxTextFile footprintInfoCache( Prj().GetProjectPath() + "fp-info-cache" );
-        GFootprintList.ReadCacheFromFile( &footprintInfoCache );
+        GFootprintList.ReadCacheFromFile( Prj().GetProjectPath() + "fp-info-cache" );
     }
 }
 
@@ -56,8 +55,7 @@ PCB_BASE_EDIT_FRAME::~PCB_BASE_EDIT_FRAME()
 {
     if( wxFileName::IsDirWritable( Prj().GetProjectPath() ) )
     {
-        wxTextFile footprintInfoCache( Prj().GetProjectPath() + "fp-info-cache" );
-        GFootprintList.WriteCacheToFile( &footprintInfoCache );
+        GFootprintList.WriteCacheToFile( Prj().GetProjectPath() + "fp-info-cache" );
     }
 
     GetCanvas()->GetView()->Clear();
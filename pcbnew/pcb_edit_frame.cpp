@@ -53,6 +53,7 @@
 #include <wildcards_and_files_ext.h>
 #include <kicad_string.h>
 #include <pcb_draw_panel_gal.h>
+#include <pcb_undo_packer.h>
 #include <functional>
 #include <settings/settings_manager.h>
 #include <tool/tool_manager.h>
@@ -209,6 +210,7 @@ PCB_EDIT_FRAME::PCB_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
 
     SetScreen( new PCB_SCREEN( GetPageSettings().GetSizeIU() ) );
     GetScreen()->SetMaxUndoItems( m_UndoRedoCountMax );
+    GetScreen()->SetUndoItemPacker( new PCB_UNDO_PACKER() );
 
     // PCB drawings start in the upper left corner.
     GetScreen()->m_Center = false;
@@ -354,7 +356,13 @@ PCB_EDIT_FRAME::~PCB_EDIT_FRAME()
 {
     // Shutdown all running tools
     if( m_toolManager )
+    {
         m_toolManager->ShutdownAllTools();
+
+        // The board is deleted before the tools, so the DRC must stop listening to it now
+        if( DRC* drcTool = m_toolManager->GetTool<DRC>() )
+            drcTool->DetachBoard();
+    }
 }
 
 
@@ -403,6 +403,83 @@ bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
 }
 
 
+void PCB_PAINTER::PrepareDraw( const VIEW_ITEM* aItem, const std::vector<int>& aLayers )
+{
+    const EDA_ITEM* item = dynamic_cast<const EDA_ITEM*>( aItem );
+
+    if( !item )
+        return;
+
+    // Only the polygons are worth preparing; the GLU tesselation used for the polygons which
+    // are not triangulated is also much slower than drawing the triangles.
+    bool triangulate = m_gal->IsOpenGlEngine();
+
+    switch( item->Type() )
+    {
+    case PCB_PAD_T:
+    {
+        const D_PAD* pad = static_cast<const D_PAD*>( item );
+
+        for( int layer : aLayers )
+        {
+            if( IsNetnameLayer( layer ) || layer == LAYER_PADS_PLATEDHOLES
+                    || layer == LAYER_NON_PLATEDHOLES )
+            {
+                continue;
+            }
+
+            SHAPE_POLY_SET polySet;
+            buildPadShape( pad, layer, polySet );
+
+            if( triangulate )
+                polySet.CacheTriangulation();
+
+            std::lock_guard<std::mutex> lock( m_preparedLock );
+            m_preparedPadShapes[ { pad, layer } ] = std::move( polySet );
+        }
+
+        break;
+    }
+
+    case PCB_LINE_T:
+    case PCB_MODULE_EDGE_T:
+    {
+        DRAWSEGMENT* segment = static_cast<DRAWSEGMENT*>( const_cast<EDA_ITEM*>( item ) );
+
+        if( triangulate && segment->GetShape() == S_POLYGON
+                && segment->GetPolyShape().OutlineCount() > 0
+                && !segment->GetPolyShape().IsTriangulationUpToDate() )
+        {
+            segment->GetPolyShape().CacheTriangulation();
+        }
+
+        break;
+    }
+
+    case PCB_ZONE_AREA_T:
+    case PCB_MODULE_ZONE_AREA_T:
+    {
+        ZONE_CONTAINER* zone = static_cast<ZONE_CONTAINER*>( const_cast<EDA_ITEM*>( item ) );
+
+        if( triangulate && !zone->GetFilledPolysList().IsTriangulationUpToDate() )
+            zone->CacheTriangulation();
+
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+
+void PCB_PAINTER::ClearPrepared()
+{
+    std::lock_guard<std::mutex> lock( m_preparedLock );
+    m_preparedPadShapes.clear();
+}
+
+
 void PCB_PAINTER::draw( const TRACK* aTrack, int aLayer )
 {
     VECTOR2D start( aTrack->GetStart() );
@@ -845,31 +922,16 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
     else
     {
         SHAPE_POLY_SET polySet;
+        auto           prepared = m_preparedPadShapes.find( { aPad, aLayer } );
 
-        switch( aLayer )
+        if( prepared != m_preparedPadShapes.end() )
         {
-        case F_Mask:
-        case B_Mask:
-            {
-            int clearance = aPad->GetSolderMaskMargin();
-            aPad->TransformShapeWithClearanceToPolygon( polySet, clearance );
-            }
-            break;
-
-        case F_Paste:
-        case B_Paste:
-            {
-            wxSize pad_size = aPad->GetSize();
-            wxSize margin = aPad->GetSolderPasteMargin();
-            const_cast<D_PAD*>(aPad)->SetSize( pad_size + margin + margin );
-            aPad->TransformShapeWithClearanceToPolygon( polySet, 0 );
-            const_cast<D_PAD*>(aPad)->SetSize( pad_size );
-            }
-            break;
-
-        default:
-            aPad->TransformShapeWithClearanceToPolygon( polySet, 0 );
-            break;
+            polySet = std::move( prepared->second );
+            m_preparedPadShapes.erase( prepared );
+        }
+        else
+        {
+            buildPadShape( aPad, aLayer, polySet );
         }
 
         m_gal->DrawPolygon( polySet );
@@ -894,6 +956,37 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
 }
 
 
+void PCB_PAINTER::buildPadShape( const D_PAD* aPad, int aLayer, SHAPE_POLY_SET& aShape ) const
+{
+    switch( aLayer )
+    {
+    case F_Mask:
+    case B_Mask:
+        {
+        int clearance = aPad->GetSolderMaskMargin();
+        aPad->TransformShapeWithClearanceToPolygon( aShape, clearance );
+        }
+        break;
+
+    case F_Paste:
+    case B_Paste:
+        {
+        // This may run on a worker thread, so the board pad must not be touched: the
+        // paste shape is built from a resized copy
+        D_PAD  dummy( *aPad );
+        wxSize margin = aPad->GetSolderPasteMargin();
+        dummy.SetSize( aPad->GetSize() + margin + margin );
+        dummy.TransformShapeWithClearanceToPolygon( aShape, 0 );
+        }
+        break;
+
+    default:
+        aPad->TransformShapeWithClearanceToPolygon( aShape, 0 );
+        break;
+    }
+}
+
+
 void PCB_PAINTER::draw( const DRAWSEGMENT* aSegment, int aLayer )
 {
     const COLOR4D& color = m_pcbSettings.GetColor( aSegment, aSegment->GetLayer() );
@@ -28,8 +28,11 @@
 #define __CLASS_PCB_PAINTER_H
 
 #include <painter.h>
+#include <geometry/shape_poly_set.h>
 
+#include <map>
 #include <memory>
+#include <mutex>
 
 
 class EDA_ITEM;
@@ -237,9 +240,19 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) override;
 
+    /// @copydoc PAINTER::PrepareDraw()
+    virtual void PrepareDraw( const VIEW_ITEM* aItem, const std::vector<int>& aLayers ) override;
+
+    /// @copydoc PAINTER::ClearPrepared()
+    virtual void ClearPrepared() override;
+
 protected:
     PCB_RENDER_SETTINGS m_pcbSettings;
 
+    ///> Pad shapes built (and triangulated) by PrepareDraw(), by pad and layer
+    std::map<std::pair<const D_PAD*, int>, SHAPE_POLY_SET> m_preparedPadShapes;
+    std::mutex m_preparedLock;
+
     // Drawing functions for various types of PCB-specific items
     void draw( const TRACK* aTrack, int aLayer );
     void draw( const ARC* aArc, int aLayer );
@@ -263,6 +276,11 @@ protected:
      */
     int getLineThickness( int aActualThickness ) const;
 
+    /**
+     * Builds the polygon of a pad as drawn on a copper, mask or paste layer.
+     */
+    void buildPadShape( const D_PAD* aPad, int aLayer, SHAPE_POLY_SET& aShape ) const;
+
     /**
      * Return drill shape of a pad.
      */
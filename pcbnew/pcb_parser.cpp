@@ -27,9 +27,11 @@
  * @brief Pcbnew s-expression file format parser implementation.
  */
 
+#include <atomic>
 #include <cerrno>
 #include <common.h>
 #include <confirm.h>
+#include <kicad_string.h>
 #include <macros.h>
 #include <title_block.h>
 #include <trigo.h>
@@ -51,6 +53,7 @@
 #include <pcb_parser.h>
 #include <convert_basic_shapes_to_polygon.h>    // for RECT_CHAMFER_POSITIONS definition
 #include <template_fieldnames.h>
+#include <thread_pool.h>
 
 using namespace PCB_KEYS_T;
 
@@ -149,11 +152,11 @@ void PCB_PARSER::pushValueIntoMap( int aIndex, int aValue )
 
 double PCB_PARSER::parseDouble()
 {
-    char* tmp;
+    const char* tmp;
 
     errno = 0;
 
-    double fval = strtod( CurText(), &tmp );
+    double fval = StrToDouble( CurText(), &tmp );
 
     if( errno )
     {
@@ -535,7 +538,12 @@ BOARD* PCB_PARSER::parseBOARD()
 
 BOARD* PCB_PARSER::parseBOARD_unchecked()
 {
-    T token;
+    T                             token;
+    std::vector<BOARD_ITEM_BLOCK> blocks;
+
+    // Board items are independent of each other, so unless there is a single thread
+    // anyway, parsing them is deferred until the whole file has been read.
+    bool readAhead = THREAD_POOL::GetInstance().GetThreadCount() > 1;
 
     parseHeader();
 
@@ -584,39 +592,26 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
         case T_gr_curve:
         case T_gr_line:
         case T_gr_poly:
-            m_board->Add( parseDRAWSEGMENT(), ADD_MODE::APPEND );
-            break;
-
         case T_gr_text:
-            m_board->Add( parseTEXTE_PCB(), ADD_MODE::APPEND );
-            break;
-
         case T_dimension:
-            m_board->Add( parseDIMENSION(), ADD_MODE::APPEND );
-            break;
-
         case T_module:
-            m_board->Add( parseMODULE(), ADD_MODE::APPEND );
-            break;
-
         case T_segment:
-            m_board->Add( parseTRACK(), ADD_MODE::APPEND );
-            break;
-
         case T_arc:
-            m_board->Add( parseARC(), ADD_MODE::APPEND );
-            break;
-
         case T_via:
-            m_board->Add( parseVIA(), ADD_MODE::APPEND );
-            break;
-
         case T_zone:
-            m_board->Add( parseZONE_CONTAINER( m_board ), ADD_MODE::APPEND );
-            break;
-
         case T_target:
-            m_board->Add( parsePCB_TARGET(), ADD_MODE::APPEND );
+            if( readAhead )
+            {
+                // Only find the extent of the item here; it is parsed on the thread pool
+                blocks.emplace_back();
+                blocks.back().m_LineNumber = CurLineNumber();
+                blocks.back().m_Text = "(" + CurStr();
+                ReadBlockText( blocks.back().m_Text );
+            }
+            else
+            {
+                m_board->Add( parseBoardItem( token ), ADD_MODE::APPEND );
+            }
             break;
 
         default:
@@ -626,6 +621,9 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
         }
     }
 
+    if( !blocks.empty() )
+        parseBoardItemBlocks( blocks );
+
     if( m_undefinedLayers.size() > 0 )
     {
         bool deleteItems;
@@ -709,6 +707,213 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
 }
 
 
+BOARD_ITEM* PCB_PARSER::parseBoardItem( T aToken )
+{
+    switch( aToken )
+    {
+    case T_gr_arc:
+    case T_gr_circle:
+    case T_gr_curve:
+    case T_gr_line:
+    case T_gr_poly:
+        return parseDRAWSEGMENT();
+
+    case T_gr_text:
+        return parseTEXTE_PCB();
+
+    case T_dimension:
+        return parseDIMENSION();
+
+    case T_module:
+        return parseMODULE();
+
+    case T_segment:
+        return parseTRACK();
+
+    case T_arc:
+        return parseARC();
+
+    case T_via:
+        return parseVIA();
+
+    case T_zone:
+        return parseZONE_CONTAINER( m_board );
+
+    case T_target:
+        return parsePCB_TARGET();
+
+    default:
+        wxFAIL_MSG( wxT( "Token " ) + GetTokenString( aToken ) + wxT( " is not a board item." ) );
+        return NULL;
+    }
+}
+
+
+/**
+ * BLOCK_LINE_READER
+ * reads the text of a block taken out of a file, reporting the line numbers of the file.
+ */
+class BLOCK_LINE_READER : public STRING_LINE_READER
+{
+public:
+    BLOCK_LINE_READER( std::string& aText, const wxString& aSource, unsigned aLineNumber ) :
+        STRING_LINE_READER( std::string(), aSource )
+    {
+        m_lines.swap( aText );
+        m_lineNum = aLineNumber - 1;
+    }
+};
+
+
+void PCB_PARSER::parseBoardItemBlocks( std::vector<BOARD_ITEM_BLOCK>& aBlocks )
+{
+    struct CHUNK
+    {
+        size_t                                            m_First;
+        size_t                                            m_End;
+        std::vector<BOARD_ITEM*>                          m_Items;
+        std::set<wxString>                                m_UndefinedLayers;
+        std::vector<std::pair<ZONE_CONTAINER*, wxString>> m_ZoneNetFixups;
+        bool                                              m_SawLegacyZoneFill = false;
+        std::exception_ptr                                m_Error;
+    };
+
+    THREAD_POOL& pool = THREAD_POOL::GetInstance();
+    size_t       totalSize = 0;
+
+    for( const BOARD_ITEM_BLOCK& block : aBlocks )
+        totalSize += block.m_Text.size();
+
+    // A few chunks per thread balance the load; each needs a parser of its own, so they
+    // should not be too small either.
+    size_t             chunkSize = std::max<size_t>( 64 * 1024,
+                                                     totalSize / ( 4 * pool.GetThreadCount() ) );
+    std::vector<CHUNK> chunks;
+    size_t             size = 0;
+
+    for( size_t ii = 0; ii < aBlocks.size(); ++ii )
+    {
+        if( chunks.empty() || size >= chunkSize )
+        {
+            chunks.emplace_back();
+            chunks.back().m_First = ii;
+            size = 0;
+        }
+
+        chunks.back().m_End = ii + 1;
+        size += aBlocks[ii].m_Text.size();
+    }
+
+    // Chunks after a failed one are skipped; the error reported is the first in the file
+    std::atomic<size_t> firstFailed( chunks.size() );
+    wxString            source = CurSource();
+    TASK_GROUP          tasks( pool );
+
+    for( size_t ii = 0; ii < chunks.size(); ++ii )
+    {
+        tasks.Run( [&, ii]()
+                   {
+                       CHUNK& chunk = chunks[ii];
+
+                       if( firstFailed < ii )
+                           return;
+
+                       try
+                       {
+                           PCB_PARSER parser;
+
+                           parser.m_board = m_board;
+                           parser.m_layerIndices = m_layerIndices;
+                           parser.m_layerMasks = m_layerMasks;
+                           parser.m_netCodes = m_netCodes;
+                           parser.m_tooRecent = m_tooRecent;
+                           parser.m_requiredVersion = m_requiredVersion;
+                           parser.m_isBlockParser = true;
+
+                           for( size_t jj = chunk.m_First; jj < chunk.m_End; ++jj )
+                           {
+                               if( firstFailed < ii )
+                                   return;
+
+                               BOARD_ITEM_BLOCK& block = aBlocks[jj];
+                               BLOCK_LINE_READER reader( block.m_Text, source,
+                                                         block.m_LineNumber );
+
+                               parser.SetLineReader( &reader );
+                               parser.NeedLEFT();
+
+                               BOARD_ITEM* item = parser.parseBoardItem( parser.NextTok() );
+
+                               parser.PopReader();
+
+                               if( item )
+                                   chunk.m_Items.push_back( item );
+                           }
+
+                           chunk.m_UndefinedLayers = std::move( parser.m_undefinedLayers );
+                           chunk.m_ZoneNetFixups = std::move( parser.m_zoneNetFixups );
+                           chunk.m_SawLegacyZoneFill = parser.m_sawLegacyZoneFill;
+                       }
+                       catch( ... )
+                       {
+                           chunk.m_Error = std::current_exception();
+
+                           size_t failed = firstFailed;
+
+                           while( ii < failed && !firstFailed.compare_exchange_weak( failed, ii ) )
+                               ;
+                       }
+                   } );
+    }
+
+    tasks.Wait();
+    aBlocks.clear();
+
+    auto deleteItems = [&]()
+                       {
+                           for( CHUNK& chunk : chunks )
+                           {
+                               for( BOARD_ITEM* item : chunk.m_Items )
+                                   delete item;
+                           }
+                       };
+
+    try
+    {
+        if( firstFailed < chunks.size() )
+            std::rethrow_exception( chunks[firstFailed].m_Error );
+
+        for( CHUNK& chunk : chunks )
+        {
+            if( chunk.m_SawLegacyZoneFill )
+            {
+                confirmLegacyZoneFill();
+                break;
+            }
+        }
+    }
+    catch( ... )
+    {
+        deleteItems();
+        throw;
+    }
+
+    // Apply the board changes of the block parsers as they would have been applied when
+    // parsing the file in one go
+    for( CHUNK& chunk : chunks )
+    {
+        for( std::pair<ZONE_CONTAINER*, wxString>& fixup : chunk.m_ZoneNetFixups )
+            fixZoneNet( fixup.first, fixup.second );
+
+        m_undefinedLayers.insert( chunk.m_UndefinedLayers.begin(),
+                                  chunk.m_UndefinedLayers.end() );
+
+        for( BOARD_ITEM* item : chunk.m_Items )
+            m_board->Add( item, ADD_MODE::APPEND );
+    }
+}
+
+
 void PCB_PARSER::parseHeader()
 {
     wxCHECK_RET( CurTok() == T_kicad_pcb,
@@ -3816,24 +4021,12 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent )
                     if( token == T_segment )    // deprecated
                     {
                         // SEGMENT fill mode no longer supported.  Make sure user is OK with converting them.
-                        if( m_showLegacyZoneWarning )
-                        {
-                            KIDIALOG dlg( nullptr,
-                                          _( "The legacy segment fill mode is no longer supported.\n"
-                                             "Convert zones to polygon fills?"),
-                                          _( "Legacy Zone Warning" ),
-                                          wxYES_NO | wxICON_WARNING );
-
-                            dlg.DoNotShowCheckbox( __FILE__, __LINE__ );
-
-                            if( dlg.ShowModal() == wxID_NO )
-                                THROW_IO_ERROR( wxT( "CANCEL" ) );
-
-                            m_showLegacyZoneWarning = false;
-                        }
+                        if( m_isBlockParser )
+                            m_sawLegacyZoneFill = true;
+                        else
+                            confirmLegacyZoneFill();
 
                         zone->SetFillMode( ZONE_FILL_MODE::POLYGONS );
-                        m_board->SetModified();
                     }
                     else if( token == T_hatch )
                         zone->SetFillMode( ZONE_FILL_MODE::HATCH_PATTERN );
@@ -4087,31 +4280,10 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent )
         // Can happens which old boards, with nonexistent nets ...
         // or after being edited by hand
         // We try to fix the mismatch.
-        NETINFO_ITEM* net = m_board->FindNet( netnameFromfile );
-
-        if( net )   // An existing net has the same net name. use it for the zone
-            zone->SetNetCode( net->GetNet() );
-        else    // Not existing net: add a new net to keep trace of the zone netname
-        {
-            int newnetcode = m_board->GetNetCount();
-            net = new NETINFO_ITEM( m_board, netnameFromfile, newnetcode );
-            m_board->Add( net );
-
-            // Store the new code mapping
-            pushValueIntoMap( newnetcode, net->GetNet() );
-            // and update the zone netcode
-            zone->SetNetCode( net->GetNet() );
-
-            // FIXME: a call to any GUI item is not allowed in io plugins:
-            // Change this code to generate a warning message outside this plugin
-            // Prompt the user
-            wxString msg;
-            msg.Printf( _( "There is a zone that belongs to a not existing net\n"
-                           "\"%s\"\n"
-                           "you should verify and edit it (run DRC test)." ),
-                           GetChars( netnameFromfile ) );
-            DisplayError( NULL, msg );
-        }
+        if( m_isBlockParser )
+            m_zoneNetFixups.emplace_back( zone.get(), netnameFromfile );
+        else
+            fixZoneNet( zone.get(), netnameFromfile );
     }
 
     // Clear flags used in zone edition:
@@ -4121,6 +4293,58 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent )
 }
 
 
+void PCB_PARSER::confirmLegacyZoneFill()
+{
+    if( m_showLegacyZoneWarning )
+    {
+        KIDIALOG dlg( nullptr,
+                      _( "The legacy segment fill mode is no longer supported.\n"
+                         "Convert zones to polygon fills?"),
+                      _( "Legacy Zone Warning" ),
+                      wxYES_NO | wxICON_WARNING );
+
+        dlg.DoNotShowCheckbox( __FILE__, __LINE__ );
+
+        if( dlg.ShowModal() == wxID_NO )
+            THROW_IO_ERROR( wxT( "CANCEL" ) );
+
+        m_showLegacyZoneWarning = false;
+    }
+
+    m_board->SetModified();
+}
+
+
+void PCB_PARSER::fixZoneNet( ZONE_CONTAINER* aZone, const wxString& aNetname )
+{
+    NETINFO_ITEM* net = m_board->FindNet( aNetname );
+
+    if( net )   // An existing net has the same net name. use it for the zone
+        aZone->SetNetCode( net->GetNet() );
+    else    // Not existing net: add a new net to keep trace of the zone netname
+    {
+        int newnetcode = m_board->GetNetCount();
+        net = new NETINFO_ITEM( m_board, aNetname, newnetcode );
+        m_board->Add( net );
+
+        // Store the new code mapping
+        pushValueIntoMap( newnetcode, net->GetNet() );
+        // and update the zone netcode
+        aZone->SetNetCode( net->GetNet() );
+
+        // FIXME: a call to any GUI item is not allowed in io plugins:
+        // Change this code to generate a warning message outside this plugin
+        // Prompt the user
+        wxString msg;
+        msg.Printf( _( "There is a zone that belongs to a not existing net\n"
+                       "\"%s\"\n"
+                       "you should verify and edit it (run DRC test)." ),
+                       GetChars( aNetname ) );
+        DisplayError( NULL, msg );
+    }
+}
+
+
 PCB_TARGET* PCB_PARSER::parsePCB_TARGET()
 {
     wxCHECK_MSG( CurTok() == T_target, NULL,
@@ -81,6 +81,24 @@ class PCB_PARSER : public PCB_LEXER
 
     bool                m_showLegacyZoneWarning;
 
+    ///> True when parsing a block of a board on a worker thread.  The board is then only
+    ///> read from, and changes to it are recorded to be applied by the main parser.
+    bool                m_isBlockParser;
+    bool                m_sawLegacyZoneFill;   ///< a legacy segment-filled zone was parsed
+
+    ///> Zones whose net name from the file does not match their net code
+    std::vector<std::pair<ZONE_CONTAINER*, wxString>> m_zoneNetFixups;
+
+    /**
+     * BOARD_ITEM_BLOCK
+     * the text of a top level board item, read ahead to be parsed on a worker thread.
+     */
+    struct BOARD_ITEM_BLOCK
+    {
+        unsigned    m_LineNumber;       ///< line of the block's opening parenthesis
+        std::string m_Text;
+    };
+
     ///> Converts net code using the mapping table if available,
     ///> otherwise returns unchanged net code if < 0 or if is is out of range
     inline int getNetCode( int aNetCode )
@@ -139,6 +157,30 @@ class PCB_PARSER : public PCB_LEXER
     void parseNETINFO_ITEM();
     void parseNETCLASS();
 
+    /**
+     * Parse the top level board item starting with the token aToken, which has just been
+     * read.  The item is not added to the board.
+     * @return the item, or NULL if aToken does not start a board item.
+     */
+    BOARD_ITEM*     parseBoardItem( PCB_KEYS_T::T aToken );
+
+    /**
+     * Parse the read ahead blocks aBlocks on the thread pool, and add the resulting items
+     * to the board in file order.
+     */
+    void            parseBoardItemBlocks( std::vector<BOARD_ITEM_BLOCK>& aBlocks );
+
+    /**
+     * Ask the user whether legacy segment-filled zones may be converted to polygon fills.
+     * @throw IO_ERROR "CANCEL" if not.
+     */
+    void            confirmLegacyZoneFill();
+
+    /**
+     * Give aZone the net named aNetname, adding the net to the board if it does not exist.
+     */
+    void            fixZoneNet( ZONE_CONTAINER* aZone, const wxString& aNetname );
+
     /** Read a DRAWSEGMENT description.
      * @param aAllowCirclesZeroWidth = true to allow items with 0 width
      * Only used in custom pad shapes for filled circles.
@@ -319,7 +361,9 @@ public:
 
     PCB_PARSER( LINE_READER* aReader = NULL ) :
         PCB_LEXER( aReader ),
-        m_board( 0 )
+        m_board( 0 ),
+        m_isBlockParser( false ),
+        m_sawLegacyZoneFill( false )
     {
         init();
     }
@@ -0,0 +1,234 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <kicad_plugin.h>
+#include <pcb_parser.h>
+#include <richio.h>
+#include "pcb_undo_packer.h"
+
+
+/*
+ * The footprint text does not hold everything an undo copy needs:
+ * - the link of a footprint editor copy to its board footprint,
+ * - the uuids of the texts, graphics and pads, which the parser may create anew,
+ * - the nets of the pads.  Net codes can change, and the nets be deleted, before the copy is
+ *   read back, so the nets are omitted from the text and found back by name.
+ * They are stored after the text, in this order:
+ *   text, link, number of children, child uuids, number of pads, then for each pad whether
+ *   it is orphaned, its net name and its pin function.
+ */
+
+
+static void writeUndoString( std::string& aData, const std::string& aValue )
+{
+    uint32_t size = aValue.size();
+
+    aData.append( reinterpret_cast<const char*>( &size ), sizeof( size ) );
+    aData.append( aValue );
+}
+
+
+template<typename T>
+static void writeUndoValue( std::string& aData, T aValue )
+{
+    aData.append( reinterpret_cast<const char*>( &aValue ), sizeof( aValue ) );
+}
+
+
+/**
+ * UNDO_DATA_READER
+ * reads back the fields written by writeUndoString() and writeUndoValue().
+ */
+class UNDO_DATA_READER
+{
+public:
+    UNDO_DATA_READER( const std::string& aData ) :
+            m_data( aData ),
+            m_pos( 0 )
+    {}
+
+    std::string ReadString()
+    {
+        uint32_t size = ReadValue<uint32_t>();
+
+        need( size );
+        m_pos += size;
+
+        return m_data.substr( m_pos - size, size );
+    }
+
+    template<typename T>
+    T ReadValue()
+    {
+        T value;
+
+        need( sizeof( value ) );
+        memcpy( &value, m_data.data() + m_pos, sizeof( value ) );
+        m_pos += sizeof( value );
+
+        return value;
+    }
+
+private:
+    void need( size_t aSize )
+    {
+        if( aSize > m_data.size() - m_pos )
+            THROW_IO_ERROR( _( "Truncated footprint in the undo data" ) );
+    }
+
+    const std::string& m_data;
+    size_t             m_pos;
+};
+
+
+/**
+ * @return the texts, graphics, pads and zones of \a aModule, in the order they are written
+ * and parsed.
+ */
+static std::vector<BOARD_ITEM*> footprintChildren( MODULE* aModule )
+{
+    std::vector<BOARD_ITEM*> children = { &aModule->Reference(), &aModule->Value() };
+
+    for( BOARD_ITEM* item : aModule->GraphicalItems() )
+        children.push_back( item );
+
+    for( D_PAD* pad : aModule->Pads() )
+        children.push_back( pad );
+
+    for( MODULE_ZONE_CONTAINER* zone : aModule->Zones() )
+        children.push_back( zone );
+
+    return children;
+}
+
+
+bool PCB_UNDO_PACKER::Pack( ITEM_PICKER& aPicker, std::string& aData )
+{
+    EDA_ITEM* image = aPicker.GetLink();
+
+    if( aPicker.GetStatus() != UR_CHANGED || !image || image->Type() != PCB_MODULE_T )
+        return false;
+
+    // The copy must be restored on the board of the item it belongs to
+    if( !aPicker.GetItem() || !static_cast<BOARD_ITEM*>( aPicker.GetItem() )->GetBoard() )
+        return false;
+
+    MODULE* module = static_cast<MODULE*>( image );
+
+    // Standard layer names are used as the parser does not know the board's layer names
+    PCB_IO io( CTL_FOR_BOARD | CTL_STD_LAYER_NAMES | CTL_OMIT_NETS );
+
+    try
+    {
+        io.Format( module );
+    }
+    catch( const IO_ERROR& )
+    {
+        return false;
+    }
+
+    writeUndoString( aData, io.GetStringOutput( true ) );
+    writeUndoString( aData, TO_UTF8( module->GetLink().AsString() ) );
+
+    std::vector<BOARD_ITEM*> children = footprintChildren( module );
+
+    writeUndoValue<uint32_t>( aData, children.size() );
+
+    for( BOARD_ITEM* child : children )
+        writeUndoString( aData, TO_UTF8( child->m_Uuid.AsString() ) );
+
+    writeUndoValue<uint32_t>( aData, module->Pads().size() );
+
+    for( D_PAD* pad : module->Pads() )
+    {
+        writeUndoValue<uint8_t>( aData, pad->GetNet() == NETINFO_LIST::OrphanedItem() );
+        writeUndoString( aData, TO_UTF8( pad->GetNetname() ) );
+        writeUndoString( aData, TO_UTF8( pad->GetPinFunction() ) );
+    }
+
+    delete image;
+    aPicker.SetLink( nullptr );
+
+    return true;
+}
+
+
+void PCB_UNDO_PACKER::Unpack( ITEM_PICKER& aPicker, const std::string& aData )
+{
+    BOARD*             board = static_cast<BOARD_ITEM*>( aPicker.GetItem() )->GetBoard();
+    UNDO_DATA_READER   data( aData );
+    STRING_LINE_READER reader( data.ReadString(), wxT( "undo" ) );
+    PCB_PARSER         parser( &reader );
+
+    parser.SetBoard( board );
+
+    std::unique_ptr<BOARD_ITEM> image( parser.Parse() );
+
+    if( !image || image->Type() != PCB_MODULE_T )
+        THROW_IO_ERROR( _( "Invalid footprint in the undo data" ) );
+
+    MODULE* module = static_cast<MODULE*>( image.get() );
+
+    module->SetLink( KIID( data.ReadString() ) );
+
+    std::vector<BOARD_ITEM*> children = footprintChildren( module );
+
+    if( data.ReadValue<uint32_t>() != children.size() )
+        THROW_IO_ERROR( _( "Invalid footprint in the undo data" ) );
+
+    for( BOARD_ITEM* child : children )
+        const_cast<KIID&>( child->m_Uuid ) = KIID( data.ReadString() );
+
+    if( data.ReadValue<uint32_t>() != module->Pads().size() )
+        THROW_IO_ERROR( _( "Invalid footprint in the undo data" ) );
+
+    for( D_PAD* pad : module->Pads() )
+    {
+        bool     orphaned = data.ReadValue<uint8_t>() != 0;
+        wxString netName = FROM_UTF8( data.ReadString().c_str() );
+
+        pad->SetPinFunction( FROM_UTF8( data.ReadString().c_str() ) );
+
+        // A pad whose net was deleted since does not belong to any net anymore
+        NETINFO_ITEM* net = nullptr;
+
+        if( !orphaned && netName.IsEmpty() )
+            net = board->FindNet( NETINFO_LIST::UNCONNECTED );
+        else if( !orphaned )
+            net = board->FindNet( netName );
+
+        if( net )
+            pad->SetNet( net );
+        else
+            pad->SetNetCode( NETINFO_LIST::ORPHANED, /* aNoAssert */ true );
+    }
+
+    aPicker.SetLink( image.release() );
+}
@@ -0,0 +1,51 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef PCB_UNDO_PACKER_H
+#define PCB_UNDO_PACKER_H
+
+#include <undo_redo_container.h>
+
+
+/**
+ * PCB_UNDO_PACKER
+ * keeps the footprint copies of old board and footprint editor undo commands as
+ * s-expressions.  A footprint copy holds all of its pads, graphics and 3D models, even
+ * when a single field was edited, and its text is usually a few percent of that once
+ * compressed.
+ *
+ * The link to the board footprint, the uuids of the footprint items and the nets of the pads
+ * are not stored by the s-expression format, so they are kept alongside.
+ *
+ * Copies of other items are small, and the fills of zone copies are shared with the zones
+ * until they are refilled, so they are kept as they are.
+ */
+class PCB_UNDO_PACKER : public UNDO_ITEM_PACKER
+{
+public:
+    bool Pack( ITEM_PICKER& aPicker, std::string& aData ) override;
+
+    void Unpack( ITEM_PICKER& aPicker, const std::string& aData ) override;
+};
+
+#endif    // PCB_UNDO_PACKER_H
@@ -179,6 +179,9 @@ PCBNEW_SETTINGS::PCBNEW_SETTINGS()
     m_params.emplace_back( new PARAM<bool>( "drc_dialog.test_footprints",
             &m_DrcDialog.test_footprints, false ) );
 
+    m_params.emplace_back( new PARAM<bool>( "drc_dialog.online_drc",
+            &m_DrcDialog.online_drc, false ) );
+
     m_params.emplace_back( new PARAM<int>( "drc_dialog.severities",
             &m_DrcDialog.severities, RPT_SEVERITY_ERROR | RPT_SEVERITY_WARNING ) );
 
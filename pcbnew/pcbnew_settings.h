@@ -78,6 +78,7 @@ public:
         bool refill_zones;
         bool test_track_to_zone;
         bool test_footprints;
+        bool online_drc;
         int  severities;
     };
 
@@ -599,7 +599,7 @@ void BRDITEMS_PLOTTER::PlotFootprintGraphicItem( EDGE_MODULE* aEdge )
 
                 for( int jj = 0; jj < tmpPoly.OutlineCount(); ++jj )
                 {
-                    SHAPE_LINE_CHAIN &poly = tmpPoly.Outline( jj );
+                    const SHAPE_LINE_CHAIN& poly = tmpPoly.COutline( jj );
                     m_plotter->PlotPoly( poly, FILLED_SHAPE, thickness, &gbr_metadata );
                 }
             }
@@ -721,7 +721,7 @@ void BRDITEMS_PLOTTER::PlotFilledAreas( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& p
 
     for( int idx = 0; idx < polysList.OutlineCount(); ++idx )
     {
-        SHAPE_LINE_CHAIN& outline = polysList.Outline( idx );
+        const SHAPE_LINE_CHAIN& outline = polysList.COutline( idx );
 
         cornerList.clear();
         cornerList.reserve( outline.PointCount() );
@@ -836,7 +836,7 @@ void BRDITEMS_PLOTTER::PlotDrawSegment( DRAWSEGMENT* aSeg )
 
                 for( int jj = 0; jj < tmpPoly.OutlineCount(); ++jj )
                 {
-                    SHAPE_LINE_CHAIN& poly = tmpPoly.Outline( jj );
+                    const SHAPE_LINE_CHAIN& poly = tmpPoly.COutline( jj );
                     m_plotter->PlotPoly( poly, FILLED_SHAPE, thickness, &gbr_metadata );
                 }
             }
@@ -55,97 +55,70 @@ static bool sortWeight( const CN_EDGE& aEdge1, const CN_EDGE& aEdge2 )
 }
 
 
-static const std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
+static const std::vector<CN_EDGE> kruskalMST( std::vector<CN_EDGE>& aEdges,
         std::vector<CN_ANCHOR_PTR>& aNodes )
 {
     unsigned int    nodeNumber = aNodes.size();
     unsigned int    mstExpectedSize = nodeNumber - 1;
     unsigned int    mstSize = 0;
-    bool ratsnestLines = false;
 
     // The output
     std::vector<CN_EDGE> mst;
 
-    // Set tags for marking cycles
-    std::unordered_map<CN_ANCHOR_PTR, int> tags;
-    unsigned int tag = 0;
+    // Disjoint sets of nodes connected together (subtrees) to detect cycles in the graph.
+    // Node tags are the indices of the nodes in the sets.
+    std::vector<int> parents( nodeNumber );
 
-    for( auto& node : aNodes )
+    for( unsigned int i = 0; i < nodeNumber; ++i )
     {
-        node->SetTag( tag );
-        tags[node] = tag++;
+        aNodes[i]->SetTag( i );
+        parents[i] = i;
     }
 
-    // Lists of nodes connected together (subtrees) to detect cycles in the graph
-    std::vector<std::list<int> > cycles( nodeNumber );
+    auto findSet = [&parents]( int aNode )
+    {
+        while( parents[aNode] != aNode )
+        {
+            parents[aNode] = parents[parents[aNode]];
+            aNode = parents[aNode];
+        }
 
-    for( unsigned int i = 0; i < nodeNumber; ++i )
-        cycles[i].push_back( i );
+        return aNode;
+    };
 
-    // Kruskal algorithm requires edges to be sorted by their weight
-    aEdges.sort( sortWeight );
+    // Kruskal algorithm requires edges to be sorted by their weight.  Keep the order of
+    // equally weighted edges, so that the same ratsnest is picked every time.
+    std::stable_sort( aEdges.begin(), aEdges.end(), sortWeight );
 
-    while( mstSize < mstExpectedSize && !aEdges.empty() )
+    for( const CN_EDGE& dt : aEdges )
     {
-        //printf("mstSize %d %d\n", mstSize, mstExpectedSize);
-        auto& dt = aEdges.front();
+        if( mstSize >= mstExpectedSize )
+            break;
 
-        int srcTag  = tags[dt.GetSourceNode()];
-        int trgTag  = tags[dt.GetTargetNode()];
+        int srcSet = findSet( dt.GetSourceNode()->GetTag() );
+        int trgSet = findSet( dt.GetTargetNode()->GetTag() );
 
         // Check if by adding this edge we are going to join two different forests
-        if( srcTag != trgTag )
-        {
-            // Because edges are sorted by their weight, first we always process connected
-            // items (weight == 0). Once we stumble upon an edge with non-zero weight,
-            // it means that the rest of the lines are ratsnest.
-            if( !ratsnestLines && dt.GetWeight() != 0 )
-                ratsnestLines = true;
-
-            // Update tags
-            if( ratsnestLines )
-            {
-                for( auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it )
-                {
-                    tags[aNodes[*it]] = srcTag;
-                }
-
-                // Do a copy of edge, but make it RN_EDGE_MST. In contrary to RN_EDGE,
-                // RN_EDGE_MST saves both source and target node and does not require any other
-                // edges to exist for getting source/target nodes
-                CN_EDGE newEdge ( dt.GetSourceNode(), dt.GetTargetNode(), dt.GetWeight() );
+        if( srcSet == trgSet )
+            continue;
 
-                assert( newEdge.GetSourceNode()->GetTag() != newEdge.GetTargetNode()->GetTag() );
-                assert( newEdge.GetWeight() > 0 );
+        parents[trgSet] = srcSet;
 
-                mst.push_back( newEdge );
-                ++mstSize;
-            }
-            else
-            {
-                // for( it = cycles[trgTag].begin(), itEnd = cycles[trgTag].end(); it != itEnd; ++it )
-                // for( auto it : cycles[trgTag] )
-                for( auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it )
-                {
-                    tags[aNodes[*it]] = srcTag;
-                    aNodes[*it]->SetTag( srcTag );
-                }
-
-                // Processing a connection, decrease the expected size of the ratsnest MST
-                --mstExpectedSize;
-            }
-
-            // Move nodes that were marked with old tag to the list marked with the new tag
-            cycles[srcTag].splice( cycles[srcTag].end(), cycles[trgTag] );
+        // Because edges are sorted by their weight, first we always process connected
+        // items (weight == 0). Once we stumble upon an edge with non-zero weight,
+        // it means that the rest of the lines are ratsnest.
+        if( dt.GetWeight() != 0 )
+        {
+            mst.emplace_back( dt.GetSourceNode(), dt.GetTargetNode(), dt.GetWeight() );
+            ++mstSize;
+        }
+        else
+        {
+            // Processing a connection, decrease the expected size of the ratsnest MST
+            --mstExpectedSize;
         }
-
-        // Remove the edge that was just processed
-        aEdges.erase( aEdges.begin() );
     }
 
-    // Probably we have discarded some of edges, so reduce the size
-    mst.resize( mstSize );
-
     return mst;
 }
 
@@ -155,30 +128,25 @@ class RN_NET::TRIANGULATOR_STATE
 private:
     std::vector<CN_ANCHOR_PTR>  m_allNodes;
 
-    std::list<hed::EDGE_PTR> hedTriangulation( std::vector<hed::NODE_PTR>& aNodes )
-    {
-        hed::TRIANGULATION triangulator;
-        triangulator.CreateDelaunay( aNodes.begin(), aNodes.end() );
-        std::list<hed::EDGE_PTR> edges;
-        triangulator.GetEdges( edges );
-
-        return edges;
-    }
+    ///> Positions of the last triangulated nodes, relative to the first one
+    std::vector<VECTOR2I>            m_cachedPoints;
 
+    ///> Edges of the last triangulation, as pairs of indices in m_cachedPoints
+    std::vector<std::pair<int, int>> m_cachedEdges;
 
-    // Checks if all nodes in aNodes lie on a single line. Requires the nodes to
-    // have unique coordinates!
-    bool areNodesColinear( const std::vector<hed::NODE_PTR>& aNodes ) const
+    // Checks if all nodes in aPoints lie on a single line. Requires the points to
+    // be unique!
+    bool areNodesColinear( const std::vector<VECTOR2I>& aPoints ) const
     {
-        if ( aNodes.size() <= 2 )
+        if ( aPoints.size() <= 2 )
             return true;
 
-        const auto p0 = aNodes[0]->Pos();
-        const auto v0 = aNodes[1]->Pos() - p0;
+        const auto p0 = aPoints[0];
+        const auto v0 = aPoints[1] - p0;
 
-        for( unsigned i = 2; i < aNodes.size(); i++ )
+        for( unsigned i = 2; i < aPoints.size(); i++ )
         {
-            const auto v1 = aNodes[i]->Pos() - p0;
+            const auto v1 = aPoints[i] - p0;
 
             if( v0.Cross( v1 ) != 0 )
             {
@@ -189,6 +157,67 @@ private:
         return true;
     }
 
+    // Checks if aPoints are a translated copy of the points triangulated last time, which
+    // is the case when a net is updated while its items are dragged around.  The
+    // triangulation does not change then.
+    bool isCached( const std::vector<VECTOR2I>& aPoints ) const
+    {
+        if( aPoints.size() != m_cachedPoints.size() )
+            return false;
+
+        for( unsigned i = 0; i < aPoints.size(); i++ )
+        {
+            if( aPoints[i] - aPoints[0] != m_cachedPoints[i] )
+                return false;
+        }
+
+        return true;
+    }
+
+    void triangulate( const std::vector<VECTOR2I>& aPoints )
+    {
+        m_cachedPoints.clear();
+        m_cachedEdges.clear();
+
+        m_cachedPoints.reserve( aPoints.size() );
+
+        for( const VECTOR2I& p : aPoints )
+            m_cachedPoints.push_back( p - aPoints[0] );
+
+        if( areNodesColinear( aPoints ) )
+        {
+            // special case: all nodes are on the same line - there's no
+            // triangulation for such set. In this case, we sort along any coordinate
+            // and chain the nodes together.
+            for( int i = 0; i < (int) aPoints.size() - 1; i++ )
+                m_cachedEdges.emplace_back( i, i + 1 );
+
+            return;
+        }
+
+        std::vector<hed::NODE_PTR> triNodes;
+        std::list<hed::EDGE_PTR>   triangEdges;
+
+        triNodes.reserve( aPoints.size() );
+
+        for( unsigned i = 0; i < aPoints.size(); i++ )
+        {
+            auto tn = std::make_shared<hed::NODE>( aPoints[i].x, aPoints[i].y );
+
+            tn->SetId( i );
+            triNodes.push_back( tn );
+        }
+
+        hed::TRIANGULATION triangulator;
+        triangulator.CreateDelaunay( triNodes.begin(), triNodes.end() );
+        triangulator.GetEdges( triangEdges );
+
+        m_cachedEdges.reserve( triangEdges.size() );
+
+        for( const auto& e : triangEdges )
+            m_cachedEdges.emplace_back( e->GetSourceNode()->Id(), e->GetTargetNode()->Id() );
+    }
+
 public:
 
     void Clear()
@@ -201,17 +230,13 @@ public:
         m_allNodes.push_back( aNode );
     }
 
-    const std::list<CN_EDGE> Triangulate()
+    std::vector<CN_EDGE> Triangulate()
     {
-        std::list<CN_EDGE> mstEdges;
-        std::list<hed::EDGE_PTR> triangEdges;
-        std::vector<hed::NODE_PTR> triNodes;
+        std::vector<CN_EDGE> mstEdges;
 
         using ANCHOR_LIST = std::vector<CN_ANCHOR_PTR>;
         std::vector<ANCHOR_LIST> anchorChains;
-
-        triNodes.reserve( m_allNodes.size() );
-        anchorChains.resize( m_allNodes.size() );
+        std::vector<VECTOR2I>    points;
 
         std::sort( m_allNodes.begin(), m_allNodes.end(),
                 [] ( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& aNode2 )
@@ -227,71 +252,38 @@ public:
         }
                 );
 
-        CN_ANCHOR_PTR prev, last;
-        int id = 0;
-
+        // Anchors sharing a position are triangulated once, and chained together below
         for( const auto& n : m_allNodes )
         {
-            if( !prev || prev->Pos() != n->Pos() )
+            if( points.empty() || points.back() != n->Pos() )
             {
-                auto tn = std::make_shared<hed::NODE> ( n->Pos().x, n->Pos().y );
-
-                tn->SetId( id );
-                triNodes.push_back( tn );
+                points.push_back( n->Pos() );
+                anchorChains.emplace_back();
             }
 
-            id++;
-            prev = n;
+            anchorChains.back().push_back( n );
         }
 
-        int prevId = 0;
-
-        for( const auto& n : triNodes )
+        if( points.size() == 1 )
         {
-            for( int i = prevId; i < n->Id(); i++ )
-                anchorChains[prevId].push_back( m_allNodes[ i ] );
-
-            prevId = n->Id();
+            return mstEdges;
         }
 
-        for( int i = prevId; i < id; i++ )
-            anchorChains[prevId].push_back( m_allNodes[ i ] );
+        if( !isCached( points ) )
+            triangulate( points );
 
-        if( triNodes.size() == 1 )
-        {
-            return mstEdges;
-        }
-        else if( areNodesColinear( triNodes ) )
-        {
-            // special case: all nodes are on the same line - there's no
-            // triangulation for such set. In this case, we sort along any coordinate
-            // and chain the nodes together.
-            for(int i = 0; i < (int)triNodes.size() - 1; i++ )
-            {
-                auto src = m_allNodes[ triNodes[i]->Id() ];
-                auto dst = m_allNodes[ triNodes[i + 1]->Id() ];
-                mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
-            }
-        }
-        else
-        {
-            hed::TRIANGULATION triangulator;
-            triangulator.CreateDelaunay( triNodes.begin(), triNodes.end() );
-            triangulator.GetEdges( triangEdges );
+        mstEdges.reserve( m_cachedEdges.size() + m_allNodes.size() - points.size() );
 
-            for( const auto& e : triangEdges )
-            {
-                auto    src = m_allNodes[ e->GetSourceNode()->Id() ];
-                auto    dst = m_allNodes[ e->GetTargetNode()->Id() ];
+        for( const auto& e : m_cachedEdges )
+        {
+            const auto& src = anchorChains[e.first].front();
+            const auto& dst = anchorChains[e.second].front();
 
-                mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
-            }
+            mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
         }
 
-        for( unsigned int i = 0; i < anchorChains.size(); i++ )
+        for( auto& chain : anchorChains )
         {
-            auto& chain = anchorChains[i];
-
             if( chain.size() < 2 )
                 continue;
 
@@ -366,8 +358,7 @@ void RN_NET::compute()
     cnt.Show();
     #endif
 
-    for( const auto& e : m_boardEdges )
-        triangEdges.push_back( e );
+    triangEdges.insert( triangEdges.end(), m_boardEdges.begin(), m_boardEdges.end() );
 
 // Get the minimal spanning tree
 #ifdef PROFILE
@@ -394,6 +385,7 @@ void RN_NET::Clear()
     m_rnEdges.clear();
     m_boardEdges.clear();
     m_nodes.clear();
+    m_sortedNodes.clear();
 
     m_dirty = true;
 }
@@ -403,6 +395,8 @@ void RN_NET::AddCluster( CN_CLUSTER_PTR aCluster )
 {
     CN_ANCHOR_PTR firstAnchor;
 
+    m_sortedNodes.clear();
+
     for( auto item : *aCluster )
     {
         bool isZone = dynamic_cast<CN_ZONE*>(item) != nullptr;
@@ -440,13 +434,34 @@ bool RN_NET::NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode
 
     VECTOR2I::extended_type distMax = VECTOR2I::ECOORD_MAX;
 
-    for( const auto& nodeA : m_nodes )
+    // The other net is usually made of items being dragged around, so keep our nodes sorted
+    // by x until the net changes and only look at the ones close to each node of the other net
+    if( m_sortedNodes.empty() )
+    {
+        m_sortedNodes = m_nodes;
+
+        std::sort( m_sortedNodes.begin(), m_sortedNodes.end(),
+                   []( const CN_ANCHOR_PTR& aA, const CN_ANCHOR_PTR& aB )
+                   {
+                       return aA->Pos().x < aB->Pos().x;
+                   } );
+    }
+
+    for( const auto& nodeB : aOtherNet.m_nodes )
     {
-        for( const auto& nodeB : aOtherNet.m_nodes )
+        const VECTOR2I posB = nodeB->Pos();
+
+        // Returns false once the nodes are too far away in x to be closer than the best pair
+        auto checkNode = [&]( const CN_ANCHOR_PTR& nodeA )
         {
+            VECTOR2I::extended_type dx = nodeA->Pos().x - posB.x;
+
+            if( dx * dx >= distMax )
+                return false;
+
             if( !nodeA->GetNoLine() )
             {
-                auto squaredDist = (nodeA->Pos() - nodeB->Pos() ).SquaredEuclideanNorm();
+                auto squaredDist = ( nodeA->Pos() - posB ).SquaredEuclideanNorm();
 
                 if( squaredDist < distMax )
                 {
@@ -456,7 +471,21 @@ bool RN_NET::NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode
                     aNode2  = nodeB;
                 }
             }
-        }
+
+            return true;
+        };
+
+        auto mid = std::lower_bound( m_sortedNodes.begin(), m_sortedNodes.end(), posB.x,
+                                     []( const CN_ANCHOR_PTR& aNode, int aX )
+                                     {
+                                         return aNode->Pos().x < aX;
+                                     } );
+
+        for( auto it = mid; it != m_sortedNodes.end() && checkNode( *it ); ++it )
+            ;
+
+        for( auto it = mid; it != m_sortedNodes.begin() && checkNode( *( it - 1 ) ); --it )
+            ;
     }
 
     return rv;
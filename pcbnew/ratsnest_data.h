@@ -151,6 +151,9 @@ protected:
     ///> Vector of nodes
     std::vector<CN_ANCHOR_PTR> m_nodes;
 
+    ///> Nodes sorted by their x coordinate, built on demand by NearestBicoloredPair()
+    mutable std::vector<CN_ANCHOR_PTR> m_sortedNodes;
+
     ///> Vector of edges that make pre-defined connections
     std::vector<CN_EDGE> m_boardEdges;
 
@@ -162,6 +165,7 @@ protected:
 
     class TRIANGULATOR_STATE;
 
+    ///> Kept between updates, so that nets moved as a whole are not triangulated again
     std::shared_ptr<TRIANGULATOR_STATE> m_triangulator;
 };
 
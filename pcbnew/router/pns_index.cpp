@@ -19,16 +19,196 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstdint>
+
 #include "pns_index.h"
 
 namespace PNS {
 
+void PACKED_INDEX::BOX::Merge( const BOX& aOther )
+{
+    m_MinX = std::min( m_MinX, aOther.m_MinX );
+    m_MinY = std::min( m_MinY, aOther.m_MinY );
+    m_MaxX = std::max( m_MaxX, aOther.m_MaxX );
+    m_MaxY = std::max( m_MaxY, aOther.m_MaxY );
+}
+
+
+void PACKED_INDEX::Add( ITEM* aItem )
+{
+    BOX2I bbox = aItem->Shape()->BBox();
+    ENTRY entry = { { bbox.GetX(), bbox.GetY(), bbox.GetRight(), bbox.GetBottom() }, aItem };
+
+    m_position[aItem] = -1 - (int) m_pending.size();
+    m_pending.push_back( entry );
+
+    if( (int) m_pending.size() > std::max<int>( MinPendingItems, m_entries.size() / NodeSize ) )
+        rebuild();
+}
+
+
+void PACKED_INDEX::Remove( ITEM* aItem )
+{
+    auto it = m_position.find( aItem );
+
+    if( it == m_position.end() )
+        return;
+
+    int pos = it->second;
+
+    m_position.erase( it );
+
+    if( pos >= 0 )
+    {
+        m_entries[pos].m_Item = nullptr;
+        m_removed++;
+
+        if( m_removed > std::max<int>( MinPendingItems, m_entries.size() / 4 ) )
+            rebuild();
+    }
+    else
+    {
+        int idx = -1 - pos;
+
+        if( idx != (int) m_pending.size() - 1 )
+        {
+            m_pending[idx] = m_pending.back();
+            m_position[m_pending[idx].m_Item] = pos;
+        }
+
+        m_pending.pop_back();
+    }
+}
+
+
+/**
+ * Returns the distance along the Hilbert curve filling a 65536 x 65536 square of point (x, y)
+ */
+static uint64_t hilbertDistance( uint32_t x, uint32_t y )
+{
+    const uint32_t n = 1 << 16;
+    uint64_t       d = 0;
+
+    for( uint32_t s = n / 2; s > 0; s /= 2 )
+    {
+        uint32_t rx = ( x & s ) > 0;
+        uint32_t ry = ( y & s ) > 0;
+
+        d += (uint64_t) s * s * ( ( 3 * rx ) ^ ry );
+
+        if( ry == 0 )
+        {
+            if( rx == 1 )
+            {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+
+            std::swap( x, y );
+        }
+    }
+
+    return d;
+}
+
+
+void PACKED_INDEX::rebuild()
+{
+    std::vector<ENTRY> entries;
+
+    entries.reserve( m_position.size() );
+
+    for( const ENTRY& entry : m_entries )
+    {
+        if( entry.m_Item )
+            entries.push_back( entry );
+    }
+
+    entries.insert( entries.end(), m_pending.begin(), m_pending.end() );
+
+    m_entries.clear();
+    m_levels.clear();
+    m_pending.clear();
+    m_removed = 0;
+
+    if( entries.empty() )
+        return;
+
+    // Sort the items along a Hilbert curve through the centers of their boxes, so that
+    // consecutive items (and groups of them) are close together
+    BOX bounds = entries[0].m_Box;
+
+    for( const ENTRY& entry : entries )
+        bounds.Merge( entry.m_Box );
+
+    int64_t width = std::max<int64_t>( (int64_t) bounds.m_MaxX - bounds.m_MinX, 1 );
+    int64_t height = std::max<int64_t>( (int64_t) bounds.m_MaxY - bounds.m_MinY, 1 );
+
+    std::vector<std::pair<uint64_t, int>> keys;
+
+    keys.reserve( entries.size() );
+
+    for( int i = 0; i < (int) entries.size(); i++ )
+    {
+        const BOX& box = entries[i].m_Box;
+        int64_t    cx = ( (int64_t) box.m_MinX + box.m_MaxX ) / 2 - bounds.m_MinX;
+        int64_t    cy = ( (int64_t) box.m_MinY + box.m_MaxY ) / 2 - bounds.m_MinY;
+
+        keys.emplace_back( hilbertDistance( (uint32_t) ( cx * 65535 / width ),
+                                          (uint32_t) ( cy * 65535 / height ) ), i );
+    }
+
+    std::sort( keys.begin(), keys.end() );
+
+    m_entries.reserve( entries.size() );
+
+    for( const auto& key : keys )
+    {
+        m_position[entries[key.second].m_Item] = m_entries.size();
+        m_entries.push_back( entries[key.second] );
+    }
+
+    // Bound the groups of NodeSize entries, then the groups of those, up to a single node
+    size_t count = m_entries.size();
+
+    do
+    {
+        std::vector<BOX> level( ( count + NodeSize - 1 ) / NodeSize );
+
+        for( size_t i = 0; i < count; i++ )
+        {
+            const BOX& box = m_levels.empty() ? m_entries[i].m_Box : m_levels.back()[i];
+
+            if( i % NodeSize == 0 )
+                level[i / NodeSize] = box;
+            else
+                level[i / NodeSize].Merge( box );
+        }
+
+        count = level.size();
+        m_levels.push_back( std::move( level ) );
+    } while( count > 1 );
+}
+
+
 INDEX::INDEX()
 {
     memset( m_subIndices, 0, sizeof( m_subIndices ) );
 }
 
 
+INDEX::INDEX( const INDEX& aOther ) :
+    m_usedSubIndices( aOther.m_usedSubIndices ),
+    m_netMap( aOther.m_netMap ),
+    m_allItems( aOther.m_allItems )
+{
+    memset( m_subIndices, 0, sizeof( m_subIndices ) );
+
+    for( int i : m_usedSubIndices )
+        m_subIndices[i] = new ITEM_SHAPE_INDEX( *aOther.m_subIndices[i] );
+}
+
+
 INDEX::~INDEX()
 {
     Clear();
@@ -78,7 +258,12 @@ INDEX::ITEM_SHAPE_INDEX* INDEX::getSubindex( const ITEM* aItem )
     }
 
     if( !m_subIndices[idx_n] )
+    {
         m_subIndices[idx_n] = new ITEM_SHAPE_INDEX;
+        m_usedSubIndices.insert( std::upper_bound( m_usedSubIndices.begin(),
+                                                   m_usedSubIndices.end(), idx_n ),
+                                 idx_n );
+    }
 
     return m_subIndices[idx_n];
 }
@@ -96,6 +281,9 @@ void INDEX::Add( ITEM* aItem )
 
     if( net >= 0 )
     {
+        if( net >= (int) m_netMap.size() )
+            m_netMap.resize( net + 1 );
+
         m_netMap[net].push_back( aItem );
     }
 }
@@ -111,8 +299,12 @@ void INDEX::Remove( ITEM* aItem )
     m_allItems.erase( aItem );
     int net = aItem->Net();
 
-    if( net >= 0 && m_netMap.find( net ) != m_netMap.end() )
-        m_netMap[net].remove( aItem );
+    if( net >= 0 && net < (int) m_netMap.size() )
+    {
+        NET_ITEMS_LIST& items = m_netMap[net];
+
+        items.erase( std::remove( items.begin(), items.end(), aItem ), items.end() );
+    }
 }
 
 void INDEX::Replace( ITEM* aOldItem, ITEM* aNewItem )
@@ -133,12 +325,14 @@ void INDEX::Clear()
 
         m_subIndices[i] = NULL;
     }
+
+    m_usedSubIndices.clear();
 }
 
 
 INDEX::NET_ITEMS_LIST* INDEX::GetItemsForNet( int aNet )
 {
-    if( m_netMap.find( aNet ) == m_netMap.end() )
+    if( aNet < 0 || aNet >= (int) m_netMap.size() )
         return NULL;
 
     return &m_netMap[aNet];
@@ -23,8 +23,11 @@
 #define __PNS_INDEX_H
 
 #include <layers_id_colors_and_visibility.h>
+#include <algorithm>
 #include <map>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <boost/range/adaptor/map.hpp>
 
@@ -36,21 +39,167 @@
 namespace PNS {
 
 
+/**
+ * PACKED_INDEX
+ *
+ * Spatial index keeping the bounding boxes of its items in flat arrays. Most items live in a
+ * bounding volume hierarchy bulk-loaded in Hilbert curve order, the ones added since it was
+ * built are kept in a short list searched linearly. Removed items are only cleared from the
+ * hierarchy, which is rebuilt once enough items have changed.
+ **/
+class PACKED_INDEX
+{
+public:
+    PACKED_INDEX() :
+        m_removed( 0 )
+    {}
+
+    void Add( ITEM* aItem );
+    void Remove( ITEM* aItem );
+
+    /**
+     * Function Query()
+     *
+     * Calls aVisitor for every item whose bounding box is within aMinDistance of the one of
+     * aShape, until it returns false.
+     * @return number of items visited.
+     */
+    template<class Visitor>
+    int Query( const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) const;
+
+    int Size() const { return m_position.size(); }
+
+private:
+    struct BOX
+    {
+        int m_MinX, m_MinY, m_MaxX, m_MaxY;
+
+        bool Overlaps( const BOX& aOther ) const
+        {
+            return m_MinX <= aOther.m_MaxX && aOther.m_MinX <= m_MaxX
+                    && m_MinY <= aOther.m_MaxY && aOther.m_MinY <= m_MaxY;
+        }
+
+        void Merge( const BOX& aOther );
+    };
+
+    struct ENTRY
+    {
+        BOX   m_Box;
+        ITEM* m_Item;       ///< NULL once removed
+    };
+
+    ///> Number of children of each node of the hierarchy
+    static const int NodeSize = 8;
+
+    ///> Items which can be added (or removed) before the hierarchy is rebuilt, at least
+    static const int MinPendingItems = 32;
+
+    template<class Visitor>
+    bool queryNode( int aLevel, int aNode, const BOX& aBox, Visitor& aVisitor, int& aCount ) const;
+
+    void rebuild();
+
+    std::vector<ENTRY>             m_entries;    ///< Items of the hierarchy, in Hilbert order
+    std::vector<std::vector<BOX>>  m_levels;     ///< Bounds of groups of NodeSize entries, then
+                                                 ///< of groups of NodeSize such groups, etc.
+    std::vector<ENTRY>             m_pending;    ///< Items added since the last rebuild
+    std::unordered_map<ITEM*, int> m_position;   ///< Index in m_entries, or -1 - index in m_pending
+    int                            m_removed;    ///< Removed items still in m_entries
+};
+
+
+template<class Visitor>
+bool PACKED_INDEX::queryNode( int aLevel, int aNode, const BOX& aBox, Visitor& aVisitor,
+                              int& aCount ) const
+{
+    int first = aNode * NodeSize;
+
+    if( aLevel == 0 )
+    {
+        int last = std::min<int>( first + NodeSize, m_entries.size() );
+
+        for( int i = first; i < last; i++ )
+        {
+            const ENTRY& entry = m_entries[i];
+
+            if( entry.m_Item && entry.m_Box.Overlaps( aBox ) )
+            {
+                if( !aVisitor( entry.m_Item ) )
+                    return false;
+
+                aCount++;
+            }
+        }
+    }
+    else
+    {
+        const std::vector<BOX>& children = m_levels[aLevel - 1];
+        int                     last = std::min<int>( first + NodeSize, children.size() );
+
+        for( int i = first; i < last; i++ )
+        {
+            if( children[i].Overlaps( aBox ) && !queryNode( aLevel - 1, i, aBox, aVisitor, aCount ) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+template<class Visitor>
+int PACKED_INDEX::Query( const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) const
+{
+    BOX2I bbox = aShape->BBox();
+    bbox.Inflate( aMinDistance );
+
+    BOX box = { bbox.GetX(), bbox.GetY(), bbox.GetRight(), bbox.GetBottom() };
+    int count = 0;
+
+    if( !m_levels.empty() )
+    {
+        int top = m_levels.size() - 1;
+
+        for( int i = 0; i < (int) m_levels[top].size(); i++ )
+        {
+            if( m_levels[top][i].Overlaps( box ) && !queryNode( top, i, box, aVisitor, count ) )
+                return count;
+        }
+    }
+
+    for( const ENTRY& entry : m_pending )
+    {
+        if( entry.m_Box.Overlaps( box ) )
+        {
+            if( !aVisitor( entry.m_Item ) )
+                return count;
+
+            count++;
+        }
+    }
+
+    return count;
+}
+
+
 /**
  * INDEX
  *
  * Custom spatial index, holding our board items and allowing for very fast searches. Items
- * are assigned to separate R-Tree subindices depending on their type and spanned layers, reducing
+ * are assigned to separate packed subindices depending on their type and spanned layers, reducing
  * overlap and improving search time.
  **/
 class INDEX
 {
 public:
-    typedef std::list<ITEM*>            NET_ITEMS_LIST;
-    typedef SHAPE_INDEX<ITEM*>          ITEM_SHAPE_INDEX;
+    typedef std::vector<ITEM*>          NET_ITEMS_LIST;
+    typedef PACKED_INDEX                ITEM_SHAPE_INDEX;
     typedef std::unordered_set<ITEM*>   ITEM_SET;
 
     INDEX();
+    INDEX( const INDEX& aOther );
+    INDEX& operator=( const INDEX& ) = delete;
     ~INDEX();
 
     /**
@@ -155,7 +304,8 @@ private:
     ITEM_SHAPE_INDEX* getSubindex( const ITEM* aItem );
 
     ITEM_SHAPE_INDEX* m_subIndices[MaxSubIndices];
-    std::map<int, NET_ITEMS_LIST> m_netMap;
+    std::vector<int> m_usedSubIndices;
+    std::vector<NET_ITEMS_LIST> m_netMap;
     ITEM_SET m_allItems;
 };
 
@@ -166,7 +316,7 @@ int INDEX::querySingle( int index, const SHAPE* aShape, int aMinDistance, Visito
     if( !m_subIndices[index] )
         return 0;
 
-    return m_subIndices[index]->Query( aShape, aMinDistance, aVisitor, false );
+    return m_subIndices[index]->Query( aShape, aMinDistance, aVisitor );
 }
 
 template<class Visitor>
@@ -207,7 +357,7 @@ int INDEX::Query( const SHAPE* aShape, int aMinDistance, Visitor& aVisitor )
 {
     int total = 0;
 
-    for( int i = 0; i < MaxSubIndices; i++ )
+    for( int i : m_usedSubIndices )
         total += querySingle( i, aShape, aMinDistance, aVisitor );
 
     return total;
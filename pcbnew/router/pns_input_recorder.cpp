@@ -0,0 +1,336 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include <wx/log.h>
+
+#include <board_connected_item.h>
+
+#include "pns_input_recorder.h"
+#include "pns_item.h"
+#include "pns_node.h"
+#include "pns_router.h"
+
+namespace PNS {
+
+static const char* const eventNames[] =
+{
+    "start_route",
+    "start_drag",
+    "move",
+    "fix",
+    "unfix",
+    "commit",
+    "stop",
+    "switch_layer",
+    "toggle_via",
+    "flip_posture",
+    "update_sizes"
+};
+
+
+static nlohmann::json sizesToJson( const SIZES_SETTINGS& aSizes )
+{
+    return nlohmann::json( {
+            { "track_width", aSizes.TrackWidth() },
+            { "diff_pair_width", aSizes.DiffPairWidth() },
+            { "diff_pair_gap", aSizes.DiffPairGap() },
+            { "diff_pair_via_gap", aSizes.DiffPairViaGap() },
+            { "diff_pair_via_gap_same_as_trace_gap", aSizes.DiffPairViaGapSameAsTraceGap() },
+            { "via_diameter", aSizes.ViaDiameter() },
+            { "via_drill", aSizes.ViaDrill() },
+            { "via_type", static_cast<int>( aSizes.ViaType() ) },
+            { "layer_top", aSizes.GetLayerTop() },
+            { "layer_bottom", aSizes.GetLayerBottom() } } );
+}
+
+
+static SIZES_SETTINGS sizesFromJson( const nlohmann::json& aJson )
+{
+    SIZES_SETTINGS sizes;
+
+    sizes.SetTrackWidth( aJson.at( "track_width" ).get<int>() );
+    sizes.SetDiffPairWidth( aJson.at( "diff_pair_width" ).get<int>() );
+    sizes.SetDiffPairGap( aJson.at( "diff_pair_gap" ).get<int>() );
+    sizes.SetDiffPairViaGap( aJson.at( "diff_pair_via_gap" ).get<int>() );
+    sizes.SetDiffPairViaGapSameAsTraceGap(
+            aJson.at( "diff_pair_via_gap_same_as_trace_gap" ).get<bool>() );
+    sizes.SetViaDiameter( aJson.at( "via_diameter" ).get<int>() );
+    sizes.SetViaDrill( aJson.at( "via_drill" ).get<int>() );
+    sizes.SetViaType( static_cast<VIATYPE>( aJson.at( "via_type" ).get<int>() ) );
+    sizes.AddLayerPair( aJson.at( "layer_top" ).get<int>(),
+                        aJson.at( "layer_bottom" ).get<int>() );
+
+    return sizes;
+}
+
+
+INPUT_RECORDER::INPUT_RECORDER()
+{
+}
+
+
+void INPUT_RECORDER::Clear()
+{
+    m_events.clear();
+}
+
+
+void INPUT_RECORDER::Record( ROUTER* aRouter, EVENT_TYPE aType, const VECTOR2I& aP,
+                             const ITEM_SET& aItems, int aArg )
+{
+    EVENT evt;
+
+    evt.m_Type = aType;
+    evt.m_Position = aP;
+    evt.m_Arg = aArg;
+
+    for( const ITEM* item : aItems.CItems() )
+    {
+        if( !item )
+            continue;
+
+        ITEM_REF ref;
+
+        ref.m_Kind = item->Kind();
+        ref.m_Net = item->Net();
+        ref.m_LayerStart = item->Layers().Start();
+        ref.m_LayerEnd = item->Layers().End();
+        ref.m_Anchor = item->Anchor( 0 );
+        ref.m_Parent = item->Parent() ? item->Parent()->m_Uuid : niluuid;
+
+        evt.m_Items.push_back( ref );
+    }
+
+    if( aType == EVT_START_ROUTE || aType == EVT_START_DRAG || aType == EVT_UPDATE_SIZES )
+        evt.m_Config[ "sizes" ] = sizesToJson( aRouter->Sizes() );
+
+    if( aType == EVT_START_ROUTE || aType == EVT_START_DRAG )
+    {
+        ROUTING_SETTINGS& settings = aRouter->Settings();
+
+        // The settings are a JSON_SETTINGS, so storing them gives us the current values
+        settings.Store();
+
+        evt.m_Config[ "mode" ] = static_cast<int>( aRouter->Mode() );
+        evt.m_Config[ "settings" ] = static_cast<const nlohmann::json&>( settings );
+    }
+
+    m_events.push_back( std::move( evt ) );
+
+    if( aType == EVT_STOP && !m_autoSaveFile.IsEmpty() && !Save( m_autoSaveFile ) )
+        wxLogTrace( "PNS", "Could not save router input log %s", m_autoSaveFile );
+}
+
+
+bool INPUT_RECORDER::Save( const wxString& aFilename ) const
+{
+    LOCALE_IO      dummy;
+    nlohmann::json js;
+
+    js[ "board" ] = m_boardFile.ToStdString();
+    js[ "events" ] = nlohmann::json::array();
+
+    for( const EVENT& evt : m_events )
+    {
+        nlohmann::json jevt;
+
+        jevt[ "type" ] = EventName( evt.m_Type );
+        jevt[ "pos" ] = { evt.m_Position.x, evt.m_Position.y };
+        jevt[ "arg" ] = evt.m_Arg;
+
+        if( !evt.m_Items.empty() )
+        {
+            jevt[ "items" ] = nlohmann::json::array();
+
+            for( const ITEM_REF& ref : evt.m_Items )
+            {
+                jevt[ "items" ].push_back( {
+                        { "kind", ref.m_Kind },
+                        { "net", ref.m_Net },
+                        { "layers", { ref.m_LayerStart, ref.m_LayerEnd } },
+                        { "anchor", { ref.m_Anchor.x, ref.m_Anchor.y } },
+                        { "parent", ref.m_Parent.AsString().ToStdString() } } );
+            }
+        }
+
+        if( !evt.m_Config.is_null() )
+            jevt[ "config" ] = evt.m_Config;
+
+        js[ "events" ].push_back( jevt );
+    }
+
+    std::ofstream file( aFilename.ToStdString() );
+
+    if( !file.is_open() )
+        return false;
+
+    file << std::setw( 2 ) << js << std::endl;
+
+    return file.good();
+}
+
+
+bool INPUT_RECORDER::Load( const wxString& aFilename )
+{
+    LOCALE_IO     dummy;
+    std::ifstream file( aFilename.ToStdString() );
+
+    if( !file.is_open() )
+        return false;
+
+    Clear();
+
+    try
+    {
+        nlohmann::json js;
+        file >> js;
+
+        m_boardFile = wxString::FromUTF8( js.at( "board" ).get<std::string>().c_str() );
+
+        for( const nlohmann::json& jevt : js.at( "events" ) )
+        {
+            EVENT             evt;
+            const std::string type = jevt.at( "type" ).get<std::string>();
+            auto              name = std::find_if( std::begin( eventNames ), std::end( eventNames ),
+                                                   [&]( const char* aName )
+                                                   {
+                                                       return type == aName;
+                                                   } );
+
+            if( name == std::end( eventNames ) )
+            {
+                wxLogTrace( "PNS", "Unknown router event '%s'", type );
+                Clear();
+                return false;
+            }
+
+            evt.m_Type = static_cast<EVENT_TYPE>( name - std::begin( eventNames ) );
+            evt.m_Position = VECTOR2I( jevt.at( "pos" )[0].get<int>(),
+                                       jevt.at( "pos" )[1].get<int>() );
+            evt.m_Arg = jevt.at( "arg" ).get<int>();
+
+            if( jevt.contains( "items" ) )
+            {
+                for( const nlohmann::json& jref : jevt.at( "items" ) )
+                {
+                    ITEM_REF ref;
+
+                    ref.m_Kind = jref.at( "kind" ).get<int>();
+                    ref.m_Net = jref.at( "net" ).get<int>();
+                    ref.m_LayerStart = jref.at( "layers" )[0].get<int>();
+                    ref.m_LayerEnd = jref.at( "layers" )[1].get<int>();
+                    ref.m_Anchor = VECTOR2I( jref.at( "anchor" )[0].get<int>(),
+                                             jref.at( "anchor" )[1].get<int>() );
+                    ref.m_Parent = KIID( wxString( jref.at( "parent" ).get<std::string>() ) );
+
+                    evt.m_Items.push_back( ref );
+                }
+            }
+
+            if( jevt.contains( "config" ) )
+                evt.m_Config = jevt.at( "config" );
+
+            m_events.push_back( std::move( evt ) );
+        }
+    }
+    catch( const std::exception& e )
+    {
+        wxLogTrace( "PNS", "Could not load router input log %s: %s", aFilename, e.what() );
+        Clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+void INPUT_RECORDER::ApplyConfig( ROUTER* aRouter, const EVENT& aEvent )
+{
+    const nlohmann::json& config = aEvent.m_Config;
+
+    if( config.is_null() )
+        return;
+
+    if( config.contains( "mode" ) )
+        aRouter->SetMode( static_cast<ROUTER_MODE>( config.at( "mode" ).get<int>() ) );
+
+    if( config.contains( "settings" ) )
+    {
+        ROUTING_SETTINGS& settings = aRouter->Settings();
+
+        settings.update( config.at( "settings" ) );
+        settings.Load();
+    }
+
+    if( config.contains( "sizes" ) )
+        aRouter->UpdateSizes( sizesFromJson( config.at( "sizes" ) ) );
+}
+
+
+ITEM_SET INPUT_RECORDER::FindItems( NODE* aWorld, const EVENT& aEvent )
+{
+    ITEM_SET items;
+
+    for( const ITEM_REF& ref : aEvent.m_Items )
+    {
+        ITEM*    found = nullptr;
+        ITEM_SET candidates = aWorld->HitTest( ref.m_Anchor );
+
+        for( ITEM* item : candidates.Items() )
+        {
+            if( item->Kind() != ref.m_Kind || item->Net() != ref.m_Net
+                    || item->Layers().Start() != ref.m_LayerStart
+                    || item->Layers().End() != ref.m_LayerEnd )
+            {
+                continue;
+            }
+
+            // Prefer the item with the same parent.  Items committed by an earlier session
+            // have no parent in a replay, so they are only matched by their properties.
+            if( item->Parent() && item->Parent()->m_Uuid == ref.m_Parent )
+            {
+                found = item;
+                break;
+            }
+
+            if( !found )
+                found = item;
+        }
+
+        if( found )
+            items.Add( found );
+        else
+            wxLogTrace( "PNS", "Replay: could not find item of kind %d at (%d, %d)",
+                        ref.m_Kind, ref.m_Anchor.x, ref.m_Anchor.y );
+    }
+
+    return items;
+}
+
+
+const char* INPUT_RECORDER::EventName( EVENT_TYPE aType )
+{
+    return eventNames[ aType ];
+}
+
+}
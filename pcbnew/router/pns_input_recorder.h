@@ -0,0 +1,125 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_INPUT_RECORDER_H
+#define __PNS_INPUT_RECORDER_H
+
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <common.h>
+#include <math/vector2d.h>
+
+#include "pns_itemset.h"
+
+namespace PNS {
+
+class NODE;
+class ROUTER;
+
+/**
+ * INPUT_RECORDER
+ *
+ * Records the calls made to the ROUTER by the interactive tools (start items, mouse
+ * trajectory, sizes and settings) so that a routing session can be replayed offline
+ * against the same board, e.g. to measure router performance.
+ */
+class INPUT_RECORDER
+{
+public:
+    enum EVENT_TYPE
+    {
+        EVT_START_ROUTE = 0,
+        EVT_START_DRAG,
+        EVT_MOVE,
+        EVT_FIX,
+        EVT_UNFIX,
+        EVT_COMMIT,
+        EVT_STOP,
+        EVT_SWITCH_LAYER,
+        EVT_TOGGLE_VIA,
+        EVT_FLIP_POSTURE,
+        EVT_UPDATE_SIZES
+    };
+
+    ///> Identifies a router item so that it can be found again in a freshly synced world
+    struct ITEM_REF
+    {
+        int      m_Kind;
+        int      m_Net;
+        int      m_LayerStart;
+        int      m_LayerEnd;
+        VECTOR2I m_Anchor;
+        KIID     m_Parent;     ///> uuid of the parent board item, niluuid for router items
+    };
+
+    struct EVENT
+    {
+        EVENT_TYPE            m_Type;
+        VECTOR2I              m_Position;
+        int                   m_Arg;        ///> layer, drag mode or force-finish flag
+        std::vector<ITEM_REF> m_Items;
+        nlohmann::json        m_Config;     ///> router mode, sizes and settings (start events)
+    };
+
+    INPUT_RECORDER();
+
+    void Clear();
+
+    void SetBoardFile( const wxString& aFilename ) { m_boardFile = aFilename; }
+    const wxString& GetBoardFile() const { return m_boardFile; }
+
+    ///> Sets a file the recording is saved to each time a routing session ends.
+    void SetAutoSaveFile( const wxString& aFilename ) { m_autoSaveFile = aFilename; }
+
+    /**
+     * Records a single router call.  Start events also capture the current configuration
+     * of \a aRouter, so that each session can be replayed on its own.
+     */
+    void Record( ROUTER* aRouter, EVENT_TYPE aType, const VECTOR2I& aP = VECTOR2I(),
+                 const ITEM_SET& aItems = ITEM_SET(), int aArg = 0 );
+
+    const std::vector<EVENT>& Events() const { return m_events; }
+
+    bool Save( const wxString& aFilename ) const;
+    bool Load( const wxString& aFilename );
+
+    /**
+     * Applies the configuration captured by a start event to \a aRouter.
+     */
+    static void ApplyConfig( ROUTER* aRouter, const EVENT& aEvent );
+
+    /**
+     * Finds the items referenced by \a aEvent in \a aWorld.
+     */
+    static ITEM_SET FindItems( NODE* aWorld, const EVENT& aEvent );
+
+    static const char* EventName( EVENT_TYPE aType );
+
+private:
+    wxString           m_boardFile;
+    wxString           m_autoSaveFile;
+    std::vector<EVENT> m_events;
+};
+
+}
+
+#endif
@@ -55,6 +55,7 @@
 #include "pns_meander_placer.h"
 #include "pns_meander_skew_placer.h"
 #include "pns_dp_meander_placer.h"
+#include "pns_input_recorder.h"
 
 namespace PNS {
 
@@ -77,6 +78,8 @@ ROUTER::ROUTER()
     m_snapshotIter = 0;
     m_violation = false;
     m_iface = nullptr;
+    m_iterationCount = 0;
+    m_recorder = nullptr;
 }
 
 
@@ -139,6 +142,9 @@ bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM_SET aStartItems, int aDragM
     if( aStartItems.Empty() )
         return false;
 
+    if( m_recorder )
+        m_recorder->Record( this, INPUT_RECORDER::EVT_START_DRAG, aP, aStartItems, aDragMode );
+
     if( aStartItems.Count( ITEM::SOLID_T ) == aStartItems.Size() )
     {
         m_dragger = std::make_unique<COMPONENT_DRAGGER>( this );
@@ -189,7 +195,10 @@ bool ROUTER::isStartingPointRoutable( const VECTOR2I& aWhere, int aLayer )
 }
 
 bool ROUTER::StartRouting( const VECTOR2I& aP, ITEM* aStartItem, int aLayer )
-{   
+{
+    if( m_recorder )
+        m_recorder->Record( this, INPUT_RECORDER::EVT_START_ROUTE, aP, ITEM_SET( aStartItem ),
+                            aLayer );
 
     if( ! isStartingPointRoutable( aP, aLayer ) )
     {
@@ -245,6 +254,9 @@ void ROUTER::DisplayItems( const ITEM_SET& aItems )
 
 void ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
 {
+    if( m_recorder )
+        m_recorder->Record( this, INPUT_RECORDER::EVT_MOVE, aP, ITEM_SET( endItem ) );
+
     m_currentEnd = aP;
 
     switch( m_state )
@@ -336,6 +348,10 @@ void ROUTER::UpdateSizes( const SIZES_SETTINGS& aSizes )
     // Change track/via size settings
     if( m_state == ROUTE_TRACK)
     {
+        // Sizes set before routing starts are recorded with the start event
+        if( m_recorder )
+            m_recorder->Record( this, INPUT_RECORDER::EVT_UPDATE_SIZES );
+
         m_placer->UpdateSizes( m_sizes );
     }
 }
@@ -392,6 +408,9 @@ bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
 {
     bool rv = false;
 
+    if( m_recorder )
+        m_recorder->Record( this, INPUT_RECORDER::EVT_FIX, aP, ITEM_SET( aEndItem ), aForceFinish );
+
     switch( m_state )
     {
     case ROUTE_TRACK:
@@ -415,12 +434,18 @@ void ROUTER::UndoLastSegment()
     if( !RoutingInProgress() )
         return;
 
+    if( m_recorder )
+        m_recorder->Record( this, INPUT_RECORDER::EVT_UNFIX );
+
     m_placer->UnfixRoute();
 }
 
 
 void ROUTER::CommitRouting()
 {
+    if( m_recorder )
+        m_recorder->Record( this, INPUT_RECORDER::EVT_COMMIT );
+
     if( m_state == ROUTE_TRACK )
         m_placer->CommitPlacement();
 
@@ -445,6 +470,9 @@ void ROUTER::StopRouting()
     if( !RoutingInProgress() )
         return;
 
+    if( m_recorder )
+        m_recorder->Record( this, INPUT_RECORDER::EVT_STOP );
+
     m_placer.reset();
     m_dragger.reset();
 
@@ -458,6 +486,9 @@ void ROUTER::StopRouting()
 
 void ROUTER::FlipPosture()
 {
+    if( m_recorder )
+        m_recorder->Record( this, INPUT_RECORDER::EVT_FLIP_POSTURE );
+
     if( m_state == ROUTE_TRACK )
     {
         m_placer->FlipPosture();
@@ -467,6 +498,9 @@ void ROUTER::FlipPosture()
 
 void ROUTER::SwitchLayer( int aLayer )
 {
+    if( m_recorder )
+        m_recorder->Record( this, INPUT_RECORDER::EVT_SWITCH_LAYER, VECTOR2I(), ITEM_SET(), aLayer );
+
     switch( m_state )
     {
     case ROUTE_TRACK:
@@ -480,6 +514,9 @@ void ROUTER::SwitchLayer( int aLayer )
 
 void ROUTER::ToggleViaPlacement()
 {
+    if( m_recorder )
+        m_recorder->Record( this, INPUT_RECORDER::EVT_TOGGLE_VIA );
+
     if( m_state == ROUTE_TRACK )
     {
         bool toggle = !m_placer->IsPlacingVia();
@@ -22,6 +22,7 @@
 #ifndef __PNS_ROUTER_H
 #define __PNS_ROUTER_H
 
+#include <atomic>
 #include <list>
 
 #include <memory>
@@ -63,6 +64,7 @@ class RULE_RESOLVER;
 class SHOVE;
 class DRAGGER;
 class DRAG_ALGO;
+class INPUT_RECORDER;
 
 enum ROUTER_MODE {
     PNS_MODE_ROUTE_SINGLE = 1,
@@ -187,6 +189,18 @@ public:
     void SetIterLimit( int aX ) { m_iterLimit = aX; }
     int GetIterLimit() const { return m_iterLimit; };
 
+    ///> Adds to the number of shove/walkaround iterations done so far (used for profiling).
+    void CountIterations( int aCount ) { m_iterationCount += aCount; }
+    int GetIterationCount() const { return m_iterationCount; }
+    void ResetIterationCount() { m_iterationCount = 0; }
+
+    /**
+     * Sets a recorder for the router calls, allowing the session to be replayed offline.
+     * The recorder is not owned by the router.  Pass nullptr to stop recording.
+     */
+    void SetRecorder( INPUT_RECORDER* aRecorder ) { m_recorder = aRecorder; }
+    INPUT_RECORDER* GetRecorder() const { return m_recorder; }
+
     void SetShowIntermediateSteps( bool aX, int aSnapshotIter = -1 )
     {
         m_showInterSteps = aX;
@@ -272,6 +286,7 @@ private:
     ROUTER_IFACE* m_iface;
 
     int m_iterLimit;
+    std::atomic<int> m_iterationCount;
     bool m_showInterSteps;
     int m_snapshotIter;
     bool m_violation;
@@ -280,6 +295,7 @@ private:
     ROUTING_SETTINGS* m_settings;
     SIZES_SETTINGS m_sizes;
     ROUTER_MODE m_mode;
+    INPUT_RECORDER* m_recorder;
 
     wxString m_toolStatusbarName;
     wxString m_failureReason;
@@ -535,6 +535,12 @@ SHOVE::SHOVE_STATUS SHOVE::onCollidingSolid( LINE& aCurrent, ITEM* aObstacle )
 
     bool success = false;
 
+    // Route() picks the winding direction itself, so both attempts walk around the cluster
+    // the same way.  The cluster is walked once, and the attempts only differ by the rank they
+    // give to the result.
+    LINE                          walkLine( aCurrent );
+    WALKAROUND::WALKAROUND_STATUS walkStatus = walkaround.Route( aCurrent, walkLine, false );
+
     for( int attempt = 0; attempt < 2; attempt++ )
     {
         if( attempt == 1 || Settings().JumpOverObstacles() )
@@ -549,12 +555,11 @@ SHOVE::SHOVE_STATUS SHOVE::onCollidingSolid( LINE& aCurrent, ITEM* aObstacle )
             walkaround.SetSingleDirection( false );
         }
 
-
-    	WALKAROUND::WALKAROUND_STATUS status = walkaround.Route( aCurrent, walkaroundLine, false );
-
-        if( status != WALKAROUND::DONE )
+        if( walkStatus != WALKAROUND::DONE )
             continue;
 
+        walkaroundLine = walkLine;
+
         walkaroundLine.ClearSegmentLinks();
         walkaroundLine.Unmark();
     	walkaroundLine.Line().Simplify();
@@ -1223,6 +1228,8 @@ SHOVE::SHOVE_STATUS SHOVE::shoveMainLoop()
         }
     }
 
+    Router()->CountIterations( m_iter );
+
     return st;
 }
 
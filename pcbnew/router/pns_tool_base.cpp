@@ -19,6 +19,7 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <wx/filename.h>
 #include <wx/numdlg.h>
 
 #include <functional>
@@ -27,6 +28,7 @@ using namespace std::placeholders;
 #include "class_draw_panel_gal.h"
 #include "class_board.h"
 
+#include <advanced_config.h>
 #include <pcb_edit_frame.h>
 #include <id.h>
 #include <macros.h>
@@ -45,6 +47,7 @@ using namespace std::placeholders;
 #include <tools/grid_helper.h>
 
 #include "pns_arc.h"
+#include "pns_input_recorder.h"
 #include "pns_kicad_iface.h"
 #include "pns_tool_base.h"
 #include "pns_segment.h"
@@ -115,6 +118,24 @@ void TOOL_BASE::Reset( RESET_REASON aReason )
 
     m_router->LoadSettings( settings->m_PnsSettings.get() );
 
+    // A replay needs the board file, so only saved boards are recorded
+    if( ADVANCED_CFG::GetCfg().m_RecordRouterInput && !board()->GetFileName().IsEmpty() )
+    {
+        if( !m_recorder || m_recorder->GetBoardFile() != board()->GetFileName() )
+        {
+            wxFileName logFile( board()->GetFileName() );
+            logFile.SetName( logFile.GetName() + wxT( "-" )
+                             + wxString( GetName() ).AfterLast( '.' ) );
+            logFile.SetExt( wxT( "json" ) );
+
+            m_recorder = std::make_unique<INPUT_RECORDER>();
+            m_recorder->SetBoardFile( board()->GetFileName() );
+            m_recorder->SetAutoSaveFile( logFile.GetFullPath() );
+        }
+
+        m_router->SetRecorder( m_recorder.get() );
+    }
+
     m_gridHelper = new GRID_HELPER( frame() );
 }
 
@@ -75,6 +75,7 @@ protected:
     GRID_HELPER* m_gridHelper;
     PNS_KICAD_IFACE* m_iface;
     ROUTER* m_router;
+    std::unique_ptr<INPUT_RECORDER> m_recorder; ///< Records the router inputs, if enabled
 
     bool m_cancelled;
 };
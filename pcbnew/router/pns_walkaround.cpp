@@ -19,7 +19,12 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <memory>
+
+#include <advanced_config.h>
 #include <core/optional.h>
+#include <thread_pool.h>
 
 #include <geometry/shape_line_chain.h>
 
@@ -52,45 +57,45 @@ NODE::OPT_OBSTACLE WALKAROUND::nearestObstacle( const LINE& aPath )
 }
 
 
-WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
-                                                              bool aWindingDirection )
+WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( WALK& aWalk )
 {
-    OPT<OBSTACLE>& current_obs =
-        aWindingDirection ? m_currentObstacle[0] : m_currentObstacle[1];
+    LINE&          path = aWalk.m_Path;
+    bool           windingDirection = aWalk.m_Cw;
+    OPT<OBSTACLE>& current_obs = aWalk.m_CurrentObstacle;
 
     if( !current_obs )
         return DONE;
 
     SHAPE_LINE_CHAIN path_pre[2], path_walk[2], path_post[2];
 
-    VECTOR2I last = aPath.CPoint( -1 );
+    VECTOR2I last = path.CPoint( -1 );
 
     if( ( current_obs->m_hull ).PointInside( last ) || ( current_obs->m_hull ).PointOnEdge( last ) )
     {
-        m_recursiveBlockageCount++;
+        aWalk.m_RecursiveBlockageCount++;
 
-        if( m_recursiveBlockageCount < 3 )
-            aPath.Line().Append( current_obs->m_hull.NearestPoint( last ) );
+        if( aWalk.m_RecursiveBlockageCount < 3 )
+            path.Line().Append( current_obs->m_hull.NearestPoint( last ) );
         else
         {
-            aPath = aPath.ClipToNearestObstacle( m_world );
+            path = path.ClipToNearestObstacle( m_world );
             return DONE;
         }
     }
 
-      aPath.Walkaround( current_obs->m_hull, path_pre[0], path_walk[0],
-                      path_post[0], aWindingDirection );
-    aPath.Walkaround( current_obs->m_hull, path_pre[1], path_walk[1],
-                      path_post[1], !aWindingDirection );
+      path.Walkaround( current_obs->m_hull, path_pre[0], path_walk[0],
+                      path_post[0], windingDirection );
+    path.Walkaround( current_obs->m_hull, path_pre[1], path_walk[1],
+                      path_post[1], !windingDirection );
 
-    if( ! aPath.Walkaround( current_obs->m_hull, path_pre[1], path_walk[1],
-                      path_post[1], !aWindingDirection ) )
+    if( ! path.Walkaround( current_obs->m_hull, path_pre[1], path_walk[1],
+                      path_post[1], !windingDirection ) )
         return STUCK;
-    auto l =aPath.CLine();
+    auto l =path.CLine();
 #ifdef DEBUG
     if( m_logger )
     {
-        m_logger->NewGroup( aWindingDirection ? "walk-cw" : "walk-ccw", m_iteration );
+        m_logger->NewGroup( windingDirection ? "walk-cw" : "walk-ccw", aWalk.m_Steps );
         m_logger->Log( &path_walk[0], 0, "path_walk" );
         m_logger->Log( &path_pre[0], 1, "path_pre" );
         m_logger->Log( &path_post[0], 4, "path_post" );
@@ -99,19 +104,19 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
     }
 #endif
 
-    if ( Dbg() )
+    if ( aWalk.m_Dbg )
     {
         char name[128];
-        snprintf(name, sizeof(name), "hull-%s-%d", aWindingDirection ? "cw" : "ccw", m_iteration );
-        Dbg()->AddLine( current_obs->m_hull, 0, 1, name);
-        snprintf(name, sizeof(name), "path-%s-%d", aWindingDirection ? "cw" : "ccw", m_iteration );
-        Dbg()->AddLine( aPath.CLine(), 1, 1, name );
+        snprintf(name, sizeof(name), "hull-%s-%d", windingDirection ? "cw" : "ccw", aWalk.m_Steps );
+        aWalk.m_Dbg->AddLine( current_obs->m_hull, 0, 1, name);
+        snprintf(name, sizeof(name), "path-%s-%d", windingDirection ? "cw" : "ccw", aWalk.m_Steps );
+        aWalk.m_Dbg->AddLine( path.CLine(), 1, 1, name );
     }
 
     int len_pre = path_walk[0].Length();
     int len_alt = path_walk[1].Length();
 
-    LINE walk_path( aPath, path_walk[1] );
+    LINE walk_path( path, path_walk[1] );
 
     bool alt_collides = static_cast<bool>( m_world->CheckColliding( &walk_path, m_itemMask ) );
 
@@ -124,9 +129,9 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
         pnew.Append( path_post[1] );
 
         if( !path_post[1].PointCount() || !path_walk[1].PointCount() )
-            current_obs = nearestObstacle( LINE( aPath, path_pre[1] ) );
+            current_obs = nearestObstacle( LINE( path, path_pre[1] ) );
         else
-            current_obs = nearestObstacle( LINE( aPath, path_post[1] ) );
+            current_obs = nearestObstacle( LINE( path, path_post[1] ) );
     }
     else*/
     {
@@ -135,25 +140,25 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
         pnew.Append( path_post[0] );
 
         if( path_post[0].PointCount() == 0 || path_walk[0].PointCount() == 0 )
-            current_obs = nearestObstacle( LINE( aPath, path_pre[0] ) );
+            current_obs = nearestObstacle( LINE( path, path_pre[0] ) );
         else
-            current_obs = nearestObstacle( LINE( aPath, path_walk[0] ) );
+            current_obs = nearestObstacle( LINE( path, path_walk[0] ) );
 
         if( !current_obs )
         {
-            current_obs = nearestObstacle( LINE( aPath, path_post[0] ) );
+            current_obs = nearestObstacle( LINE( path, path_post[0] ) );
         }
     }
 
     pnew.Simplify();
-    aPath.SetShape( pnew );
+    path.SetShape( pnew );
 
     return IN_PROGRESS;
 }
 
 
 
-bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
+static bool clipToLoopStart( SHAPE_LINE_CHAIN& l, DEBUG_DECORATOR* aDbg )
 {
     auto ip = l.SelfIntersecting();
 
@@ -166,8 +171,8 @@ bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
 
         int pidx2 = tail.Split( ip->p );
         
-        auto dbg = ROUTER::GetInstance()->GetInterface()->GetDebugDecorator();
-        dbg->AddPoint( ip->p, 5 );
+        if( aDbg )
+            aDbg->AddPoint( ip->p, 5 );
         
         l = lead;
         l.Append( tail.Slice( 0, pidx2 ) );
@@ -180,11 +185,176 @@ bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
 
 
 
+/**
+ * Keeps the debug graphics of a walk done on a worker thread, to be drawn once it is over
+ */
+class DEBUG_RECORDER : public DEBUG_DECORATOR
+{
+public:
+    void AddPoint( VECTOR2I aP, int aColor, const std::string aName = "" ) override
+    {
+        m_calls.emplace_back( [=]( DEBUG_DECORATOR* aDbg ) { aDbg->AddPoint( aP, aColor, aName ); } );
+    }
+
+    void AddLine( const SHAPE_LINE_CHAIN& aLine, int aType = 0, int aWidth = 0,
+                  const std::string aName = "" ) override
+    {
+        m_calls.emplace_back( [=]( DEBUG_DECORATOR* aDbg )
+                              {
+                                  aDbg->AddLine( aLine, aType, aWidth, aName );
+                              } );
+    }
+
+    void AddSegment( SEG aS, int aColor, const std::string aName = "" ) override
+    {
+        m_calls.emplace_back( [=]( DEBUG_DECORATOR* aDbg ) { aDbg->AddSegment( aS, aColor, aName ); } );
+    }
+
+    void AddBox( BOX2I aB, int aColor, const std::string aName = "" ) override
+    {
+        m_calls.emplace_back( [=]( DEBUG_DECORATOR* aDbg ) { aDbg->AddBox( aB, aColor, aName ); } );
+    }
+
+    void AddDirections( VECTOR2D aP, int aMask, int aColor, const std::string aName = "" ) override
+    {
+        m_calls.emplace_back( [=]( DEBUG_DECORATOR* aDbg )
+                              {
+                                  aDbg->AddDirections( aP, aMask, aColor, aName );
+                              } );
+    }
+
+    void Clear() override
+    {
+        m_calls.emplace_back( []( DEBUG_DECORATOR* aDbg ) { aDbg->Clear(); } );
+    }
+
+    void Replay( DEBUG_DECORATOR* aDbg )
+    {
+        for( const auto& call : m_calls )
+            call( aDbg );
+
+        m_calls.clear();
+    }
+
+private:
+    std::vector<std::function<void( DEBUG_DECORATOR* )>> m_calls;
+};
+
+
+void WALKAROUND::step( WALK& aWalk, bool aClipLoops )
+{
+    if( aWalk.m_Status != STUCK )
+        aWalk.m_Status = singleStep( aWalk );
+
+    if( aClipLoops && clipToLoopStart( aWalk.m_Path.Line(), aWalk.m_Dbg ) )
+        aWalk.m_Status = ALMOST_DONE;
+
+    aWalk.m_Steps++;
+}
+
+
+void WALKAROUND::walkBoth( WALK& aCw, WALK& aCcw, bool aClipLoops, std::atomic<int>* aDoneAt )
+{
+    // Walks aWalk by at most aMaxSteps iterations, returns false once it is over
+    auto advance =
+            [&]( WALK& aWalk, int aMaxSteps ) -> bool
+            {
+                for( int ii = 0; ii < aMaxSteps; ii++ )
+                {
+                    if( aWalk.m_Status != IN_PROGRESS || aWalk.m_Steps >= m_iterationLimit )
+                        return false;
+
+                    // The other direction was done earlier, this one cannot be picked anymore
+                    if( aDoneAt && aWalk.m_Steps > aDoneAt->load() )
+                        return false;
+
+                    step( aWalk, aClipLoops );
+
+                    if( aDoneAt && aWalk.m_Status == DONE )
+                    {
+                        int doneAt = aDoneAt->load();
+
+                        while( aWalk.m_Steps - 1 < doneAt
+                               && !aDoneAt->compare_exchange_weak( doneAt, aWalk.m_Steps - 1 ) )
+                            ;
+                    }
+                }
+
+                return true;
+            };
+
+    bool parallel = ADVANCED_CFG::GetCfg().m_ParallelRouting
+                    && THREAD_POOL::GetInstance().GetThreadCount() > 1
+                    && aCw.m_Status == IN_PROGRESS && aCcw.m_Status == IN_PROGRESS && !m_logger;
+
+    if( !parallel )
+    {
+        // Walk both directions in lockstep, as long as either of them can go on
+        while( advance( aCw, 1 ) | advance( aCcw, 1 ) )
+            ;
+
+        return;
+    }
+
+    std::unique_ptr<DEBUG_RECORDER> recorders[2];
+
+    if( Dbg() )
+    {
+        recorders[0].reset( new DEBUG_RECORDER );
+        recorders[1].reset( new DEBUG_RECORDER );
+        aCw.m_Dbg = recorders[0].get();
+        aCcw.m_Dbg = recorders[1].get();
+    }
+
+    TASK_GROUP tasks( THREAD_POOL::GetInstance() );
+
+    tasks.Run( [&]() { advance( aCw, m_iterationLimit ); } );
+    tasks.Run( [&]() { advance( aCcw, m_iterationLimit ); } );
+    tasks.Wait();
+
+    if( Dbg() )
+    {
+        recorders[0]->Replay( Dbg() );
+        recorders[1]->Replay( Dbg() );
+        aCw.m_Dbg = aCcw.m_Dbg = Dbg();
+    }
+}
+
+
+int WALKAROUND::catchUp( WALK& aCw, WALK& aCcw, bool aClipLoops,
+                         const std::function<bool( WALKAROUND_STATUS, WALKAROUND_STATUS )>& aFinished )
+{
+    // A walk which went further than iteration t was still in progress at t, since walkBoth()
+    // stops each walk at its first iteration which is not in progress
+    auto statusAt =
+            []( const WALK& aWalk, int t )
+            {
+                return aWalk.m_Steps - 1 > t ? IN_PROGRESS : aWalk.m_Status;
+            };
+
+    // Before both walks stopped, at least one was in progress and they could not be finished
+    for( int t = std::max( std::min( aCw.m_Steps, aCcw.m_Steps ) - 1, 0 ); t < m_iterationLimit; t++ )
+    {
+        while( aCw.m_Steps < t + 1 )
+            step( aCw, aClipLoops );
+
+        while( aCcw.m_Steps < t + 1 )
+            step( aCcw, aClipLoops );
+
+        if( aFinished( statusAt( aCw, t ), statusAt( aCcw, t ) ) )
+        {
+            aCw.m_Status = statusAt( aCw, t );
+            aCcw.m_Status = statusAt( aCcw, t );
+            return t;
+        }
+    }
+
+    return m_iterationLimit;
+}
+
+
 const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
 {
-    LINE path_cw( aInitialPath ), path_ccw( aInitialPath );
-    WALKAROUND_STATUS s_cw = IN_PROGRESS, s_ccw = IN_PROGRESS;
-    SHAPE_LINE_CHAIN best_path;
     RESULT result;
 
     // special case for via-in-the-middle-of-track placement
@@ -198,67 +368,38 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
 
     start( aInitialPath );
 
-    m_currentObstacle[0] = m_currentObstacle[1] = nearestObstacle( aInitialPath );
-    m_recursiveBlockageCount = 0;
+    WALK cw( aInitialPath, true, IN_PROGRESS ), ccw( aInitialPath, false, IN_PROGRESS );
 
-    result.lineCw = aInitialPath;
-    result.lineCcw = aInitialPath;
+    cw.m_CurrentObstacle = ccw.m_CurrentObstacle = nearestObstacle( aInitialPath );
+    cw.m_Dbg = ccw.m_Dbg = Dbg();
 
     if( m_forceWinding )
     {
-        s_cw = m_forceCw ? IN_PROGRESS : STUCK;
-        s_ccw = m_forceCw ? STUCK : IN_PROGRESS;
+        cw.m_Status = m_forceCw ? IN_PROGRESS : STUCK;
+        ccw.m_Status = m_forceCw ? STUCK : IN_PROGRESS;
         m_forceSingleDirection = true;
     } else {
         m_forceSingleDirection = false;
     }
 
-    while( m_iteration < m_iterationLimit )
-    {
-        if( s_cw != STUCK )
-            s_cw = singleStep( path_cw, true );
-
-        if( s_ccw != STUCK )
-            s_ccw = singleStep( path_ccw, false );
-
-        //Dbg()->AddLine( path_cw.CLine(), 2, 10000 );
-
-
-        //printf("iter %d s_cw %d s_ccw %d\n", m_iteration, s_cw, s_ccw );
-        
-        auto old = path_cw.CLine();
+    walkBoth( cw, ccw, true, nullptr );
 
-        if( clipToLoopStart( path_cw.Line() ))
-        {
-            //printf("ClipCW\n");
-            //Dbg()->AddLine( old, 1, 40000 );
-            s_cw = ALMOST_DONE;
-        }
+    m_iteration = catchUp( cw, ccw, true,
+                           []( WALKAROUND_STATUS aCw, WALKAROUND_STATUS aCcw )
+                           {
+                               return aCw != IN_PROGRESS && aCcw != IN_PROGRESS;
+                           } );
 
-        if( clipToLoopStart( path_ccw.Line() ))
-        {
-            //printf("ClipCCW\n");
-            s_ccw = ALMOST_DONE;
-        }
+    Router()->CountIterations( m_iteration );
 
-        
-        if( s_cw != IN_PROGRESS )
-        {
-            result.lineCw = path_cw;
-            result.statusCw = s_cw;
-        }
-
-        if( s_ccw != IN_PROGRESS )
-        {
-            result.lineCcw = path_ccw;
-            result.statusCcw = s_ccw;
-        }
-
-        if( s_cw != IN_PROGRESS && s_ccw != IN_PROGRESS )
-            break;
+    const LINE&       path_cw = cw.m_Path;
+    const LINE&       path_ccw = ccw.m_Path;
+    WALKAROUND_STATUS s_cw = cw.m_Status, s_ccw = ccw.m_Status;
 
-        m_iteration++;
-    }
+    result.lineCw = path_cw;
+    result.statusCw = s_cw;
+    result.lineCcw = path_ccw;
+    result.statusCcw = s_ccw;
 
     if( s_cw == IN_PROGRESS )
     {
@@ -303,10 +444,6 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
 WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
         LINE& aWalkPath, bool aOptimize )
 {
-    LINE path_cw( aInitialPath ), path_ccw( aInitialPath );
-    WALKAROUND_STATUS s_cw = IN_PROGRESS, s_ccw = IN_PROGRESS;
-    SHAPE_LINE_CHAIN best_path;
-
     // special case for via-in-the-middle-of-track placement
     if( aInitialPath.PointCount() <= 1 )
     {
@@ -319,28 +456,45 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
 
     start( aInitialPath );
 
-    m_currentObstacle[0] = m_currentObstacle[1] = nearestObstacle( aInitialPath );
-    m_recursiveBlockageCount = 0;
+    WALK cw( aInitialPath, true, IN_PROGRESS ), ccw( aInitialPath, false, IN_PROGRESS );
+
+    cw.m_CurrentObstacle = ccw.m_CurrentObstacle = nearestObstacle( aInitialPath );
+    cw.m_Dbg = ccw.m_Dbg = Dbg();
 
     aWalkPath = aInitialPath;
 
     if( m_forceWinding )
     {
-        s_cw = m_forceCw ? IN_PROGRESS : STUCK;
-        s_ccw = m_forceCw ? STUCK : IN_PROGRESS;
+        cw.m_Status = m_forceCw ? IN_PROGRESS : STUCK;
+        ccw.m_Status = m_forceCw ? STUCK : IN_PROGRESS;
         m_forceSingleDirection = true;
     } else {
         m_forceSingleDirection = false;
     }
 
-    while( m_iteration < m_iterationLimit )
-    {
-        if( s_cw != STUCK )
-            s_cw = singleStep( path_cw, true );
+    // Unless the longer path is wanted, the first direction to be done wins
+    std::atomic<int> doneAt( m_iterationLimit );
+
+    walkBoth( cw, ccw, false, m_forceLongerPath ? nullptr : &doneAt );
+
+    bool forceLongerPath = m_forceLongerPath;
+
+    m_iteration = catchUp( cw, ccw, false,
+                           [forceLongerPath]( WALKAROUND_STATUS aCw, WALKAROUND_STATUS aCcw )
+                           {
+                               return ( aCw == DONE && aCcw == DONE )
+                                      || ( aCw == STUCK && aCcw == STUCK )
+                                      || ( ( aCw == DONE || aCcw == DONE ) && !forceLongerPath );
+                           } );
 
-        if( s_ccw != STUCK )
-            s_ccw = singleStep( path_ccw, false );
+    Router()->CountIterations( m_iteration );
 
+    const LINE&       path_cw = cw.m_Path;
+    const LINE&       path_ccw = ccw.m_Path;
+    WALKAROUND_STATUS s_cw = cw.m_Status, s_ccw = ccw.m_Status;
+
+    if( m_iteration < m_iterationLimit )
+    {
         if( ( s_cw == DONE && s_ccw == DONE ) || ( s_cw == STUCK && s_ccw == STUCK ) )
         {
             int len_cw  = path_cw.CLine().Length();
@@ -350,24 +504,17 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
                 aWalkPath = ( len_cw > len_ccw ? path_cw : path_ccw );
             else
                 aWalkPath = ( len_cw < len_ccw ? path_cw : path_ccw );
-
-            break;
         }
-        else if( s_cw == DONE && !m_forceLongerPath )
+        else if( s_cw == DONE )
         {
             aWalkPath = path_cw;
-            break;
         }
-        else if( s_ccw == DONE && !m_forceLongerPath )
+        else
         {
             aWalkPath = path_ccw;
-            break;
         }
-
-        m_iteration++;
     }
-
-    if( m_iteration == m_iterationLimit )
+    else
     {
         int len_cw  = path_cw.CLine().Length();
         int len_ccw = path_ccw.CLine().Length();
@@ -22,6 +22,8 @@
 #ifndef __PNS_WALKAROUND_H
 #define __PNS_WALKAROUND_H
 
+#include <atomic>
+#include <functional>
 #include <set>
 
 #include "pns_line.h"
@@ -49,7 +51,6 @@ public:
         m_itemMask = ITEM::ANY_T;
 
         // Initialize other members, to avoid uninitialized variables.
-        m_recursiveBlockageCount = 0;
         m_recursiveCollision[0] = m_recursiveCollision[1] = false;
         m_iteration = 0;
         m_forceCw = false;
@@ -140,14 +141,55 @@ public:
     const RESULT Route( const LINE& aInitialPath );
 
 private:
+    /**
+     * The walk around the obstacles in one winding direction.  The walks only read the world,
+     * so the two directions can be walked on separate threads.
+     */
+    struct WALK
+    {
+        WALK( const LINE& aPath, bool aCw, WALKAROUND_STATUS aStatus ) :
+            m_Path( aPath ),
+            m_Cw( aCw ),
+            m_Status( aStatus ),
+            m_Steps( 0 ),
+            m_RecursiveBlockageCount( 0 ),
+            m_Dbg( nullptr )
+        {}
+
+        LINE               m_Path;
+        bool               m_Cw;
+        WALKAROUND_STATUS  m_Status;
+        int                m_Steps;       ///< Number of iterations walked so far
+        NODE::OPT_OBSTACLE m_CurrentObstacle;
+        int                m_RecursiveBlockageCount;
+        DEBUG_DECORATOR*   m_Dbg;         ///< Where the walk draws its debug graphics
+    };
+
     void start( const LINE& aInitialPath );
 
-    WALKAROUND_STATUS singleStep( LINE& aPath, bool aWindingDirection );
+    WALKAROUND_STATUS singleStep( WALK& aWalk );
     NODE::OPT_OBSTACLE nearestObstacle( const LINE& aPath );
 
+    ///> Does one iteration of aWalk, optionally clipping the loops of its path
+    void step( WALK& aWalk, bool aClipLoops );
+
+    /**
+     * Walks both directions until each of them stops being in progress, reaches the
+     * iteration limit or, when aDoneAt is given, walks past the first iteration at which
+     * either direction was done.  Uses worker threads when parallel routing is enabled.
+     */
+    void walkBoth( WALK& aCw, WALK& aCcw, bool aClipLoops, std::atomic<int>* aDoneAt );
+
+    /**
+     * Brings both walks to the first iteration at which aFinished holds for their statuses,
+     * exactly as if they had been walked in lockstep from the start.
+     * @return the iteration at which the walks finished, or the iteration limit
+     */
+    int catchUp( WALK& aCw, WALK& aCcw, bool aClipLoops,
+                 const std::function<bool( WALKAROUND_STATUS, WALKAROUND_STATUS )>& aFinished );
+
     NODE* m_world;
 
-    int m_recursiveBlockageCount;
     int m_iteration;
     int m_iterationLimit;
     int m_itemMask;
@@ -157,7 +199,6 @@ private:
     bool m_forceCw;
     bool m_forceUniqueWindingDirection;
     VECTOR2I m_cursorPos;
-    NODE::OPT_OBSTACLE m_currentObstacle[2];
     bool m_recursiveCollision[2];
     std::set<ITEM*> m_restrictedSet;
 };
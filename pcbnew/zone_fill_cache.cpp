@@ -0,0 +1,436 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <wx/filename.h>
+#include <wx/log.h>
+
+#include <streamwrapper.h>
+#include <class_board.h>
+#include <class_zone.h>
+#include "zone_fill_cache.h"
+
+
+/**
+ * Flag to enable zone fill cache file tracing.
+ *
+ * Use "KICAD_ZONE_FILL_CACHE" to enable.
+ */
+static const wxChar traceZoneFillCache[] = wxT( "KICAD_ZONE_FILL_CACHE" );
+
+/*
+ * File layout (all values little-endian):
+ *
+ *   magic "KZFC", version, zone count
+ *   for each zone:
+ *     uuid, flags, MD5 of the final fill
+ *     [ZFC_FILL]         fill key, [unless ZFC_FILL_IS_FINAL] pre-island-removal fill
+ *     [ZFC_TRIANGLES]    triangulated polygons of the final fill
+ *
+ * The final fill itself is stored in the board file.  Its MD5 ties each record to the fill
+ * it was written with, so records of fills edited outside of this cache are discarded.
+ *
+ * The fill keys are built with std::hash and so are only meaningful to a build using the same
+ * standard library; a mismatch merely causes a refill.  The version must be bumped whenever
+ * the layout or the key computation of ZONE_FILLER changes.
+ */
+static const uint32_t s_CacheMagic   = 0x43465A4B;    // "KZFC"
+static const uint32_t s_CacheVersion = 1;
+
+enum ZONE_CACHE_FLAGS
+{
+    ZFC_FILL          = 1 << 0,
+    ZFC_TRIANGLES     = 1 << 1,
+    ZFC_FILL_IS_FINAL = 1 << 2,   // the pre-island-removal fill is the final fill
+};
+
+
+typedef std::vector<std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>> TRIANGULATION;
+
+
+namespace
+{
+
+void writeU32( std::ostream& aStream, uint32_t aValue )
+{
+    unsigned char buf[4];
+
+    for( int ii = 0; ii < 4; ++ii )
+        buf[ii] = ( aValue >> ( 8 * ii ) ) & 0xFF;
+
+    aStream.write( reinterpret_cast<const char*>( buf ), sizeof( buf ) );
+}
+
+
+void writeU64( std::ostream& aStream, uint64_t aValue )
+{
+    writeU32( aStream, aValue & 0xFFFFFFFF );
+    writeU32( aStream, aValue >> 32 );
+}
+
+
+void writeString( std::ostream& aStream, const std::string& aValue )
+{
+    writeU32( aStream, aValue.size() );
+    aStream.write( aValue.data(), aValue.size() );
+}
+
+
+void writePoint( std::ostream& aStream, const VECTOR2I& aPoint )
+{
+    writeU32( aStream, static_cast<uint32_t>( aPoint.x ) );
+    writeU32( aStream, static_cast<uint32_t>( aPoint.y ) );
+}
+
+
+void writePolySet( std::ostream& aStream, const SHAPE_POLY_SET& aPolySet )
+{
+    writeU32( aStream, aPolySet.OutlineCount() );
+
+    for( int ii = 0; ii < aPolySet.OutlineCount(); ++ii )
+    {
+        const SHAPE_POLY_SET::POLYGON& poly = aPolySet.CPolygon( ii );
+
+        writeU32( aStream, poly.size() );
+
+        for( const SHAPE_LINE_CHAIN& chain : poly )
+        {
+            writeU32( aStream, chain.PointCount() );
+
+            for( int jj = 0; jj < chain.PointCount(); ++jj )
+                writePoint( aStream, chain.CPoint( jj ) );
+        }
+    }
+}
+
+
+void writeTriangulation( std::ostream& aStream, const SHAPE_POLY_SET& aPolySet )
+{
+    writeU32( aStream, aPolySet.TriangulatedPolyCount() );
+
+    for( unsigned ii = 0; ii < aPolySet.TriangulatedPolyCount(); ++ii )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* tri = aPolySet.TriangulatedPolygon( ii );
+
+        writeU32( aStream, tri->GetVertexCount() );
+
+        for( size_t jj = 0; jj < tri->GetVertexCount(); ++jj )
+            writePoint( aStream, tri->GetVertex( jj ) );
+
+        writeU32( aStream, tri->GetTriangleCount() );
+
+        for( size_t jj = 0; jj < tri->GetTriangleCount(); ++jj )
+        {
+            const auto& indices = tri->GetTriangleIndices( jj );
+
+            writeU32( aStream, indices.a );
+            writeU32( aStream, indices.b );
+            writeU32( aStream, indices.c );
+        }
+    }
+}
+
+
+// The readers leave the stream in a failed state on truncated or inconsistent data; callers
+// check it once per record.
+
+uint32_t readU32( std::istream& aStream )
+{
+    unsigned char buf[4] = { 0, 0, 0, 0 };
+    uint32_t      value = 0;
+
+    aStream.read( reinterpret_cast<char*>( buf ), sizeof( buf ) );
+
+    for( int ii = 0; ii < 4; ++ii )
+        value |= static_cast<uint32_t>( buf[ii] ) << ( 8 * ii );
+
+    return value;
+}
+
+
+uint64_t readU64( std::istream& aStream )
+{
+    uint64_t low = readU32( aStream );
+    uint64_t high = readU32( aStream );
+
+    return low | ( high << 32 );
+}
+
+
+std::string readString( std::istream& aStream )
+{
+    uint32_t    size = readU32( aStream );
+    std::string value;
+
+    // Identifiers and hashes only; anything longer means a corrupt file.
+    if( !aStream || size > 256 )
+    {
+        aStream.setstate( std::ios_base::failbit );
+        return value;
+    }
+
+    value.resize( size );
+    aStream.read( &value[0], size );
+    return value;
+}
+
+
+VECTOR2I readPoint( std::istream& aStream )
+{
+    int x = static_cast<int32_t>( readU32( aStream ) );
+    int y = static_cast<int32_t>( readU32( aStream ) );
+
+    return VECTOR2I( x, y );
+}
+
+
+void readPolySet( std::istream& aStream, SHAPE_POLY_SET& aPolySet )
+{
+    uint32_t polyCount = readU32( aStream );
+
+    for( uint32_t ii = 0; ii < polyCount && aStream; ++ii )
+    {
+        uint32_t contourCount = readU32( aStream );
+
+        for( uint32_t jj = 0; jj < contourCount && aStream; ++jj )
+        {
+            SHAPE_LINE_CHAIN chain;
+            uint32_t         pointCount = readU32( aStream );
+
+            for( uint32_t kk = 0; kk < pointCount && aStream; ++kk )
+                chain.Append( readPoint( aStream ) );
+
+            chain.SetClosed( true );
+
+            if( jj == 0 )
+                aPolySet.AddOutline( chain );
+            else
+                aPolySet.AddHole( chain );
+        }
+    }
+}
+
+
+void readTriangulation( std::istream& aStream, TRIANGULATION& aTris )
+{
+    uint32_t polyCount = readU32( aStream );
+
+    for( uint32_t ii = 0; ii < polyCount && aStream; ++ii )
+    {
+        auto     tri = std::make_unique<SHAPE_POLY_SET::TRIANGULATED_POLYGON>();
+        uint32_t vertexCount = readU32( aStream );
+
+        for( uint32_t jj = 0; jj < vertexCount && aStream; ++jj )
+            tri->AddVertex( readPoint( aStream ) );
+
+        uint32_t triangleCount = readU32( aStream );
+
+        for( uint32_t jj = 0; jj < triangleCount && aStream; ++jj )
+        {
+            uint32_t a = readU32( aStream );
+            uint32_t b = readU32( aStream );
+            uint32_t c = readU32( aStream );
+
+            // An index out of range would be dereferenced by the renderer.
+            if( a >= vertexCount || b >= vertexCount || c >= vertexCount )
+            {
+                aStream.setstate( std::ios_base::failbit );
+                return;
+            }
+
+            tri->AddTriangle( a, b, c );
+        }
+
+        aTris.push_back( std::move( tri ) );
+    }
+}
+
+} // namespace
+
+
+wxString ZoneFillCacheFileName( const wxString& aBoardFileName )
+{
+    wxFileName fn( aBoardFileName );
+
+    fn.SetExt( wxT( "kicad_zone_cache" ) );
+    return fn.GetFullPath();
+}
+
+
+bool SaveZoneFillCache( BOARD* aBoard, const wxString& aFileName )
+{
+    OPEN_OSTREAM( file, aFileName.ToUTF8() );
+
+    if( !file )
+    {
+        wxLogTrace( traceZoneFillCache, "Cannot open %s for writing", aFileName );
+        return false;
+    }
+
+    std::vector<ZONE_CONTAINER*> zones;
+
+    for( ZONE_CONTAINER* zone : aBoard->Zones() )
+    {
+        std::shared_ptr<ZONE_FILL_CACHE> cache = zone->GetFillCache();
+
+        if( ( cache && cache->m_IsValid ) || zone->GetFilledPolysList().IsTriangulationUpToDate() )
+            zones.push_back( zone );
+    }
+
+    writeU32( file, s_CacheMagic );
+    writeU32( file, s_CacheVersion );
+    writeU32( file, zones.size() );
+
+    for( ZONE_CONTAINER* zone : zones )
+    {
+        std::shared_ptr<ZONE_FILL_CACHE> cache = zone->GetFillCache();
+        const SHAPE_POLY_SET&            fill = zone->GetFilledPolysList();
+        uint32_t                         flags = 0;
+
+        if( cache && cache->m_IsValid )
+        {
+            flags |= ZFC_FILL;
+
+            // Most zones have no islands to remove; don't store their fill twice.
+            if( cache->m_FilledPolys.GetHash() == fill.GetHash() )
+                flags |= ZFC_FILL_IS_FINAL;
+        }
+
+        if( fill.IsTriangulationUpToDate() )
+            flags |= ZFC_TRIANGLES;
+
+        writeString( file, std::string( zone->m_Uuid.AsString().ToUTF8() ) );
+        writeU32( file, flags );
+        writeString( file, fill.GetHash().Format() );
+
+        if( flags & ZFC_FILL )
+        {
+            writeU64( file, cache->m_FillKey );
+
+            if( !( flags & ZFC_FILL_IS_FINAL ) )
+                writePolySet( file, cache->m_FilledPolys );
+        }
+
+        if( flags & ZFC_TRIANGLES )
+            writeTriangulation( file, fill );
+    }
+
+    bool ok = file.good();
+
+    CLOSE_STREAM( file );
+
+    wxLogTrace( traceZoneFillCache, "Saved %zu zones to %s: %s", zones.size(), aFileName,
+                ok ? "ok" : "failed" );
+
+    return ok;
+}
+
+
+bool LoadZoneFillCache( BOARD* aBoard, const wxString& aFileName )
+{
+    if( !wxFileName::FileExists( aFileName ) )
+        return false;
+
+    OPEN_ISTREAM( file, aFileName.ToUTF8() );
+
+    if( !file || readU32( file ) != s_CacheMagic || readU32( file ) != s_CacheVersion )
+    {
+        wxLogTrace( traceZoneFillCache, "Ignoring %s: unreadable or incompatible", aFileName );
+        CLOSE_STREAM( file );
+        return false;
+    }
+
+    std::map<KIID, ZONE_CONTAINER*> zonesById;
+
+    for( ZONE_CONTAINER* zone : aBoard->Zones() )
+        zonesById[ zone->m_Uuid ] = zone;
+
+    uint32_t zoneCount = readU32( file );
+    uint32_t restoredFills = 0;
+    uint32_t restoredTriangulations = 0;
+
+    for( uint32_t ii = 0; ii < zoneCount && file; ++ii )
+    {
+        KIID     id( wxString::FromUTF8( readString( file ).c_str() ) );
+        uint32_t    flags = readU32( file );
+        std::string fillHash = readString( file );
+
+        auto          cache = std::make_shared<ZONE_FILL_CACHE>();
+        TRIANGULATION triangulation;
+
+        if( flags & ZFC_FILL )
+        {
+            cache->m_FillKey = readU64( file );
+
+            if( !( flags & ZFC_FILL_IS_FINAL ) )
+                readPolySet( file, cache->m_FilledPolys );
+        }
+
+        if( flags & ZFC_TRIANGLES )
+            readTriangulation( file, triangulation );
+
+        // Only apply complete records
+        if( !file )
+            break;
+
+        auto it = zonesById.find( id );
+
+        if( it == zonesById.end() )
+            continue;
+
+        ZONE_CONTAINER* zone = it->second;
+
+        if( zone->GetFilledPolysList().GetHash().Format() != fillHash )
+            continue;
+
+        if( flags & ZFC_FILL )
+        {
+            if( flags & ZFC_FILL_IS_FINAL )
+                cache->m_FilledPolys = zone->GetFilledPolysList();
+
+            cache->m_IsValid = true;
+            zone->SetFillCache( cache );
+            restoredFills++;
+        }
+
+        if( flags & ZFC_TRIANGLES )
+        {
+            zone->FilledPolysList().SetTriangulation( std::move( triangulation ) );
+            restoredTriangulations++;
+        }
+    }
+
+    bool ok = !file.fail();
+
+    CLOSE_STREAM( file );
+
+    wxLogTrace( traceZoneFillCache, "Loaded %s: %u fills, %u triangulations restored%s",
+                aFileName, restoredFills, restoredTriangulations, ok ? "" : " (truncated)" );
+
+    return ok;
+}
@@ -0,0 +1,84 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __ZONE_FILL_CACHE_H
+#define __ZONE_FILL_CACHE_H
+
+#include <map>
+#include <utility>
+#include <wx/string.h>
+#include <geometry/shape_poly_set.h>
+
+class BOARD;
+
+
+/**
+ * ZONE_FILL_CACHE
+ * The intermediate results of the last fill of a copper zone.
+ *
+ * Every entry is stored with a key hashing all of its inputs, and is only reused when the
+ * key computed at refill time matches.  Stale entries are simply rebuilt, so the cache never
+ * has to be invalidated when the board is edited.
+ */
+struct ZONE_FILL_CACHE
+{
+    /**
+     * The merged clearance holes of the knockouts whose bounding box centre lies in one
+     * tile of the clearance grid.
+     */
+    struct TILE
+    {
+        bool           m_IsValid = false;
+        size_t         m_Key = 0;
+        SHAPE_POLY_SET m_Holes;
+    };
+
+    std::map<std::pair<int, int>, TILE> m_Tiles;     // by tile column and row
+
+    bool           m_IsValid = false;
+    size_t         m_FillKey = 0;       // key of all the inputs of the fill
+    SHAPE_POLY_SET m_FilledPolys;       // the fill, before removal of insulated islands
+};
+
+
+/**
+ * @return the name of the zone fill cache file kept next to the board file aBoardFileName.
+ */
+wxString ZoneFillCacheFileName( const wxString& aBoardFileName );
+
+/**
+ * Writes the fill caches of the zones of aBoard, and the triangulations of their fills, to
+ * aFileName.
+ * @return false if the file could not be written.
+ */
+bool SaveZoneFillCache( BOARD* aBoard, const wxString& aFileName );
+
+/**
+ * Restores the fill caches of the zones of aBoard from aFileName, as well as the
+ * triangulations of the fills which are unchanged since the file was written.  Entries of
+ * zones which no longer exist are ignored.
+ * @return false if the file could not be read or was written by an incompatible version.
+ */
+bool LoadZoneFillCache( BOARD* aBoard, const wxString& aFileName );
+
+#endif
@@ -23,9 +23,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
-#include <thread>
 #include <algorithm>
-#include <future>
+#include <cmath>
 
 #include <class_board.h>
 #include <class_zone.h>
@@ -45,8 +44,13 @@
 #include <confirm.h>
 #include <convert_to_biu.h>
 #include <math/util.h>      // for KiROUND
+#include <thread_pool.h>
+#include <hash_eda.h>
+
+#include <boost/functional/hash.hpp>
 
 #include "zone_filler.h"
+#include "zone_fill_cache.h"
 
 class PROGRESS_REPORTER_HIDER
 {
@@ -73,6 +77,15 @@ private:
 static const double s_RoundPadThermalSpokeAngle = 450;
 static const bool s_DumpZonesWhenFilling = false;
 
+// Clearance knockouts are grouped (and cached) in square tiles of this size
+static const int s_KnockoutTileSize = Millimeter2iu( 10 );
+
+// Everything which affects the shape of a knockout, in absolute coordinates.  Net codes are
+// left out as they are renumbered when a board is loaded (the keys may be persisted in the
+// zone fill cache file); the net only matters through the choice of knockouts and gaps.
+static const int s_KnockoutHashFlags = HASH_FLAGS::ALL & ~HASH_FLAGS::REL_COORD
+                                       & ~HASH_FLAGS::NET;
+
 
 ZONE_FILLER::ZONE_FILLER(  BOARD* aBoard, COMMIT* aCommit ) :
     m_board( aBoard ),
@@ -98,6 +111,19 @@ void ZONE_FILLER::InstallNewProgressReporter( wxWindow* aParent, const wxString&
 }
 
 
+void ZONE_FILLER::waitForTasks( TASK_GROUP& aTasks )
+{
+    // Here we balance returns with a 100ms timeout to allow UI updating
+    while( !aTasks.WaitFor( std::chrono::milliseconds( 100 ) ) )
+    {
+        if( m_progressReporter )
+            m_progressReporter->KeepRefreshing();
+    }
+
+    aTasks.Wait();
+}
+
+
 bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck )
 {
     std::vector<CN_ZONE_ISOLATED_ISLAND_LIST> toFill;
@@ -112,9 +138,12 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
     if( m_progressReporter )
     {
         m_progressReporter->Report( aCheck ? _( "Checking zone fills..." ) : _( "Building zone fills..." ) );
-        m_progressReporter->SetMaxProgress( toFill.size() );
     }
 
+    // Set once up front: the zones are filled concurrently and all share these values.
+    m_high_def = m_board->GetDesignSettings().m_MaxError;
+    m_low_def = std::min( ARC_LOW_DEF, int( m_high_def*1.5 ) );   // Reasonable value
+
     // The board outlines is used to clip solid areas inside the board (when outlines are valid)
     m_boardOutline.RemoveAllContours();
     m_brdOutlinesValid = m_board->GetBoardPolygonOutlines( m_boardOutline );
@@ -140,56 +169,44 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         zone->UnFill();
     }
 
-    std::atomic<size_t> nextItem( 0 );
-    size_t              parallelThreadCount =
-            std::min<size_t>( std::thread::hardware_concurrency(), aZones.size() );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
-
-    auto fill_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
-    {
-        size_t num = 0;
-
-        for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
-        {
-            ZONE_CONTAINER* zone = toFill[i].m_zone;
-            zone->SetFilledPolysUseThickness( filledPolyWithOutline );
-            SHAPE_POLY_SET rawPolys, finalPolys;
-            fillSingleZone( zone, rawPolys, finalPolys );
+    if( m_progressReporter )
+        m_progressReporter->SetMaxProgress( toFill.size() );
 
-            zone->SetRawPolysList( rawPolys );
-            zone->SetFilledPolysList( finalPolys );
-            zone->SetIsFilled( true );
+    // Submit the largest pours first so that one huge zone doesn't end up serializing the
+    // tail of the fill.  Large pours also split their knockouts into sub-tasks, which the
+    // pool's idle workers steal.
+    std::vector<ZONE_CONTAINER*> fillOrder;
 
-            if( m_progressReporter )
-                m_progressReporter->AdvanceProgress();
+    for( CN_ZONE_ISOLATED_ISLAND_LIST& zone : toFill )
+        fillOrder.push_back( zone.m_zone );
 
-            num++;
-        }
+    std::stable_sort( fillOrder.begin(), fillOrder.end(),
+                      []( const ZONE_CONTAINER* a, const ZONE_CONTAINER* b )
+                      {
+                          return a->GetBoundingBox().GetArea() > b->GetBoundingBox().GetArea();
+                      } );
 
-        return num;
-    };
+    TASK_GROUP fillTasks;
 
-    if( parallelThreadCount <= 1 )
-        fill_lambda( m_progressReporter );
-    else
+    for( ZONE_CONTAINER* zone : fillOrder )
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, fill_lambda, m_progressReporter );
-
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
-
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
-        }
+        fillTasks.Run( [this, zone, filledPolyWithOutline]()
+                       {
+                           zone->SetFilledPolysUseThickness( filledPolyWithOutline );
+                           SHAPE_POLY_SET rawPolys, finalPolys;
+                           fillSingleZone( zone, rawPolys, finalPolys );
+
+                           zone->SetRawPolysList( rawPolys );
+                           zone->SetFilledPolysList( finalPolys );
+                           zone->SetIsFilled( true );
+
+                           if( m_progressReporter )
+                               m_progressReporter->AdvanceProgress();
+                       } );
     }
 
+    waitForTasks( fillTasks );
+
     // Now update the connectivity to check for copper islands
     if( m_progressReporter )
     {
@@ -231,8 +248,8 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         {
             for( int idx = 0; idx < poly.OutlineCount(); )
             {
-                if( poly.Polygon( idx ).empty() ||
-                    !m_boardOutline.Contains( poly.Polygon( idx ).front().CPoint( 0 ) ) )
+                if( poly.CPolygon( idx ).empty() ||
+                    !m_boardOutline.Contains( poly.CPolygon( idx ).front().CPoint( 0 ) ) )
                 {
                     poly.DeletePolygon( idx );
                 }
@@ -275,45 +292,23 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
     }
 
 
-    nextItem = 0;
-
-    auto tri_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
-    {
-        size_t num = 0;
-
-        for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
-        {
-            toFill[i].m_zone->CacheTriangulation();
-            num++;
-
-            if( m_progressReporter )
-                m_progressReporter->AdvanceProgress();
-        }
-
-        return num;
-    };
+    TASK_GROUP triangulationTasks;
 
-    if( parallelThreadCount <= 1 )
-        tri_lambda( m_progressReporter );
-    else
+    for( CN_ZONE_ISOLATED_ISLAND_LIST& zone : toFill )
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, tri_lambda, m_progressReporter );
+        ZONE_CONTAINER* zoneToTriangulate = zone.m_zone;
 
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
+        triangulationTasks.Run( [this, zoneToTriangulate]()
+                                {
+                                    zoneToTriangulate->CacheTriangulation();
 
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
-        }
+                                    if( m_progressReporter )
+                                        m_progressReporter->AdvanceProgress();
+                                } );
     }
 
+    waitForTasks( triangulationTasks );
+
     if( m_progressReporter )
     {
         m_progressReporter->AdvancePhase();
@@ -511,14 +506,12 @@ void ZONE_FILLER::knockoutThermalReliefs( const ZONE_CONTAINER* aZone, SHAPE_POL
 
 
 /**
- * Removes clearance from the shape for copper items which share the zone's layer but are
+ * Collects the clearance knockouts of the copper items which share the zone's layer but are
  * not connected to it.
  */
-void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aHoles )
+void ZONE_FILLER::collectCopperItemClearances( const ZONE_CONTAINER* aZone,
+                                               std::vector<CLEARANCE_KNOCKOUT>& aKnockouts )
 {
-    static DRAWSEGMENT dummyEdge;
-    dummyEdge.SetLayer( Edge_Cuts );
-
     // a small extra clearance to be sure actual track clearance is not smaller
     // than requested clearance due to many approximations in calculations,
     // like arc to segment approx, rounding issues...
@@ -547,6 +540,9 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
     {
         for( auto pad : module->Pads() )
         {
+            D_PAD*        padRef = pad;
+            KNOCKOUT_TYPE type = KNOCKOUT_PAD;
+
             if( !pad->IsOnLayer( aZone->GetLayer() ) )
             {
                 if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
@@ -554,6 +550,7 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
 
                 setupDummyPadForHole( pad, dummypad );
                 pad = &dummypad;
+                type = KNOCKOUT_PAD_HOLE;
             }
 
             if( pad->GetNetCode() != aZone->GetNetCode() || pad->GetNetCode() <= 0
@@ -570,7 +567,7 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
                     else
                         gap = aZone->GetClearance( pad );
 
-                    addKnockout( pad, gap, aHoles );
+                    aKnockouts.push_back( { type, padRef, gap } );
                 }
             }
         }
@@ -590,27 +587,29 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
         {
             int gap = aZone->GetClearance( track ) + extra_margin;
 
-            track->TransformShapeWithClearanceToPolygon( aHoles, gap, m_low_def );
+            aKnockouts.push_back( { KNOCKOUT_TRACK, track, gap } );
         }
     }
 
     // Add graphic item clearances.  They are by definition unconnected, and have no clearance
     // definitions of their own.
     //
+    static const KICAD_T graphicKnockoutTypes[] = { PCB_LINE_T, PCB_TEXT_T, PCB_MODULE_EDGE_T,
+                                                    PCB_MODULE_TEXT_T, EOT };
+
     auto doGraphicItem =
             [&]( BOARD_ITEM* aItem )
             {
+                // Other graphic items (dimensions, targets...) don't produce a knockout
+                if( !aItem->IsType( graphicKnockoutTypes ) )
+                    return;
+
                 // A item on the Edge_Cuts is always seen as on any layer:
                 if( !aItem->IsOnLayer( aZone->GetLayer() ) && !aItem->IsOnLayer( Edge_Cuts ) )
                     return;
 
                 if( aItem->GetBoundingBox().Intersects( zone_boundingbox ) )
-                {
-                    bool ignoreLineWidth = aItem->IsOnLayer( Edge_Cuts );
-                    int  gap = aZone->GetClearance( aItem );
-
-                    addKnockout( aItem, gap, ignoreLineWidth, aHoles );
-                }
+                    aKnockouts.push_back( { KNOCKOUT_GRAPHIC, aItem, aZone->GetClearance( aItem ) } );
             };
 
     for( auto module : m_board->Modules() )
@@ -653,7 +652,145 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
             if( !zone->GetIsKeepout() && aZone->GetNetCode() != zone->GetNetCode() )
                 gap = aZone->GetClearance( zone );
 
-            zone->TransformOutlinesShapeWithClearanceToPolygon( aHoles, gap );
+            aKnockouts.push_back( { KNOCKOUT_ZONE, zone, gap } );
+        }
+    }
+}
+
+
+/**
+ * Sorts the knockouts into tiles of a fixed grid (by the centre of their bounding box) and
+ * computes the key of each tile from the knockouts it holds.
+ */
+void ZONE_FILLER::tileKnockouts( const std::vector<CLEARANCE_KNOCKOUT>& aKnockouts,
+                                 KNOCKOUT_TILES& aTiles )
+{
+    for( size_t ii = 0; ii < aKnockouts.size(); ++ii )
+    {
+        const CLEARANCE_KNOCKOUT& knockout = aKnockouts[ii];
+        EDA_RECT                  bbox = knockout.m_Item->GetBoundingBox();
+        wxPoint                   center = bbox.Centre();
+
+        std::pair<int, int> tileId( (int) std::floor( (double) center.x / s_KnockoutTileSize ),
+                                    (int) std::floor( (double) center.y / s_KnockoutTileSize ) );
+
+        size_t itemKey = hash_eda( knockout.m_Item, s_KnockoutHashFlags );
+
+        boost::hash_combine( itemKey, (int) knockout.m_Type );
+        boost::hash_combine( itemKey, knockout.m_Gap );
+        boost::hash_combine( itemKey, bbox.GetX() );
+        boost::hash_combine( itemKey, bbox.GetY() );
+        boost::hash_combine( itemKey, bbox.GetWidth() );
+        boost::hash_combine( itemKey, bbox.GetHeight() );
+
+        if( knockout.m_Item->Type() == PCB_MODULE_TEXT_T )
+        {
+            TEXTE_MODULE* text = static_cast<TEXTE_MODULE*>( knockout.m_Item );
+            boost::hash_combine( itemKey, text->IsVisible() );
+        }
+
+        KNOCKOUT_TILE& tile = aTiles[ tileId ];
+
+        // Summed, so that the key doesn't depend on the order of the board's item lists
+        tile.m_Key += itemKey;
+        tile.m_Knockouts.push_back( ii );
+    }
+
+    for( auto& entry : aTiles )
+    {
+        boost::hash_combine( entry.second.m_Key, m_high_def );
+        boost::hash_combine( entry.second.m_Key, m_low_def );
+    }
+}
+
+
+/**
+ * Builds the clearance holes of the given knockouts.  Only the tiles whose key differs from
+ * the one cached with the zone are rebuilt (in parallel); the others are reused.
+ */
+void ZONE_FILLER::buildCopperItemClearances( const std::vector<CLEARANCE_KNOCKOUT>& aKnockouts,
+                                             const KNOCKOUT_TILES& aTiles,
+                                             ZONE_FILL_CACHE& aCache, SHAPE_POLY_SET& aHoles )
+{
+    // Forget the tiles which no longer hold any knockouts
+    for( auto it = aCache.m_Tiles.begin(); it != aCache.m_Tiles.end(); )
+    {
+        if( aTiles.count( it->first ) )
+            ++it;
+        else
+            it = aCache.m_Tiles.erase( it );
+    }
+
+    TASK_GROUP tileTasks;
+
+    for( const auto& entry : aTiles )
+    {
+        const KNOCKOUT_TILE*   tile = &entry.second;
+        ZONE_FILL_CACHE::TILE& cached = aCache.m_Tiles[ entry.first ];
+
+        if( cached.m_IsValid && cached.m_Key == tile->m_Key )
+            continue;
+
+        cached.m_IsValid = false;
+
+        tileTasks.Run( [this, &aKnockouts, tile, &cached]()
+                       {
+                           cached.m_Holes.RemoveAllContours();
+                           buildKnockouts( aKnockouts, tile->m_Knockouts, cached.m_Holes );
+                           cached.m_Key = tile->m_Key;
+                           cached.m_IsValid = true;
+                       } );
+    }
+
+    tileTasks.Wait();
+
+    for( const auto& entry : aCache.m_Tiles )
+        aHoles.Append( entry.second.m_Holes );
+
+    aHoles.Simplify( SHAPE_POLY_SET::PM_FAST );
+}
+
+
+/**
+ * Converts the knockouts of aKnockouts listed in aIndices to polygons and merges them into
+ * aHoles.
+ */
+void ZONE_FILLER::buildKnockouts( const std::vector<CLEARANCE_KNOCKOUT>& aKnockouts,
+                                  const std::vector<size_t>& aIndices, SHAPE_POLY_SET& aHoles )
+{
+    // Each tile needs its own dummy pad for the holes; see collectCopperItemClearances()
+    MODULE  dummymodule( m_board );
+    D_PAD   dummypad( &dummymodule );
+
+    for( size_t ii : aIndices )
+    {
+        const CLEARANCE_KNOCKOUT& knockout = aKnockouts[ii];
+
+        switch( knockout.m_Type )
+        {
+        case KNOCKOUT_PAD:
+            addKnockout( static_cast<D_PAD*>( knockout.m_Item ), knockout.m_Gap, aHoles );
+            break;
+
+        case KNOCKOUT_PAD_HOLE:
+            setupDummyPadForHole( static_cast<D_PAD*>( knockout.m_Item ), dummypad );
+            addKnockout( &dummypad, knockout.m_Gap, aHoles );
+            break;
+
+        case KNOCKOUT_TRACK:
+            static_cast<TRACK*>( knockout.m_Item )->TransformShapeWithClearanceToPolygon(
+                    aHoles, knockout.m_Gap, m_low_def );
+            break;
+
+        case KNOCKOUT_GRAPHIC:
+            addKnockout( knockout.m_Item, knockout.m_Gap, knockout.m_Item->IsOnLayer( Edge_Cuts ),
+                         aHoles );
+            break;
+
+        case KNOCKOUT_ZONE:
+            static_cast<ZONE_CONTAINER*>( knockout.m_Item )
+                    ->TransformOutlinesShapeWithClearanceToPolygon( aHoles, knockout.m_Gap );
+            break;
         }
     }
 
@@ -661,6 +798,74 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
 }
 
 
+/**
+ * Computes the key of everything a zone's fill depends on: its settings and smoothed
+ * outline, the thermally connected pads and the clearance knockout tiles.
+ */
+size_t ZONE_FILLER::hashFillInputs( const ZONE_CONTAINER* aZone,
+                                    const SHAPE_POLY_SET& aSmoothedOutline,
+                                    const KNOCKOUT_TILES& aTiles )
+{
+    size_t key = 0;
+
+    boost::hash_combine( key, (int) aZone->GetLayer() );
+    boost::hash_combine( key, aZone->GetPriority() );
+    boost::hash_combine( key, aZone->GetMinThickness() );
+    boost::hash_combine( key, aZone->GetFilledPolysUseThickness() );
+    boost::hash_combine( key, (int) aZone->GetFillMode() );
+    boost::hash_combine( key, aZone->GetHatchFillTypeThickness() );
+    boost::hash_combine( key, aZone->GetHatchFillTypeGap() );
+    boost::hash_combine( key, aZone->GetHatchFillTypeOrientation() );
+    boost::hash_combine( key, aZone->GetHatchFillTypeSmoothingLevel() );
+    boost::hash_combine( key, aZone->GetHatchFillTypeSmoothingValue() );
+    boost::hash_combine( key, aZone->GetCornerRadius() );
+    boost::hash_combine( key, m_high_def );
+    boost::hash_combine( key, m_low_def );
+
+    for( int ii = 0; ii < aSmoothedOutline.OutlineCount(); ++ii )
+    {
+        for( const SHAPE_LINE_CHAIN& chain : aSmoothedOutline.CPolygon( ii ) )
+        {
+            boost::hash_combine( key, chain.PointCount() );
+
+            for( int jj = 0; jj < chain.PointCount(); ++jj )
+            {
+                boost::hash_combine( key, chain.CPoint( jj ).x );
+                boost::hash_combine( key, chain.CPoint( jj ).y );
+            }
+        }
+    }
+
+    // Thermal reliefs and spokes
+    size_t thermalKey = 0;
+
+    for( MODULE* module : m_board->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+        {
+            if( !hasThermalConnection( pad, aZone ) )
+                continue;
+
+            size_t padKey = hash_eda( pad, s_KnockoutHashFlags );
+            boost::hash_combine( padKey, aZone->GetThermalReliefGap( pad ) );
+            boost::hash_combine( padKey, aZone->GetThermalReliefCopperBridge( pad ) );
+            thermalKey += padKey;
+        }
+    }
+
+    boost::hash_combine( key, thermalKey );
+
+    for( const auto& entry : aTiles )
+    {
+        boost::hash_combine( key, entry.first.first );
+        boost::hash_combine( key, entry.first.second );
+        boost::hash_combine( key, entry.second.m_Key );
+    }
+
+    return key;
+}
+
+
 /**
  * 1 - Creates the main zone outline using a correction to shrink the resulting area by
  *     m_ZoneMinThickness / 2.  The result is areas with a margin of m_ZoneMinThickness / 2
@@ -675,12 +880,10 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
 void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
                                         const SHAPE_POLY_SET& aSmoothedOutline,
                                         std::set<VECTOR2I>* aPreserveCorners,
+                                        ZONE_FILL_CACHE& aCache,
                                         SHAPE_POLY_SET& aRawPolys,
                                         SHAPE_POLY_SET& aFinalPolys )
 {
-    m_high_def = m_board->GetDesignSettings().m_MaxError;
-    m_low_def = std::min( ARC_LOW_DEF, int( m_high_def*1.5 ) );   // Reasonable value
-
     // Features which are min_width should survive pruning; features that are *less* than
     // min_width should not.  Therefore we subtract epsilon from the min_width when
     // deflating/inflating.
@@ -702,6 +905,25 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
     SHAPE_POLY_SET::CORNER_STRATEGY intermediatecornerStrategy = SHAPE_POLY_SET::CHAMFER_ALL_CORNERS;
     SHAPE_POLY_SET::CORNER_STRATEGY finalcornerStrategy = SHAPE_POLY_SET::ROUND_ALL_CORNERS;
 
+    // Collect everything which is knocked out of the zone.  This is cheap compared to the
+    // polygon work, and tells us which parts of the fill (if any) have to be redone.
+    std::vector<CLEARANCE_KNOCKOUT> knockouts;
+    KNOCKOUT_TILES                  tiles;
+
+    collectCopperItemClearances( aZone, knockouts );
+    tileKnockouts( knockouts, tiles );
+
+    size_t fillKey = hashFillInputs( aZone, aSmoothedOutline, tiles );
+
+    if( aCache.m_IsValid && aCache.m_FillKey == fillKey )
+    {
+        aRawPolys = aCache.m_FilledPolys;
+        aFinalPolys = aCache.m_FilledPolys;
+        return;
+    }
+
+    aCache.m_IsValid = false;
+
     std::deque<SHAPE_LINE_CHAIN> thermalSpokes;
     SHAPE_POLY_SET clearanceHoles;
 
@@ -713,17 +935,22 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
     if( s_DumpZonesWhenFilling )
         dumper->BeginGroup( "clipper-zone" );
 
-    knockoutThermalReliefs( aZone, aRawPolys );
+    // The thermal reliefs, the thermal spokes and the clearance holes are independent of
+    // each other, so they are built concurrently.
+    TASK_GROUP knockoutTasks;
 
-    if( s_DumpZonesWhenFilling )
-        dumper->Write( &aRawPolys, "solid-areas-minus-thermal-reliefs" );
+    knockoutTasks.Run( [&]() { knockoutThermalReliefs( aZone, aRawPolys ); } );
+    knockoutTasks.Run( [&]() { buildThermalSpokes( aZone, thermalSpokes ); } );
 
-    buildCopperItemClearances( aZone, clearanceHoles );
+    buildCopperItemClearances( knockouts, tiles, aCache, clearanceHoles );
 
-    if( s_DumpZonesWhenFilling )
-        dumper->Write( &aRawPolys, "clearance holes" );
+    knockoutTasks.Wait();
 
-    buildThermalSpokes( aZone, thermalSpokes );
+    if( s_DumpZonesWhenFilling )
+    {
+        dumper->Write( &aRawPolys, "solid-areas-minus-thermal-reliefs" );
+        dumper->Write( &clearanceHoles, "clearance holes" );
+    }
 
     // Create a temporary zone that we can hit-test spoke-ends against.  It's only temporary
     // because the "real" subtract-clearance-holes has to be done after the spokes are added.
@@ -811,6 +1038,10 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
 
     aFinalPolys = aRawPolys;
 
+    aCache.m_FillKey = fillKey;
+    aCache.m_FilledPolys = aRawPolys;
+    aCache.m_IsValid = true;
+
     if( s_DumpZonesWhenFilling )
         dumper->EndGroup();
 }
@@ -838,7 +1069,16 @@ bool ZONE_FILLER::fillSingleZone( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPol
 
     if( aZone->IsOnCopperLayer() )
     {
-        computeRawFilledArea( aZone, smoothedPoly, &colinearCorners, aRawPolys, aFinalPolys );
+        std::shared_ptr<ZONE_FILL_CACHE> cache = aZone->GetFillCache();
+
+        if( !cache )
+        {
+            cache = std::make_shared<ZONE_FILL_CACHE>();
+            aZone->SetFillCache( cache );
+        }
+
+        computeRawFilledArea( aZone, smoothedPoly, &colinearCorners, *cache, aRawPolys,
+                              aFinalPolys );
     }
     else
     {
@@ -934,14 +1174,14 @@ void ZONE_FILLER::buildThermalSpokes( const ZONE_CONTAINER* aZone,
             // We use the bounding-box to lay out the spokes, but for this to work the
             // bounding box has to be built at the same rotation as the spokes.
 
+            // The bounding box is taken from an unrotated copy of the pad: the pad itself
+            // must not be modified as other zones are being filled concurrently.
             wxPoint shapePos = pad->ShapePos();
-            wxPoint padPos = pad->GetPosition();
             double padAngle = pad->GetOrientation();
-            pad->SetOrientation( 0.0 );
-            pad->SetPosition( { 0, 0 } );
-            BOX2I reliefBB = pad->GetBoundingBox();
-            pad->SetPosition( padPos );
-            pad->SetOrientation( padAngle );
+            std::unique_ptr<D_PAD> unrotatedPad( pad->ClonePad() );
+            unrotatedPad->SetOrientation( 0.0 );
+            unrotatedPad->SetPosition( { 0, 0 } );
+            BOX2I reliefBB = unrotatedPad->GetBoundingBox();
 
             reliefBB.Inflate( thermalReliefGap + epsilon );
 
@@ -1082,13 +1322,13 @@ void ZONE_FILLER::addHatchFillTypeOnZone( const ZONE_CONTAINER* aZone, SHAPE_POL
             case 1:
                 // Chamfer() uses the distance from a corner to create a end point
                 // for the chamfer.
-                hole_base = smooth_hole.Chamfer( smooth_value ).Outline( 0 );
+                hole_base = smooth_hole.Chamfer( smooth_value ).COutline( 0 );
                 break;
 
             default:
                 if( aZone->GetHatchFillTypeSmoothingLevel() > 2 )
                     error_max /= 2;    // Force better smoothing
-                hole_base = smooth_hole.Fillet( smooth_value, error_max ).Outline( 0 );
+                hole_base = smooth_hole.Fillet( smooth_value, error_max ).COutline( 0 );
                 break;
 
             case 0:
@@ -1136,7 +1376,7 @@ void ZONE_FILLER::addHatchFillTypeOnZone( const ZONE_CONTAINER* aZone, SHAPE_POL
     // It happens for holes near the zone outline
     for( int ii = 0; ii < holes.OutlineCount(); )
     {
-        double area = holes.Outline( ii ).Area();
+        double area = holes.COutline( ii ).Area();
 
         if( area < minimal_hole_area ) // The current hole is too small: remove it
             holes.DeletePolygon( ii );
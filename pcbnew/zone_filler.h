@@ -26,10 +26,13 @@
 #ifndef __ZONE_FILLER_H
 #define __ZONE_FILLER_H
 
+#include <map>
 #include <vector>
 #include <class_zone.h>
 
 class WX_PROGRESS_REPORTER;
+class TASK_GROUP;
+struct ZONE_FILL_CACHE;
 class BOARD;
 class COMMIT;
 class SHAPE_POLY_SET;
@@ -47,13 +50,62 @@ public:
 
 private:
 
+    enum KNOCKOUT_TYPE
+    {
+        KNOCKOUT_PAD,
+        KNOCKOUT_PAD_HOLE,      // the hole of a pad which isn't on the zone's layer
+        KNOCKOUT_TRACK,
+        KNOCKOUT_GRAPHIC,
+        KNOCKOUT_ZONE
+    };
+
+    /**
+     * A copper item clearance to knock out of a zone, collected before any polygon work.
+     */
+    struct CLEARANCE_KNOCKOUT
+    {
+        KNOCKOUT_TYPE m_Type;
+        BOARD_ITEM*   m_Item;
+        int           m_Gap;
+    };
+
+    /**
+     * The knockouts falling into one tile of the clearance grid, and the key of the tile.
+     */
+    struct KNOCKOUT_TILE
+    {
+        size_t              m_Key = 0;
+        std::vector<size_t> m_Knockouts;    // indices into the knockout list
+    };
+
+    typedef std::map<std::pair<int, int>, KNOCKOUT_TILE> KNOCKOUT_TILES;
+
+    /**
+     * Wait for aTasks to complete, refreshing the progress reporter in the meantime.
+     */
+    void waitForTasks( TASK_GROUP& aTasks );
+
     void addKnockout( D_PAD* aPad, int aGap, SHAPE_POLY_SET& aHoles );
 
     void addKnockout( BOARD_ITEM* aItem, int aGap, bool aIgnoreLineWidth, SHAPE_POLY_SET& aHoles );
 
     void knockoutThermalReliefs( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aFill );
 
-    void buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aHoles );
+    void collectCopperItemClearances( const ZONE_CONTAINER* aZone,
+                                      std::vector<CLEARANCE_KNOCKOUT>& aKnockouts );
+
+    void tileKnockouts( const std::vector<CLEARANCE_KNOCKOUT>& aKnockouts,
+                        KNOCKOUT_TILES& aTiles );
+
+    void buildCopperItemClearances( const std::vector<CLEARANCE_KNOCKOUT>& aKnockouts,
+                                    const KNOCKOUT_TILES& aTiles, ZONE_FILL_CACHE& aCache,
+                                    SHAPE_POLY_SET& aHoles );
+
+    void buildKnockouts( const std::vector<CLEARANCE_KNOCKOUT>& aKnockouts,
+                         const std::vector<size_t>& aIndices, SHAPE_POLY_SET& aHoles );
+
+    size_t hashFillInputs( const ZONE_CONTAINER* aZone, const SHAPE_POLY_SET& aSmoothedOutline,
+                           const KNOCKOUT_TILES& aTiles );
 
     /**
      * Function computeRawFilledArea
@@ -65,10 +117,12 @@ private:
      * BuildFilledSolidAreasPolygons() call this function just after creating the
      *  filled copper area polygon (without clearance areas
      * @param aPcb: the current board
+     * @param aCache: the zone's fill cache; the parts of the fill whose inputs are unchanged
+     * since the last fill are taken from it.
      */
     void computeRawFilledArea( const ZONE_CONTAINER* aZone,
                                const SHAPE_POLY_SET& aSmoothedOutline,
-                               std::set<VECTOR2I>* aPreserveCorners,
+                               std::set<VECTOR2I>* aPreserveCorners, ZONE_FILL_CACHE& aCache,
                                SHAPE_POLY_SET& aRawPolys, SHAPE_POLY_SET& aFinalPolys );
 
     /**
@@ -0,0 +1,156 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_shape_poly_set_cow.cpp
+ * Test suite for the polygons shared between copies of a SHAPE_POLY_SET.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+
+static SHAPE_POLY_SET makeSquare( int aSize )
+{
+    SHAPE_POLY_SET poly;
+
+    poly.NewOutline();
+    poly.Append( 0, 0 );
+    poly.Append( aSize, 0 );
+    poly.Append( aSize, aSize );
+    poly.Append( 0, aSize );
+
+    return poly;
+}
+
+
+BOOST_AUTO_TEST_SUITE( ShapePolySetCow )
+
+
+/**
+ * Check that modifying a copy does not modify the original, and the other way round
+ */
+BOOST_AUTO_TEST_CASE( CopiesAreIndependent )
+{
+    SHAPE_POLY_SET original = makeSquare( 100 );
+    SHAPE_POLY_SET copy( original );
+    SHAPE_POLY_SET assigned;
+
+    assigned = original;
+
+    copy.Move( VECTOR2I( 10, 0 ) );
+    assigned.Append( 50, 150 );
+
+    BOOST_CHECK_EQUAL( original.CVertex( 0 ), VECTOR2I( 0, 0 ) );
+    BOOST_CHECK_EQUAL( original.VertexCount(), 4 );
+    BOOST_CHECK_EQUAL( copy.CVertex( 0 ), VECTOR2I( 10, 0 ) );
+    BOOST_CHECK_EQUAL( assigned.VertexCount(), 5 );
+
+    original.SetVertex( 0, VECTOR2I( -5, -5 ) );
+
+    BOOST_CHECK_EQUAL( copy.CVertex( 0 ), VECTOR2I( 10, 0 ) );
+    BOOST_CHECK_EQUAL( assigned.CVertex( 0 ), VECTOR2I( 0, 0 ) );
+}
+
+
+/**
+ * Check that a copy made after a reference into the polygons has been handed out is not
+ * modified through this reference
+ */
+BOOST_AUTO_TEST_CASE( HeldReferences )
+{
+    SHAPE_POLY_SET    original = makeSquare( 100 );
+    SHAPE_LINE_CHAIN& outline = original.Outline( 0 );
+    SHAPE_POLY_SET    copy( original );
+    SHAPE_POLY_SET    appended;
+
+    appended.Append( original );
+
+    outline.SetPoint( 0, VECTOR2I( -1, -1 ) );
+
+    BOOST_CHECK_EQUAL( original.CVertex( 0 ), VECTOR2I( -1, -1 ) );
+    BOOST_CHECK_EQUAL( copy.CVertex( 0 ), VECTOR2I( 0, 0 ) );
+    BOOST_CHECK_EQUAL( appended.CVertex( 0 ), VECTOR2I( 0, 0 ) );
+}
+
+
+/**
+ * Check that copies keep the triangulation as long as their polygons are not modified
+ */
+BOOST_AUTO_TEST_CASE( SharedTriangulation )
+{
+    SHAPE_POLY_SET original = makeSquare( 100 );
+
+    original.CacheTriangulation();
+    BOOST_REQUIRE( original.IsTriangulationUpToDate() );
+
+    SHAPE_POLY_SET copy( original );
+    SHAPE_POLY_SET deepCopy( original, true );
+
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+    BOOST_CHECK( deepCopy.IsTriangulationUpToDate() );
+    BOOST_CHECK_EQUAL( copy.TriangulatedPolyCount(), original.TriangulatedPolyCount() );
+
+    copy.Move( VECTOR2I( 10, 10 ) );
+
+    BOOST_CHECK( !copy.IsTriangulationUpToDate() );
+    BOOST_CHECK( original.IsTriangulationUpToDate() );
+
+    copy.CacheTriangulation();
+
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+    BOOST_CHECK( original.IsTriangulationUpToDate() );
+
+    // The triangulation of the original has not been moved with the copy
+    VECTOR2I a, b, c;
+    original.TriangulatedPolygon( 0 )->GetTriangle( 0, a, b, c );
+
+    for( const VECTOR2I& pt : { a, b, c } )
+        BOOST_CHECK( pt.x <= 100 && pt.y <= 100 );
+}
+
+
+/**
+ * Check that emptying a set does not affect its copies
+ */
+BOOST_AUTO_TEST_CASE( RemoveAllContours )
+{
+    SHAPE_POLY_SET original = makeSquare( 100 );
+    SHAPE_POLY_SET copy( original );
+
+    original.RemoveAllContours();
+
+    BOOST_CHECK( original.IsEmpty() );
+    BOOST_CHECK_EQUAL( copy.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( copy.VertexCount(), 4 );
+
+    original.NewOutline();
+    original.Append( 1, 1 );
+
+    BOOST_CHECK_EQUAL( copy.CVertex( 0 ), VECTOR2I( 0, 0 ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
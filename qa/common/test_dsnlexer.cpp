@@ -0,0 +1,215 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_dsnlexer.cpp
+ * Test suite for DSNLEXER reading from the various LINE_READERs.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <dsnlexer.h>
+#include <richio.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <algorithm>
+
+
+/**
+ * A temporary file holding some text, removed on destruction
+ */
+class TEMP_TEXT_FILE
+{
+public:
+    TEMP_TEXT_FILE( const std::string& aText )
+    {
+        m_name = wxFileName::CreateTempFileName( "qa_dsnlexer" );
+
+        wxFFile file( m_name, "wb" );
+        file.Write( aText.data(), aText.size() );
+    }
+
+    ~TEMP_TEXT_FILE()
+    {
+        wxRemoveFile( m_name );
+    }
+
+    const wxString& GetName() const { return m_name; }
+
+private:
+    wxString m_name;
+};
+
+
+/**
+ * Lex everything from aReader into a list of "token:text" strings
+ */
+static std::vector<std::string> lexAll( LINE_READER* aReader )
+{
+    DSNLEXER                 lexer( nullptr, 0, aReader );
+    std::vector<std::string> tokens;
+
+    for( int tok = lexer.NextTok(); tok != DSN_EOF; tok = lexer.NextTok() )
+        tokens.push_back( std::to_string( tok ) + ":" + lexer.CurStr() );
+
+    return tokens;
+}
+
+
+static const std::string s_text =
+        "(kicad_pcb (version 20200628)\n"
+        "  (at 1.5 -2.25e3 90)\n"
+        "\n"
+        "  (name \"escaped \\\"quote\\\" \\x41\\101\")\n"
+        "  (fp_text reference R1)\r\n"
+        ")";         // no trailing newline
+
+
+BOOST_AUTO_TEST_SUITE( DsnLexer )
+
+
+/**
+ * Check that a mapped file produces the same tokens as the same text in a string
+ */
+BOOST_AUTO_TEST_CASE( MappedFileMatchesString )
+{
+    TEMP_TEXT_FILE          file( s_text );
+    STRING_LINE_READER      stringReader( s_text, "string" );
+    MAPPED_FILE_LINE_READER mappedReader( file.GetName() );
+
+    std::vector<std::string> expected = lexAll( &stringReader );
+    std::vector<std::string> mapped = lexAll( &mappedReader );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( mapped.begin(), mapped.end(), expected.begin(),
+                                   expected.end() );
+
+    BOOST_CHECK( std::find( expected.begin(), expected.end(),
+                            std::to_string( DSN_STRING ) + ":escaped \"quote\" AA" )
+                 != expected.end() );
+}
+
+
+/**
+ * Check that ReadLine() and ReadLineInPlace() return the same lines
+ */
+BOOST_AUTO_TEST_CASE( MappedFileLines )
+{
+    TEMP_TEXT_FILE          file( "first\nsecond\n\nlast" );
+    MAPPED_FILE_LINE_READER reader( file.GetName() );
+    unsigned                length;
+
+    BOOST_CHECK_EQUAL( std::string( reader.ReadLine() ), "first\n" );
+
+    const char* line = reader.ReadLineInPlace( &length );
+    BOOST_CHECK_EQUAL( std::string( line, length ), "second\n" );
+    BOOST_CHECK_EQUAL( reader.LineNumber(), 2u );
+
+    BOOST_CHECK_EQUAL( std::string( reader.ReadLine() ), "\n" );
+    BOOST_CHECK_EQUAL( std::string( reader.ReadLine() ), "last" );
+    BOOST_CHECK( reader.ReadLine() == nullptr );
+    BOOST_CHECK( reader.ReadLineInPlace( &length ) == nullptr );
+    BOOST_CHECK_EQUAL( length, 0u );
+
+    reader.Rewind();
+    BOOST_CHECK_EQUAL( std::string( reader.ReadLine() ), "first\n" );
+}
+
+
+/**
+ * Check that empty files can be read and that missing files are reported
+ */
+BOOST_AUTO_TEST_CASE( MappedFileEdgeCases )
+{
+    TEMP_TEXT_FILE          empty( "" );
+    MAPPED_FILE_LINE_READER reader( empty.GetName() );
+
+    BOOST_CHECK( reader.ReadLine() == nullptr );
+
+    BOOST_CHECK_THROW( MAPPED_FILE_LINE_READER( empty.GetName() + "_missing" ), IO_ERROR );
+}
+
+
+/**
+ * Check that error messages quote the current line although it is read in place
+ */
+BOOST_AUTO_TEST_CASE( CurLineIsTerminated )
+{
+    TEMP_TEXT_FILE          file( "(first line)\n(second line)\n" );
+    MAPPED_FILE_LINE_READER reader( file.GetName() );
+    DSNLEXER                lexer( nullptr, 0, &reader );
+
+    lexer.NextTok();
+    lexer.NextTok();
+
+    BOOST_CHECK_EQUAL( std::string( lexer.CurLine() ), "(first line)\n" );
+    BOOST_CHECK_EQUAL( lexer.CurLineNumber(), 1 );
+}
+
+
+/**
+ * Check that ReadBlockText() stops at the matching parenthesis, ignoring those in strings
+ * and comments, and keeps the lines of the block
+ */
+BOOST_AUTO_TEST_CASE( ReadBlockText )
+{
+    STRING_LINE_READER reader( "(board (segment (start 0 0)\n"
+                               "# (comment\n"
+                               "  (name \"a ) \\\" (\")) (via)\n"
+                               ")\n",
+                               "string" );
+    DSNLEXER           lexer( nullptr, 0, &reader );
+    std::string        text;
+
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_LEFT );
+    lexer.NextTok();
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_LEFT );
+    lexer.NextTok();
+    BOOST_CHECK_EQUAL( lexer.CurStr(), "segment" );
+
+    lexer.ReadBlockText( text );
+
+    // The comment line is kept as an empty line, so that the line numbers still match
+    BOOST_CHECK_EQUAL( text, " (start 0 0)\n\n  (name \"a ) \\\" (\"))" );
+    BOOST_CHECK_EQUAL( lexer.CurTok(), DSN_RIGHT );
+    BOOST_CHECK_EQUAL( lexer.CurLineNumber(), 3 );
+
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_LEFT );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_SYMBOL );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_RIGHT );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_RIGHT );
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_EOF );
+
+    STRING_LINE_READER unterminated( "(board (segment (start 0 0)\n", "string" );
+    DSNLEXER           lexer2( nullptr, 0, &unterminated );
+
+    lexer2.NextTok();
+    lexer2.NextTok();
+
+    BOOST_CHECK_THROW( lexer2.ReadBlockText( text ), IO_ERROR );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -107,4 +107,54 @@ BOOST_AUTO_TEST_CASE( NaturalNumberCompare )
     }
 }
 
+/**
+ * Test the #StrToDouble function against strtod() in the "C" locale
+ */
+BOOST_AUTO_TEST_CASE( StrToDoubleMatchesStrtod )
+{
+    const std::vector<std::string> cases = {
+        "0", "-0", "1.5", "-2.25e3", " 123.456789", "0.000001", ".5", "5.", "+7",
+        "52.525252", "3.14159265358979323846", "1e-30", "1e308", "12345678901234567890123",
+        "1e", "2.5)", "abc"
+    };
+
+    for( const std::string& c : cases )
+    {
+        const char* end;
+        char*       expectedEnd;
+        double      value = StrToDouble( c.c_str(), &end );
+        double      expected = strtod( c.c_str(), &expectedEnd );
+
+        BOOST_CHECK_MESSAGE( value == expected, c + " failed" );
+        BOOST_CHECK_EQUAL( end - c.c_str(), expectedEnd - c.c_str() );
+    }
+}
+
+/**
+ * Test the #FormatDouble function, which must produce the shortest plain string
+ * reading back as the same value
+ */
+BOOST_AUTO_TEST_CASE( FormatDoubleShortest )
+{
+    const std::vector<std::pair<double, std::string>> cases = {
+        { 0.0, "0" },
+        { 1.5, "1.5" },
+        { -0.35, "-0.35" },
+        { 52.525252, "52.525252" },
+        { 1e-7, "0.0000001" },
+        { 1e22, "10000000000000000000000" },
+        { 0.1 + 0.2, "0.30000000000000004" },
+        { -2147483648 / 1e6, "-2147.483648" }
+    };
+
+    for( const auto& c : cases )
+        BOOST_CHECK_EQUAL( FormatDouble( c.first ), c.second );
+
+    // Limited precision
+    BOOST_CHECK_EQUAL( FormatDouble( 100.0 / 3.0, 10 ), "33.33333333" );
+
+    for( double value : { 1.0 / 3.0, 1e-30, 123456.789e10, -6.02214076e23 } )
+        BOOST_CHECK_EQUAL( StrToDouble( FormatDouble( value ).c_str() ), value );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
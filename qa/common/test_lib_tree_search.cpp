@@ -0,0 +1,233 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_lib_tree_search.cpp
+ * Test suite for the indexed search of the library tree.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <common/lib_tree_model.h>
+#include <eda_pattern_match.h>
+
+#include <list>
+
+#include <wx/tokenzr.h>
+
+
+/**
+ * A library item without units
+ */
+class TEST_LIB_TREE_ITEM : public LIB_TREE_ITEM
+{
+public:
+    TEST_LIB_TREE_ITEM( const wxString& aLib, const wxString& aName, const wxString& aSearch ) :
+            m_libId( aLib, aName ),
+            m_searchText( aSearch )
+    {
+    }
+
+    LIB_ID GetLibId() const override { return m_libId; }
+
+    wxString GetName() const override { return m_libId.GetLibItemName(); }
+    wxString GetLibNickname() const override { return m_libId.GetLibNickname(); }
+
+    wxString GetDescription() override { return m_searchText; }
+    wxString GetSearchText() override { return m_searchText; }
+
+private:
+    LIB_ID   m_libId;
+    wxString m_searchText;
+};
+
+
+struct LIB_TREE_SEARCH_FIXTURE
+{
+    LIB_TREE_SEARCH_FIXTURE()
+    {
+        m_items.emplace_back( "Device", "R", "res resistor" );
+        m_items.emplace_back( "Device", "R_Small", "res resistor small" );
+        m_items.emplace_back( "Device", "C", "cap capacitor" );
+        m_items.emplace_back( "Device", "L_Core", "inductor choke" );
+        m_items.emplace_back( "Resistor_SMD", "R_0603", "resistor smd 0603" );
+        m_items.emplace_back( "Resistor_SMD", "R_0805", "resistor smd 0805" );
+        m_items.emplace_back( "Capacitor_SMD", "C_0603", "capacitor smd 0603" );
+        m_items.emplace_back( "Power", "GND", "power flag ground" );
+
+        for( LIB_TREE_NODE_ROOT* tree : { &m_indexed, &m_reference } )
+        {
+            for( TEST_LIB_TREE_ITEM& item : m_items )
+                addItem( *tree, item );
+
+            tree->AddLib( "Empty", "A library without items" );
+            tree->AssignIntrinsicRanks();
+        }
+    }
+
+    static void addItem( LIB_TREE_NODE_ROOT& aTree, TEST_LIB_TREE_ITEM& aItem )
+    {
+        for( std::unique_ptr<LIB_TREE_NODE>& lib : aTree.m_Children )
+        {
+            if( lib->m_Name == aItem.GetLibNickname() )
+            {
+                static_cast<LIB_TREE_NODE_LIB*>( lib.get() )->AddItem( &aItem );
+                return;
+            }
+        }
+
+        aTree.AddLib( aItem.GetLibNickname(), wxEmptyString ).AddItem( &aItem );
+    }
+
+    /**
+     * Search both trees, scoring the reference one term by term, and check that they
+     * score the same.
+     */
+    void CheckSearch( const wxString& aSearch )
+    {
+        std::vector<wxString> terms;
+        wxStringTokenizer     tokenizer( aSearch );
+
+        while( tokenizer.HasMoreTokens() )
+            terms.push_back( tokenizer.GetNextToken().Lower() );
+
+        m_indexed.ResetScore();
+        m_indexed.UpdateScores( terms );
+
+        m_reference.ResetScore();
+
+        for( const wxString& term : terms )
+        {
+            EDA_COMBINED_MATCHER matcher( term );
+            m_reference.UpdateScore( matcher );
+        }
+
+        // Sort as the adapter does, so that the next search sees the items reordered
+        m_indexed.SortNodes();
+        m_reference.SortNodes();
+
+        BOOST_TEST_CONTEXT( aSearch.ToStdString() )
+        {
+            BOOST_REQUIRE_EQUAL( m_indexed.m_Children.size(), m_reference.m_Children.size() );
+
+            for( size_t ii = 0; ii < m_indexed.m_Children.size(); ++ii )
+            {
+                LIB_TREE_NODE& lib = *m_indexed.m_Children[ii];
+                LIB_TREE_NODE& refLib = *m_reference.m_Children[ii];
+
+                BOOST_CHECK_EQUAL( lib.m_Name, refLib.m_Name );
+                BOOST_CHECK_EQUAL( lib.m_Score, refLib.m_Score );
+                BOOST_REQUIRE_EQUAL( lib.m_Children.size(), refLib.m_Children.size() );
+
+                for( size_t jj = 0; jj < lib.m_Children.size(); ++jj )
+                {
+                    BOOST_CHECK_EQUAL( lib.m_Children[jj]->m_Name, refLib.m_Children[jj]->m_Name );
+                    BOOST_CHECK_EQUAL( lib.m_Children[jj]->m_Score,
+                                       refLib.m_Children[jj]->m_Score );
+                }
+            }
+        }
+    }
+
+    std::list<TEST_LIB_TREE_ITEM> m_items;
+    LIB_TREE_NODE_ROOT            m_indexed;
+    LIB_TREE_NODE_ROOT            m_reference;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( LibTreeSearch, LIB_TREE_SEARCH_FIXTURE )
+
+
+/**
+ * Check the literal pattern fast path of the matcher
+ */
+BOOST_AUTO_TEST_CASE( LiteralPatterns )
+{
+    BOOST_CHECK( EDA_COMBINED_MATCHER::IsLiteralPattern( "r_0603" ) );
+    BOOST_CHECK( EDA_COMBINED_MATCHER::IsLiteralPattern( "74hc-00" ) );
+    BOOST_CHECK( !EDA_COMBINED_MATCHER::IsLiteralPattern( "" ) );
+    BOOST_CHECK( !EDA_COMBINED_MATCHER::IsLiteralPattern( "r.s" ) );
+    BOOST_CHECK( !EDA_COMBINED_MATCHER::IsLiteralPattern( "r*" ) );
+    BOOST_CHECK( !EDA_COMBINED_MATCHER::IsLiteralPattern( "<10" ) );
+
+    EDA_COMBINED_MATCHER matcher( "0603" );
+    int                  matchers = 0;
+    int                  position = EDA_PATTERN_NOT_FOUND;
+
+    BOOST_CHECK( matcher.IsLiteral() );
+    BOOST_CHECK( matcher.Find( "r_0603", matchers, position ) );
+    BOOST_CHECK_EQUAL( position, 2 );
+    BOOST_CHECK( !matcher.Find( "r_0805", matchers, position ) );
+}
+
+
+/**
+ * Check that the indexed search scores the tree as the plain one does while typing
+ */
+BOOST_AUTO_TEST_CASE( Typing )
+{
+    for( const wxString& search : { "r", "re", "res", "resi", "resistor", "res 06",
+                                    "res 0603", "r", "smd", "smd cap", "xyz", "device",
+                                    "power", "empty" } )
+    {
+        CheckSearch( search );
+    }
+}
+
+
+/**
+ * Check the terms which are not looked up in the index
+ */
+BOOST_AUTO_TEST_CASE( Patterns )
+{
+    for( const wxString& search : { "r.s", "r*s", "res r.s", "r_0?03", "res", "res r*" } )
+        CheckSearch( search );
+}
+
+
+/**
+ * Check that the index follows the changes of the tree
+ */
+BOOST_AUTO_TEST_CASE( TreeChanges )
+{
+    CheckSearch( "res" );
+
+    m_items.emplace_back( "Device", "R_Pack04", "resistor network" );
+    m_items.emplace_back( "Resistor_THT", "R_Axial", "resistor tht axial" );
+
+    for( auto it = std::prev( m_items.end(), 2 ); it != m_items.end(); ++it )
+    {
+        addItem( m_indexed, *it );
+        addItem( m_reference, *it );
+    }
+
+    m_indexed.AssignIntrinsicRanks();
+    m_reference.AssignIntrinsicRanks();
+
+    CheckSearch( "resi" );
+    CheckSearch( "resistor axial" );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
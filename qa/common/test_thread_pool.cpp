@@ -0,0 +1,158 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_thread_pool.cpp
+ * Test suite for THREAD_POOL and TASK_GROUP.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <thread_pool.h>
+
+#include <stdexcept>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( ThreadPool )
+
+
+/**
+ * Check that every task of a group is run exactly once
+ */
+BOOST_AUTO_TEST_CASE( RunsAllTasks )
+{
+    THREAD_POOL         pool( 4 );
+    std::vector<int>    results( 1000, 0 );
+    std::atomic<size_t> workerRuns( 0 );
+
+    {
+        TASK_GROUP tasks( pool );
+
+        for( size_t ii = 0; ii < results.size(); ++ii )
+        {
+            tasks.Run( [&, ii]()
+                       {
+                           results[ii]++;
+
+                           if( pool.IsWorkerThread() )
+                               workerRuns++;
+                       } );
+        }
+
+        tasks.Wait();
+    }
+
+    for( int result : results )
+        BOOST_CHECK_EQUAL( result, 1 );
+
+    // The calling thread helps out while waiting, but is not a worker of the pool
+    BOOST_CHECK( !pool.IsWorkerThread() );
+    BOOST_CHECK_LE( workerRuns.load(), results.size() );
+}
+
+
+/**
+ * Check that tasks waiting for their own subtasks cannot deadlock the pool, even when
+ * there are more waiting tasks than workers
+ */
+BOOST_AUTO_TEST_CASE( NestedGroups )
+{
+    THREAD_POOL      pool( 2 );
+    std::atomic<int> count( 0 );
+    TASK_GROUP       outer( pool );
+
+    for( int ii = 0; ii < 8; ++ii )
+    {
+        outer.Run( [&]()
+                   {
+                       TASK_GROUP inner( pool );
+
+                       for( int jj = 0; jj < 8; ++jj )
+                           inner.Run( [&]() { count++; } );
+
+                       inner.Wait();
+                   } );
+    }
+
+    outer.Wait();
+
+    BOOST_CHECK_EQUAL( count.load(), 64 );
+}
+
+
+/**
+ * Check that an exception thrown by a task is reported by Wait() once all tasks are done
+ */
+BOOST_AUTO_TEST_CASE( RethrowsException )
+{
+    THREAD_POOL      pool( 2 );
+    std::atomic<int> count( 0 );
+    TASK_GROUP       tasks( pool );
+
+    for( int ii = 0; ii < 16; ++ii )
+    {
+        tasks.Run( [&, ii]()
+                   {
+                       count++;
+
+                       if( ii == 3 )
+                           throw std::runtime_error( "task failed" );
+                   } );
+    }
+
+    BOOST_CHECK_THROW( tasks.Wait(), std::runtime_error );
+    BOOST_CHECK_EQUAL( count.load(), 16 );
+
+    // The exception is only reported once
+    BOOST_CHECK_NO_THROW( tasks.Wait() );
+}
+
+
+/**
+ * Check that WaitFor() returns once the tasks are done without running them itself
+ */
+BOOST_AUTO_TEST_CASE( WaitForTimeout )
+{
+    THREAD_POOL       pool( 1 );
+    std::atomic<bool> release( false );
+    TASK_GROUP        tasks( pool );
+
+    tasks.Run( [&]()
+               {
+                   while( !release )
+                       std::this_thread::yield();
+               } );
+
+    BOOST_CHECK( !tasks.WaitFor( std::chrono::milliseconds( 10 ) ) );
+
+    release = true;
+
+    while( !tasks.WaitFor( std::chrono::milliseconds( 10 ) ) )
+        ;
+
+    BOOST_CHECK( tasks.IsDone() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
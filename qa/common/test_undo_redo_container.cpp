@@ -0,0 +1,222 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_undo_redo_container.cpp
+ * Test suite for packing PICKED_ITEMS_LIST commands.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <undo_redo_container.h>
+
+#include <ki_exception.h>
+
+
+/**
+ * An item holding a single value, to be packed as text
+ */
+class TEST_ITEM : public EDA_ITEM
+{
+public:
+    TEST_ITEM( int aValue ) :
+            EDA_ITEM( NOT_USED ),
+            m_Value( aValue )
+    {
+    }
+
+    wxString GetClass() const override { return "TEST_ITEM"; }
+
+#if defined(DEBUG)
+    void Show( int nestLevel, std::ostream& os ) const override {}
+#endif
+
+    int m_Value;
+};
+
+
+/**
+ * Packs the links of UR_CHANGED pickers, and fails to unpack negative values
+ */
+class TEST_PACKER : public UNDO_ITEM_PACKER
+{
+public:
+    bool Pack( ITEM_PICKER& aPicker, std::string& aData ) override
+    {
+        if( aPicker.GetStatus() != UR_CHANGED || !aPicker.GetLink() )
+            return false;
+
+        aData = std::to_string( static_cast<TEST_ITEM*>( aPicker.GetLink() )->m_Value );
+
+        delete aPicker.GetLink();
+        aPicker.SetLink( nullptr );
+        return true;
+    }
+
+    void Unpack( ITEM_PICKER& aPicker, const std::string& aData ) override
+    {
+        int value = std::stoi( aData );
+
+        if( value < 0 )
+            THROW_IO_ERROR( "negative value" );
+
+        aPicker.SetLink( new TEST_ITEM( value ) );
+    }
+};
+
+
+/**
+ * A command changing aCount items, whose copies hold the values 0 to aCount - 1, and
+ * adding one more item
+ */
+static PICKED_ITEMS_LIST* makeCommand( std::vector<std::unique_ptr<TEST_ITEM>>& aItems,
+                                       int aCount )
+{
+    PICKED_ITEMS_LIST* command = new PICKED_ITEMS_LIST();
+
+    for( int ii = 0; ii < aCount; ++ii )
+    {
+        aItems.emplace_back( new TEST_ITEM( 100 + ii ) );
+
+        ITEM_PICKER picker( aItems.back().get(), UR_CHANGED );
+        picker.SetLink( new TEST_ITEM( ii ) );
+        command->PushItem( picker );
+    }
+
+    aItems.emplace_back( new TEST_ITEM( -1 ) );
+    command->PushItem( ITEM_PICKER( aItems.back().get(), UR_NEW ) );
+
+    return command;
+}
+
+
+static void checkCommand( PICKED_ITEMS_LIST* aCommand, int aCount )
+{
+    BOOST_REQUIRE_EQUAL( aCommand->GetCount(), (unsigned) aCount + 1 );
+
+    for( int ii = 0; ii < aCount; ++ii )
+    {
+        auto link = static_cast<TEST_ITEM*>( aCommand->GetPickedItemLink( ii ) );
+
+        BOOST_REQUIRE( link );
+        BOOST_CHECK_EQUAL( link->m_Value, ii );
+        BOOST_CHECK_EQUAL( static_cast<TEST_ITEM*>( aCommand->GetPickedItem( ii ) )->m_Value,
+                           100 + ii );
+    }
+
+    BOOST_CHECK( aCommand->GetPickedItemLink( aCount ) == nullptr );
+    BOOST_CHECK_EQUAL( aCommand->GetPickedItemStatus( aCount ), UR_NEW );
+}
+
+
+BOOST_AUTO_TEST_SUITE( UndoRedoContainer )
+
+
+/**
+ * Check that the copies of packed pickers are restored by Unpack()
+ */
+BOOST_AUTO_TEST_CASE( PackUnpack )
+{
+    std::vector<std::unique_ptr<TEST_ITEM>> items;
+    std::unique_ptr<PICKED_ITEMS_LIST>      command( makeCommand( items, 50 ) );
+    TEST_PACKER                             packer;
+
+    command->Pack( packer );
+
+    BOOST_CHECK( command->IsPacked() );
+    BOOST_CHECK( command->GetPickedItemLink( 0 ) == nullptr );
+    BOOST_CHECK_GT( command->GetPackedMemory(), 0u );
+
+    command->Unpack( packer );
+
+    BOOST_CHECK( !command->IsPacked() );
+    BOOST_CHECK_EQUAL( command->GetPackedMemory(), 0u );
+    checkCommand( command.get(), 50 );
+
+    command->ClearListAndDeleteItems();
+}
+
+
+/**
+ * Check that packed data moved to a journal is read back, and that the journal is emptied
+ * once no command needs it
+ */
+BOOST_AUTO_TEST_CASE( Journal )
+{
+    std::vector<std::unique_ptr<TEST_ITEM>> items;
+    std::unique_ptr<PICKED_ITEMS_LIST>      first( makeCommand( items, 20 ) );
+    std::unique_ptr<PICKED_ITEMS_LIST>      second( makeCommand( items, 30 ) );
+    TEST_PACKER                             packer;
+    UNDO_JOURNAL                            journal;
+
+    first->Pack( packer );
+    second->Pack( packer );
+    first->MoveToJournal( journal );
+    second->MoveToJournal( journal );
+
+    BOOST_CHECK_EQUAL( first->GetPackedMemory(), 0u );
+    BOOST_CHECK_EQUAL( second->GetPackedMemory(), 0u );
+
+    second->Unpack( packer );
+    checkCommand( second.get(), 30 );
+
+    // A command deleted while packed releases its journal data
+    first->ClearListAndDeleteItems();
+    first.reset();
+
+    std::unique_ptr<PICKED_ITEMS_LIST> third( makeCommand( items, 10 ) );
+
+    third->Pack( packer );
+    third->MoveToJournal( journal );
+    third->Unpack( packer );
+    checkCommand( third.get(), 10 );
+
+    second->ClearListAndDeleteItems();
+    third->ClearListAndDeleteItems();
+}
+
+
+/**
+ * Check that pickers whose copy cannot be unpacked are dropped from the command
+ */
+BOOST_AUTO_TEST_CASE( UnpackFailure )
+{
+    std::vector<std::unique_ptr<TEST_ITEM>> items;
+    std::unique_ptr<PICKED_ITEMS_LIST>      command( makeCommand( items, 3 ) );
+    TEST_PACKER                             packer;
+
+    static_cast<TEST_ITEM*>( command->GetPickedItemLink( 1 ) )->m_Value = -5;
+
+    command->Pack( packer );
+    command->Unpack( packer );
+
+    BOOST_REQUIRE_EQUAL( command->GetCount(), 3u );
+    BOOST_CHECK_EQUAL( static_cast<TEST_ITEM*>( command->GetPickedItemLink( 0 ) )->m_Value, 0 );
+    BOOST_CHECK_EQUAL( static_cast<TEST_ITEM*>( command->GetPickedItemLink( 1 ) )->m_Value, 2 );
+
+    command->ClearListAndDeleteItems();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,139 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_view_update.cpp
+ * Test suite for the update queue of KIGFX::VIEW.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <gal/graphics_abstraction_layer.h>
+#include <gal/gal_display_options.h>
+#include <view/view.h>
+#include <view/view_item.h>
+
+
+// All these tests are of a class in KIGFX
+using namespace KIGFX;
+
+
+/**
+ * A square item on a single layer.
+ */
+class TEST_VIEW_ITEM : public VIEW_ITEM
+{
+public:
+    const BOX2I ViewBBox() const override
+    {
+        return BOX2I( VECTOR2I( 0, 0 ), VECTOR2I( 100, 100 ) );
+    }
+
+    void ViewGetLayers( int aLayers[], int& aCount ) const override
+    {
+        aLayers[0] = 0;
+        aCount = 1;
+    }
+};
+
+
+/**
+ * Two views drawing on a GAL which draws nothing.  The test layer is not cached, so the
+ * updates only touch the layer trees.
+ */
+struct VIEW_UPDATE_FIXTURE
+{
+    VIEW_UPDATE_FIXTURE() :
+            m_gal( m_options ),
+            m_view( true ),
+            m_otherView( true )
+    {
+        for( VIEW* view : { &m_view, &m_otherView } )
+        {
+            view->SetGAL( &m_gal );
+            view->SetLayerTarget( 0, TARGET_NONCACHED );
+        }
+    }
+
+    bool IsInLayers( VIEW& aView, VIEW_ITEM* aItem )
+    {
+        std::vector<VIEW::LAYER_ITEM_PAIR> items;
+        aView.Query( BOX2I( VECTOR2I( -10, -10 ), VECTOR2I( 200, 200 ) ), items );
+
+        for( const VIEW::LAYER_ITEM_PAIR& item : items )
+        {
+            if( item.first == aItem )
+                return true;
+        }
+
+        return false;
+    }
+
+    GAL_DISPLAY_OPTIONS m_options;
+    GAL                 m_gal;
+    VIEW                m_view;
+    VIEW                m_otherView;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ViewUpdate, VIEW_UPDATE_FIXTURE )
+
+
+/**
+ * Updating a removed item must not put it back into the view
+ */
+BOOST_AUTO_TEST_CASE( RemoveThenUpdate )
+{
+    TEST_VIEW_ITEM item;
+
+    m_view.Add( &item );
+    m_view.UpdateItems();
+    BOOST_CHECK( IsInLayers( m_view, &item ) );
+
+    m_view.Remove( &item );
+    m_view.Update( &item );
+    m_view.UpdateItems();
+    BOOST_CHECK( !IsInLayers( m_view, &item ) );
+}
+
+
+/**
+ * Updating an item in a view must not add it to another view
+ */
+BOOST_AUTO_TEST_CASE( UpdateFromOtherView )
+{
+    TEST_VIEW_ITEM item;
+
+    m_otherView.Add( &item );
+    m_otherView.UpdateItems();
+
+    m_view.Update( &item );
+    m_view.UpdateItems();
+    BOOST_CHECK( !IsInLayers( m_view, &item ) );
+    BOOST_CHECK( IsInLayers( m_otherView, &item ) );
+
+    m_otherView.Remove( &item );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -25,8 +25,13 @@
 #include <netlist_reader/netlist_reader.h>
 #include <netlist_reader/pcb_netlist.h>
 #include <project.h>
+#include <sch_component.h>
 #include <sch_io_mgr.h>
+#include <sch_line.h>
+#include <sch_pin.h>
+#include <sch_screen.h>
 #include <sch_sheet.h>
+#include <sch_text.h>
 #include <schematic.h>
 #include <wildcards_and_files_ext.h>
 
@@ -35,26 +40,64 @@ class TEST_NETLISTS_FIXTURE
 {
 public:
     TEST_NETLISTS_FIXTURE() :
-            m_schematic( &m_project )
+            m_schematic( &m_project ),
+            m_reference( &m_project ),
+            m_incrementalUpdates( 0 )
     {
         m_pi = SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_KICAD );
     }
 
-    void loadSchematic( const wxString& aBaseName );
+    void loadSchematic( const wxString& aBaseName, SCHEMATIC& aSchematic );
 
-    wxString getNetlistFileName( bool aTest = false );
+    void loadSchematic( const wxString& aBaseName ) { loadSchematic( aBaseName, m_schematic ); }
 
-    void writeNetlist();
+    /**
+     * @param aSuffix is empty for the reference netlist, and tells the generated ones apart
+     */
+    wxString getNetlistFileName( const wxString& aSuffix = wxEmptyString );
 
-    void compareNetlists();
+    void writeNetlist( const wxString& aFileName, SCHEMATIC& aSchematic );
+
+    void writeNetlist( const wxString& aFileName ) { writeNetlist( aFileName, m_schematic ); }
+
+    void compareNetlists( const wxString& aGoldenFile, const wxString& aTestFile );
 
     void cleanup();
 
     void doNetlistTest( const wxString& aBaseName );
 
+    /**
+     * Edits the schematic several times in a row, only updating its connection graph
+     * incrementally, and checks after each edit that it gives the same netlist as a
+     * separately loaded copy of the schematic, edited the same way and fully recalculated
+     */
+    void doIncrementalNetlistTest( const wxString& aBaseName );
+
+    /**
+     * @return the item of m_reference at the same place as the given item of m_schematic
+     */
+    SCH_ITEM* findReferenceItem( SCH_ITEM* aItem, size_t aSheetIndex );
+
+    /**
+     * Applies an edit to an item of m_schematic and to the same item of m_reference, then
+     * updates the connection graph of m_schematic incrementally, the one of m_reference from
+     * scratch, and compares their netlists
+     *
+     * @param aSheetIndex is the index of the sheet of the item in the sheet list
+     * @param aEdit is given the item and the screen it is on
+     */
+    void checkEdit( const std::string& aDescription, size_t aSheetIndex, SCH_ITEM* aItem,
+                    const std::function<void( SCH_ITEM*, SCH_SCREEN* )>& aEdit );
+
     ///> Schematic to load
     SCHEMATIC m_schematic;
 
+    ///> Copy of the schematic for the incremental updates, which is always fully recalculated
+    SCHEMATIC m_reference;
+
+    ///> Number of edits for which the connection graph was only partly rebuilt
+    int m_incrementalUpdates;
+
     ///> Dummy project
     PROJECT m_project;
 
@@ -74,7 +117,7 @@ static wxString getSchematicFile( const wxString& aBaseName )
 }
 
 
-void TEST_NETLISTS_FIXTURE::loadSchematic( const wxString& aBaseName )
+void TEST_NETLISTS_FIXTURE::loadSchematic( const wxString& aBaseName, SCHEMATIC& aSchematic )
 {
     wxString fn = getSchematicFile( aBaseName );
 
@@ -86,22 +129,22 @@ void TEST_NETLISTS_FIXTURE::loadSchematic( const wxString& aBaseName )
     m_project.SetProjectFullName( pro.GetFullPath() );
     m_project.SetElem( PROJECT::ELEM_SCH_PART_LIBS, nullptr );
 
-    m_schematic.Reset();
-    m_schematic.SetRoot( m_pi->Load( fn, &m_schematic ) );
+    aSchematic.Reset();
+    aSchematic.SetRoot( m_pi->Load( fn, &aSchematic ) );
 
     BOOST_REQUIRE_EQUAL( m_pi->GetError().IsEmpty(), true );
 
-    m_schematic.CurrentSheet().push_back( &m_schematic.Root() );
+    aSchematic.CurrentSheet().push_back( &aSchematic.Root() );
 
-    SCH_SCREENS screens( m_schematic.Root() );
+    SCH_SCREENS screens( aSchematic.Root() );
 
     for( SCH_SCREEN* screen = screens.GetFirst(); screen; screen = screens.GetNext() )
         screen->UpdateLocalLibSymbolLinks();
 
-    SCH_SHEET_LIST sheets = m_schematic.GetSheets();
+    SCH_SHEET_LIST sheets = aSchematic.GetSheets();
 
     // Restore all of the loaded symbol instances from the root sheet screen.
-    sheets.UpdateSymbolInstances( m_schematic.RootScreen()->GetSymbolInstances() );
+    sheets.UpdateSymbolInstances( aSchematic.RootScreen()->GetSymbolInstances() );
 
     sheets.AnnotatePowerSymbols();
 
@@ -113,16 +156,15 @@ void TEST_NETLISTS_FIXTURE::loadSchematic( const wxString& aBaseName )
     // NOTE: SchematicCleanUp is not called; QA schematics must already be clean or else
     // SchematicCleanUp must be freed from its UI dependencies.
 
-    m_schematic.ConnectionGraph()->Recalculate( sheets, true );
+    aSchematic.ConnectionGraph()->Recalculate( sheets, true );
 }
 
 
-wxString TEST_NETLISTS_FIXTURE::getNetlistFileName( bool aTest )
+wxString TEST_NETLISTS_FIXTURE::getNetlistFileName( const wxString& aSuffix )
 {
     wxFileName netFile = m_schematic.Prj().GetProjectFullName();
 
-    if( aTest )
-        netFile.SetName( netFile.GetName() + "_test" );
+    netFile.SetName( netFile.GetName() + aSuffix );
 
     netFile.SetExt( NetlistFileExtension );
 
@@ -130,28 +172,29 @@ wxString TEST_NETLISTS_FIXTURE::getNetlistFileName( bool aTest )
 }
 
 
-void TEST_NETLISTS_FIXTURE::writeNetlist()
+void TEST_NETLISTS_FIXTURE::writeNetlist( const wxString& aFileName, SCHEMATIC& aSchematic )
 {
-    auto exporter = std::make_unique<NETLIST_EXPORTER_KICAD>( &m_schematic );
-    BOOST_REQUIRE_EQUAL( exporter->WriteNetlist( getNetlistFileName( true ), 0 ), true );
+    auto exporter = std::make_unique<NETLIST_EXPORTER_KICAD>( &aSchematic );
+    BOOST_REQUIRE_EQUAL( exporter->WriteNetlist( aFileName, 0 ), true );
 }
 
 
-void TEST_NETLISTS_FIXTURE::compareNetlists()
+void TEST_NETLISTS_FIXTURE::compareNetlists( const wxString& aGoldenFile,
+                                             const wxString& aTestFile )
 {
     NETLIST golden;
     NETLIST test;
 
     {
         std::unique_ptr<NETLIST_READER> netlistReader(
-                NETLIST_READER::GetNetlistReader( &golden, getNetlistFileName(), wxEmptyString ) );
+                NETLIST_READER::GetNetlistReader( &golden, aGoldenFile, wxEmptyString ) );
 
         BOOST_REQUIRE_NO_THROW( netlistReader->LoadNetlist() );
     }
 
     {
-        std::unique_ptr<NETLIST_READER> netlistReader( NETLIST_READER::GetNetlistReader(
-                &test, getNetlistFileName( true ), wxEmptyString ) );
+        std::unique_ptr<NETLIST_READER> netlistReader(
+                NETLIST_READER::GetNetlistReader( &test, aTestFile, wxEmptyString ) );
 
         BOOST_REQUIRE_NO_THROW( netlistReader->LoadNetlist() );
     }
@@ -192,15 +235,178 @@ void TEST_NETLISTS_FIXTURE::compareNetlists()
 
 void TEST_NETLISTS_FIXTURE::cleanup()
 {
-    wxRemoveFile( getNetlistFileName( true ) );
+    wxRemoveFile( getNetlistFileName( "_test" ) );
+    wxRemoveFile( getNetlistFileName( "_full" ) );
 }
 
 
 void TEST_NETLISTS_FIXTURE::doNetlistTest( const wxString& aBaseName )
 {
     loadSchematic( aBaseName );
-    writeNetlist();
-    compareNetlists();
+    writeNetlist( getNetlistFileName( "_test" ) );
+    compareNetlists( getNetlistFileName(), getNetlistFileName( "_test" ) );
+    cleanup();
+}
+
+
+SCH_ITEM* TEST_NETLISTS_FIXTURE::findReferenceItem( SCH_ITEM* aItem, size_t aSheetIndex )
+{
+    // The test schematics do not store the IDs of wires and labels
+    SCH_SCREEN* screen = m_reference.GetSheets()[aSheetIndex].LastScreen();
+    EDA_RECT    bbox = aItem->GetBoundingBox();
+
+    for( SCH_ITEM* item : screen->Items().OfType( aItem->Type() ) )
+    {
+        if( item->GetPosition() == aItem->GetPosition()
+                && item->GetBoundingBox().GetOrigin() == bbox.GetOrigin()
+                && item->GetBoundingBox().GetEnd() == bbox.GetEnd() )
+        {
+            return item;
+        }
+    }
+
+    return nullptr;
+}
+
+
+void TEST_NETLISTS_FIXTURE::checkEdit( const std::string& aDescription, size_t aSheetIndex,
+                                       SCH_ITEM* aItem,
+                                       const std::function<void( SCH_ITEM*, SCH_SCREEN* )>& aEdit )
+{
+    BOOST_TEST_CONTEXT( aDescription )
+    {
+        SCH_ITEM* reference = findReferenceItem( aItem, aSheetIndex );
+
+        BOOST_REQUIRE( reference );
+
+        aEdit( aItem, m_schematic.GetSheets()[aSheetIndex].LastScreen() );
+        aEdit( reference, m_reference.GetSheets()[aSheetIndex].LastScreen() );
+
+        m_schematic.ConnectionGraph()->Recalculate( m_schematic.GetSheets(), false );
+
+        if( m_schematic.ConnectionGraph()->WasLastUpdateIncremental() )
+            m_incrementalUpdates++;
+
+        m_reference.ConnectionGraph()->Recalculate( m_reference.GetSheets(), true );
+
+        writeNetlist( getNetlistFileName( "_test" ), m_schematic );
+        writeNetlist( getNetlistFileName( "_full" ), m_reference );
+
+        compareNetlists( getNetlistFileName( "_full" ), getNetlistFileName( "_test" ) );
+    }
+}
+
+
+void TEST_NETLISTS_FIXTURE::doIncrementalNetlistTest( const wxString& aBaseName )
+{
+    loadSchematic( aBaseName, m_schematic );
+    loadSchematic( aBaseName, m_reference );
+
+    SCH_SHEET_LIST         sheets = m_schematic.GetSheets();
+    SCH_LINE*              wire = nullptr;
+    size_t                 wireSheet = 0;
+    std::vector<SCH_TEXT*> labels;
+    size_t                 labelSheet = 0;
+    wxString               newName;
+    const wxPoint          offset( Mils2iu( 25 ), Mils2iu( 25 ) );
+
+    // A wire on a component pin
+    for( size_t ii = 0; ii < sheets.size() && !wire; ++ii )
+    {
+        SCH_SCREEN* screen = sheets[ii].LastScreen();
+
+        for( SCH_ITEM* item : screen->Items().OfType( SCH_LINE_T ) )
+        {
+            SCH_LINE* line = static_cast<SCH_LINE*>( item );
+
+            if( line->IsWire() && ( screen->GetPin( line->GetStartPoint(), nullptr, true )
+                                    || screen->GetPin( line->GetEndPoint(), nullptr, true ) ) )
+            {
+                wire = line;
+                wireSheet = ii;
+                break;
+            }
+        }
+    }
+
+    // Three labels of a sheet, and the different name of a fourth one
+    for( size_t ii = 0; ii < sheets.size() && labels.empty(); ++ii )
+    {
+        std::vector<SCH_TEXT*> others;
+        SCH_TEXT*              renamed = nullptr;
+
+        newName.Empty();
+
+        for( SCH_ITEM* item : sheets[ii].LastScreen()->Items().OfType( SCH_LABEL_T ) )
+        {
+            SCH_TEXT* label = static_cast<SCH_TEXT*>( item );
+
+            if( !renamed )
+                renamed = label;
+            else if( newName.IsEmpty() && label->GetText() != renamed->GetText() )
+                newName = label->GetText();
+            else
+                others.push_back( label );
+        }
+
+        if( !newName.IsEmpty() && others.size() >= 2 )
+        {
+            labels = { others[0], others[1], renamed };
+            labelSheet = ii;
+        }
+    }
+
+    BOOST_REQUIRE( wire );
+    BOOST_REQUIRE_EQUAL( labels.size(), 3 );
+
+    // The connection graph of m_schematic is not fully recalculated from here on
+
+    checkEdit( "move a wire off a pin", wireSheet, wire,
+            [&]( SCH_ITEM* aItem, SCH_SCREEN* aScreen )
+            {
+                // By half a grid step, so that it lands on nothing
+                aItem->Move( offset );
+                aItem->SetConnectivityDirty();
+                aScreen->Update( aItem );
+            } );
+
+    checkEdit( "delete a label", labelSheet, labels[0],
+            [&]( SCH_ITEM* aItem, SCH_SCREEN* aScreen )
+            {
+                aScreen->Remove( aItem );
+                delete aItem;
+            } );
+
+    // The new label is likely to be allocated where the deleted one was
+    checkEdit( "replace a label by a new one elsewhere", labelSheet, labels[1],
+            [&]( SCH_ITEM* aItem, SCH_SCREEN* aScreen )
+            {
+                wxPoint  pos = aItem->GetPosition() + wxPoint( Mils2iu( 10000 ), 0 );
+                wxString text = static_cast<SCH_TEXT*>( aItem )->GetText();
+
+                aScreen->Remove( aItem );
+                delete aItem;
+
+                aScreen->Append( new SCH_LABEL( pos, text ) );
+            } );
+
+    // Joins two nets
+    checkEdit( "rename a label", labelSheet, labels[2],
+            [&]( SCH_ITEM* aItem, SCH_SCREEN* aScreen )
+            {
+                static_cast<SCH_TEXT*>( aItem )->SetText( newName );
+                aItem->SetConnectivityDirty();
+                aScreen->Update( aItem );
+            } );
+
+    checkEdit( "move the wire back", wireSheet, wire,
+            [&]( SCH_ITEM* aItem, SCH_SCREEN* aScreen )
+            {
+                aItem->Move( -offset );
+                aItem->SetConnectivityDirty();
+                aScreen->Update( aItem );
+            } );
+
     cleanup();
 }
 
@@ -238,4 +444,14 @@ BOOST_AUTO_TEST_CASE( ComplexHierarchy )
 }
 
 
+BOOST_AUTO_TEST_CASE( IncrementalUpdate )
+{
+    doIncrementalNetlistTest( "video" );
+    doIncrementalNetlistTest( "complex_hierarchy" );
+
+    // The edits must not all have fallen back to a full recalculation
+    BOOST_CHECK_GT( m_incrementalUpdates, 0 );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,160 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for DANGLING_END_INDEX and the dangling end tests of SCH_SCREEN
+ */
+
+#include <convert_to_biu.h>
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <sch_item.h>
+#include <sch_line.h>
+#include <sch_screen.h>
+#include <sch_text.h>
+
+#include <algorithm>
+
+
+static SCH_LINE* makeWire( const wxPoint& aStart, const wxPoint& aEnd )
+{
+    SCH_LINE* wire = new SCH_LINE( aStart, LAYER_WIRE );
+    wire->SetEndPoint( aEnd );
+
+    return wire;
+}
+
+
+BOOST_AUTO_TEST_SUITE( SchDanglingEnds )
+
+
+/**
+ * Check the point and segment queries of the index, including segments crossing several
+ * grid cells and negative coordinates
+ */
+BOOST_AUTO_TEST_CASE( IndexQueries )
+{
+    std::unique_ptr<SCH_LINE> straight( makeWire( wxPoint( Mils2iu( -3000 ), 0 ),
+                                                  wxPoint( Mils2iu( 3000 ), 0 ) ) );
+    std::unique_ptr<SCH_LINE> diagonal( makeWire( wxPoint( Mils2iu( -2500 ), Mils2iu( -2500 ) ),
+                                                  wxPoint( Mils2iu( 2500 ), Mils2iu( 2500 ) ) ) );
+
+    std::vector<DANGLING_END_ITEM> ends;
+    straight->GetEndPoints( ends );
+    diagonal->GetEndPoints( ends );
+
+    DANGLING_END_INDEX index( ends );
+
+    BOOST_CHECK_EQUAL( index.GetItems().size(), 4u );
+    BOOST_CHECK( index.IsSegmentStart( 0 ) );
+    BOOST_CHECK( !index.IsSegmentStart( 1 ) );
+    BOOST_CHECK( index.IsSegmentStart( 2 ) );
+
+    BOOST_REQUIRE_EQUAL( index.GetEndsAt( wxPoint( Mils2iu( 3000 ), 0 ) ).size(), 1u );
+    BOOST_CHECK_EQUAL( index.GetEndsAt( wxPoint( Mils2iu( 3000 ), 0 ) )[0], 1u );
+    BOOST_CHECK( index.GetEndsAt( wxPoint( Mils2iu( 3000 ), 1 ) ).empty() );
+
+    auto hasSegment =
+            [&]( const wxPoint& aPos, size_t aSegment ) -> bool
+            {
+                const std::vector<size_t>& segs = index.GetSegmentsNear( aPos );
+                return std::find( segs.begin(), segs.end(), aSegment ) != segs.end();
+            };
+
+    for( int x = Mils2iu( -3000 ); x <= Mils2iu( 3000 ); x += Mils2iu( 50 ) )
+        BOOST_CHECK( hasSegment( wxPoint( x, 0 ), 0 ) );
+
+    for( int x = Mils2iu( -2500 ); x <= Mils2iu( 2500 ); x += Mils2iu( 50 ) )
+        BOOST_CHECK( hasSegment( wxPoint( x, x ), 2 ) );
+
+    BOOST_CHECK( !hasSegment( wxPoint( Mils2iu( -2500 ), Mils2iu( 2500 ) ), 2 ) );
+
+    std::vector<size_t> inside;
+    index.GetEndsInside( EDA_RECT( wxPoint( Mils2iu( -3000 ), Mils2iu( -3000 ) ),
+                                   wxSize( Mils2iu( 1000 ), Mils2iu( 3000 ) ) ),
+                         inside );
+
+    std::vector<size_t> expected = { 0, 2 };
+
+    std::sort( inside.begin(), inside.end() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( inside.begin(), inside.end(), expected.begin(),
+                                   expected.end() );
+}
+
+
+/**
+ * Check that the incremental test finds the items whose state changed after edits
+ */
+BOOST_AUTO_TEST_CASE( IncrementalUpdate )
+{
+    SCH_SCREEN screen;
+
+    SCH_LINE*  first = makeWire( wxPoint( 0, 0 ), wxPoint( Mils2iu( 1000 ), 0 ) );
+    SCH_LINE*  second = makeWire( wxPoint( Mils2iu( 1000 ), 0 ),
+                                  wxPoint( Mils2iu( 1000 ), Mils2iu( 1000 ) ) );
+    SCH_LABEL* label = new SCH_LABEL( wxPoint( Mils2iu( 500 ), 0 ), "NET" );
+
+    screen.Append( first );
+    screen.Append( second );
+    screen.Append( label );
+
+    BOOST_CHECK( screen.TestDanglingEnds() );
+    BOOST_CHECK( first->IsStartDangling() );
+    BOOST_CHECK( !first->IsEndDangling() );
+    BOOST_CHECK( !second->IsStartDangling() );
+    BOOST_CHECK( second->IsEndDangling() );
+    BOOST_CHECK( !label->IsDangling() );
+
+    // Nothing changed
+    BOOST_CHECK( !screen.UpdateDanglingEnds() );
+
+    // Move the second wire away from the first one
+    std::vector<SCH_ITEM*> changed;
+    std::function<void( SCH_ITEM* )> changedHandler =
+            [&]( SCH_ITEM* aItem )
+            {
+                changed.push_back( aItem );
+            };
+
+    second->Move( wxPoint( Mils2iu( 100 ), 0 ) );
+    screen.Update( second );
+
+    BOOST_CHECK( screen.UpdateDanglingEnds( &changedHandler ) );
+    BOOST_CHECK( first->IsEndDangling() );
+    BOOST_CHECK( second->IsStartDangling() );
+    BOOST_CHECK( !label->IsDangling() );
+    BOOST_CHECK( std::find( changed.begin(), changed.end(), first ) != changed.end() );
+    BOOST_CHECK( std::find( changed.begin(), changed.end(), label ) == changed.end() );
+
+    // Removing the wire under the label leaves it dangling
+    screen.Remove( first );
+    delete first;
+
+    BOOST_CHECK( screen.UpdateDanglingEnds() );
+    BOOST_CHECK( label->IsDangling() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,282 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_symbol_lib_index.cpp
+ * Test suite for the indexed, on demand loading of symbol libraries.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <class_libentry.h>
+#include <properties.h>
+#include <sch_io_mgr.h>
+#include <sch_sexpr_parser.h>
+#include <symbol_lib_index.h>
+#include <symbol_lib_table.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+
+/**
+ * Temporary library files sharing a name, removed on destruction
+ */
+class TEMP_LIB_FILES
+{
+public:
+    TEMP_LIB_FILES()
+    {
+        m_base = wxFileName::CreateTempFileName( "qa_symbol_lib_index" );
+    }
+
+    ~TEMP_LIB_FILES()
+    {
+        for( const wxString& file : m_files )
+            wxRemoveFile( file );
+
+        wxRemoveFile( m_base );
+    }
+
+    wxString Add( const wxString& aExt, const std::string& aText )
+    {
+        wxString  name = m_base + "." + aExt;
+        wxFFile   file( name, "wb" );
+
+        file.Write( aText.data(), aText.size() );
+        m_files.push_back( name );
+
+        return name;
+    }
+
+private:
+    wxString              m_base;
+    std::vector<wxString> m_files;
+};
+
+
+static const std::string s_sexprLib =
+        "(kicad_symbol_lib (version 20200126) (host kicad_symbol_editor \"5.99\")\n"
+        "  (symbol \"R\" (pin_numbers hide)\n"
+        "    (property \"Reference\" \"R\" (id 0))\n"
+        "    (property \"Value\" \"R\" (id 1))\n"
+        "    (property \"Footprint\" \"Resistor_SMD:R_0603\" (id 2))\n"
+        "    (property \"ki_keywords\" \"res resistor\" (id 4))\n"
+        "    (property \"ki_description\" \"Resistor (\\\"generic)\" (id 5))\n"
+        "    (symbol \"R_0_1\")\n"
+        "  )\n"
+        "  (symbol \"R_Small\" (extends \"R\")\n"
+        "    (property \"Reference\" \"R\" (id 0))\n"
+        "    (property \"Value\" \"R_Small\" (id 1))\n"
+        "    (property \"ki_description\" \"Small resistor\" (id 5))\n"
+        "  )\n"
+        "  (symbol \"GND\" (power)\n"
+        "    (property \"Reference\" \"#PWR\" (id 0))\n"
+        "    (property \"Value\" \"GND\" (id 1))\n"
+        "    (symbol \"GND_0_1\")\n"
+        "  )\n"
+        "  (symbol \"74HC00\"\n"
+        "    (property \"Reference\" \"U\" (id 0))\n"
+        "    (property \"Value\" \"74HC00\" (id 1))\n"
+        "    (symbol \"74HC00_1_1\")\n"
+        "    (symbol \"74HC00_2_1\")\n"
+        "    (symbol \"74HC00_3_1\")\n"
+        "    (symbol \"74HC00_4_1\")\n"
+        "  )\n"
+        ")\n";
+
+
+static const std::string s_legacyLib =
+        "EESchema-LIBRARY Version 2.4\n"
+        "#encoding utf-8\n"
+        "#\n"
+        "# R\n"
+        "#\n"
+        "DEF R R 0 0 N Y 1 F N\n"
+        "F0 \"R\" 80 0 50 V V C CNN\n"
+        "F1 \"R\" 0 0 50 V V C CNN\n"
+        "F2 \"Resistor_SMD:R_0603\" -70 0 50 V I C CNN\n"
+        "F3 \"\" 0 0 50 H I C CNN\n"
+        "ALIAS R_Small R_Alt\n"
+        "$FPLIST\n"
+        " R_*\n"
+        "$ENDFPLIST\n"
+        "DRAW\n"
+        "S -40 -100 40 100 0 1 10 N\n"
+        "ENDDRAW\n"
+        "ENDDEF\n"
+        "#\n"
+        "# GND\n"
+        "#\n"
+        "DEF GND #PWR 0 0 Y Y 1 F P\n"
+        "F0 \"#PWR\" 0 -250 50 H I C CNN\n"
+        "F1 \"GND\" 0 -150 50 H V C CNN\n"
+        "F2 \"\" 0 0 50 H I C CNN\n"
+        "F3 \"\" 0 0 50 H I C CNN\n"
+        "ENDDEF\n"
+        "#\n"
+        "#End Library\n";
+
+
+static const std::string s_legacyDocs =
+        "EESchema-DOCLIB  Version 2.0\n"
+        "#\n"
+        "$CMP R\n"
+        "D Resistor\n"
+        "K res resistor\n"
+        "$ENDCMP\n"
+        "#\n"
+        "$CMP R_Small\n"
+        "D Small resistor\n"
+        "$ENDCMP\n"
+        "#\n"
+        "#End Doc Library\n";
+
+
+static LIB_SYMBOL_INFO* findInfo( std::vector<LIB_SYMBOL_INFO>& aInfo, const wxString& aName )
+{
+    for( LIB_SYMBOL_INFO& info : aInfo )
+    {
+        if( info.GetName() == aName )
+            return &info;
+    }
+
+    return nullptr;
+}
+
+
+BOOST_AUTO_TEST_SUITE( SymbolLibIndex )
+
+
+/**
+ * Check that the index of an s-expression library points at the symbol definitions
+ */
+BOOST_AUTO_TEST_CASE( SexprIndex )
+{
+    TEMP_LIB_FILES          files;
+    wxString                libPath = files.Add( "kicad_sym", s_sexprLib );
+    MAPPED_FILE_LINE_READER reader( libPath );
+    SCH_SEXPR_PARSER        parser( &reader );
+    SYMBOL_LIB_INDEX        index;
+
+    parser.ParseLibIndex( index );
+
+    BOOST_CHECK_EQUAL( index.GetEntries().size(), 4u );
+    BOOST_CHECK_EQUAL( index.GetVersionMajor(), 20200126 );
+
+    for( const auto& pair : index.GetEntries() )
+    {
+        std::string text = SYMBOL_LIB_INDEX::ReadSymbolText( libPath, pair.second );
+
+        BOOST_CHECK_EQUAL( text.substr( 0, 9 ), "(symbol \"" );
+        BOOST_CHECK_EQUAL( text.back(), ')' );
+    }
+
+    const SYMBOL_LIB_INDEX_ENTRY* r = index.Find( "R" );
+    const SYMBOL_LIB_INDEX_ENTRY* rSmall = index.Find( "R_Small" );
+
+    BOOST_REQUIRE( r && rSmall );
+    BOOST_CHECK_EQUAL( r->m_Description, "Resistor (\"generic)" );
+    BOOST_CHECK_EQUAL( r->m_Keywords, "res resistor" );
+    BOOST_CHECK_EQUAL( r->m_Footprint, "Resistor_SMD:R_0603" );
+    BOOST_CHECK_EQUAL( rSmall->m_Parent, "R" );
+    BOOST_CHECK_EQUAL( index.Find( "74HC00" )->m_UnitCount, 4 );
+    BOOST_CHECK( index.Find( "GND" )->m_IsPower );
+    BOOST_CHECK( !r->m_IsPower );
+}
+
+
+/**
+ * Check that both library plugins enumerate the indexed symbols and parse them on demand
+ */
+BOOST_AUTO_TEST_CASE( LoadOnDemand )
+{
+    TEMP_LIB_FILES files;
+    wxString       sexprPath = files.Add( "kicad_sym", s_sexprLib );
+    wxString       legacyPath = files.Add( "lib", s_legacyLib );
+
+    files.Add( "dcm", s_legacyDocs );
+
+    std::vector<std::pair<SCH_IO_MGR::SCH_FILE_T, wxString>> libs = {
+        { SCH_IO_MGR::SCH_KICAD, sexprPath },
+        { SCH_IO_MGR::SCH_LEGACY, legacyPath }
+    };
+
+    for( const auto& lib : libs )
+    {
+        BOOST_TEST_CONTEXT( lib.second.ToStdString() )
+        {
+            // The second pass reads the index from the cache
+            for( int pass = 0; pass < 2; ++pass )
+            {
+                SCH_PLUGIN::SCH_PLUGIN_RELEASER pi( SCH_IO_MGR::FindPlugin( lib.first ) );
+                std::vector<LIB_SYMBOL_INFO>    info;
+
+                pi->EnumerateSymbolInfo( info, lib.second );
+
+                LIB_SYMBOL_INFO* r = findInfo( info, "R" );
+                LIB_SYMBOL_INFO* rSmall = findInfo( info, "R_Small" );
+
+                BOOST_REQUIRE( r && rSmall && findInfo( info, "GND" ) );
+                BOOST_CHECK( r->IsRoot() );
+                BOOST_CHECK( !rSmall->IsRoot() );
+                BOOST_CHECK_EQUAL( rSmall->GetDescription(), "Small resistor" );
+                BOOST_CHECK( r->GetSearchText().Contains( "Resistor_SMD:R_0603" ) );
+
+                PROPERTIES                   powerOnly;
+                std::vector<LIB_SYMBOL_INFO> power;
+
+                powerOnly[ SYMBOL_LIB_TABLE::PropPowerSymsOnly ] = "";
+                pi->EnumerateSymbolInfo( power, lib.second, &powerOnly );
+
+                BOOST_REQUIRE_EQUAL( power.size(), 1u );
+                BOOST_CHECK_EQUAL( power[0].GetName(), "GND" );
+
+                // Loading a derived symbol loads the symbol it derives from
+                LIB_PART* part = pi->LoadSymbol( lib.second, "R_Small" );
+
+                BOOST_REQUIRE( part );
+                BOOST_CHECK( part->IsAlias() );
+                BOOST_CHECK_EQUAL( part->GetDescription(), "Small resistor" );
+                BOOST_CHECK_EQUAL( part->GetParent().lock()->GetName(), "R" );
+
+                BOOST_CHECK( pi->LoadSymbol( lib.second, "Missing" ) == nullptr );
+
+                wxArrayString names;
+
+                pi->EnumerateSymbolLib( names, lib.second );
+                BOOST_CHECK_EQUAL( names.size(), info.size() );
+
+                std::vector<LIB_PART*> parts;
+
+                pi->EnumerateSymbolLib( parts, lib.second );
+                BOOST_CHECK_EQUAL( parts.size(), info.size() );
+                BOOST_CHECK( pi->LoadSymbol( lib.second, "R_Small" ) == part );
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,273 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_drc_online.cpp
+ * Test suite for the incremental re-test of the changed items by the online DRC.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <connectivity/connectivity_data.h>
+#include <drc/drc.h>
+#include <drc/drc_item.h>
+
+#include "drc_test_utils.h"
+
+#include <set>
+#include <tuple>
+
+
+static wxPoint mm( double aX, double aY )
+{
+    return wxPoint( Millimeter2iu( aX ), Millimeter2iu( aY ) );
+}
+
+
+struct DRC_ONLINE_TEST_FIXTURE
+{
+    DRC_ONLINE_TEST_FIXTURE()
+    {
+        NETINFO_ITEM* net1 = new NETINFO_ITEM( &m_board, "N1", 1 );
+        NETINFO_ITEM* net2 = new NETINFO_ITEM( &m_board, "N2", 2 );
+
+        m_board.Add( net1 );
+        m_board.Add( net2 );
+
+        // A closed triangle of tracks, so that no end is dangling
+        m_a = addTrack( mm( 0, 0 ), mm( 10, 0 ), 1 );
+        m_b = addTrack( mm( 10, 0 ), mm( 5, 8 ), 1 );
+        m_c = addTrack( mm( 5, 8 ), mm( 0, 0 ), 1 );
+
+        // A track of another net, far from the triangle
+        m_d = addTrack( mm( 0, 50.1 ), mm( 10, 50.1 ), 2 );
+
+        m_board.GetConnectivity()->Build( &m_board );
+    }
+
+    ~DRC_ONLINE_TEST_FIXTURE()
+    {
+        m_drc.DetachBoard();
+    }
+
+    TRACK* addTrack( const wxPoint& aStart, const wxPoint& aEnd, int aNet )
+    {
+        TRACK* track = new TRACK( &m_board );
+
+        track->SetStart( aStart );
+        track->SetEnd( aEnd );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetLayer( F_Cu );
+        track->SetNetCode( aNet );
+
+        m_board.Add( track );
+        return track;
+    }
+
+    /**
+     * Move a track as a commit does, and run the online DRC.
+     */
+    void MoveTrack( TRACK* aTrack, const wxPoint& aOffset )
+    {
+        aTrack->Move( aOffset );
+        m_board.GetConnectivity()->Build( &m_board );
+        m_board.OnItemChanged( aTrack );
+
+        std::vector<MARKER_PCB*> removed;
+        std::vector<MARKER_PCB*> added;
+
+        m_drc.RetestChangedItems( removed, added );
+
+        for( MARKER_PCB* marker : removed )
+            delete marker;
+    }
+
+    /**
+     * Re-test every track, as a full run of the track tests reporting all errors does.
+     */
+    void RetestAllTracks()
+    {
+        m_board.DeleteMARKERs();
+
+        for( TRACK* track : m_board.Tracks() )
+            m_board.OnItemChanged( track );
+
+        std::vector<MARKER_PCB*> removed;
+        std::vector<MARKER_PCB*> added;
+
+        m_drc.RetestChangedItems( removed, added );
+    }
+
+    typedef std::tuple<int, KIID, KIID> MARKER_KEY;
+
+    std::set<MARKER_KEY> GetMarkers()
+    {
+        std::set<MARKER_KEY> markers;
+
+        for( MARKER_PCB* marker : m_board.Markers() )
+        {
+            const RC_ITEM* item = marker->GetRCItem();
+            KIID           mainID = item->GetMainItemID();
+            KIID           auxID = item->GetAuxItemID();
+
+            if( auxID < mainID )
+                std::swap( mainID, auxID );
+
+            markers.emplace( item->GetErrorCode(), mainID, auxID );
+        }
+
+        return markers;
+    }
+
+    /**
+     * Check the markers left by the online DRC are those of a full run.
+     */
+    void CheckSameAsFullRun()
+    {
+        std::set<MARKER_KEY> online = GetMarkers();
+
+        RetestAllTracks();
+
+        std::set<MARKER_KEY> full = GetMarkers();
+
+        BOOST_CHECK_EQUAL( online.size(), full.size() );
+        BOOST_CHECK( online == full );
+    }
+
+    bool HasDanglingMarker( TRACK* aTrack )
+    {
+        for( MARKER_PCB* marker : m_board.Markers() )
+        {
+            if( KI_TEST::IsDrcMarkerOfType( *marker, DRCE_DANGLING_TRACK )
+                    && marker->GetRCItem()->GetMainItemID() == aTrack->m_Uuid )
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool HasClearanceMarker( TRACK* aTrack, TRACK* aOther )
+    {
+        for( MARKER_PCB* marker : m_board.Markers() )
+        {
+            const RC_ITEM* item = marker->GetRCItem();
+            std::set<KIID> ids = { item->GetMainItemID(), item->GetAuxItemID() };
+
+            if( !KI_TEST::IsDrcMarkerOfType( *marker, DRCE_DANGLING_TRACK )
+                    && ids == std::set<KIID>{ aTrack->m_Uuid, aOther->m_Uuid } )
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    BOARD  m_board;
+    DRC    m_drc;
+    TRACK* m_a;
+    TRACK* m_b;
+    TRACK* m_c;
+    TRACK* m_d;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DrcOnline, DRC_ONLINE_TEST_FIXTURE )
+
+
+/**
+ * Check that moving a track updates the markers both where it was and where it goes
+ */
+BOOST_AUTO_TEST_CASE( MoveTrack )
+{
+    m_drc.StartOnlineDRC( &m_board );
+
+    BOOST_CHECK( m_board.Markers().empty() );
+
+    // Move A onto D: the tracks it was connected to are left dangling, and it collides
+    // with D
+    MoveTrack( m_a, mm( 0, 50 ) );
+
+    BOOST_CHECK( HasDanglingMarker( m_b ) );
+    BOOST_CHECK( HasDanglingMarker( m_c ) );
+    BOOST_CHECK( HasClearanceMarker( m_a, m_d ) );
+
+    // Move A back: the markers around both positions are gone
+    MoveTrack( m_a, mm( 0, -50 ) );
+
+    BOOST_CHECK( !HasDanglingMarker( m_a ) );
+    BOOST_CHECK( !HasDanglingMarker( m_b ) );
+    BOOST_CHECK( !HasDanglingMarker( m_c ) );
+    BOOST_CHECK( !HasClearanceMarker( m_a, m_d ) );
+}
+
+
+/**
+ * Check that moves removing or uncovering several errors at once give the markers of a full
+ * run.  The middle track of three close tracks of different nets has an error with each of
+ * the other two.
+ */
+BOOST_AUTO_TEST_CASE( MoveTrackMultipleErrors )
+{
+    NETINFO_ITEM* net3 = new NETINFO_ITEM( &m_board, "N3", 3 );
+    m_board.Add( net3 );
+
+    TRACK* x = addTrack( mm( 0, 100 ), mm( 10, 100 ), 1 );
+    TRACK* y = addTrack( mm( 0, 100.3 ), mm( 10, 100.3 ), 2 );
+    TRACK* z = addTrack( mm( 0, 100.6 ), mm( 10, 100.6 ), 3 );
+
+    m_board.GetConnectivity()->Build( &m_board );
+    m_drc.StartOnlineDRC( &m_board );
+    RetestAllTracks();
+
+    BOOST_CHECK( HasClearanceMarker( x, y ) );
+    BOOST_CHECK( HasClearanceMarker( y, z ) );
+    BOOST_CHECK( !HasClearanceMarker( x, z ) );
+
+    // Move the middle track away: both of its errors go
+    MoveTrack( y, mm( 0, 20 ) );
+    BOOST_CHECK( !HasClearanceMarker( x, y ) );
+    BOOST_CHECK( !HasClearanceMarker( y, z ) );
+    CheckSameAsFullRun();
+
+    // Move it back: both errors are back
+    MoveTrack( y, mm( 0, -20 ) );
+    BOOST_CHECK( HasClearanceMarker( x, y ) );
+    BOOST_CHECK( HasClearanceMarker( y, z ) );
+    CheckSameAsFullRun();
+
+    // Move the first track between the two others: it now collides with both, and the error
+    // between them is still reported
+    MoveTrack( x, mm( 0, 0.45 ) );
+    BOOST_CHECK( HasClearanceMarker( x, y ) );
+    BOOST_CHECK( HasClearanceMarker( x, z ) );
+    BOOST_CHECK( HasClearanceMarker( y, z ) );
+    CheckSameAsFullRun();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
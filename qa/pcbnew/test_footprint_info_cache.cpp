@@ -0,0 +1,214 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_footprint_info_cache.cpp
+ * Test suite for the footprint info cache and the incremental reading of footprint libraries.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <footprint_info_impl.h>
+#include <fp_lib_table.h>
+
+#include <wx/dir.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+
+/**
+ * A directory of footprint libraries, removed on destruction
+ */
+class TEMP_FP_LIBS
+{
+public:
+    TEMP_FP_LIBS()
+    {
+        m_dir = wxFileName::CreateTempFileName( "qa_fp_info_cache" );
+        wxRemoveFile( m_dir );
+        wxFileName::Mkdir( m_dir );
+    }
+
+    ~TEMP_FP_LIBS()
+    {
+        wxFileName::Rmdir( m_dir, wxPATH_RMDIR_RECURSIVE );
+    }
+
+    /**
+     * Add a footprint to a library, creating the library if needed
+     *
+     * @return the library path
+     */
+    wxString AddFootprint( const wxString& aLib, const wxString& aName,
+                           const wxString& aDescription )
+    {
+        wxFileName fn( m_dir, aName, "kicad_mod" );
+
+        fn.AppendDir( aLib + ".pretty" );
+
+        if( !fn.DirExists() )
+            fn.Mkdir();
+
+        wxFFile file( fn.GetFullPath(), "wb" );
+
+        file.Write( wxString::Format( "(module %s (layer F.Cu) (tedit 5B307E4A)\n"
+                                      "  (descr \"%s\")\n"
+                                      "  (tags test)\n"
+                                      "  (pad 1 smd rect (at 0 0) (size 1 1) "
+                                      "(layers F.Cu F.Paste F.Mask))\n"
+                                      ")\n",
+                                      aName, aDescription ) );
+
+        return fn.GetPath();
+    }
+
+    wxString GetPath( const wxString& aFile ) const
+    {
+        return wxFileName( m_dir, aFile ).GetFullPath();
+    }
+
+private:
+    wxString m_dir;
+};
+
+
+static FOOTPRINT_INFO* findFootprint( FOOTPRINT_LIST& aList, const wxString& aLib,
+                                      const wxString& aName )
+{
+    for( const std::unique_ptr<FOOTPRINT_INFO>& fpinfo : aList.GetList() )
+    {
+        if( fpinfo->GetLibNickname() == aLib && fpinfo->GetName() == aName )
+            return fpinfo.get();
+    }
+
+    return nullptr;
+}
+
+
+BOOST_AUTO_TEST_SUITE( FootprintInfoCache )
+
+
+/**
+ * Check that only the libraries which changed are read again
+ */
+BOOST_AUTO_TEST_CASE( ReadChangedLibraries )
+{
+    TEMP_FP_LIBS libs;
+    FP_LIB_TABLE table;
+
+    table.InsertRow( new FP_LIB_TABLE_ROW( "A", libs.AddFootprint( "A", "A1", "First" ),
+                                           "KiCad", wxEmptyString ) );
+    table.InsertRow( new FP_LIB_TABLE_ROW( "B", libs.AddFootprint( "B", "B1", "Second" ),
+                                           "KiCad", wxEmptyString ) );
+
+    FOOTPRINT_LIST_IMPL list;
+
+    BOOST_CHECK( list.ReadFootprintFiles( &table ) );
+    BOOST_REQUIRE_EQUAL( list.GetCount(), 2u );
+
+    FOOTPRINT_INFO* a1 = findFootprint( list, "A", "A1" );
+    FOOTPRINT_INFO* b1 = findFootprint( list, "B", "B1" );
+
+    BOOST_REQUIRE( a1 && b1 );
+    BOOST_CHECK_EQUAL( a1->GetDescription(), "First" );
+
+    libs.AddFootprint( "B", "B2", "Third" );
+
+    BOOST_CHECK( list.ReadFootprintFiles( &table ) );
+    BOOST_CHECK_EQUAL( list.GetCount(), 3u );
+    BOOST_CHECK( findFootprint( list, "A", "A1" ) == a1 );
+    BOOST_CHECK( findFootprint( list, "B", "B2" ) );
+
+    // Reading a single library drops the others
+    wxString nickname( "A" );
+
+    BOOST_CHECK( list.ReadFootprintFiles( &table, &nickname ) );
+    BOOST_CHECK_EQUAL( list.GetCount(), 1u );
+    BOOST_CHECK( findFootprint( list, "A", "A1" ) == a1 );
+}
+
+
+/**
+ * Check that the cache restores the list and the library timestamps
+ */
+BOOST_AUTO_TEST_CASE( CacheRoundTrip )
+{
+    TEMP_FP_LIBS libs;
+    FP_LIB_TABLE table;
+    wxString     cachePath = libs.GetPath( "fp-info-cache" );
+
+    table.InsertRow( new FP_LIB_TABLE_ROW( "A", libs.AddFootprint( "A", "A1", "First" ),
+                                           "KiCad", wxEmptyString ) );
+    table.InsertRow( new FP_LIB_TABLE_ROW( "B", libs.AddFootprint( "B", "B1", "Second" ),
+                                           "KiCad", wxEmptyString ) );
+
+    {
+        FOOTPRINT_LIST_IMPL list;
+
+        BOOST_CHECK( list.ReadFootprintFiles( &table ) );
+        list.WriteCacheToFile( cachePath );
+    }
+
+    FOOTPRINT_LIST_IMPL cached;
+
+    cached.ReadCacheFromFile( cachePath );
+    BOOST_REQUIRE_EQUAL( cached.GetCount(), 2u );
+
+    FOOTPRINT_INFO* a1 = findFootprint( cached, "A", "A1" );
+    FOOTPRINT_INFO* b1 = findFootprint( cached, "B", "B1" );
+
+    BOOST_REQUIRE( a1 && b1 );
+    BOOST_CHECK_EQUAL( b1->GetDescription(), "Second" );
+    BOOST_CHECK_EQUAL( b1->GetKeywords(), "test" );
+    BOOST_CHECK_EQUAL( b1->GetPadCount(), 1u );
+
+    // Nothing changed, so nothing is read
+    BOOST_CHECK( cached.ReadFootprintFiles( &table ) );
+    BOOST_CHECK( findFootprint( cached, "A", "A1" ) == a1 );
+    BOOST_CHECK( findFootprint( cached, "B", "B1" ) == b1 );
+
+    libs.AddFootprint( "B", "B2", "Third" );
+
+    BOOST_CHECK( cached.ReadFootprintFiles( &table ) );
+    BOOST_CHECK_EQUAL( cached.GetCount(), 3u );
+    BOOST_CHECK( findFootprint( cached, "A", "A1" ) == a1 );
+
+    // A truncated cache is discarded
+    wxFFile file( cachePath, "rb" );
+    std::string data( file.Length(), '\0' );
+
+    file.Read( &data[0], data.size() );
+    file.Close();
+
+    wxFFile truncated( cachePath, "wb" );
+
+    truncated.Write( data.data(), data.size() - 3 );
+    truncated.Close();
+
+    cached.ReadCacheFromFile( cachePath );
+    BOOST_CHECK_EQUAL( cached.GetCount(), 0u );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,204 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_pcb_undo_packer.cpp
+ * Test suite for the packing of the footprint copies kept by undo commands.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_edge_mod.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_text_mod.h>
+#include <pcb_undo_packer.h>
+
+#include <functional>
+#include <memory>
+
+
+struct PCB_UNDO_PACKER_FIXTURE
+{
+    PCB_UNDO_PACKER_FIXTURE()
+    {
+        m_net = new NETINFO_ITEM( &m_board, "N1", 1 );
+        m_board.Add( m_net );
+
+        m_module = new MODULE( &m_board );
+        m_module->SetReference( "U1" );
+        m_module->SetLink( KIID() );
+
+        EDGE_MODULE* edge = new EDGE_MODULE( m_module );
+        edge->SetStart0( wxPoint( 0, 0 ) );
+        edge->SetEnd0( wxPoint( Millimeter2iu( 1 ), 0 ) );
+        edge->SetLayer( F_SilkS );
+        edge->SetDrawCoord();
+        m_module->Add( edge );
+
+        TEXTE_MODULE* text = new TEXTE_MODULE( m_module );
+        text->SetText( "text" );
+        text->SetLayer( F_SilkS );
+        m_module->Add( text );
+
+        D_PAD* pad = new D_PAD( m_module );
+        pad->SetName( "1" );
+        pad->SetPinFunction( "IN" );
+        pad->SetNet( m_net );
+        m_module->Add( pad );
+
+        m_board.Add( m_module );
+    }
+
+    /**
+     * Pack and unpack a footprint copy, as an old undo command does.
+     * @param aImage is the copy, owned by the picker until it is packed.
+     * @param aBetween is run while the copy is packed.
+     * @return the unpacked copy.
+     */
+    std::unique_ptr<MODULE> PackAndUnpack( MODULE* aImage,
+                                           const std::function<void()>& aBetween = nullptr )
+    {
+        ITEM_PICKER picker( m_module, UR_CHANGED );
+        std::string data;
+
+        picker.SetLink( aImage );
+
+        BOOST_REQUIRE( m_packer.Pack( picker, data ) );
+        BOOST_CHECK( picker.GetLink() == nullptr );
+
+        if( aBetween )
+            aBetween();
+
+        m_packer.Unpack( picker, data );
+
+        BOOST_REQUIRE( picker.GetLink() );
+        BOOST_REQUIRE( picker.GetLink()->Type() == PCB_MODULE_T );
+
+        return std::unique_ptr<MODULE>( static_cast<MODULE*>( picker.GetLink() ) );
+    }
+
+    /**
+     * @return the uuids of the footprint and of its items, in the order they are stored.
+     */
+    static std::vector<KIID> GetUuids( MODULE* aModule )
+    {
+        std::vector<KIID> uuids = { aModule->m_Uuid, aModule->Reference().m_Uuid,
+                                    aModule->Value().m_Uuid };
+
+        for( BOARD_ITEM* item : aModule->GraphicalItems() )
+            uuids.push_back( item->m_Uuid );
+
+        for( D_PAD* pad : aModule->Pads() )
+            uuids.push_back( pad->m_Uuid );
+
+        return uuids;
+    }
+
+    BOARD           m_board;
+    NETINFO_ITEM*   m_net;
+    MODULE*         m_module;
+    PCB_UNDO_PACKER m_packer;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PcbUndoPacker, PCB_UNDO_PACKER_FIXTURE )
+
+
+/**
+ * Check the state the s-expression format does not store is restored
+ */
+BOOST_AUTO_TEST_CASE( FootprintRoundTrip )
+{
+    MODULE*           image = static_cast<MODULE*>( m_module->Clone() );
+    KIID              link = image->GetLink();
+    std::vector<KIID> uuids = GetUuids( image );
+
+    std::unique_ptr<MODULE> unpacked = PackAndUnpack( image );
+
+    BOOST_CHECK( unpacked->GetLink() == link );
+    BOOST_CHECK_EQUAL( unpacked->GraphicalItems().size(), 2 );
+
+    std::vector<KIID> unpackedUuids = GetUuids( unpacked.get() );
+
+    BOOST_REQUIRE_EQUAL( unpackedUuids.size(), uuids.size() );
+
+    for( size_t ii = 0; ii < uuids.size(); ++ii )
+    {
+        BOOST_TEST_CONTEXT( "Item " << ii )
+        {
+            BOOST_CHECK( unpackedUuids[ii] == uuids[ii] );
+        }
+    }
+
+    BOOST_REQUIRE_EQUAL( unpacked->Pads().size(), 1 );
+    BOOST_CHECK( unpacked->Pads().front()->GetNet() == m_net );
+    BOOST_CHECK( unpacked->Pads().front()->GetPinFunction() == "IN" );
+}
+
+
+/**
+ * A net deleted after the copy was packed must not make it unreadable
+ */
+BOOST_AUTO_TEST_CASE( DeletedNet )
+{
+    std::unique_ptr<MODULE> unpacked = PackAndUnpack( static_cast<MODULE*>( m_module->Clone() ),
+            [&]()
+            {
+                m_module->Pads().front()->SetNetCode( NETINFO_LIST::UNCONNECTED );
+                m_board.Remove( m_net );
+            } );
+
+    BOOST_REQUIRE_EQUAL( unpacked->Pads().size(), 1 );
+    BOOST_CHECK( unpacked->Pads().front()->GetNet() == NETINFO_LIST::OrphanedItem() );
+
+    delete m_net;
+}
+
+
+/**
+ * A net deleted while the copy is packed must not be mistaken for a new net given its code
+ */
+BOOST_AUTO_TEST_CASE( ReusedNetCode )
+{
+    NETINFO_ITEM* other = nullptr;
+
+    std::unique_ptr<MODULE> unpacked = PackAndUnpack( static_cast<MODULE*>( m_module->Clone() ),
+            [&]()
+            {
+                m_module->Pads().front()->SetNetCode( NETINFO_LIST::UNCONNECTED );
+                m_board.Remove( m_net );
+
+                other = new NETINFO_ITEM( &m_board, "N2", m_net->GetNet() );
+                m_board.Add( other );
+            } );
+
+    BOOST_REQUIRE_EQUAL( other->GetNet(), m_net->GetNet() );
+    BOOST_CHECK( unpacked->Pads().front()->GetNet() == NETINFO_LIST::OrphanedItem() );
+
+    delete m_net;
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
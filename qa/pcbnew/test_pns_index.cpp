@@ -0,0 +1,156 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_pns_index.cpp
+ * Test suite for the spatial indices of the router.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <router/pns_index.h>
+#include <router/pns_segment.h>
+
+#include <memory>
+#include <random>
+#include <set>
+
+
+/**
+ * Items of aItems whose bounding box is within aMinDistance of the one of aShape
+ */
+static std::set<PNS::ITEM*> bruteForceQuery( const std::set<PNS::ITEM*>& aItems,
+                                             const SHAPE* aShape, int aMinDistance )
+{
+    BOX2I                box = aShape->BBox();
+    std::set<PNS::ITEM*> found;
+
+    box.Inflate( aMinDistance );
+
+    for( PNS::ITEM* item : aItems )
+    {
+        BOX2I itemBox = item->Shape()->BBox();
+
+        if( itemBox.GetX() <= box.GetRight() && box.GetX() <= itemBox.GetRight()
+                && itemBox.GetY() <= box.GetBottom() && box.GetY() <= itemBox.GetBottom() )
+        {
+            found.insert( item );
+        }
+    }
+
+    return found;
+}
+
+
+BOOST_AUTO_TEST_SUITE( PnsIndex )
+
+
+/**
+ * Check that queries find the same items as a linear search while items are added to and
+ * removed from the index, across rebuilds of its hierarchy
+ */
+BOOST_AUTO_TEST_CASE( PackedIndexMatchesBruteForce )
+{
+    std::mt19937                        rng( 42 );
+    std::uniform_int_distribution<int>  coord( -10000000, 10000000 );
+    std::uniform_int_distribution<int>  length( 0, 500000 );
+    std::vector<std::unique_ptr<PNS::SEGMENT>> segments;
+    std::set<PNS::ITEM*>                live;
+    PNS::PACKED_INDEX                   index;
+
+    for( int step = 0; step < 5000; step++ )
+    {
+        if( live.empty() || rng() % 3 )
+        {
+            VECTOR2I a( coord( rng ), coord( rng ) );
+            VECTOR2I b = a + VECTOR2I( length( rng ), length( rng ) );
+
+            segments.emplace_back( new PNS::SEGMENT( SEG( a, b ), 1 ) );
+            segments.back()->SetWidth( 250000 );
+
+            index.Add( segments.back().get() );
+            live.insert( segments.back().get() );
+        }
+        else
+        {
+            auto it = live.begin();
+            std::advance( it, rng() % live.size() );
+
+            index.Remove( *it );
+            live.erase( it );
+        }
+
+        if( step % 100 == 0 )
+        {
+            VECTOR2I             a( coord( rng ), coord( rng ) );
+            SHAPE_SEGMENT        query( SEG( a, a + VECTOR2I( 2000000, 100000 ) ), 200000 );
+            std::set<PNS::ITEM*> found;
+
+            auto visitor =
+                    [&]( PNS::ITEM* aItem )
+                    {
+                        BOOST_CHECK( found.insert( aItem ).second );
+                        return true;
+                    };
+
+            index.Query( &query, 10000, visitor );
+
+            std::set<PNS::ITEM*> expected = bruteForceQuery( live, &query, 10000 );
+
+            BOOST_CHECK( found == expected );
+            BOOST_CHECK_EQUAL( index.Size(), (int) live.size() );
+        }
+    }
+}
+
+
+/**
+ * Check that returning false from the visitor stops the search
+ */
+BOOST_AUTO_TEST_CASE( PackedIndexStopsSearch )
+{
+    std::vector<std::unique_ptr<PNS::SEGMENT>> segments;
+    PNS::PACKED_INDEX                          index;
+
+    for( int i = 0; i < 1000; i++ )
+    {
+        segments.emplace_back( new PNS::SEGMENT( SEG( VECTOR2I( i, 0 ), VECTOR2I( i, 10 ) ), 1 ) );
+        index.Add( segments.back().get() );
+    }
+
+    SHAPE_SEGMENT query( SEG( VECTOR2I( 0, 5 ), VECTOR2I( 1000, 5 ) ), 0 );
+    int           visited = 0;
+
+    auto visitor =
+            [&]( PNS::ITEM* aItem )
+            {
+                return ++visited < 10;
+            };
+
+    index.Query( &query, 0, visitor );
+
+    BOOST_CHECK_EQUAL( visited, 10 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
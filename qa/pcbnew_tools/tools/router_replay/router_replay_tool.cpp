@@ -0,0 +1,468 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+
+#include <common.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <router/pns_arc.h>
+#include <router/pns_debug_decorator.h>
+#include <router/pns_input_recorder.h>
+#include <router/pns_kicad_iface.h>
+#include <router/pns_router.h>
+#include <router/pns_segment.h>
+#include <router/pns_via.h>
+#include <settings/json_settings.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+using REPLAY_DURATION = std::chrono::microseconds;
+
+
+/**
+ * Headless router interface keeping track of the items committed by the replay
+ */
+class REPLAY_IFACE : public PNS_KICAD_IFACE_BASE
+{
+public:
+    void AddItem( PNS::ITEM* aItem ) override
+    {
+        m_added.insert( aItem );
+    }
+
+    void RemoveItem( PNS::ITEM* aItem ) override
+    {
+        if( !m_added.erase( aItem ) )
+            m_removed++;
+    }
+
+    ///> Items committed by the router and not removed since.  Owned by the router's world.
+    const std::set<PNS::ITEM*>& AddedItems() const { return m_added; }
+
+    ///> Number of board items removed by the router
+    int RemovedCount() const { return m_removed; }
+
+private:
+    std::set<PNS::ITEM*> m_added;
+    int                  m_removed = 0;
+};
+
+
+/**
+ * Timing and iteration counts of the replayed events of one type
+ */
+struct EVENT_STATS
+{
+    int             m_count = 0;
+    int             m_iterations = 0;
+    REPLAY_DURATION m_total = REPLAY_DURATION( 0 );
+    REPLAY_DURATION m_max = REPLAY_DURATION( 0 );
+};
+
+
+/**
+ * Replays a recorded router session against a board
+ */
+class ROUTER_REPLAY
+{
+public:
+    /**
+     * What is printed by the replay
+     */
+    struct EXECUTION_CONTEXT
+    {
+        bool m_verbose;
+        bool m_print_steps;
+        bool m_print_geometry;
+    };
+
+    ROUTER_REPLAY( const EXECUTION_CONTEXT& aExecCtx, BOARD& aBoard ) :
+            m_exec_context( aExecCtx ),
+            m_board( aBoard )
+    {
+    }
+
+    /**
+     * Replays all events of \a aLog once
+     * @return the total time spent in the router
+     */
+    REPLAY_DURATION Execute( const PNS::INPUT_RECORDER& aLog )
+    {
+        PNS::DEBUG_DECORATOR decorator;
+        REPLAY_IFACE         iface;
+
+        iface.SetBoard( &m_board );
+        iface.SetDebugDecorator( &decorator );
+
+        // The routing settings live in a JSON tree, so they need a parent to attach to
+        JSON_SETTINGS         settingsRoot( "router_replay", SETTINGS_LOC::NESTED, 0, false,
+                                            false, false );
+        PNS::ROUTING_SETTINGS settings( &settingsRoot, "pns" );
+        PNS::ROUTER           router;
+
+        router.SetInterface( &iface );
+        router.ClearWorld();
+        router.SyncWorld();
+        router.LoadSettings( &settings );
+
+        std::map<PNS::INPUT_RECORDER::EVENT_TYPE, EVENT_STATS> stats;
+        REPLAY_DURATION                                        total( 0 );
+        int                                                    step = 0;
+
+        for( const PNS::INPUT_RECORDER::EVENT& evt : aLog.Events() )
+        {
+            PNS::ITEM_SET items = PNS::INPUT_RECORDER::FindItems( router.GetWorld(), evt );
+            PNS::ITEM*    item = items.Empty() ? nullptr : items[0];
+
+            if( (size_t) items.Size() != evt.m_Items.size() && m_exec_context.m_verbose )
+            {
+                std::cout << "Step " << step << ": found " << items.Size() << " of "
+                          << evt.m_Items.size() << " items" << std::endl;
+            }
+
+            REPLAY_DURATION duration;
+            bool            ok = true;
+
+            router.ResetIterationCount();
+
+            {
+                SCOPED_PROF_COUNTER<REPLAY_DURATION> timer( duration );
+                ok = replayEvent( router, evt, items, item );
+            }
+
+            EVENT_STATS& evtStats = stats[evt.m_Type];
+
+            evtStats.m_count++;
+            evtStats.m_iterations += router.GetIterationCount();
+            evtStats.m_total += duration;
+            evtStats.m_max = std::max( evtStats.m_max, duration );
+            total += duration;
+
+            if( m_exec_context.m_print_steps )
+            {
+                std::cout << step << " " << PNS::INPUT_RECORDER::EventName( evt.m_Type ) << " ("
+                          << evt.m_Position.x << ", " << evt.m_Position.y << ")"
+                          << " " << duration.count() << "us"
+                          << " " << router.GetIterationCount() << " iterations"
+                          << ( ok ? "" : " FAILED" ) << std::endl;
+            }
+
+            if( !ok && m_exec_context.m_verbose )
+                std::cout << "  " << router.FailureReason().ToStdString() << std::endl;
+
+            step++;
+        }
+
+        router.StopRouting();
+
+        reportStats( stats, total );
+        reportGeometry( iface );
+
+        return total;
+    }
+
+private:
+    bool replayEvent( PNS::ROUTER& aRouter, const PNS::INPUT_RECORDER::EVENT& aEvent,
+                      const PNS::ITEM_SET& aItems, PNS::ITEM* aItem )
+    {
+        switch( aEvent.m_Type )
+        {
+        case PNS::INPUT_RECORDER::EVT_START_ROUTE:
+            PNS::INPUT_RECORDER::ApplyConfig( &aRouter, aEvent );
+            return aRouter.StartRouting( aEvent.m_Position, aItem, aEvent.m_Arg );
+
+        case PNS::INPUT_RECORDER::EVT_START_DRAG:
+            PNS::INPUT_RECORDER::ApplyConfig( &aRouter, aEvent );
+            return aRouter.StartDragging( aEvent.m_Position, aItems, aEvent.m_Arg );
+
+        case PNS::INPUT_RECORDER::EVT_MOVE:
+            aRouter.Move( aEvent.m_Position, aItem );
+            break;
+
+        case PNS::INPUT_RECORDER::EVT_FIX:
+            return aRouter.FixRoute( aEvent.m_Position, aItem, aEvent.m_Arg != 0 );
+
+        case PNS::INPUT_RECORDER::EVT_UNFIX:
+            aRouter.UndoLastSegment();
+            break;
+
+        case PNS::INPUT_RECORDER::EVT_COMMIT:
+            aRouter.CommitRouting();
+            break;
+
+        case PNS::INPUT_RECORDER::EVT_STOP:
+            aRouter.StopRouting();
+            break;
+
+        case PNS::INPUT_RECORDER::EVT_SWITCH_LAYER:
+            aRouter.SwitchLayer( aEvent.m_Arg );
+            break;
+
+        case PNS::INPUT_RECORDER::EVT_TOGGLE_VIA:
+            aRouter.ToggleViaPlacement();
+            break;
+
+        case PNS::INPUT_RECORDER::EVT_FLIP_POSTURE:
+            aRouter.FlipPosture();
+            break;
+
+        case PNS::INPUT_RECORDER::EVT_UPDATE_SIZES:
+            PNS::INPUT_RECORDER::ApplyConfig( &aRouter, aEvent );
+            break;
+        }
+
+        return true;
+    }
+
+    void reportStats( const std::map<PNS::INPUT_RECORDER::EVENT_TYPE, EVENT_STATS>& aStats,
+                      const REPLAY_DURATION& aTotal ) const
+    {
+        std::cout << "Event          count   iterations   total [us]   mean [us]    max [us]"
+                  << std::endl;
+
+        for( const auto& entry : aStats )
+        {
+            const EVENT_STATS& s = entry.second;
+
+            std::cout << std::left << std::setw( 14 )
+                      << PNS::INPUT_RECORDER::EventName( entry.first ) << std::right
+                      << std::setw( 6 ) << s.m_count
+                      << std::setw( 13 ) << s.m_iterations
+                      << std::setw( 13 ) << s.m_total.count()
+                      << std::setw( 12 ) << s.m_total.count() / s.m_count
+                      << std::setw( 12 ) << s.m_max.count() << std::endl;
+        }
+
+        std::cout << "Total: " << aTotal.count() << "us" << std::endl;
+    }
+
+    void reportGeometry( const REPLAY_IFACE& aIface ) const
+    {
+        int     segments = 0, arcs = 0, vias = 0;
+        int64_t length = 0;
+
+        for( const PNS::ITEM* item : aIface.AddedItems() )
+        {
+            switch( item->Kind() )
+            {
+            case PNS::ITEM::SEGMENT_T:
+            {
+                const PNS::SEGMENT* segment = static_cast<const PNS::SEGMENT*>( item );
+                const SEG&          seg = segment->Seg();
+
+                segments++;
+                length += seg.Length();
+
+                if( m_exec_context.m_print_geometry )
+                {
+                    std::cout << "segment net " << item->Net() << " layer "
+                              << item->Layers().Start() << " (" << seg.A.x << ", " << seg.A.y
+                              << ") (" << seg.B.x << ", " << seg.B.y << ") width "
+                              << segment->Width() << std::endl;
+                }
+
+                break;
+            }
+
+            case PNS::ITEM::ARC_T:
+            {
+                const PNS::ARC* arc = static_cast<const PNS::ARC*>( item );
+
+                arcs++;
+                length += arc->CLine().Length();
+
+                if( m_exec_context.m_print_geometry )
+                {
+                    std::cout << "arc net " << item->Net() << " layer " << item->Layers().Start()
+                              << " (" << arc->Anchor( 0 ).x << ", " << arc->Anchor( 0 ).y
+                              << ") (" << arc->Anchor( 1 ).x << ", " << arc->Anchor( 1 ).y
+                              << ") width " << arc->Width() << std::endl;
+                }
+
+                break;
+            }
+
+            case PNS::ITEM::VIA_T:
+            {
+                const PNS::VIA* via = static_cast<const PNS::VIA*>( item );
+
+                vias++;
+
+                if( m_exec_context.m_print_geometry )
+                {
+                    std::cout << "via net " << item->Net() << " layers "
+                              << item->Layers().Start() << "-" << item->Layers().End() << " ("
+                              << via->Pos().x << ", " << via->Pos().y << ") diameter "
+                              << via->Diameter() << std::endl;
+                }
+
+                break;
+            }
+
+            default:
+                break;
+            }
+        }
+
+        std::cout << "Committed: " << segments << " segments, " << arcs << " arcs, " << vias
+                  << " vias, track length " << length << "nm" << std::endl;
+        std::cout << "Removed: " << aIface.RemovedCount() << " board items" << std::endl;
+    }
+
+    const EXECUTION_CONTEXT m_exec_context;
+    BOARD&                  m_board;
+};
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print replay information" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "s",
+            "steps",
+            _( "print the latency and iteration count of each step" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "g",
+            "geometry",
+            _( "print the geometry committed by the router" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "b",
+            "board",
+            _( "board file to replay against (default: the recorded one)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            _( "replay the log this many times" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "router input log" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool-specific return codes
+ */
+enum REPLAY_RET_CODES
+{
+    LOG_LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    BOARD_LOAD_FAILED,
+};
+
+
+int router_replay_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program replays the router inputs recorded with the RecordRouterInput "
+               "advanced config option against a board, and reports the router timings. "
+               "The replay only matches the recording if the board was saved before routing "
+               "and not changed by other tools in between." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    PNS::INPUT_RECORDER log;
+
+    if( !log.Load( cl_parser.GetParam( 0 ) ) )
+    {
+        std::cerr << "Could not load router input log " << cl_parser.GetParam( 0 ).ToStdString()
+                  << std::endl;
+        return REPLAY_RET_CODES::LOG_LOAD_FAILED;
+    }
+
+    wxString boardFile = log.GetBoardFile();
+    cl_parser.Found( "board", &boardFile );
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( boardFile.ToStdString() );
+
+    if( !board )
+        return REPLAY_RET_CODES::BOARD_LOAD_FAILED;
+
+    long repeat = 1;
+    cl_parser.Found( "repeat", &repeat );
+
+    ROUTER_REPLAY::EXECUTION_CONTEXT exec_context{
+        cl_parser.Found( "verbose" ),
+        cl_parser.Found( "steps" ),
+        cl_parser.Found( "geometry" ),
+    };
+
+    ROUTER_REPLAY   replay( exec_context, *board );
+    REPLAY_DURATION best = REPLAY_DURATION::max();
+
+    for( long ii = 0; ii < std::max( repeat, 1L ); ++ii )
+        best = std::min( best, replay.Execute( log ) );
+
+    if( repeat > 1 )
+        std::cout << "Best of " << repeat << ": " << best.count() << "us" << std::endl;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "router_replay",
+        "Replay a recorded interactive router session against a board",
+        router_replay_main_func } );